@@ -0,0 +1,98 @@
+/*
+  Copyright (c) 2009-2017 Dave Gamble and cJSON contributors
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+/* Measures how long the common loop over cJSON_GetArraySize and cJSON_GetArrayItem takes
+ * with and without an index created by cJSON_IndexArray. Without the index the loop is O(n^2). */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "../cJSON.h"
+
+static double milliseconds_since(clock_t start)
+{
+    return ((double)(clock() - start) * 1000.0) / (double)CLOCKS_PER_SEC;
+}
+
+static double sum_items(const cJSON *array)
+{
+    double sum = 0;
+    int i = 0;
+
+    for (i = 0; i < cJSON_GetArraySize(array); i++)
+    {
+        sum += cJSON_GetNumberValue(cJSON_GetArrayItem(array, i));
+    }
+
+    return sum;
+}
+
+static double time_sum(const cJSON *array, int size)
+{
+    clock_t start = clock();
+    double expected = ((double)size * (size - 1)) / 2;
+
+    if (sum_items(array) != expected)
+    {
+        fprintf(stderr, "Wrong sum of the items.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    return milliseconds_since(start);
+}
+
+int CJSON_CDECL main(void)
+{
+    int size = 0;
+
+    printf("%10s %14s %14s %14s %14s\n", "items", "list ms", "ns/item", "indexed ms", "ns/item");
+    for (size = 1000; size <= 16000; size *= 2)
+    {
+        cJSON *array = cJSON_CreateArray();
+        double list_time = 0;
+        double indexed_time = 0;
+        int i = 0;
+
+        for (i = 0; i < size; i++)
+        {
+            cJSON_AddItemToArray(array, cJSON_CreateNumber(i));
+        }
+
+        list_time = time_sum(array, size);
+        if (!cJSON_IndexArray(array))
+        {
+            fprintf(stderr, "Failed to index the array.\n");
+            return EXIT_FAILURE;
+        }
+        indexed_time = time_sum(array, size);
+
+        printf("%10d %14.2f %14.1f %14.2f %14.1f\n",
+                size,
+                list_time, (list_time * 1e6) / size,
+                indexed_time, (indexed_time * 1e6) / size);
+
+        cJSON_Delete(array);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,90 @@
+/*
+  Copyright (c) 2009-2017 Dave Gamble and cJSON contributors
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+/* Measures how long it takes to build arrays and objects of growing size
+ * item by item. Appending is O(1), so the time per item should stay flat. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "../cJSON.h"
+
+static double milliseconds_since(clock_t start)
+{
+    return ((double)(clock() - start) * 1000.0) / (double)CLOCKS_PER_SEC;
+}
+
+static double build_array(int size)
+{
+    cJSON *array = cJSON_CreateArray();
+    clock_t start = clock();
+    double elapsed = 0;
+    int i = 0;
+
+    for (i = 0; i < size; i++)
+    {
+        cJSON_AddItemToArray(array, cJSON_CreateNumber(i));
+    }
+    elapsed = milliseconds_since(start);
+
+    cJSON_Delete(array);
+    return elapsed;
+}
+
+static double build_object(int size)
+{
+    cJSON *object = cJSON_CreateObject();
+    char key[32];
+    clock_t start = clock();
+    double elapsed = 0;
+    int i = 0;
+
+    for (i = 0; i < size; i++)
+    {
+        sprintf(key, "key%d", i);
+        cJSON_AddItemToObject(object, key, cJSON_CreateNumber(i));
+    }
+    elapsed = milliseconds_since(start);
+
+    cJSON_Delete(object);
+    return elapsed;
+}
+
+int CJSON_CDECL main(void)
+{
+    int size = 0;
+
+    printf("%10s %14s %14s %14s %14s\n", "items", "array ms", "ns/item", "object ms", "ns/item");
+    for (size = 12500; size <= 400000; size *= 2)
+    {
+        double array_time = build_array(size);
+        double object_time = build_object(size);
+
+        printf("%10d %14.2f %14.1f %14.2f %14.1f\n",
+                size,
+                array_time, (array_time * 1e6) / size,
+                object_time, (object_time * 1e6) / size);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,954 @@
+/*
+  Copyright (c) 2009-2017 Dave Gamble and cJSON contributors
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+/* Measures the throughput and the number of allocations of the main operations
+ * on generated documents of different shapes.
+ *
+ * usage: cjson_bench [filter]
+ * Only runs the benchmarks whose "corpus/operation" name contains filter. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../cJSON.h"
+#ifdef CJSON_BENCH_UTILS
+#include "../cJSON_Utils.h"
+#endif
+
+/* every operation is repeated until it has run for at least this long */
+#define MINIMUM_SECONDS 0.25
+
+#ifdef CJSON_BENCH_UTILS
+/* how many values the projection benchmarks select */
+#define PROJECTED_POINTERS 5
+#endif
+
+typedef struct
+{
+    const char *name;
+    cJSON *tree;
+    char *text; /* unformatted */
+    size_t length;
+    char *formatted;
+    size_t formatted_length;
+    unsigned char *cbor; /* the same tree as CBOR */
+    size_t cbor_length;
+    /* scratch space for the operations */
+    char *buffer;
+    size_t buffer_length;
+    cJSON_PrintBuffer *print_buffer; /* reused by every print to buffer */
+    cJSON_KeyTable *keys; /* shared by every parse with key table */
+    cJSON *copy;
+    cJSON *snapshots; /* a copy from cJSON_DuplicateShared, so its copies share its children */
+    cJSON *packed; /* parsed with cJSON_ParsePacked */
+    double *numbers; /* room for the numbers of the biggest packed array */
+    size_t numbers_length;
+    cJSON *modified; /* a copy with some changes */
+    cJSON *patches;
+    cJSON *reverse_patches;
+#ifdef CJSON_BENCH_UTILS
+    /* the paths of the patches, as JSON pointers into tree */
+    const char **pointers;
+    cJSONUtils_Pointer **compiled_pointers;
+    cJSON **pointer_results;
+    size_t pointer_count;
+    /* a few of the pointers, spread over the document */
+    const char *projected_pointers[PROJECTED_POINTERS];
+#endif
+} corpus;
+
+/* runs an operation once and returns the number of bytes of JSON it processed */
+typedef size_t (*operation_function)(corpus *document);
+
+typedef struct
+{
+    const char *name;
+    operation_function run;
+} operation;
+
+static void fail(const char *message)
+{
+    fprintf(stderr, "%s\n", message);
+    exit(EXIT_FAILURE);
+}
+
+/* deterministic pseudo random numbers, so every run sees the same documents */
+static unsigned long random_state = 1;
+
+static unsigned long next_random(void)
+{
+    random_state = (random_state * 1103515245UL + 12345UL) & 0x7FFFFFFFUL;
+    return random_state >> 8;
+}
+
+static cJSON *generate_records(void)
+{
+    static const char *names[] = { "alpha", "bravo", "charlie", "delta", "echo", "foxtrot" };
+    cJSON *records = cJSON_CreateArray();
+    int i = 0;
+
+    for (i = 0; i < 10000; i++)
+    {
+        cJSON *record = cJSON_CreateObject();
+        cJSON *tags = cJSON_CreateArray();
+        cJSON_AddNumberToObject(record, "id", i);
+        cJSON_AddStringToObject(record, "name", names[next_random() % 6]);
+        cJSON_AddBoolToObject(record, "active", (next_random() % 2) == 0);
+        cJSON_AddNumberToObject(record, "score", (double)(next_random() % 100000) / 100.0);
+        cJSON_AddItemToArray(tags, cJSON_CreateString(names[next_random() % 6]));
+        cJSON_AddItemToArray(tags, cJSON_CreateString(names[next_random() % 6]));
+        cJSON_AddItemToObject(record, "tags", tags);
+        cJSON_AddNullToObject(record, "parent");
+        cJSON_AddItemToArray(records, record);
+    }
+
+    return records;
+}
+
+static cJSON *generate_deep(void)
+{
+    cJSON *documents = cJSON_CreateArray();
+    int i = 0;
+
+    for (i = 0; i < 250; i++)
+    {
+        cJSON *value = cJSON_CreateNumber(i);
+        int depth = 0;
+
+        /* nested arrays with a small object on every level.
+         * cJSON_Compare compares the members of objects in both directions,
+         * so long chains of objects would take exponential time. */
+        for (depth = 0; depth < 200; depth++)
+        {
+            cJSON *level = cJSON_CreateArray();
+            cJSON *object = cJSON_CreateObject();
+            cJSON_AddNumberToObject(object, "depth", depth);
+            cJSON_AddItemToArray(level, object);
+            cJSON_AddItemToArray(level, value);
+            value = level;
+        }
+        cJSON_AddItemToArray(documents, value);
+    }
+
+    return documents;
+}
+
+static cJSON *generate_wide(void)
+{
+    cJSON *object = cJSON_CreateObject();
+    char key[32];
+    int i = 0;
+
+    for (i = 0; i < 50000; i++)
+    {
+        sprintf(key, "key_%d_%lu", i, next_random() % 1000);
+        cJSON_AddNumberToObject(object, key, i);
+    }
+
+    return object;
+}
+
+static cJSON *generate_strings(void)
+{
+    static const char *words[] = { "lorem ", "ipsum ", "dolor ", "sit ", "amet, ", "\"quoted\" ", "tab\t", "line\n", "caf\xc3\xa9 ", "\xe2\x82\xac " };
+    cJSON *strings = cJSON_CreateArray();
+    char *string = (char*)malloc(8192 + 16);
+    int i = 0;
+
+    if (string == NULL)
+    {
+        fail("Failed to allocate memory.");
+    }
+
+    for (i = 0; i < 200; i++)
+    {
+        size_t length = 0;
+        string[0] = '\0';
+        while (length < 8192)
+        {
+            /* mostly plain text with an escape sequence every now and then */
+            const char *word = words[((next_random() % 8) == 0) ? (5 + (next_random() % 5)) : (next_random() % 5)];
+            strcpy(string + length, word);
+            length += strlen(word);
+        }
+        cJSON_AddItemToArray(strings, cJSON_CreateString(string));
+    }
+    free(string);
+
+    return strings;
+}
+
+static cJSON *generate_numbers(void)
+{
+    cJSON *numbers = cJSON_CreateArray();
+    int i = 0;
+
+    for (i = 0; i < 200000; i++)
+    {
+        double number = 0;
+        switch (next_random() % 3)
+        {
+            case 0:
+                number = (double)(next_random() % 100000);
+                break;
+            case 1:
+                number = (double)(next_random() % 100000000) / 1000.0;
+                break;
+            default:
+                number = ((double)next_random() / 3.0) * ((next_random() % 2) ? 1e-12 : 1e12);
+                break;
+        }
+        cJSON_AddItemToArray(numbers, cJSON_CreateNumber(number));
+    }
+
+    return numbers;
+}
+
+/* change every 16th scalar (up to a limit, applying patches to big arrays takes quadratic time)
+ * and append an item, so patches have something to do */
+static void modify(cJSON *item, size_t *counter)
+{
+    cJSON *child = item->child;
+    while (child != NULL)
+    {
+        if (cJSON_IsArray(child) || cJSON_IsObject(child))
+        {
+            modify(child, counter);
+        }
+        else if ((*counter < (16 * 256)) && (((*counter)++ % 16) == 0))
+        {
+            if (cJSON_IsNumber(child))
+            {
+                cJSON_SetNumberValue(child, cJSON_GetNumberValue(child) + 1);
+            }
+            else
+            {
+                cJSON *replacement = cJSON_CreateString("changed");
+                if (cJSON_IsObject(item))
+                {
+                    /* keeps the key */
+                    cJSON_ReplaceItemInObjectCaseSensitive(item, child->string, replacement);
+                }
+                else
+                {
+                    cJSON_ReplaceItemViaPointer(item, child, replacement);
+                }
+                child = replacement;
+            }
+        }
+        child = child->next;
+    }
+}
+
+static void prepare(corpus *document, const char *name, cJSON *tree)
+{
+    memset(document, '\0', sizeof(corpus));
+    document->name = name;
+    document->tree = tree;
+    document->text = cJSON_PrintUnformatted(tree);
+    document->formatted = cJSON_Print(tree);
+    if ((document->text == NULL) || (document->formatted == NULL))
+    {
+        fail("Failed to print a corpus.");
+    }
+    document->length = strlen(document->text);
+    document->formatted_length = strlen(document->formatted);
+    document->cbor = cJSON_PrintCBOR(tree, &document->cbor_length);
+    if (document->cbor == NULL)
+    {
+        fail("Failed to print a corpus as CBOR.");
+    }
+
+    /* enough for the formatted text and its terminating zero */
+    document->buffer_length = document->formatted_length + 1;
+    document->buffer = (char*)malloc(document->buffer_length);
+    document->print_buffer = cJSON_CreatePrintBuffer(0);
+    document->keys = cJSON_CreateKeyTable();
+    document->copy = cJSON_Duplicate(tree, 1);
+    document->snapshots = cJSON_DuplicateShared(tree);
+    document->packed = cJSON_ParsePacked(document->text, NULL, 1);
+    if ((document->buffer == NULL) || (document->print_buffer == NULL) || (document->keys == NULL) || (document->copy == NULL)
+            || (document->snapshots == NULL) || (document->packed == NULL))
+    {
+        fail("Failed to allocate memory.");
+    }
+    document->numbers_length = (size_t)cJSON_GetArraySize(document->packed);
+    if ((document->packed->type & cJSON_IsPacked) == 0)
+    {
+        cJSON *child = NULL;
+        for (child = document->packed->child; child != NULL; child = child->next)
+        {
+            if ((size_t)cJSON_GetArraySize(child) > document->numbers_length)
+            {
+                document->numbers_length = (size_t)cJSON_GetArraySize(child);
+            }
+        }
+    }
+    document->numbers = (double*)malloc(document->numbers_length * sizeof(double) + sizeof(double));
+    if (document->numbers == NULL)
+    {
+        fail("Failed to allocate memory.");
+    }
+
+#ifdef CJSON_BENCH_UTILS
+    {
+        cJSON *modified = cJSON_Duplicate(tree, 1);
+        size_t counter = 0;
+        document->modified = modified;
+        modify(modified, &counter);
+        if (cJSON_IsArray(modified))
+        {
+            cJSON_AddItemToArray(modified, cJSON_CreateString("added"));
+        }
+        else
+        {
+            cJSON_AddItemToObject(modified, "added", cJSON_CreateTrue());
+        }
+
+        document->patches = cJSONUtils_GeneratePatchesCaseSensitive(document->tree, modified);
+        document->reverse_patches = cJSONUtils_GeneratePatchesCaseSensitive(modified, document->tree);
+        if ((document->patches == NULL) || (document->reverse_patches == NULL))
+        {
+            fail("Failed to generate patches.");
+        }
+
+        document->pointer_count = (size_t)cJSON_GetArraySize(document->patches);
+        if (document->pointer_count < PROJECTED_POINTERS)
+        {
+            fail("Not enough patches for the projection.");
+        }
+        document->pointers = (const char**)malloc(document->pointer_count * sizeof(const char*));
+        document->compiled_pointers = (cJSONUtils_Pointer**)malloc(document->pointer_count * sizeof(cJSONUtils_Pointer*));
+        document->pointer_results = (cJSON**)malloc(document->pointer_count * sizeof(cJSON*));
+        if ((document->pointers == NULL) || (document->compiled_pointers == NULL) || (document->pointer_results == NULL))
+        {
+            fail("Failed to allocate memory.");
+        }
+        for (counter = 0; counter < document->pointer_count; counter++)
+        {
+            document->pointers[counter] = cJSON_GetStringValue(cJSON_GetObjectItem(cJSON_GetArrayItem(document->patches, (int)counter), "path"));
+            document->compiled_pointers[counter] = cJSONUtils_CompilePointer(document->pointers[counter]);
+            if (document->compiled_pointers[counter] == NULL)
+            {
+                fail("Failed to compile a pointer.");
+            }
+        }
+        for (counter = 0; counter < PROJECTED_POINTERS; counter++)
+        {
+            document->projected_pointers[counter] = document->pointers[(counter * document->pointer_count) / PROJECTED_POINTERS];
+        }
+    }
+#else
+    (void)modify;
+#endif
+}
+
+static void release(corpus *document)
+{
+    cJSON_Delete(document->tree);
+    cJSON_free(document->text);
+    cJSON_free(document->formatted);
+    cJSON_free(document->cbor);
+    free(document->buffer);
+    cJSON_DeletePrintBuffer(document->print_buffer);
+    cJSON_DeleteKeyTable(document->keys);
+    cJSON_Delete(document->copy);
+    cJSON_Delete(document->snapshots);
+    cJSON_Delete(document->packed);
+    free(document->numbers);
+    cJSON_Delete(document->modified);
+    cJSON_Delete(document->patches);
+    cJSON_Delete(document->reverse_patches);
+#ifdef CJSON_BENCH_UTILS
+    {
+        size_t i = 0;
+        for (i = 0; i < document->pointer_count; i++)
+        {
+            cJSONUtils_DeleteCompiledPointer(document->compiled_pointers[i]);
+        }
+        free(document->pointers);
+        free(document->compiled_pointers);
+        free(document->pointer_results);
+    }
+#endif
+}
+
+static size_t run_parse(corpus *document)
+{
+    cJSON *tree = cJSON_Parse(document->text);
+    if (tree == NULL)
+    {
+        fail("Failed to parse.");
+    }
+    cJSON_Delete(tree);
+
+    return document->length;
+}
+
+static size_t run_parse_formatted(corpus *document)
+{
+    cJSON *tree = cJSON_Parse(document->formatted);
+    if (tree == NULL)
+    {
+        fail("Failed to parse.");
+    }
+    cJSON_Delete(tree);
+
+    return document->formatted_length;
+}
+
+static size_t run_parse_with_arena(corpus *document)
+{
+    cJSON *tree = cJSON_ParseWithArena(document->text, NULL, 1);
+    if (tree == NULL)
+    {
+        fail("Failed to parse with an arena.");
+    }
+    cJSON_ArenaDelete(tree);
+
+    return document->length;
+}
+
+static size_t run_validate(corpus *document)
+{
+    if (!cJSON_Validate(document->text, document->length, NULL))
+    {
+        fail("Failed to validate.");
+    }
+
+    return document->length;
+}
+
+/* only reads the first member, like a consumer that needs a few fields of a big document */
+static size_t run_parse_lazy(corpus *document)
+{
+    cJSON *tree = cJSON_ParseLazy(document->text, NULL, 1, 1);
+    if (tree == NULL)
+    {
+        fail("Failed to parse lazily.");
+    }
+    if (cJSON_GetArraySize(cJSON_GetArrayItem(tree, 0)) < 0)
+    {
+        fail("Failed to access a lazy item.");
+    }
+    cJSON_Delete(tree);
+
+    return document->length;
+}
+
+/* includes copying the text, because parsing in situ destroys it */
+static size_t run_parse_in_situ(corpus *document)
+{
+    cJSON *tree = NULL;
+    memcpy(document->buffer, document->text, document->length + 1);
+    tree = cJSON_ParseInSitu(document->buffer);
+    if (tree == NULL)
+    {
+        fail("Failed to parse in situ.");
+    }
+    cJSON_Delete(tree);
+
+    return document->length;
+}
+
+static size_t run_print(corpus *document)
+{
+    char *printed = cJSON_Print(document->tree);
+    if (printed == NULL)
+    {
+        fail("Failed to print.");
+    }
+    cJSON_free(printed);
+
+    return document->formatted_length;
+}
+
+static size_t run_print_unformatted(corpus *document)
+{
+    char *printed = cJSON_PrintUnformatted(document->tree);
+    if (printed == NULL)
+    {
+        fail("Failed to print.");
+    }
+    cJSON_free(printed);
+
+    return document->length;
+}
+
+static size_t run_print_preallocated(corpus *document)
+{
+    if (!cJSON_PrintPreallocated(document->tree, document->buffer, (int)document->buffer_length, 0))
+    {
+        fail("Failed to print into a preallocated buffer.");
+    }
+
+    return document->length;
+}
+
+static size_t run_printed_length(corpus *document)
+{
+    if (cJSON_PrintedLength(document->tree, 0) != document->length)
+    {
+        fail("Wrong printed length.");
+    }
+
+    return document->length;
+}
+
+/* a single allocation of exactly the right size */
+static size_t run_print_exact(corpus *document)
+{
+    size_t length = cJSON_PrintedLength(document->tree, 0);
+    char *printed = (char*)cJSON_malloc(length + 1);
+    if ((printed == NULL) || !cJSON_PrintPreallocated(document->tree, printed, (int)length + 1, 0))
+    {
+        fail("Failed to print with the exact length.");
+    }
+    cJSON_free(printed);
+
+    return document->length;
+}
+
+static size_t run_print_to_buffer(corpus *document)
+{
+    size_t length = 0;
+    if ((cJSON_PrintToBuffer(document->print_buffer, document->tree, 0, &length) == NULL) || (length != document->length))
+    {
+        fail("Failed to print to a print buffer.");
+    }
+
+    return document->length;
+}
+
+static cJSON_bool CJSON_CDECL discard(const char *data, size_t length, void *context)
+{
+    (void)data;
+    *(size_t*)context += length;
+
+    return 1;
+}
+
+static size_t run_print_to_writer(corpus *document)
+{
+    size_t written = 0;
+    if (!cJSON_PrintToWriter(document->tree, 0, discard, &written) || (written != document->length))
+    {
+        fail("Failed to print to a writer.");
+    }
+
+    return document->length;
+}
+
+/* after the first run, all keys are in the table already */
+static size_t run_parse_with_key_table(corpus *document)
+{
+    cJSON *tree = cJSON_ParseWithKeyTable(document->text, NULL, 0, document->keys);
+    if (tree == NULL)
+    {
+        fail("Failed to parse with a key table.");
+    }
+    cJSON_Delete(tree);
+
+    return document->length;
+}
+
+static size_t run_parse_packed(corpus *document)
+{
+    cJSON *tree = cJSON_ParsePacked(document->text, NULL, 0);
+    if (tree == NULL)
+    {
+        fail("Failed to parse packed.");
+    }
+    cJSON_Delete(tree);
+
+    return document->length;
+}
+
+static size_t run_print_packed(corpus *document)
+{
+    char *printed = cJSON_PrintUnformatted(document->packed);
+    if (printed == NULL)
+    {
+        fail("Failed to print packed.");
+    }
+    cJSON_free(printed);
+
+    return document->length;
+}
+
+/* reads the numbers of every array of numbers directly under the root, or the root itself */
+static size_t run_get_double_arrays(corpus *document)
+{
+    cJSON *child = NULL;
+    if ((document->packed->type & cJSON_IsPacked) != 0)
+    {
+        if (!cJSON_GetDoubleArray(document->packed, document->numbers, (size_t)cJSON_GetArraySize(document->packed)))
+        {
+            fail("Failed to get a double array.");
+        }
+        return document->length;
+    }
+    for (child = document->packed->child; child != NULL; child = child->next)
+    {
+        int size = cJSON_GetArraySize(child);
+        if (((child->type & cJSON_IsPacked) != 0) && !cJSON_GetDoubleArray(child, document->numbers, (size_t)size))
+        {
+            fail("Failed to get a double array.");
+        }
+    }
+
+    return document->length;
+}
+
+/* the CBOR operations report the length of the unformatted text, so that they compare with parse and print unformatted */
+static size_t run_parse_cbor(corpus *document)
+{
+    cJSON *tree = cJSON_ParseCBOR(document->cbor, document->cbor_length, NULL);
+    if (tree == NULL)
+    {
+        fail("Failed to parse CBOR.");
+    }
+    cJSON_Delete(tree);
+
+    return document->length;
+}
+
+static size_t run_print_cbor(corpus *document)
+{
+    size_t length = 0;
+    unsigned char *printed = cJSON_PrintCBOR(document->tree, &length);
+    if ((printed == NULL) || (length != document->cbor_length))
+    {
+        fail("Failed to print CBOR.");
+    }
+    cJSON_free(printed);
+
+    return document->length;
+}
+
+/* includes copying the text, because minifying works in place */
+static size_t run_minify(corpus *document)
+{
+    memcpy(document->buffer, document->formatted, document->formatted_length + 1);
+    cJSON_Minify(document->buffer);
+
+    return document->formatted_length;
+}
+
+static size_t run_duplicate(corpus *document)
+{
+    cJSON *copy = cJSON_Duplicate(document->tree, 1);
+    if (copy == NULL)
+    {
+        fail("Failed to duplicate.");
+    }
+    cJSON_Delete(copy);
+
+    return document->length;
+}
+
+static size_t run_duplicate_shared(corpus *document)
+{
+    cJSON *copy = cJSON_DuplicateShared(document->snapshots);
+    if (copy == NULL)
+    {
+        fail("Failed to duplicate.");
+    }
+    cJSON_Delete(copy);
+
+    return document->length;
+}
+
+/* takes a snapshot and changes its first value at the deepest level, which copies the levels on the path to it */
+static size_t run_snapshot_and_change(corpus *document)
+{
+    cJSON *copy = cJSON_DuplicateShared(document->snapshots);
+    cJSON *parent = copy;
+    cJSON *child = NULL;
+    if (copy == NULL)
+    {
+        fail("Failed to duplicate.");
+    }
+
+    for (;;)
+    {
+        /* only the children of unshared items can be changed */
+        if (!cJSON_Unshare(parent))
+        {
+            fail("Failed to change a snapshot.");
+        }
+        child = cJSON_GetArrayItem(parent, 0);
+        if ((child == NULL) || !(cJSON_IsArray(child) || cJSON_IsObject(child)))
+        {
+            break;
+        }
+        parent = child;
+    }
+    if ((child != NULL) && !cJSON_ReplaceItemViaPointer(parent, child, cJSON_CreateString("changed")))
+    {
+        fail("Failed to change a snapshot.");
+    }
+    cJSON_Delete(copy);
+
+    return document->length;
+}
+
+static size_t run_compare(corpus *document)
+{
+    if (!cJSON_Compare(document->tree, document->copy, 1))
+    {
+        fail("Failed to compare.");
+    }
+
+    return document->length;
+}
+
+static size_t run_hash(corpus *document)
+{
+    if (cJSON_Hash(document->copy, 1) != cJSON_Hash(document->tree, 1))
+    {
+        fail("Failed to hash.");
+    }
+
+    return document->length;
+}
+
+#ifdef CJSON_BENCH_UTILS
+static size_t run_generate_patches(corpus *document)
+{
+    cJSON *patches = cJSONUtils_GeneratePatchesCaseSensitive(document->tree, document->modified);
+    if (patches == NULL)
+    {
+        fail("Failed to generate patches.");
+    }
+    cJSON_Delete(patches);
+
+    return document->length;
+}
+
+static size_t run_generate_aligned_patches(corpus *document)
+{
+    cJSON *patches = cJSONUtils_GeneratePatchesWithOpts(document->tree, document->modified, 1, 64);
+    if (patches == NULL)
+    {
+        fail("Failed to generate patches.");
+    }
+    cJSON_Delete(patches);
+
+    return document->length;
+}
+
+/* applies the patches and reverts them again, so every run starts with the same document */
+static size_t run_apply_patches(corpus *document)
+{
+    if ((cJSONUtils_ApplyPatchesCaseSensitive(document->copy, document->patches) != 0)
+        || (cJSONUtils_ApplyPatchesCaseSensitive(document->copy, document->reverse_patches) != 0))
+    {
+        fail("Failed to apply patches.");
+    }
+
+    return 2 * document->length;
+}
+
+static size_t run_get_pointers(corpus *document)
+{
+    size_t i = 0;
+    for (i = 0; i < document->pointer_count; i++)
+    {
+        document->pointer_results[i] = cJSONUtils_GetPointerCaseSensitive(document->tree, document->pointers[i]);
+    }
+
+    return document->length;
+}
+
+/* what the projection saves: parsing everything to get a few values */
+static size_t run_parse_and_get_pointers(corpus *document)
+{
+    size_t i = 0;
+    cJSON *tree = cJSON_Parse(document->text);
+    if (tree == NULL)
+    {
+        fail("Failed to parse.");
+    }
+    for (i = 0; i < PROJECTED_POINTERS; i++)
+    {
+        document->pointer_results[i] = cJSONUtils_GetPointerCaseSensitive(tree, document->projected_pointers[i]);
+    }
+    cJSON_Delete(tree);
+
+    return document->length;
+}
+
+static size_t run_parse_projection(corpus *document)
+{
+    cJSON *tree = cJSON_ParseProjection(document->text, document->projected_pointers, PROJECTED_POINTERS, 1, document->pointer_results);
+    if (tree == NULL)
+    {
+        fail("Failed to parse a projection.");
+    }
+    cJSON_Delete(tree);
+
+    return document->length;
+}
+
+static size_t run_get_compiled_pointers(corpus *document)
+{
+    size_t i = 0;
+    for (i = 0; i < document->pointer_count; i++)
+    {
+        document->pointer_results[i] = cJSONUtils_GetCompiledPointerCaseSensitive(document->tree, document->compiled_pointers[i]);
+    }
+
+    return document->length;
+}
+
+static size_t run_get_compiled_pointers_at_once(corpus *document)
+{
+    if (!cJSONUtils_GetCompiledPointersCaseSensitive(document->tree, document->compiled_pointers, document->pointer_count, document->pointer_results))
+    {
+        fail("Failed to get pointers.");
+    }
+
+    return document->length;
+}
+#endif
+
+static const operation operations[] = {
+    { "parse", run_parse },
+    { "parse formatted", run_parse_formatted },
+    { "parse with arena", run_parse_with_arena },
+    { "parse in situ", run_parse_in_situ },
+    { "parse lazy", run_parse_lazy },
+    { "parse packed", run_parse_packed },
+    { "parse with key table", run_parse_with_key_table },
+    { "validate", run_validate },
+    { "parse cbor", run_parse_cbor },
+    { "print", run_print },
+    { "print unformatted", run_print_unformatted },
+    { "print preallocated", run_print_preallocated },
+    { "printed length", run_printed_length },
+    { "print exact", run_print_exact },
+    { "print to buffer", run_print_to_buffer },
+    { "print to writer", run_print_to_writer },
+    { "print packed", run_print_packed },
+    { "print cbor", run_print_cbor },
+    { "minify", run_minify },
+    { "get double arrays", run_get_double_arrays },
+    { "duplicate", run_duplicate },
+    { "duplicate shared", run_duplicate_shared },
+    { "snapshot + change", run_snapshot_and_change },
+    { "compare", run_compare },
+    { "hash", run_hash },
+#ifdef CJSON_BENCH_UTILS
+    { "generate patches", run_generate_patches },
+    { "generate aligned patches", run_generate_aligned_patches },
+    { "apply patches", run_apply_patches },
+    { "get pointers", run_get_pointers },
+    { "get compiled", run_get_compiled_pointers },
+    { "get all compiled", run_get_compiled_pointers_at_once },
+    { "parse + get pointers", run_parse_and_get_pointers },
+    { "parse projection", run_parse_projection },
+#endif
+};
+
+static size_t allocations = 0;
+
+static void * CJSON_CDECL counting_malloc(size_t size)
+{
+    allocations++;
+    return malloc(size);
+}
+
+static void CJSON_CDECL counting_free(void *pointer)
+{
+    free(pointer);
+}
+
+static void benchmark(corpus *document, const operation *current, const char *filter)
+{
+    cJSON_Hooks counting_hooks = { counting_malloc, counting_free };
+    char name[64];
+    size_t bytes = 0;
+    size_t iterations = 0;
+    double seconds = 0;
+    clock_t start = 0;
+
+    sprintf(name, "%s/%s", document->name, current->name);
+    if ((filter != NULL) && (strstr(name, filter) == NULL))
+    {
+        return;
+    }
+
+    /* warm up, this also builds the lazy indexes of big objects */
+    current->run(document);
+
+    /* count the allocations of a single run with the default hooks being replaced,
+     * the time is measured with the default hooks, which use realloc when printing */
+    allocations = 0;
+    cJSON_InitHooks(&counting_hooks);
+    current->run(document);
+    cJSON_InitHooks(NULL);
+
+    start = clock();
+    do
+    {
+        bytes += current->run(document);
+        iterations++;
+        seconds = (double)(clock() - start) / (double)CLOCKS_PER_SEC;
+    } while (seconds < MINIMUM_SECONDS);
+
+    printf("%-32s %10.1f %12.1f %12.3f %12lu\n",
+            name,
+            (double)document->length / 1024.0,
+            ((double)bytes / (1024.0 * 1024.0)) / seconds,
+            (seconds * 1000.0) / (double)iterations,
+            (unsigned long)allocations);
+    fflush(stdout);
+}
+
+int CJSON_CDECL main(int argc, char **argv)
+{
+    corpus documents[5];
+    const char *filter = (argc > 1) ? argv[1] : NULL;
+    size_t i = 0;
+    size_t j = 0;
+
+    prepare(&documents[0], "records", generate_records());
+    prepare(&documents[1], "deep", generate_deep());
+    prepare(&documents[2], "wide", generate_wide());
+    prepare(&documents[3], "strings", generate_strings());
+    prepare(&documents[4], "numbers", generate_numbers());
+
+    printf("%-32s %10s %12s %12s %12s\n", "benchmark", "size KB", "MB/s", "ms/op", "allocs/op");
+    for (i = 0; i < (sizeof(documents) / sizeof(documents[0])); i++)
+    {
+        for (j = 0; j < (sizeof(operations) / sizeof(operations[0])); j++)
+        {
+            benchmark(&documents[i], &operations[j], filter);
+        }
+        release(&documents[i]);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,167 @@
+/*
+  Copyright (c) 2009-2017 Dave Gamble and cJSON contributors
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+/* Measures the throughput of cJSON_ParseBatch on generated newline delimited JSON
+ * with an increasing number of worker threads.
+ *
+ * usage: ndjson_batch [maximum threads] (8 by default) */
+
+/* clock_gettime, the processor time of clock() adds up over all threads */
+#if !defined(_WIN32)
+#define _POSIX_C_SOURCE 199309L
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../cJSON.h"
+
+typedef struct
+{
+    size_t documents;
+    size_t invalid;
+    cJSON_bool use_arena;
+} batch_result;
+
+static double seconds_now(void)
+{
+#if defined(CLOCK_MONOTONIC)
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + ((double)now.tv_nsec / 1e9);
+#else
+    return (double)clock() / (double)CLOCKS_PER_SEC;
+#endif
+}
+
+static cJSON_bool CJSON_CDECL count_document(cJSON *item, size_t index, const char *record, size_t record_length, void *context)
+{
+    batch_result *result = (batch_result*)context;
+    (void)index;
+    (void)record;
+    (void)record_length;
+
+    result->documents++;
+    if (item == NULL)
+    {
+        result->invalid++;
+    }
+    else if (!result->use_arena)
+    {
+        cJSON_Delete(item);
+    }
+
+    return 1;
+}
+
+/* log records like the ones this API is meant for, about 64 MB of them */
+static char *generate(size_t *length)
+{
+    static const char *const levels[] = { "debug", "info", "warning", "error" };
+    const size_t count = 300000;
+    size_t capacity = count * 256;
+    char *buffer = (char*)malloc(capacity);
+    size_t offset = 0;
+    size_t i = 0;
+
+    if (buffer == NULL)
+    {
+        return NULL;
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        offset += (size_t)sprintf(buffer + offset,
+                "{\"time\":%u.%03u,\"level\":\"%s\",\"host\":\"node-%02u\",\"message\":\"request %u took %u ms\","
+                "\"tags\":[\"http\",\"api\",\"v%u\"],\"latency\":%u.%u,\"ok\":%s}\n",
+                (unsigned int)(1500000000 + i), (unsigned int)(i % 1000), levels[i % 4], (unsigned int)(i % 32),
+                (unsigned int)i, (unsigned int)((i * 7) % 1000), (unsigned int)(i % 3), (unsigned int)((i * 13) % 500),
+                (unsigned int)(i % 10), ((i % 17) == 0) ? "false" : "true");
+    }
+
+    *length = offset;
+    return buffer;
+}
+
+int CJSON_CDECL main(int argc, char **argv)
+{
+    int maximum_threads = 8;
+    size_t length = 0;
+    char *buffer = NULL;
+    int use_arena = 0;
+
+    if (argc > 1)
+    {
+        maximum_threads = atoi(argv[1]);
+    }
+
+    buffer = generate(&length);
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Failed to generate the documents.\n");
+        return EXIT_FAILURE;
+    }
+
+    printf("%u MB of newline delimited JSON\n", (unsigned int)(length / (1024 * 1024)));
+    printf("%8s %8s %12s %10s %10s\n", "arena", "threads", "documents", "MB/s", "speedup");
+    for (use_arena = 0; use_arena <= 1; use_arena++)
+    {
+        double single_thread = 0;
+        int threads = 1;
+
+        while (threads <= maximum_threads)
+        {
+            batch_result result;
+            double start = 0;
+            double seconds = 0;
+
+            memset(&result, '\0', sizeof(result));
+            result.use_arena = use_arena;
+            start = seconds_now();
+            if (!cJSON_ParseBatch(buffer, length, threads, use_arena, count_document, &result) || (result.invalid != 0))
+            {
+                fprintf(stderr, "Failed to parse the documents.\n");
+                return EXIT_FAILURE;
+            }
+            seconds = seconds_now() - start;
+            if (threads == 1)
+            {
+                single_thread = seconds;
+            }
+
+            printf("%8s %8d %12u %10.1f %10.2f\n", use_arena ? "yes" : "no", threads, (unsigned int)result.documents,
+                    ((double)length / (1024.0 * 1024.0)) / seconds, single_thread / seconds);
+
+            if (threads == maximum_threads)
+            {
+                break;
+            }
+            threads = ((threads * 2) > maximum_threads) ? maximum_threads : (threads * 2);
+        }
+    }
+
+    free(buffer);
+
+    return EXIT_SUCCESS;
+}
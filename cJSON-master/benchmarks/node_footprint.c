@@ -0,0 +1,166 @@
+/*
+  Copyright (c) 2009-2017 Dave Gamble and cJSON contributors
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+/* Measures how much heap memory a parsed tree takes. Build once with and once without
+ * -DENABLE_COMPACT_NODES=On to compare the two layouts of struct cJSON.
+ * The last row parses the records with a key table, whose memory is included. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../cJSON.h"
+
+/* every allocation is prefixed with its size, so frees can be accounted for */
+typedef union
+{
+    size_t size;
+    double alignment;
+} allocation_header;
+
+static size_t allocated_bytes = 0;
+static size_t allocations = 0;
+
+static void * CJSON_CDECL counting_malloc(size_t size)
+{
+    allocation_header *header = (allocation_header*)malloc(sizeof(allocation_header) + size);
+    if (header == NULL)
+    {
+        return NULL;
+    }
+
+    header->size = size;
+    allocated_bytes += size;
+    allocations++;
+
+    return header + 1;
+}
+
+static void CJSON_CDECL counting_free(void *pointer)
+{
+    allocation_header *header = NULL;
+    if (pointer == NULL)
+    {
+        return;
+    }
+
+    header = ((allocation_header*)pointer) - 1;
+    allocated_bytes -= header->size;
+    allocations--;
+    free(header);
+}
+
+static double milliseconds_since(clock_t start)
+{
+    return ((double)(clock() - start) * 1000.0) / (double)CLOCKS_PER_SEC;
+}
+
+static char *generate(const char *name, int count)
+{
+    cJSON *root = cJSON_CreateArray();
+    char *json = NULL;
+    int i = 0;
+
+    for (i = 0; i < count; i++)
+    {
+        if (strcmp(name, "numbers") == 0)
+        {
+            cJSON_AddItemToArray(root, cJSON_CreateNumber(i * 0.5));
+        }
+        else if (strcmp(name, "short strings") == 0)
+        {
+            char string[8];
+            sprintf(string, "s%d", i % 100000);
+            cJSON_AddItemToArray(root, cJSON_CreateString(string));
+        }
+        else
+        {
+            static const char *const colors[] = { "red", "green", "blue", "yellow" };
+            cJSON *record = cJSON_CreateObject();
+            char name_buffer[32];
+            sprintf(name_buffer, "user number %d", i);
+            cJSON_AddItemToObject(record, "id", cJSON_CreateNumber(i));
+            cJSON_AddItemToObject(record, "name", cJSON_CreateString(name_buffer));
+            cJSON_AddItemToObject(record, "color", cJSON_CreateString(colors[i % 4]));
+            cJSON_AddItemToObject(record, "active", cJSON_CreateBool(i % 2));
+            cJSON_AddItemToObject(record, "score", cJSON_CreateNumber(i * 1.25));
+            cJSON_AddItemToArray(root, record);
+        }
+    }
+
+    json = cJSON_PrintUnformatted(root);
+    cJSON_Delete(root);
+
+    return json;
+}
+
+int CJSON_CDECL main(void)
+{
+    static const char *const corpora[] = { "numbers", "short strings", "records", "records, keys" };
+    cJSON_Hooks hooks = { counting_malloc, counting_free };
+    size_t i = 0;
+
+    printf("sizeof(cJSON) = %u\n", (unsigned int)sizeof(cJSON));
+    printf("%14s %10s %12s %14s %12s %12s\n", "corpus", "items", "allocations", "bytes", "bytes/item", "parse ms");
+    for (i = 0; i < (sizeof(corpora) / sizeof(corpora[0])); i++)
+    {
+        const int count = 200000;
+        char *json = generate(corpora[i], count);
+        cJSON *tree = NULL;
+        cJSON_KeyTable *keys = NULL;
+        clock_t start = 0;
+        double parse_time = 0;
+        size_t items = 0;
+
+        if (json == NULL)
+        {
+            fprintf(stderr, "Failed to generate the %s corpus.\n", corpora[i]);
+            return EXIT_FAILURE;
+        }
+
+        cJSON_InitHooks(&hooks);
+        if (strstr(corpora[i], "keys") != NULL)
+        {
+            keys = cJSON_CreateKeyTable();
+        }
+        start = clock();
+        tree = (keys != NULL) ? cJSON_ParseWithKeyTable(json, NULL, 0, keys) : cJSON_Parse(json);
+        parse_time = milliseconds_since(start);
+        if (tree == NULL)
+        {
+            fprintf(stderr, "Failed to parse the %s corpus.\n", corpora[i]);
+            return EXIT_FAILURE;
+        }
+
+        /* the root, every element and for records every member */
+        items = 1 + (size_t)count * ((strncmp(corpora[i], "records", 7) == 0) ? 6 : 1);
+        printf("%14s %10u %12u %14u %12.1f %12.2f\n", corpora[i], (unsigned int)items, (unsigned int)allocations, (unsigned int)allocated_bytes, (double)allocated_bytes / (double)items, parse_time);
+
+        cJSON_Delete(tree);
+        cJSON_DeleteKeyTable(keys);
+        cJSON_InitHooks(NULL);
+        free(json);
+    }
+
+    return EXIT_SUCCESS;
+}
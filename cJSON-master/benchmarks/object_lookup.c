@@ -0,0 +1,98 @@
+/*
+  Copyright (c) 2009-2017 Dave Gamble and cJSON contributors
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+/* Measures how long it takes to look up every key of objects of growing size.
+ * The objects get a hash index with cJSON_IndexObject, so the time per lookup should stay flat. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "../cJSON.h"
+
+static double milliseconds_since(clock_t start)
+{
+    return ((double)(clock() - start) * 1000.0) / (double)CLOCKS_PER_SEC;
+}
+
+static cJSON *create_object(int size)
+{
+    cJSON *object = cJSON_CreateObject();
+    char key[32];
+    int i = 0;
+
+    for (i = 0; i < size; i++)
+    {
+        sprintf(key, "key%d", i);
+        cJSON_AddItemToObject(object, key, cJSON_CreateNumber(i));
+    }
+    if (!cJSON_IndexObject(object))
+    {
+        fprintf(stderr, "Failed to index an object.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    return object;
+}
+
+static double look_up_all_keys(const cJSON *object, int size)
+{
+    char key[32];
+    clock_t start = clock();
+    int found = 0;
+    int i = 0;
+
+    for (i = 0; i < size; i++)
+    {
+        sprintf(key, "key%d", i);
+        if (cJSON_GetObjectItemCaseSensitive(object, key) != NULL)
+        {
+            found++;
+        }
+    }
+
+    if (found != size)
+    {
+        fprintf(stderr, "Only found %d of %d keys.\n", found, size);
+        exit(EXIT_FAILURE);
+    }
+
+    return milliseconds_since(start);
+}
+
+int CJSON_CDECL main(void)
+{
+    int size = 0;
+
+    printf("%10s %14s %14s\n", "items", "lookup ms", "ns/lookup");
+    for (size = 12500; size <= 400000; size *= 2)
+    {
+        cJSON *object = create_object(size);
+        double lookup_time = look_up_all_keys(object, size);
+
+        printf("%10d %14.2f %14.1f\n", size, lookup_time, (lookup_time * 1e6) / size);
+
+        cJSON_Delete(object);
+    }
+
+    return EXIT_SUCCESS;
+}
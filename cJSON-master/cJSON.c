@@ -43,11 +43,45 @@
 #include <stdlib.h>
 #include <limits.h>
 #include <ctype.h>
+#include <float.h>
 
 #ifdef ENABLE_LOCALES
 #include <locale.h>
 #endif
 
+/* C89 has no NAN, a division by zero would trip the sanitizers */
+#ifndef NAN
+#define NAN sqrt(-1.0)
+#endif
+
+/* file descriptor output, see cJSON_PrintToFd */
+#if defined(_WIN32)
+#include <io.h>
+#define CJSON_FD_WRITE
+#elif defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__))
+#include <unistd.h>
+#include <errno.h>
+#define CJSON_FD_WRITE
+#endif
+
+/* worker threads for cJSON_ParseBatch, without them batches are parsed on the calling thread */
+#if defined(CJSON_THREADS) && defined(_WIN32)
+#include <windows.h>
+#define CJSON_WIN32_THREADS
+#elif defined(CJSON_THREADS)
+#include <pthread.h>
+#define CJSON_PTHREADS
+#endif
+
+/* vector instructions for scanning strings, see count_plain_characters */
+#if !defined(CJSON_DISABLE_SIMD) && defined(__AVX2__)
+#define CJSON_SIMD_AVX2
+#include <immintrin.h>
+#elif !defined(CJSON_DISABLE_SIMD) && (defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64))
+#define CJSON_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
 #if defined(_MSC_VER)
 #pragma warning (pop)
 #endif
@@ -79,12 +113,99 @@ CJSON_PUBLIC(const char *) cJSON_GetErrorPtr(void)
     return (const char*) (global_error.json + global_error.position);
 }
 
-CJSON_PUBLIC(char *) cJSON_GetStringValue(cJSON *item) {
-    if (!cJSON_IsString(item)) {
+#if defined(__clang__) || (defined(__GNUC__)  && ((__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ > 5))))
+    #pragma GCC diagnostic push
+#endif
+#ifdef __GNUC__
+#pragma GCC diagnostic ignored "-Wcast-qual"
+#endif
+/* helper function to cast away const */
+static void* cast_away_const(const void* string)
+{
+    return (void*)string;
+}
+#if defined(__clang__) || (defined(__GNUC__)  && ((__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ > 5))))
+    #pragma GCC diagnostic pop
+#endif
+
+/* lazy arrays and objects keep the start of their text in the string and its length in valueint, see cJSON_ParseLazy */
+#define item_is_lazy(item) (((item)->type & cJSON_IsLazy) != 0)
+/* packed arrays are lazy arrays that keep their numbers in the string instead, see cJSON_ParsePacked */
+#define item_is_packed(item) (((item)->type & cJSON_IsPacked) != 0)
+/* shared arrays and objects keep the block their children are in in the string, child points into it, see cJSON_DuplicateShared */
+#define item_is_shared(item) (((item)->type & cJSON_IsShared) != 0)
+/* the children of these have to be copied before they can be changed, see make_writable */
+#define item_is_writable(item) (((item)->type & (cJSON_IsShared | cJSON_IsReadOnly)) == 0)
+
+/* With CJSON_COMPACT_NODES the string, number and index of an item share their memory,
+ * which one is valid depends on the type. Without it arrays and objects keep their index in
+ * the unused valuestring. Everything else goes through these. */
+#define item_has_index(item) ((((item)->type & (cJSON_Array | cJSON_Object)) != 0) && !((item)->type & (cJSON_IsLazy | cJSON_IsShared)))
+#ifdef CJSON_COMPACT_NODES
+#define item_number(item) ((item)->value.number)
+#define set_index(item, new_index) ((item)->value.index = (new_index))
+#define index_of(item) (item_has_index(item) ? (item)->value.index : NULL)
+#define string_is_inline(item) (((item)->type & cJSON_StringIsInline) != 0)
+#define lazy_text(item) ((const unsigned char*)(item)->value.string)
+#define packed_numbers(item) ((double*)(void*)(item)->value.string)
+#define shared_of(item) ((shared_children*)(void*)(item)->value.string)
+#else
+#define item_number(item) ((item)->valuedouble)
+#define set_index(item, new_index) ((item)->valuestring = (char*)(void*)(new_index))
+#define index_of(item) (item_has_index(item) ? (struct cJSON_Index*)(void*)(item)->valuestring : NULL)
+#define string_is_inline(item) false
+#define lazy_text(item) ((const unsigned char*)(item)->valuestring)
+#define packed_numbers(item) ((double*)(void*)(item)->valuestring)
+#define shared_of(item) ((shared_children*)(void*)(item)->valuestring)
+#endif
+
+static char *item_valuestring(const cJSON * const item)
+{
+#ifdef CJSON_COMPACT_NODES
+    if ((item->type & (cJSON_String | cJSON_Raw)) == 0)
+    {
+        return NULL;
+    }
+    if (string_is_inline(item))
+    {
+        return (char*)cast_away_const(item->value.inline_string);
+    }
+
+    return item->value.string;
+#else
+    if ((item->type & (cJSON_Array | cJSON_Object)) != 0)
+    {
         return NULL;
     }
 
     return item->valuestring;
+#endif
+}
+
+static void set_valuestring(cJSON * const item, char *valuestring)
+{
+#ifdef CJSON_COMPACT_NODES
+    item->type &= ~cJSON_StringIsInline;
+    item->value.string = valuestring;
+#else
+    item->valuestring = valuestring;
+#endif
+}
+
+CJSON_PUBLIC(char *) cJSON_GetStringValue(const cJSON * const item) {
+    if (!cJSON_IsString(item)) {
+        return NULL;
+    }
+
+    return item_valuestring(item);
+}
+
+CJSON_PUBLIC(double) cJSON_GetNumberValue(const cJSON * const item) {
+    if (!cJSON_IsNumber(item)) {
+        return (double) NAN;
+    }
+
+    return item_number(item);
 }
 
 /* This is a safeguard to prevent copy-pasters from using incompatible C and header files */
@@ -124,37 +245,77 @@ static int case_insensitive_strcmp(const unsigned char *string1, const unsigned
     return tolower(*string1) - tolower(*string2);
 }
 
+/* the same as cJSON_Context, reallocate may be NULL */
 typedef struct internal_hooks
 {
-    void *(CJSON_CDECL *allocate)(size_t size);
-    void (CJSON_CDECL *deallocate)(void *pointer);
-    void *(CJSON_CDECL *reallocate)(void *pointer, size_t size);
+    void *(CJSON_CDECL *allocate)(size_t size, void *user_data);
+    void (CJSON_CDECL *deallocate)(void *pointer, void *user_data);
+    void *(CJSON_CDECL *reallocate)(void *pointer, size_t size, void *user_data);
+    void *user_data;
 } internal_hooks;
 
-#if defined(_MSC_VER)
-/* work around MSVC error C2322: '...' address of dillimport '...' is not static */
-static void * CJSON_CDECL internal_malloc(size_t size)
+static void * CJSON_CDECL internal_malloc(size_t size, void *user_data)
 {
+    (void)user_data;
     return malloc(size);
 }
-static void CJSON_CDECL internal_free(void *pointer)
+static void CJSON_CDECL internal_free(void *pointer, void *user_data)
 {
+    (void)user_data;
     free(pointer);
 }
-static void * CJSON_CDECL internal_realloc(void *pointer, size_t size)
+static void * CJSON_CDECL internal_realloc(void *pointer, size_t size, void *user_data)
 {
+    (void)user_data;
     return realloc(pointer, size);
 }
-#else
-#define internal_malloc malloc
-#define internal_free free
-#define internal_realloc realloc
-#endif
+
+/* the functions of cJSON_InitHooks don't take a user pointer, so they are called through these */
+static cJSON_Hooks global_user_hooks = { NULL, NULL };
+
+static void * CJSON_CDECL global_user_malloc(size_t size, void *user_data)
+{
+    (void)user_data;
+    return global_user_hooks.malloc_fn(size);
+}
+static void CJSON_CDECL global_user_free(void *pointer, void *user_data)
+{
+    (void)user_data;
+    global_user_hooks.free_fn(pointer);
+}
 
 /* strlen of character literals resolved at compile time */
 #define static_strlen(string_literal) (sizeof(string_literal) - sizeof(""))
 
-static internal_hooks global_hooks = { internal_malloc, internal_free, internal_realloc };
+static internal_hooks global_hooks = { internal_malloc, internal_free, internal_realloc, NULL };
+
+/* the hooks of a context or the global ones if it is NULL */
+static internal_hooks context_hooks(const cJSON_Context * const context)
+{
+    internal_hooks hooks = global_hooks;
+
+    if (context != NULL)
+    {
+        hooks.allocate = (context->malloc_fn != NULL) ? context->malloc_fn : internal_malloc;
+        hooks.deallocate = (context->free_fn != NULL) ? context->free_fn : internal_free;
+        hooks.reallocate = context->realloc_fn;
+        hooks.user_data = context->user_data;
+
+        /* realloc matches malloc and free only if those are used as well */
+        if ((hooks.reallocate == NULL) && (context->malloc_fn == NULL) && (context->free_fn == NULL))
+        {
+            hooks.reallocate = internal_realloc;
+        }
+    }
+
+    return hooks;
+}
+
+/* memory from hooks can be freed with the global hooks and the other way around */
+static cJSON_bool hooks_are_global(const internal_hooks * const hooks)
+{
+    return (hooks->allocate == global_hooks.allocate) && (hooks->deallocate == global_hooks.deallocate) && (hooks->user_data == global_hooks.user_data);
+}
 
 static unsigned char* cJSON_strdup(const unsigned char* string, const internal_hooks * const hooks)
 {
@@ -167,7 +328,7 @@ static unsigned char* cJSON_strdup(const unsigned char* string, const internal_h
     }
 
     length = strlen((const char*)string) + sizeof("");
-    copy = (unsigned char*)hooks->allocate(length);
+    copy = (unsigned char*)hooks->allocate(length, hooks->user_data);
     if (copy == NULL)
     {
         return NULL;
@@ -182,36 +343,38 @@ CJSON_PUBLIC(void) cJSON_InitHooks(cJSON_Hooks* hooks)
     if (hooks == NULL)
     {
         /* Reset hooks */
-        global_hooks.allocate = malloc;
-        global_hooks.deallocate = free;
-        global_hooks.reallocate = realloc;
+        global_hooks.allocate = internal_malloc;
+        global_hooks.deallocate = internal_free;
+        global_hooks.reallocate = internal_realloc;
         return;
     }
 
-    global_hooks.allocate = malloc;
+    global_user_hooks = *hooks;
+
+    global_hooks.allocate = internal_malloc;
     if (hooks->malloc_fn != NULL)
     {
-        global_hooks.allocate = hooks->malloc_fn;
+        global_hooks.allocate = global_user_malloc;
     }
 
-    global_hooks.deallocate = free;
+    global_hooks.deallocate = internal_free;
     if (hooks->free_fn != NULL)
     {
-        global_hooks.deallocate = hooks->free_fn;
+        global_hooks.deallocate = global_user_free;
     }
 
     /* use realloc only if both free and malloc are used */
     global_hooks.reallocate = NULL;
-    if ((global_hooks.allocate == malloc) && (global_hooks.deallocate == free))
+    if ((global_hooks.allocate == internal_malloc) && (global_hooks.deallocate == internal_free))
     {
-        global_hooks.reallocate = realloc;
+        global_hooks.reallocate = internal_realloc;
     }
 }
 
 /* Internal constructor. */
 static cJSON *cJSON_New_Item(const internal_hooks * const hooks)
 {
-    cJSON* node = (cJSON*)hooks->allocate(sizeof(cJSON));
+    cJSON* node = (cJSON*)hooks->allocate(sizeof(cJSON), hooks->user_data);
     if (node)
     {
         memset(node, '\0', sizeof(cJSON));
@@ -220,2519 +383,8595 @@ static cJSON *cJSON_New_Item(const internal_hooks * const hooks)
     return node;
 }
 
-/* Delete a cJSON structure. */
-CJSON_PUBLIC(void) cJSON_Delete(cJSON *item)
+/* Indexes of the children of big objects and arrays.
+ * Objects get a hash table of their keys. Every child of the object has an entry. The position
+ * of the child is recorded as well, so that lookups return the first of several items with the
+ * same key, just like the linear search.
+ * Arrays get a table of pointers to their children instead, so they can be accessed by position. */
+typedef struct
 {
-    cJSON *next = NULL;
-    while (item != NULL)
+    cJSON *item; /* NULL if the slot is free */
+    size_t hash;
+    size_t order;
+} index_entry;
+
+struct cJSON_Index
+{
+    index_entry *entries; /* NULL for arrays */
+    size_t capacity; /* always a power of two */
+    size_t count; /* number of items in the index */
+    size_t used; /* number of slots that are not free, including deleted ones */
+    size_t next_order;
+    cJSON **items; /* NULL for objects */
+    size_t items_capacity;
+};
+
+/* marks slots of deleted items, so that the probe sequences of other items aren't cut short */
+static cJSON deleted_index_entry;
+
+static const size_t minimum_index_capacity = 16;
+
+/* FNV-1a of the lowercase key, this way it can be used for case sensitive and insensitive lookups */
+static size_t hash_key(const unsigned char *key)
+{
+    size_t hash = 2166136261UL;
+
+    for (; *key != '\0'; key++)
     {
-        next = item->next;
-        if (!(item->type & cJSON_IsReference) && (item->child != NULL))
-        {
-            cJSON_Delete(item->child);
-        }
-        if (!(item->type & cJSON_IsReference) && (item->valuestring != NULL))
-        {
-            global_hooks.deallocate(item->valuestring);
-        }
-        if (!(item->type & cJSON_StringIsConst) && (item->string != NULL))
-        {
-            global_hooks.deallocate(item->string);
-        }
-        global_hooks.deallocate(item);
-        item = next;
+        hash ^= (size_t)tolower(*key);
+        hash *= 16777619UL;
     }
+
+    return hash;
 }
 
-/* get the decimal point character of the current locale */
-static unsigned char get_decimal_point(void)
+static void index_free(struct cJSON_Index *index)
 {
-#ifdef ENABLE_LOCALES
-    struct lconv *lconv = localeconv();
-    return (unsigned char) lconv->decimal_point[0];
-#else
-    return '.';
-#endif
+    if (index == NULL)
+    {
+        return;
+    }
+
+    if (index->entries != NULL)
+    {
+        global_hooks.deallocate(index->entries, global_hooks.user_data);
+    }
+    if (index->items != NULL)
+    {
+        global_hooks.deallocate(index->items, global_hooks.user_data);
+    }
+    global_hooks.deallocate(index, global_hooks.user_data);
 }
 
-typedef struct
+/* insert an entry, the caller has to make sure that there is a free slot */
+static void index_insert_entry(struct cJSON_Index * const index, cJSON * const item, size_t hash, size_t order)
 {
-    const unsigned char *content;
-    size_t length;
-    size_t offset;
-    size_t depth; /* How deeply nested (in arrays/objects) is the input at the current offset. */
-    internal_hooks hooks;
-} parse_buffer;
+    size_t mask = index->capacity - 1;
+    size_t position = hash & mask;
 
-/* check if the given size is left to read in a given parse buffer (starting with 1) */
-#define can_read(buffer, size) ((buffer != NULL) && (((buffer)->offset + size) <= (buffer)->length))
-/* check if the buffer can be accessed at the given index (starting with 0) */
-#define can_access_at_index(buffer, index) ((buffer != NULL) && (((buffer)->offset + index) < (buffer)->length))
-#define cannot_access_at_index(buffer, index) (!can_access_at_index(buffer, index))
-/* get a pointer to the buffer at the position */
-#define buffer_at_offset(buffer) ((buffer)->content + (buffer)->offset)
+    while (index->entries[position].item != NULL)
+    {
+        position = (position + 1) & mask;
+    }
 
-/* Parse the input text to generate a number, and populate the result into item. */
-static cJSON_bool parse_number(cJSON * const item, parse_buffer * const input_buffer)
+    index->entries[position].item = item;
+    index->entries[position].hash = hash;
+    index->entries[position].order = order;
+    index->count++;
+    index->used++;
+}
+
+static cJSON_bool index_resize(struct cJSON_Index * const index, size_t capacity)
 {
-    double number = 0;
-    unsigned char *after_end = NULL;
-    unsigned char number_c_string[64];
-    unsigned char decimal_point = get_decimal_point();
+    index_entry *old_entries = index->entries;
+    size_t old_capacity = index->capacity;
     size_t i = 0;
 
-    if ((input_buffer == NULL) || (input_buffer->content == NULL))
+    if (capacity > ((size_t)-1 / sizeof(index_entry)))
     {
         return false;
     }
 
-    /* copy the number into a temporary buffer and replace '.' with the decimal point
-     * of the current locale (for strtod)
-     * This also takes care of '\0' not necessarily being available for marking the end of the input */
-    for (i = 0; (i < (sizeof(number_c_string) - 1)) && can_access_at_index(input_buffer, i); i++)
+    index->entries = (index_entry*)global_hooks.allocate(capacity * sizeof(index_entry), global_hooks.user_data);
+    if (index->entries == NULL)
     {
-        switch (buffer_at_offset(input_buffer)[i])
-        {
-            case '0':
-            case '1':
-            case '2':
-            case '3':
-            case '4':
-            case '5':
-            case '6':
-            case '7':
-            case '8':
-            case '9':
-            case '+':
-            case '-':
-            case 'e':
-            case 'E':
-                number_c_string[i] = buffer_at_offset(input_buffer)[i];
-                break;
-
-            case '.':
-                number_c_string[i] = decimal_point;
-                break;
-
-            default:
-                goto loop_end;
-        }
+        index->entries = old_entries;
+        return false;
     }
-loop_end:
-    number_c_string[i] = '\0';
+    memset(index->entries, '\0', capacity * sizeof(index_entry));
+    index->capacity = capacity;
+    index->count = 0;
+    index->used = 0;
 
-    number = strtod((const char*)number_c_string, (char**)&after_end);
-    if (number_c_string == after_end)
+    for (i = 0; i < old_capacity; i++)
     {
-        return false; /* parse_error */
+        if ((old_entries[i].item != NULL) && (old_entries[i].item != &deleted_index_entry))
+        {
+            index_insert_entry(index, old_entries[i].item, old_entries[i].hash, old_entries[i].order);
+        }
     }
 
-    item->valuedouble = number;
+    global_hooks.deallocate(old_entries, global_hooks.user_data);
 
-    /* use saturation in case of overflow */
-    if (number >= INT_MAX)
-    {
-        item->valueint = INT_MAX;
-    }
-    else if (number <= (double)INT_MIN)
-    {
-        item->valueint = INT_MIN;
-    }
-    else
+    return true;
+}
+
+static cJSON_bool index_add(struct cJSON_Index * const index, cJSON * const item, size_t order)
+{
+    /* keep the load factor (including deleted entries) below 3/4 */
+    if (((index->used + 1) * 4) > (index->capacity * 3))
     {
-        item->valueint = (int)number;
+        size_t capacity = index->capacity;
+        /* only grow if the index is really filled with items and not just deleted entries */
+        if (((index->count + 1) * 2) > capacity)
+        {
+            capacity *= 2;
+        }
+        if (!index_resize(index, capacity))
+        {
+            return false;
+        }
     }
 
-    item->type = cJSON_Number;
+    index_insert_entry(index, item, hash_key((const unsigned char*)item->string), order);
 
-    input_buffer->offset += (size_t)(after_end - number_c_string);
     return true;
 }
 
-/* don't ask me, but the original cJSON_SetNumberValue returns an integer or double */
-CJSON_PUBLIC(double) cJSON_SetNumberHelper(cJSON *object, double number)
+static index_entry *index_find_entry(const struct cJSON_Index * const index, const cJSON * const item)
 {
-    if (number >= INT_MAX)
+    size_t mask = index->capacity - 1;
+    size_t position = 0;
+
+    if (item->string == NULL)
     {
-        object->valueint = INT_MAX;
+        return NULL;
     }
-    else if (number <= (double)INT_MIN)
+
+    for (position = hash_key((const unsigned char*)item->string) & mask; index->entries[position].item != NULL; position = (position + 1) & mask)
     {
-        object->valueint = INT_MIN;
+        if (index->entries[position].item == item)
+        {
+            return &index->entries[position];
+        }
     }
-    else
+
+    return NULL;
+}
+
+static cJSON *index_lookup(const struct cJSON_Index * const index, const char * const name, const cJSON_bool case_sensitive)
+{
+    size_t hash = hash_key((const unsigned char*)name);
+    size_t mask = index->capacity - 1;
+    size_t position = 0;
+    const index_entry *found = NULL;
+
+    /* walk the whole probe sequence, there might be several items with the same key */
+    for (position = hash & mask; index->entries[position].item != NULL; position = (position + 1) & mask)
     {
-        object->valueint = (int)number;
+        const index_entry *entry = &index->entries[position];
+        if ((entry->hash != hash) || (entry->item == &deleted_index_entry) || ((found != NULL) && (found->order < entry->order)))
+        {
+            continue;
+        }
+
+        if ((name == entry->item->string) || (case_sensitive ? (strcmp(name, entry->item->string) == 0) : (case_insensitive_strcmp((const unsigned char*)name, (const unsigned char*)entry->item->string) == 0)))
+        {
+            found = entry;
+        }
     }
 
-    return object->valuedouble = number;
+    return (found != NULL) ? found->item : NULL;
 }
 
-typedef struct
+static struct cJSON_Index *create_object_index(const cJSON * const object)
 {
-    unsigned char *buffer;
-    size_t length;
-    size_t offset;
-    size_t depth; /* current nesting depth (for formatted printing) */
-    cJSON_bool noalloc;
-    cJSON_bool format; /* is this print a formatted print */
-    internal_hooks hooks;
-} printbuffer;
+    struct cJSON_Index *index = NULL;
+    cJSON *child = NULL;
+    size_t count = 0;
+    size_t capacity = minimum_index_capacity;
 
-/* realloc printbuffer if necessary to have at least "needed" bytes more */
-static unsigned char* ensure(printbuffer * const p, size_t needed)
-{
-    unsigned char *newbuffer = NULL;
-    size_t newsize = 0;
+    for (child = object->child; child != NULL; child = child->next)
+    {
+        if (child->string == NULL)
+        {
+            /* not a proper object */
+            return NULL;
+        }
+        count++;
+    }
 
-    if ((p == NULL) || (p->buffer == NULL))
+    while ((capacity / 2) < count)
     {
-        return NULL;
+        capacity *= 2;
     }
 
-    if ((p->length > 0) && (p->offset >= p->length))
+    index = (struct cJSON_Index*)global_hooks.allocate(sizeof(struct cJSON_Index), global_hooks.user_data);
+    if (index == NULL)
     {
-        /* make sure that offset is valid */
         return NULL;
     }
+    memset(index, '\0', sizeof(struct cJSON_Index));
 
-    if (needed > INT_MAX)
+    if (!index_resize(index, capacity))
     {
-        /* sizes bigger than INT_MAX are currently not supported */
+        global_hooks.deallocate(index, global_hooks.user_data);
         return NULL;
     }
 
-    needed += p->offset + 1;
-    if (needed <= p->length)
+    for (child = object->child; child != NULL; child = child->next)
     {
-        return p->buffer + p->offset;
+        index_insert_entry(index, child, hash_key((const unsigned char*)child->string), index->next_order);
+        index->next_order++;
     }
 
-    if (p->noalloc) {
-        return NULL;
+    return index;
+}
+
+static cJSON_bool reserve_array_index(struct cJSON_Index * const index, size_t count)
+{
+    cJSON **items = NULL;
+    size_t capacity = index->items_capacity;
+
+    /* the table always exists, even for empty arrays */
+    if ((index->items != NULL) && (count <= capacity))
+    {
+        return true;
     }
 
-    /* calculate new buffer size */
-    if (needed > (INT_MAX / 2))
+    if (capacity < minimum_index_capacity)
     {
-        /* overflow of int, use INT_MAX if possible */
-        if (needed <= INT_MAX)
-        {
-            newsize = INT_MAX;
-        }
-        else
+        capacity = minimum_index_capacity;
+    }
+    while (capacity < count)
+    {
+        if (capacity > ((size_t)-1 / sizeof(cJSON*) / 2))
         {
-            return NULL;
+            return false;
         }
-    }
-    else
-    {
-        newsize = needed * 2;
+        capacity *= 2;
     }
 
-    if (p->hooks.reallocate != NULL)
+    if (global_hooks.reallocate != NULL)
     {
-        /* reallocate with realloc if available */
-        newbuffer = (unsigned char*)p->hooks.reallocate(p->buffer, newsize);
-        if (newbuffer == NULL)
+        items = (cJSON**)global_hooks.reallocate(index->items, capacity * sizeof(cJSON*), global_hooks.user_data);
+        if (items == NULL)
         {
-            p->hooks.deallocate(p->buffer);
-            p->length = 0;
-            p->buffer = NULL;
-
-            return NULL;
+            return false;
         }
     }
     else
     {
-        /* otherwise reallocate manually */
-        newbuffer = (unsigned char*)p->hooks.allocate(newsize);
-        if (!newbuffer)
+        items = (cJSON**)global_hooks.allocate(capacity * sizeof(cJSON*), global_hooks.user_data);
+        if (items == NULL)
         {
-            p->hooks.deallocate(p->buffer);
-            p->length = 0;
-            p->buffer = NULL;
-
-            return NULL;
+            return false;
         }
-        if (newbuffer)
+        if (index->items != NULL)
         {
-            memcpy(newbuffer, p->buffer, p->offset + 1);
+            memcpy(items, index->items, index->count * sizeof(cJSON*));
+            global_hooks.deallocate(index->items, global_hooks.user_data);
         }
-        p->hooks.deallocate(p->buffer);
     }
-    p->length = newsize;
-    p->buffer = newbuffer;
 
-    return newbuffer + p->offset;
+    index->items = items;
+    index->items_capacity = capacity;
+
+    return true;
 }
 
-/* calculate the new length of the string in a printbuffer and update the offset */
-static void update_offset(printbuffer * const buffer)
+static struct cJSON_Index *create_array_index(const cJSON * const array)
 {
-    const unsigned char *buffer_pointer = NULL;
-    if ((buffer == NULL) || (buffer->buffer == NULL))
+    struct cJSON_Index *index = NULL;
+    cJSON *child = NULL;
+    size_t count = 0;
+
+    for (child = array->child; child != NULL; child = child->next)
     {
-        return;
+        count++;
     }
-    buffer_pointer = buffer->buffer + buffer->offset;
 
-    buffer->offset += strlen((const char*)buffer_pointer);
+    index = (struct cJSON_Index*)global_hooks.allocate(sizeof(struct cJSON_Index), global_hooks.user_data);
+    if (index == NULL)
+    {
+        return NULL;
+    }
+    memset(index, '\0', sizeof(struct cJSON_Index));
+
+    if (!reserve_array_index(index, count))
+    {
+        global_hooks.deallocate(index, global_hooks.user_data);
+        return NULL;
+    }
+
+    for (child = array->child; child != NULL; child = child->next)
+    {
+        index->items[index->count] = child;
+        index->count++;
+    }
+
+    return index;
 }
 
-/* Render the number nicely from the given item into a string. */
-static cJSON_bool print_number(const cJSON * const item, printbuffer * const output_buffer)
+/* position of an item in an array index, index->count if it isn't there */
+static size_t array_index_position(const struct cJSON_Index * const index, const cJSON * const item)
 {
-    unsigned char *output_pointer = NULL;
-    double d = item->valuedouble;
-    int length = 0;
-    size_t i = 0;
-    unsigned char number_buffer[26]; /* temporary buffer to print the number into */
-    unsigned char decimal_point = get_decimal_point();
-    double test;
+    size_t position = 0;
 
-    if (output_buffer == NULL)
+    /* removing the last item is the most common case */
+    if ((index->count > 0) && (index->items[index->count - 1] == item))
     {
-        return false;
+        return index->count - 1;
     }
 
-    /* This checks for NaN and Infinity */
-    if ((d * 0) != 0)
+    while ((position < index->count) && (index->items[position] != item))
     {
-        length = sprintf((char*)number_buffer, "null");
+        position++;
     }
-    else
+
+    return position;
+}
+
+static void drop_index(cJSON * const item)
+{
+    index_free(index_of(item));
+    set_index(item, NULL);
+}
+
+static cJSON_bool arena_adopt(cJSON * const item);
+
+/* the index of an arena item is released together with the arena, it is dropped if the arena can't remember it */
+static void attach_index(cJSON * const item, struct cJSON_Index * const index)
+{
+    if ((index != NULL) && !arena_adopt(item))
+    {
+        index_free(index);
+        set_index(item, NULL);
+        return;
+    }
+
+    set_index(item, index);
+}
+
+/* The following keep the index of a parent up to date when its children change.
+ * If that isn't possible the index is dropped, it can be created again later. */
+static void index_item_added(cJSON * const parent, cJSON * const item)
+{
+    struct cJSON_Index *index = index_of(parent);
+
+    if (index == NULL)
     {
-        /* Try 15 decimal places of precision to avoid nonsignificant nonzero digits */
-        length = sprintf((char*)number_buffer, "%1.15g", d);
+        return;
+    }
 
-        /* Check whether the original double can be recovered */
-        if ((sscanf((char*)number_buffer, "%lg", &test) != 1) || ((double)test != d))
+    if (index->items != NULL)
+    {
+        if (!reserve_array_index(index, index->count + 1))
         {
-            /* If not, print with 17 decimal places of precision */
-            length = sprintf((char*)number_buffer, "%1.17g", d);
+            drop_index(parent);
+            return;
         }
+        index->items[index->count] = item;
+        index->count++;
+        return;
     }
 
-    /* sprintf failed or buffer overrun occurred */
-    if ((length < 0) || (length > (int)(sizeof(number_buffer) - 1)))
+    if ((item->string == NULL) || !index_add(index, item, index->next_order))
     {
-        return false;
+        drop_index(parent);
+        return;
     }
+    index->next_order++;
+}
 
-    /* reserve appropriate space in the output */
-    output_pointer = ensure(output_buffer, (size_t)length + sizeof(""));
-    if (output_pointer == NULL)
+static void index_item_removed(const cJSON * const parent, const cJSON * const item)
+{
+    struct cJSON_Index *index = index_of(parent);
+    index_entry *entry = NULL;
+
+    if (index == NULL)
     {
-        return false;
+        return;
     }
 
-    /* copy the printed number to the output and replace locale
-     * dependent decimal point with '.' */
-    for (i = 0; i < ((size_t)length); i++)
+    if (index->items != NULL)
     {
-        if (number_buffer[i] == decimal_point)
+        size_t position = array_index_position(index, item);
+        if (position < index->count)
         {
-            output_pointer[i] = '.';
-            continue;
+            memmove(&index->items[position], &index->items[position + 1], (index->count - position - 1) * sizeof(cJSON*));
+            index->count--;
         }
-
-        output_pointer[i] = number_buffer[i];
+        return;
     }
-    output_pointer[i] = '\0';
-
-    output_buffer->offset += (size_t)length;
 
-    return true;
+    entry = index_find_entry(index, item);
+    if (entry != NULL)
+    {
+        entry->item = &deleted_index_entry;
+        index->count--;
+    }
 }
 
-/* parse 4 digit hexadecimal number */
-static unsigned parse_hex4(const unsigned char * const input)
+static void index_item_replaced(cJSON * const parent, const cJSON * const item, cJSON * const replacement)
 {
-    unsigned int h = 0;
-    size_t i = 0;
+    struct cJSON_Index *index = index_of(parent);
+    index_entry *entry = NULL;
+    size_t order = 0;
 
-    for (i = 0; i < 4; i++)
+    if (index == NULL)
     {
-        /* parse digit */
-        if ((input[i] >= '0') && (input[i] <= '9'))
-        {
-            h += (unsigned int) input[i] - '0';
-        }
-        else if ((input[i] >= 'A') && (input[i] <= 'F'))
-        {
-            h += (unsigned int) 10 + input[i] - 'A';
-        }
-        else if ((input[i] >= 'a') && (input[i] <= 'f'))
+        return;
+    }
+
+    if (index->items != NULL)
+    {
+        size_t position = array_index_position(index, item);
+        if (position < index->count)
         {
-            h += (unsigned int) 10 + input[i] - 'a';
+            index->items[position] = replacement;
         }
-        else /* invalid */
+        else
         {
-            return 0;
+            drop_index(parent);
         }
+        return;
+    }
 
-        if (i < 3)
-        {
-            /* shift left to make place for the next nibble */
-            h = h << 4;
-        }
+    entry = index_find_entry(index, item);
+    if ((entry == NULL) || (replacement->string == NULL))
+    {
+        drop_index(parent);
+        return;
     }
 
-    return h;
+    /* the replacement takes over the position of the item */
+    order = entry->order;
+    entry->item = &deleted_index_entry;
+    index->count--;
+    if (!index_add(index, replacement, order))
+    {
+        drop_index(parent);
+    }
 }
 
-/* converts a UTF-16 literal to UTF-8
- * A literal can be one or two sequences of the form \uXXXX */
-static unsigned char utf16_literal_to_utf8(const unsigned char * const input_pointer, const unsigned char * const input_end, unsigned char **output_pointer)
+static void index_item_inserted(cJSON * const parent, size_t position, cJSON * const item)
 {
-    long unsigned int codepoint = 0;
-    unsigned int first_code = 0;
-    const unsigned char *first_sequence = input_pointer;
-    unsigned char utf8_length = 0;
-    unsigned char utf8_position = 0;
-    unsigned char sequence_length = 0;
-    unsigned char first_byte_mark = 0;
+    struct cJSON_Index *index = index_of(parent);
 
-    if ((input_end - first_sequence) < 6)
+    if (index == NULL)
     {
-        /* input ends unexpectedly */
-        goto fail;
+        return;
     }
 
-    /* get the first utf16 sequence */
-    first_code = parse_hex4(first_sequence + 2);
-
-    /* check that the code is valid */
-    if (((first_code >= 0xDC00) && (first_code <= 0xDFFF)))
+    /* the positions of all following items change, so the index of an object can't be updated */
+    if ((index->items == NULL) || (position > index->count) || !reserve_array_index(index, index->count + 1))
     {
-        goto fail;
+        drop_index(parent);
+        return;
     }
 
-    /* UTF16 surrogate pair */
-    if ((first_code >= 0xD800) && (first_code <= 0xDBFF))
-    {
-        const unsigned char *second_sequence = first_sequence + 6;
-        unsigned int second_code = 0;
-        sequence_length = 12; /* \uXXXX\uXXXX */
+    memmove(&index->items[position + 1], &index->items[position], (index->count - position) * sizeof(cJSON*));
+    index->items[position] = item;
+    index->count++;
+}
 
-        if ((input_end - second_sequence) < 6)
-        {
-            /* input ends unexpectedly */
-            goto fail;
-        }
+/* The children of arrays and objects that share them, see cJSON_DuplicateShared. A block is never changed:
+ * its items are marked cJSON_IsReadOnly, the arrays and objects among them have blocks of their own, and an
+ * item that shares a block copies its children (or takes them over if nobody else shares them) before they
+ * are changed. Until then its child points into the block, so reading doesn't have to know about it. */
+typedef struct
+{
+    cJSON *child;
+    internal_hooks hooks; /* the block and its items were allocated with these */
+#if defined(CJSON_WIN32_THREADS)
+    volatile LONG references;
+#else
+    unsigned long references;
+#endif
+} shared_children;
+
+#if defined(CJSON_WIN32_THREADS)
+#define acquire_shared(shared) ((void)InterlockedIncrement(&(shared)->references))
+#define release_shared(shared) (InterlockedDecrement(&(shared)->references) == 0)
+#define shared_is_unique(shared) (InterlockedCompareExchange(&(shared)->references, 1, 1) == 1)
+#elif defined(CJSON_PTHREADS) && (defined(__GNUC__) || defined(__clang__))
+#define acquire_shared(shared) ((void)__atomic_add_fetch(&(shared)->references, 1, __ATOMIC_RELAXED))
+#define release_shared(shared) (__atomic_sub_fetch(&(shared)->references, 1, __ATOMIC_ACQ_REL) == 0)
+#define shared_is_unique(shared) (__atomic_load_n(&(shared)->references, __ATOMIC_ACQUIRE) == 1)
+#elif defined(CJSON_PTHREADS)
+static pthread_mutex_t shared_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static void acquire_shared(shared_children * const shared)
+{
+    pthread_mutex_lock(&shared_mutex);
+    shared->references++;
+    pthread_mutex_unlock(&shared_mutex);
+}
 
-        if ((second_sequence[0] != '\\') || (second_sequence[1] != 'u'))
-        {
-            /* missing second half of the surrogate pair */
-            goto fail;
-        }
+static cJSON_bool release_shared(shared_children * const shared)
+{
+    unsigned long references = 0;
 
-        /* get the second utf16 sequence */
-        second_code = parse_hex4(second_sequence + 2);
-        /* check that the code is valid */
-        if ((second_code < 0xDC00) || (second_code > 0xDFFF))
-        {
-            /* invalid second half of the surrogate pair */
-            goto fail;
-        }
+    pthread_mutex_lock(&shared_mutex);
+    references = --shared->references;
+    pthread_mutex_unlock(&shared_mutex);
 
+    return references == 0;
+}
 
-        /* calculate the unicode codepoint from the surrogate pair */
-        codepoint = 0x10000 + (((first_code & 0x3FF) << 10) | (second_code & 0x3FF));
-    }
-    else
-    {
-        sequence_length = 6; /* \uXXXX */
-        codepoint = first_code;
-    }
+static cJSON_bool shared_is_unique(shared_children * const shared)
+{
+    unsigned long references = 0;
 
-    /* encode as UTF-8
-     * takes at maximum 4 bytes to encode:
-     * 11110xxx 10xxxxxx 10xxxxxx 10xxxxxx */
-    if (codepoint < 0x80)
-    {
-        /* normal ascii, encoding 0xxxxxxx */
-        utf8_length = 1;
-    }
-    else if (codepoint < 0x800)
-    {
-        /* two bytes, encoding 110xxxxx 10xxxxxx */
-        utf8_length = 2;
-        first_byte_mark = 0xC0; /* 11000000 */
-    }
-    else if (codepoint < 0x10000)
+    pthread_mutex_lock(&shared_mutex);
+    references = shared->references;
+    pthread_mutex_unlock(&shared_mutex);
+
+    return references == 1;
+}
+#else
+#define acquire_shared(shared) ((void)(shared)->references++)
+#define release_shared(shared) (--(shared)->references == 0)
+#define shared_is_unique(shared) ((shared)->references == 1)
+#endif
+
+static void delete_item(cJSON *item, const internal_hooks * const hooks);
+static void arena_delete_document(cJSON * const root);
+
+/* let go of a block, the last item that shared it deletes it */
+static void release_block(shared_children * const shared)
+{
+    internal_hooks hooks;
+
+    if (release_shared(shared))
     {
-        /* three bytes, encoding 1110xxxx 10xxxxxx 10xxxxxx */
-        utf8_length = 3;
-        first_byte_mark = 0xE0; /* 11100000 */
+        hooks = shared->hooks;
+        delete_item(shared->child, &hooks);
+        hooks.deallocate(shared, hooks.user_data);
     }
-    else if (codepoint <= 0x10FFFF)
+}
+
+/* free everything an item owns apart from its children */
+static void delete_contents(cJSON * const item, const internal_hooks * const hooks)
+{
+    if (!(item->type & (cJSON_IsReference | cJSON_IsLazy)) && !string_is_inline(item) && (item_valuestring(item) != NULL))
     {
-        /* four bytes, encoding 1110xxxx 10xxxxxx 10xxxxxx 10xxxxxx */
-        utf8_length = 4;
-        first_byte_mark = 0xF0; /* 11110000 */
+        hooks->deallocate(item_valuestring(item), hooks->user_data);
     }
-    else
+    if (item_is_packed(item) && !(item->type & cJSON_IsReference))
     {
-        /* invalid unicode codepoint */
-        goto fail;
+        hooks->deallocate(packed_numbers(item), hooks->user_data);
     }
-
-    /* encode as utf8 */
-    for (utf8_position = (unsigned char)(utf8_length - 1); utf8_position > 0; utf8_position--)
+    if (item_is_shared(item) && !(item->type & cJSON_IsReference))
     {
-        /* 10xxxxxx */
-        (*output_pointer)[utf8_position] = (unsigned char)((codepoint | 0x80) & 0xBF);
-        codepoint >>= 6;
+        release_block(shared_of(item));
     }
-    /* encode first byte */
-    if (utf8_length > 1)
+    if (!(item->type & cJSON_StringIsConst) && (item->string != NULL))
     {
-        (*output_pointer)[0] = (unsigned char)((codepoint | first_byte_mark) & 0xFF);
+        hooks->deallocate(item->string, hooks->user_data);
     }
-    else
+    if (index_of(item) != NULL)
     {
-        (*output_pointer)[0] = (unsigned char)(codepoint & 0x7F);
+        index_free(index_of(item));
     }
-
-    *output_pointer += utf8_length;
-
-    return sequence_length;
-
-fail:
-    return 0;
 }
 
-/* Parse the input text into an unescaped cinput, and populate item. */
-static cJSON_bool parse_string(cJSON * const item, parse_buffer * const input_buffer)
+/* the memory of an arena item stays in the arena, so it is emptied instead, this way it can't be freed twice */
+static void clear_arena_item(cJSON * const item)
+{
+    memset(item, '\0', sizeof(cJSON));
+    item->type = cJSON_IsArenaItem;
+}
+
+/* Delete a cJSON structure. */
+static void delete_item(cJSON *item, const internal_hooks * const hooks)
+{
+    cJSON *next = NULL;
+    while (item != NULL)
+    {
+        next = item->next;
+        if (item->type & cJSON_IsArenaRoot)
+        {
+            /* the arena knows everything the tree has been given after parsing */
+            arena_delete_document(item);
+        }
+        else
+        {
+            if (!(item->type & (cJSON_IsReference | cJSON_IsShared)) && (item->child != NULL))
+            {
+                delete_item(item->child, hooks);
+            }
+            delete_contents(item, hooks);
+            if (item->type & cJSON_IsArenaItem)
+            {
+                clear_arena_item(item);
+            }
+            else
+            {
+                hooks->deallocate(item, hooks->user_data);
+            }
+        }
+        item = next;
+    }
+}
+
+CJSON_PUBLIC(void) cJSON_Delete(cJSON *item)
+{
+    delete_item(item, &global_hooks);
+}
+
+CJSON_PUBLIC(void) cJSON_DeleteWithContext(cJSON *item, const cJSON_Context *context)
+{
+    internal_hooks hooks = context_hooks(context);
+    delete_item(item, &hooks);
+}
+
+/* An arena hands out the memory for a whole parse tree from a few big chunks,
+ * so the tree can be released at once instead of item by item. */
+typedef struct arena_chunk
+{
+    struct arena_chunk *next;
+    size_t length; /* usable bytes after the header */
+    size_t used;
+} arena_chunk;
+
+/* an arena item that owns memory from outside of the arena, see arena_adopt */
+typedef struct arena_owner
+{
+    struct arena_owner *next;
+    cJSON *item;
+} arena_owner;
+
+typedef struct
+{
+    arena_chunk *chunks; /* the chunk that is currently being filled comes first */
+    arena_owner *owners; /* released together with the arena */
+    internal_hooks hooks;
+} parse_arena;
+
+/* Items in an arena remember it, so that what they are given after parsing can be released with it. */
+typedef struct
+{
+    cJSON item;
+    parse_arena *arena;
+} arena_item;
+
+#define arena_of(item) (((const arena_item*)(const void*)(item))->arena)
+
+/* The first chunk of an arena starts with this, so the arena can be found again from the root item. */
+typedef struct
+{
+    arena_chunk chunk;
+    parse_arena arena;
+    arena_item root;
+} arena_document;
+
+typedef union
+{
+    void *pointer;
+    double number;
+    size_t size;
+} arena_alignment;
+
+#define arena_align(size) ((((size) + sizeof(arena_alignment) - 1) / sizeof(arena_alignment)) * sizeof(arena_alignment))
+#define arena_chunk_data(chunk) ((unsigned char*)(chunk) + arena_align(sizeof(arena_chunk)))
+
+static const size_t arena_minimum_chunk_length = 4096;
+
+/* create an arena whose first chunk is big enough to hold a document of the given length */
+static arena_document *arena_create(size_t document_length, const internal_hooks * const hooks)
+{
+    arena_document *document = NULL;
+    size_t header_length = arena_align(sizeof(arena_document));
+    size_t length = (document_length > arena_minimum_chunk_length) ? document_length : arena_minimum_chunk_length;
+
+    if (length > ((size_t)-1 - header_length))
+    {
+        return NULL;
+    }
+
+    document = (arena_document*)hooks->allocate(header_length + length, hooks->user_data);
+    if (document == NULL)
+    {
+        return NULL;
+    }
+    memset(document, '\0', sizeof(arena_document));
+
+    document->chunk.length = header_length + length - arena_align(sizeof(arena_chunk));
+    document->chunk.used = header_length - arena_align(sizeof(arena_chunk));
+    document->arena.chunks = &document->chunk;
+    document->arena.hooks = *hooks;
+    document->root.item.type = cJSON_IsArenaItem;
+    document->root.arena = &document->arena;
+
+    return document;
+}
+
+/* create an arena that isn't part of a document, its first chunk has the given length */
+static cJSON_bool arena_init(parse_arena * const arena, size_t length, const internal_hooks * const hooks)
+{
+    arena->chunks = (arena_chunk*)hooks->allocate(arena_align(sizeof(arena_chunk)) + length, hooks->user_data);
+    if (arena->chunks == NULL)
+    {
+        return false;
+    }
+    arena->chunks->next = NULL;
+    arena->chunks->length = length;
+    arena->chunks->used = 0;
+    arena->owners = NULL;
+    arena->hooks = *hooks;
+
+    return true;
+}
+
+static void *arena_allocate(parse_arena * const arena, size_t size)
+{
+    arena_chunk *chunk = arena->chunks;
+    unsigned char *memory = NULL;
+
+    /* prevent overflows when calculating the size of a new chunk */
+    if (size > ((size_t)-1 / 4))
+    {
+        return NULL;
+    }
+    size = arena_align(size);
+
+    if ((chunk->length - chunk->used) < size)
+    {
+        /* the chunks grow geometrically so that big documents only need a few of them */
+        size_t length = chunk->length * 2;
+        if (length < size)
+        {
+            length = size;
+        }
+
+        chunk = (arena_chunk*)arena->hooks.allocate(arena_align(sizeof(arena_chunk)) + length, arena->hooks.user_data);
+        if (chunk == NULL)
+        {
+            return NULL;
+        }
+        chunk->next = arena->chunks;
+        chunk->length = length;
+        chunk->used = 0;
+        arena->chunks = chunk;
+    }
+
+    memory = arena_chunk_data(chunk) + chunk->used;
+    chunk->used += size;
+
+    return memory;
+}
+
+/* Remember an arena item that has been given memory from outside of the arena, like the items that are added to it,
+ * so that the memory can be released with the arena without walking the whole tree. */
+static cJSON_bool arena_adopt(cJSON * const item)
+{
+    parse_arena *arena = NULL;
+    arena_owner *owner = NULL;
+
+    if (!(item->type & cJSON_IsArenaItem))
+    {
+        return true;
+    }
+
+    arena = arena_of(item);
+    /* changes mostly come in a row for the same item */
+    if ((arena->owners != NULL) && (arena->owners->item == item))
+    {
+        return true;
+    }
+
+    owner = (arena_owner*)arena_allocate(arena, sizeof(arena_owner));
+    if (owner == NULL)
+    {
+        return false;
+    }
+    owner->item = item;
+    owner->next = arena->owners;
+    arena->owners = owner;
+
+    return true;
+}
+
+/* an arena container that gets an item from outside of the arena has to free it */
+#define arena_adopt_child(parent, child) (((child)->type & cJSON_IsArenaItem) || arena_adopt(parent))
+
+/* free what the items of an arena have been given after parsing, the arena items among their children are owners of their own */
+static void arena_release_owners(parse_arena * const arena)
+{
+    arena_owner *owner = NULL;
+
+    for (owner = arena->owners; owner != NULL; owner = owner->next)
+    {
+        cJSON *item = owner->item;
+        cJSON *child = (item->type & (cJSON_IsReference | cJSON_IsShared)) ? NULL : item->child;
+        while (child != NULL)
+        {
+            cJSON *next = child->next;
+            if (!(child->type & cJSON_IsArenaItem))
+            {
+                child->next = NULL;
+                delete_item(child, &global_hooks);
+            }
+            child = next;
+        }
+        delete_contents(item, &global_hooks);
+        clear_arena_item(item);
+    }
+    arena->owners = NULL;
+}
+
+static void arena_release(parse_arena * const arena)
+{
+    internal_hooks hooks = arena->hooks;
+    /* the arena itself lives in the last chunk, so it mustn't be used after that is gone */
+    arena_chunk *chunk = NULL;
+
+    arena_release_owners(arena);
+    chunk = arena->chunks;
+    while (chunk != NULL)
+    {
+        arena_chunk *next = chunk->next;
+        hooks.deallocate(chunk, hooks.user_data);
+        chunk = next;
+    }
+}
+
+/* release everything but the newest chunk, which is the biggest one, and start from its beginning again */
+static void arena_reset(parse_arena * const arena)
+{
+    arena_chunk *chunk = NULL;
+
+    arena_release_owners(arena);
+    chunk = arena->chunks->next;
+    while (chunk != NULL)
+    {
+        arena_chunk *next = chunk->next;
+        arena->hooks.deallocate(chunk, arena->hooks.user_data);
+        chunk = next;
+    }
+    arena->chunks->next = NULL;
+    arena->chunks->used = 0;
+}
+
+/* the root of a document is the first item in its arena */
+static void arena_delete_document(cJSON * const root)
+{
+    arena_release(arena_of(root));
+}
+
+CJSON_PUBLIC(void) cJSON_ArenaDelete(cJSON *root)
+{
+    /* other items don't know where their arena starts */
+    if ((root != NULL) && (root->type & cJSON_IsArenaRoot))
+    {
+        delete_item(root, &global_hooks);
+    }
+}
+
+/* A key table stores every distinct key once, parsed objects point their keys into it. */
+typedef struct
+{
+    const char *key; /* NULL for free slots */
+    size_t length;
+    size_t hash;
+} key_table_entry;
+
+struct cJSON_KeyTable
+{
+    key_table_entry *entries;
+    size_t capacity; /* always a power of 2 */
+    size_t count;
+    parse_arena strings; /* the keys, they are never freed one by one */
+    internal_hooks hooks;
+};
+
+static const size_t minimum_key_table_capacity = 64;
+
+/* FNV-1a like hash_key, but of exactly length bytes, so keys can be looked up before they are copied out of the input */
+static size_t hash_key_bytes(const unsigned char *key, size_t length)
+{
+    size_t hash = 2166136261UL;
+    size_t i = 0;
+
+    for (i = 0; i < length; i++)
+    {
+        hash ^= (size_t)key[i];
+        hash *= 16777619UL;
+    }
+
+    return hash;
+}
+
+static key_table_entry *key_table_find(const cJSON_KeyTable * const table, const unsigned char * const key, const size_t length, const size_t hash)
+{
+    size_t mask = table->capacity - 1;
+    size_t position = 0;
+
+    for (position = hash & mask; table->entries[position].key != NULL; position = (position + 1) & mask)
+    {
+        key_table_entry *entry = &table->entries[position];
+        if ((entry->hash == hash) && (entry->length == length) && (memcmp(entry->key, key, length) == 0))
+        {
+            return entry;
+        }
+    }
+
+    /* the free slot where the key would be inserted */
+    return &table->entries[position];
+}
+
+static cJSON_bool key_table_resize(cJSON_KeyTable * const table, size_t capacity)
+{
+    key_table_entry *old_entries = table->entries;
+    size_t old_capacity = table->capacity;
+    size_t i = 0;
+
+    if (capacity > ((size_t)-1 / sizeof(key_table_entry)))
+    {
+        return false;
+    }
+
+    table->entries = (key_table_entry*)table->hooks.allocate(capacity * sizeof(key_table_entry), table->hooks.user_data);
+    if (table->entries == NULL)
+    {
+        table->entries = old_entries;
+        return false;
+    }
+    memset(table->entries, '\0', capacity * sizeof(key_table_entry));
+    table->capacity = capacity;
+
+    for (i = 0; i < old_capacity; i++)
+    {
+        if (old_entries[i].key != NULL)
+        {
+            *key_table_find(table, (const unsigned char*)old_entries[i].key, old_entries[i].length, old_entries[i].hash) = old_entries[i];
+        }
+    }
+
+    if (old_entries != NULL)
+    {
+        table->hooks.deallocate(old_entries, table->hooks.user_data);
+    }
+
+    return true;
+}
+
+/* the shared copy of a key, which is added to the table if it isn't there yet. Returns NULL on allocation failure. */
+static const char *key_table_intern(cJSON_KeyTable * const table, const unsigned char * const key, const size_t length)
+{
+    size_t hash = hash_key_bytes(key, length);
+    key_table_entry *entry = key_table_find(table, key, length, hash);
+    char *copy = NULL;
+
+    if (entry->key != NULL)
+    {
+        return entry->key;
+    }
+
+    /* keep the load factor below 3/4 */
+    if (((table->count + 1) * 4) > (table->capacity * 3))
+    {
+        if (!key_table_resize(table, table->capacity * 2))
+        {
+            return NULL;
+        }
+        entry = key_table_find(table, key, length, hash);
+    }
+
+    copy = (char*)arena_allocate(&table->strings, length + sizeof(""));
+    if (copy == NULL)
+    {
+        return NULL;
+    }
+    memcpy(copy, key, length);
+    copy[length] = '\0';
+
+    entry->key = copy;
+    entry->length = length;
+    entry->hash = hash;
+    table->count++;
+
+    return copy;
+}
+
+CJSON_PUBLIC(cJSON_KeyTable *) cJSON_CreateKeyTable(void)
+{
+    cJSON_KeyTable *table = (cJSON_KeyTable*)global_hooks.allocate(sizeof(cJSON_KeyTable), global_hooks.user_data);
+    if (table == NULL)
+    {
+        return NULL;
+    }
+    memset(table, '\0', sizeof(cJSON_KeyTable));
+    table->hooks = global_hooks;
+
+    if (!arena_init(&table->strings, arena_minimum_chunk_length, &global_hooks))
+    {
+        global_hooks.deallocate(table, global_hooks.user_data);
+        return NULL;
+    }
+    if (!key_table_resize(table, minimum_key_table_capacity))
+    {
+        arena_release(&table->strings);
+        global_hooks.deallocate(table, global_hooks.user_data);
+        return NULL;
+    }
+
+    return table;
+}
+
+CJSON_PUBLIC(const char *) cJSON_InternKey(cJSON_KeyTable *table, const char *key)
+{
+    if ((table == NULL) || (key == NULL))
+    {
+        return NULL;
+    }
+
+    return key_table_intern(table, (const unsigned char*)key, strlen(key));
+}
+
+CJSON_PUBLIC(size_t) cJSON_GetKeyTableSize(const cJSON_KeyTable *table)
+{
+    return (table != NULL) ? table->count : 0;
+}
+
+CJSON_PUBLIC(void) cJSON_DeleteKeyTable(cJSON_KeyTable *table)
+{
+    if (table == NULL)
+    {
+        return;
+    }
+
+    arena_release(&table->strings);
+    table->hooks.deallocate(table->entries, table->hooks.user_data);
+    table->hooks.deallocate(table, table->hooks.user_data);
+}
+
+/* get the decimal point character of the current locale */
+static unsigned char get_decimal_point(void)
+{
+#ifdef ENABLE_LOCALES
+    struct lconv *lconv = localeconv();
+    return (unsigned char) lconv->decimal_point[0];
+#else
+    return '.';
+#endif
+}
+
+typedef struct
+{
+    const unsigned char *content;
+    size_t length;
+    size_t offset;
+    size_t depth; /* How deeply nested (in arrays/objects) is the input at the current offset. */
+    internal_hooks hooks;
+    parse_arena *arena; /* if not NULL, all items and strings are allocated from this arena */
+    unsigned char *in_situ; /* if not NULL, the writable content that strings are unescaped into */
+    size_t lazy_depth; /* if not 0, arrays and objects at this depth or deeper are only skipped, see cJSON_ParseLazy */
+    cJSON_bool pack_numbers; /* store arrays of numbers as packed arrays, see cJSON_ParsePacked */
+    cJSON_KeyTable *keys; /* if not NULL, keys of objects are shared through this table, see cJSON_ParseWithKeyTable */
+} parse_buffer;
+
+/* check if the given size is left to read in a given parse buffer (starting with 1) */
+#define can_read(buffer, size) ((buffer != NULL) && (((buffer)->offset + size) <= (buffer)->length))
+/* check if the buffer can be accessed at the given index (starting with 0) */
+#define can_access_at_index(buffer, index) ((buffer != NULL) && (((buffer)->offset + index) < (buffer)->length))
+#define cannot_access_at_index(buffer, index) (!can_access_at_index(buffer, index))
+/* get a pointer to the buffer at the position */
+#define buffer_at_offset(buffer) ((buffer)->content + (buffer)->offset)
+
+/* allocate memory for the tree that is being parsed */
+static void *parse_allocate(parse_buffer * const input_buffer, size_t size)
+{
+    if (input_buffer->arena != NULL)
+    {
+        return arena_allocate(input_buffer->arena, size);
+    }
+
+    return input_buffer->hooks.allocate(size, input_buffer->hooks.user_data);
+}
+
+static void parse_deallocate(parse_buffer * const input_buffer, void *pointer)
+{
+    /* memory from an arena is only ever released as a whole */
+    if (input_buffer->arena == NULL)
+    {
+        input_buffer->hooks.deallocate(pointer, input_buffer->hooks.user_data);
+    }
+}
+
+static cJSON *parse_new_item(parse_buffer * const input_buffer)
+{
+    cJSON *node = NULL;
+
+    if (input_buffer->arena == NULL)
+    {
+        return cJSON_New_Item(&input_buffer->hooks);
+    }
+
+    node = (cJSON*)parse_allocate(input_buffer, sizeof(arena_item));
+    if (node != NULL)
+    {
+        memset(node, '\0', sizeof(arena_item));
+        ((arena_item*)(void*)node)->arena = input_buffer->arena;
+    }
+
+    return node;
+}
+
+/* parse_value overwrites the type, so the ownership flags of arena and in situ items are set once an item is complete */
+static void parse_finish_item(const parse_buffer * const input_buffer, cJSON * const item)
+{
+    if ((input_buffer->keys != NULL) && (item->string != NULL))
+    {
+        /* the key belongs to the key table */
+        item->type |= cJSON_StringIsConst;
+    }
+
+    if ((input_buffer->arena == NULL) && (input_buffer->in_situ == NULL))
+    {
+        return;
+    }
+
+    if (input_buffer->arena != NULL)
+    {
+        item->type |= cJSON_IsArenaItem;
+    }
+    if ((item_valuestring(item) != NULL) && !string_is_inline(item))
+    {
+        item->type |= cJSON_IsReference;
+    }
+    if (item->string != NULL)
+    {
+        item->type |= cJSON_StringIsConst;
+    }
+}
+
+/* The fast path for parsing numbers needs every operation on doubles to be rounded to double precision.
+ * This isn't the case on x87 FPUs, which calculate with extended precision. */
+#if (defined(__FLT_EVAL_METHOD__) && (__FLT_EVAL_METHOD__ == 0)) || defined(_M_X64) || defined(_M_AMD64) || defined(_M_ARM64)
+#define CJSON_EXACT_DOUBLE_ARITHMETIC
+#endif
+
+#define is_digit(character) (((character) >= '0') && ((character) <= '9'))
+
+#ifdef CJSON_EXACT_DOUBLE_ARITHMETIC
+/* all of these can be represented exactly as double */
+static const double exact_powers_of_ten[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/* Parse numbers with at most 15 significant digits and a small exponent without strtod.
+ * The digits fit into a double exactly, so the result of multiplying or dividing by an exact power
+ * of ten is correctly rounded (Clinger's fast path).
+ * Returns the length of the number or 0 if it has to be parsed by strtod. */
+static size_t parse_number_fast(const unsigned char * const input, const size_t length, const unsigned char decimal_point, double * const number)
+{
+    double mantissa = 0;
+    size_t position = 0;
+    size_t significant_digits = 0;
+    int exponent = 0;
+    int explicit_exponent = 0;
+    cJSON_bool negative = false;
+    cJSON_bool negative_exponent = false;
+
+    if ((position < length) && (input[position] == '-'))
+    {
+        negative = true;
+        position++;
+    }
+
+    if ((position >= length) || !is_digit(input[position]))
+    {
+        return 0;
+    }
+
+    /* integer part, JSON doesn't allow leading zeros */
+    if (input[position] == '0')
+    {
+        position++;
+    }
+    else
+    {
+        for (; (position < length) && is_digit(input[position]); position++)
+        {
+            if (significant_digits == 15)
+            {
+                return 0;
+            }
+            mantissa = (mantissa * 10) + (input[position] - '0');
+            significant_digits++;
+        }
+    }
+
+    /* fraction */
+    if ((position < length) && (input[position] == decimal_point))
+    {
+        position++;
+        if ((position >= length) || !is_digit(input[position]))
+        {
+            return 0;
+        }
+
+        for (; (position < length) && is_digit(input[position]); position++)
+        {
+            exponent--;
+            if ((significant_digits == 0) && (input[position] == '0'))
+            {
+                /* leading zeros aren't significant */
+                continue;
+            }
+            if (significant_digits == 15)
+            {
+                return 0;
+            }
+            mantissa = (mantissa * 10) + (input[position] - '0');
+            significant_digits++;
+        }
+    }
+
+    /* exponent */
+    if ((position < length) && ((input[position] == 'e') || (input[position] == 'E')))
+    {
+        position++;
+        if ((position < length) && ((input[position] == '+') || (input[position] == '-')))
+        {
+            negative_exponent = input[position] == '-';
+            position++;
+        }
+        if ((position >= length) || !is_digit(input[position]))
+        {
+            return 0;
+        }
+
+        for (; (position < length) && is_digit(input[position]); position++)
+        {
+            if (explicit_exponent > 1000)
+            {
+                return 0;
+            }
+            explicit_exponent = (explicit_exponent * 10) + (input[position] - '0');
+        }
+    }
+
+    /* let strtod decide what to do with anything out of the ordinary */
+    if ((position < length) && (is_digit(input[position]) || (input[position] == decimal_point)
+                || (input[position] == '+') || (input[position] == '-')
+                || (input[position] == 'e') || (input[position] == 'E')))
+    {
+        return 0;
+    }
+
+    exponent += negative_exponent ? -explicit_exponent : explicit_exponent;
+    if (significant_digits == 0)
+    {
+        mantissa = 0;
+    }
+    else if (exponent < -22)
+    {
+        return 0;
+    }
+    else if (exponent < 0)
+    {
+        mantissa /= exact_powers_of_ten[-exponent];
+    }
+    else if (exponent > 22)
+    {
+        /* move part of the exponent to the mantissa if it still has less than 16 digits then */
+        if ((significant_digits + (size_t)(exponent - 22)) > 15)
+        {
+            return 0;
+        }
+        mantissa *= exact_powers_of_ten[exponent - 22];
+        mantissa *= exact_powers_of_ten[22];
+    }
+    else
+    {
+        mantissa *= exact_powers_of_ten[exponent];
+    }
+
+    *number = negative ? -mantissa : mantissa;
+
+    return position;
+}
+#endif
+
+/* Parse a number with strtod. Returns the length of the number or 0 if it isn't one. */
+static size_t parse_number_strtod(const unsigned char * const input, const size_t length, const unsigned char decimal_point, double * const number)
+{
+    unsigned char *after_end = NULL;
+    unsigned char number_c_string[64];
+    unsigned char locale_decimal_point = get_decimal_point();
+    size_t i = 0;
+
+    /* copy the number into a temporary buffer and replace the decimal point with the one
+     * of the current locale (for strtod)
+     * This also takes care of '\0' not necessarily being available for marking the end of the input */
+    for (i = 0; (i < (sizeof(number_c_string) - 1)) && (i < length); i++)
+    {
+        if (input[i] == decimal_point)
+        {
+            number_c_string[i] = locale_decimal_point;
+            continue;
+        }
+
+        switch (input[i])
+        {
+            case '0':
+            case '1':
+            case '2':
+            case '3':
+            case '4':
+            case '5':
+            case '6':
+            case '7':
+            case '8':
+            case '9':
+            case '+':
+            case '-':
+            case 'e':
+            case 'E':
+                number_c_string[i] = input[i];
+                break;
+
+            default:
+                goto loop_end;
+        }
+    }
+loop_end:
+    number_c_string[i] = '\0';
+
+    *number = strtod((const char*)number_c_string, (char**)&after_end);
+
+    return (size_t)(after_end - number_c_string);
+}
+
+/* Parse a number in the given buffer. Returns the length of the number or 0 if it isn't one. */
+static size_t parse_decimal_number(const unsigned char * const input, const size_t length, const unsigned char decimal_point, double * const number)
+{
+#ifdef CJSON_EXACT_DOUBLE_ARITHMETIC
+    size_t number_length = parse_number_fast(input, length, decimal_point, number);
+    if (number_length != 0)
+    {
+        return number_length;
+    }
+#endif
+
+    return parse_number_strtod(input, length, decimal_point, number);
+}
+
+/* Parse the input text to generate a number, and populate the result into item. */
+static cJSON_bool parse_number(cJSON * const item, parse_buffer * const input_buffer)
+{
+    double number = 0;
+    size_t number_length = 0;
+
+    if ((input_buffer == NULL) || (input_buffer->content == NULL))
+    {
+        return false;
+    }
+
+    number_length = parse_decimal_number(buffer_at_offset(input_buffer), input_buffer->length - input_buffer->offset, '.', &number);
+    if (number_length == 0)
+    {
+        return false; /* parse_error */
+    }
+
+    item_number(item) = number;
+
+    /* use saturation in case of overflow */
+    if (number >= INT_MAX)
+    {
+        item->valueint = INT_MAX;
+    }
+    else if (number <= (double)INT_MIN)
+    {
+        item->valueint = INT_MIN;
+    }
+    else
+    {
+        item->valueint = (int)number;
+    }
+
+    item->type = cJSON_Number;
+
+    input_buffer->offset += number_length;
+    return true;
+}
+
+/* don't ask me, but the original cJSON_SetNumberValue returns an integer or double */
+CJSON_PUBLIC(double) cJSON_SetNumberHelper(cJSON *object, double number)
+{
+    if (object->type & cJSON_IsReadOnly)
+    {
+        /* other copies share it, see cJSON_DuplicateShared */
+        return number;
+    }
+
+    if (number >= INT_MAX)
+    {
+        object->valueint = INT_MAX;
+    }
+    else if (number <= (double)INT_MIN)
+    {
+        object->valueint = INT_MIN;
+    }
+    else
+    {
+        object->valueint = (int)number;
+    }
+
+#ifdef CJSON_COMPACT_NODES
+    if (!cJSON_IsNumber(object))
+    {
+        /* the memory of the number belongs to the string or index of other types */
+        return number;
+    }
+#endif
+
+    return item_number(object) = number;
+}
+
+CJSON_PUBLIC(int) cJSON_SetIntHelper(cJSON *object, double number)
+{
+    cJSON_SetNumberHelper(object, number);
+
+    return object->valueint;
+}
+
+typedef struct
+{
+    unsigned char *buffer;
+    size_t length;
+    size_t offset;
+    size_t depth; /* current nesting depth (for formatted printing) */
+    cJSON_bool noalloc;
+    cJSON_bool format; /* is this print a formatted print */
+    internal_hooks hooks;
+    cJSON_WriteCallback write; /* if set, full buffers are flushed here instead of growing */
+    void *write_context;
+} printbuffer;
+
+/* hand everything before offset to the write callback and start over at the beginning of the buffer */
+static cJSON_bool flush_printbuffer(printbuffer * const p)
+{
+    if (p->offset == 0)
+    {
+        return true;
+    }
+
+    if (!p->write((const char*)p->buffer, p->offset, p->write_context))
+    {
+        return false;
+    }
+    p->offset = 0;
+    p->buffer[0] = '\0';
+
+    return true;
+}
+
+/* realloc printbuffer if necessary to have at least "needed" bytes more */
+static unsigned char* ensure(printbuffer * const p, size_t needed)
+{
+    unsigned char *newbuffer = NULL;
+    size_t newsize = 0;
+
+    if ((p == NULL) || (p->buffer == NULL))
+    {
+        return NULL;
+    }
+
+    if ((p->length > 0) && (p->offset > p->length))
+    {
+        /* make sure that offset is valid, it reaches length when the buffer is exactly full */
+        return NULL;
+    }
+
+    if (needed > INT_MAX)
+    {
+        /* sizes bigger than INT_MAX are currently not supported */
+        return NULL;
+    }
+
+    /* needed already includes the terminating zero where one is written */
+    needed += p->offset;
+    if (needed <= p->length)
+    {
+        return p->buffer + p->offset;
+    }
+
+    if ((p->write != NULL) && (p->offset > 0))
+    {
+        needed -= p->offset;
+        if (!flush_printbuffer(p))
+        {
+            return NULL;
+        }
+        if (needed <= p->length)
+        {
+            return p->buffer;
+        }
+    }
+
+    if (p->noalloc) {
+        return NULL;
+    }
+
+    /* calculate new buffer size */
+    if (needed > (INT_MAX / 2))
+    {
+        /* overflow of int, use INT_MAX if possible */
+        if (needed <= INT_MAX)
+        {
+            newsize = INT_MAX;
+        }
+        else
+        {
+            return NULL;
+        }
+    }
+    else
+    {
+        newsize = needed * 2;
+    }
+
+    if (p->hooks.reallocate != NULL)
+    {
+        /* reallocate with realloc if available */
+        newbuffer = (unsigned char*)p->hooks.reallocate(p->buffer, newsize, p->hooks.user_data);
+        if (newbuffer == NULL)
+        {
+            p->hooks.deallocate(p->buffer, p->hooks.user_data);
+            p->length = 0;
+            p->buffer = NULL;
+
+            return NULL;
+        }
+    }
+    else
+    {
+        /* otherwise reallocate manually */
+        newbuffer = (unsigned char*)p->hooks.allocate(newsize, p->hooks.user_data);
+        if (!newbuffer)
+        {
+            p->hooks.deallocate(p->buffer, p->hooks.user_data);
+            p->length = 0;
+            p->buffer = NULL;
+
+            return NULL;
+        }
+        memcpy(newbuffer, p->buffer, p->offset);
+        p->hooks.deallocate(p->buffer, p->hooks.user_data);
+    }
+    p->length = newsize;
+    p->buffer = newbuffer;
+
+    return newbuffer + p->offset;
+}
+
+/* calculate the new length of the string in a printbuffer and update the offset */
+static void update_offset(printbuffer * const buffer)
+{
+    const unsigned char *buffer_pointer = NULL;
+    if ((buffer == NULL) || (buffer->buffer == NULL))
+    {
+        return;
+    }
+    buffer_pointer = buffer->buffer + buffer->offset;
+
+    buffer->offset += strlen((const char*)buffer_pointer);
+}
+
+/* Print an integer with less than 16 digits without going through sprintf, the same way "%1.15g" does. */
+static int print_integer(double number, unsigned char * const output)
+{
+    unsigned char digits[32]; /* enough for any unsigned long, so the compiler can see that it never overflows */
+    unsigned long high = 0;
+    unsigned long low = 0;
+    size_t digit_count = 0;
+    int length = 0;
+
+    if (number < 0)
+    {
+        output[length++] = '-';
+        number = -number;
+    }
+
+    /* split into two parts that fit into 32 bit */
+    high = (unsigned long)(number / 1e9);
+    low = (unsigned long)(number - ((double)high * 1e9));
+
+    do
+    {
+        digits[digit_count++] = (unsigned char)('0' + (low % 10));
+        low /= 10;
+    } while ((low != 0) || ((high != 0) && (digit_count < 9)));
+    while (high != 0)
+    {
+        digits[digit_count++] = (unsigned char)('0' + (high % 10));
+        high /= 10;
+    }
+
+    while (digit_count > 0)
+    {
+        output[length++] = digits[--digit_count];
+    }
+    output[length] = '\0';
+
+    return length;
+}
+
+/* temporary buffer to print a number into, 26 would do, but compilers can not see that the precision is at most 17 */
+#define NUMBER_BUFFER_LENGTH 40
+
+/* Format a number the way it is printed, with the decimal point of the locale. Returns the length or -1 on failure. */
+static int format_double(const double d, unsigned char * const number_buffer, unsigned char * const decimal_point)
+{
+    int length = 0;
+    int precision = 0;
+    double test = 0;
+
+    *decimal_point = '.';
+
+    /* This checks for NaN and Infinity */
+    if ((d * 0) != 0)
+    {
+        length = sprintf((char*)number_buffer, "null");
+    }
+    else if ((d != 0) && (fabs(d) < 1e15) && (floor(d) == d))
+    {
+        /* integers are exact, no need to check the round trip */
+        length = print_integer(d, number_buffer);
+    }
+    else
+    {
+        *decimal_point = get_decimal_point();
+
+        /* Use the shortest precision that allows the original double to be recovered,
+         * 17 is always enough. Any number with 15 digits can be represented as double, so
+         * there is no shorter representation than the one with 15 digits, except for denormals. */
+        for (precision = (fabs(d) < DBL_MIN) ? 1 : 15; precision <= 17; precision++)
+        {
+            length = sprintf((char*)number_buffer, "%1.*g", precision, d);
+            if ((precision == 17) || (length < 0) || (length > (NUMBER_BUFFER_LENGTH - 1)))
+            {
+                break;
+            }
+
+            if ((parse_decimal_number(number_buffer, (size_t)length, *decimal_point, &test) == (size_t)length) && (test == d))
+            {
+                break;
+            }
+        }
+    }
+
+    /* sprintf failed or buffer overrun occurred */
+    if ((length < 0) || (length > (NUMBER_BUFFER_LENGTH - 1)))
+    {
+        return -1;
+    }
+
+    return length;
+}
+
+/* Render the number nicely into a string. */
+static cJSON_bool print_double(const double d, printbuffer * const output_buffer)
+{
+    unsigned char *output_pointer = NULL;
+    int length = 0;
+    size_t i = 0;
+    unsigned char number_buffer[NUMBER_BUFFER_LENGTH];
+    unsigned char decimal_point = '.';
+
+    if (output_buffer == NULL)
+    {
+        return false;
+    }
+
+    length = format_double(d, number_buffer, &decimal_point);
+    if (length < 0)
+    {
+        return false;
+    }
+
+    /* reserve appropriate space in the output */
+    output_pointer = ensure(output_buffer, (size_t)length + sizeof(""));
+    if (output_pointer == NULL)
+    {
+        return false;
+    }
+
+    /* copy the printed number to the output and replace locale
+     * dependent decimal point with '.' */
+    for (i = 0; i < ((size_t)length); i++)
+    {
+        if (number_buffer[i] == decimal_point)
+        {
+            output_pointer[i] = '.';
+            continue;
+        }
+
+        output_pointer[i] = number_buffer[i];
+    }
+    output_pointer[i] = '\0';
+
+    output_buffer->offset += (size_t)length;
+
+    return true;
+}
+
+static cJSON_bool print_number(const cJSON * const item, printbuffer * const output_buffer)
+{
+    return print_double(item_number(item), output_buffer);
+}
+
+/* parse 4 digit hexadecimal number */
+static unsigned parse_hex4(const unsigned char * const input)
+{
+    unsigned int h = 0;
+    size_t i = 0;
+
+    for (i = 0; i < 4; i++)
+    {
+        /* parse digit */
+        if ((input[i] >= '0') && (input[i] <= '9'))
+        {
+            h += (unsigned int) input[i] - '0';
+        }
+        else if ((input[i] >= 'A') && (input[i] <= 'F'))
+        {
+            h += (unsigned int) 10 + input[i] - 'A';
+        }
+        else if ((input[i] >= 'a') && (input[i] <= 'f'))
+        {
+            h += (unsigned int) 10 + input[i] - 'a';
+        }
+        else /* invalid */
+        {
+            return 0;
+        }
+
+        if (i < 3)
+        {
+            /* shift left to make place for the next nibble */
+            h = h << 4;
+        }
+    }
+
+    return h;
+}
+
+/* converts a UTF-16 literal to UTF-8
+ * A literal can be one or two sequences of the form \uXXXX */
+static unsigned char utf16_literal_to_utf8(const unsigned char * const input_pointer, const unsigned char * const input_end, unsigned char **output_pointer)
+{
+    long unsigned int codepoint = 0;
+    unsigned int first_code = 0;
+    const unsigned char *first_sequence = input_pointer;
+    unsigned char utf8_length = 0;
+    unsigned char utf8_position = 0;
+    unsigned char sequence_length = 0;
+    unsigned char first_byte_mark = 0;
+
+    if ((input_end - first_sequence) < 6)
+    {
+        /* input ends unexpectedly */
+        goto fail;
+    }
+
+    /* get the first utf16 sequence */
+    first_code = parse_hex4(first_sequence + 2);
+
+    /* check that the code is valid */
+    if (((first_code >= 0xDC00) && (first_code <= 0xDFFF)))
+    {
+        goto fail;
+    }
+
+    /* UTF16 surrogate pair */
+    if ((first_code >= 0xD800) && (first_code <= 0xDBFF))
+    {
+        const unsigned char *second_sequence = first_sequence + 6;
+        unsigned int second_code = 0;
+        sequence_length = 12; /* \uXXXX\uXXXX */
+
+        if ((input_end - second_sequence) < 6)
+        {
+            /* input ends unexpectedly */
+            goto fail;
+        }
+
+        if ((second_sequence[0] != '\\') || (second_sequence[1] != 'u'))
+        {
+            /* missing second half of the surrogate pair */
+            goto fail;
+        }
+
+        /* get the second utf16 sequence */
+        second_code = parse_hex4(second_sequence + 2);
+        /* check that the code is valid */
+        if ((second_code < 0xDC00) || (second_code > 0xDFFF))
+        {
+            /* invalid second half of the surrogate pair */
+            goto fail;
+        }
+
+
+        /* calculate the unicode codepoint from the surrogate pair */
+        codepoint = 0x10000 + (((first_code & 0x3FF) << 10) | (second_code & 0x3FF));
+    }
+    else
+    {
+        sequence_length = 6; /* \uXXXX */
+        codepoint = first_code;
+    }
+
+    /* encode as UTF-8
+     * takes at maximum 4 bytes to encode:
+     * 11110xxx 10xxxxxx 10xxxxxx 10xxxxxx */
+    if (codepoint < 0x80)
+    {
+        /* normal ascii, encoding 0xxxxxxx */
+        utf8_length = 1;
+    }
+    else if (codepoint < 0x800)
+    {
+        /* two bytes, encoding 110xxxxx 10xxxxxx */
+        utf8_length = 2;
+        first_byte_mark = 0xC0; /* 11000000 */
+    }
+    else if (codepoint < 0x10000)
+    {
+        /* three bytes, encoding 1110xxxx 10xxxxxx 10xxxxxx */
+        utf8_length = 3;
+        first_byte_mark = 0xE0; /* 11100000 */
+    }
+    else if (codepoint <= 0x10FFFF)
+    {
+        /* four bytes, encoding 1110xxxx 10xxxxxx 10xxxxxx 10xxxxxx */
+        utf8_length = 4;
+        first_byte_mark = 0xF0; /* 11110000 */
+    }
+    else
+    {
+        /* invalid unicode codepoint */
+        goto fail;
+    }
+
+    /* encode as utf8 */
+    for (utf8_position = (unsigned char)(utf8_length - 1); utf8_position > 0; utf8_position--)
+    {
+        /* 10xxxxxx */
+        (*output_pointer)[utf8_position] = (unsigned char)((codepoint | 0x80) & 0xBF);
+        codepoint >>= 6;
+    }
+    /* encode first byte */
+    if (utf8_length > 1)
+    {
+        (*output_pointer)[0] = (unsigned char)((codepoint | first_byte_mark) & 0xFF);
+    }
+    else
+    {
+        (*output_pointer)[0] = (unsigned char)(codepoint & 0x7F);
+    }
+
+    *output_pointer += utf8_length;
+
+    return sequence_length;
+
+fail:
+    return 0;
+}
+
+/* Count the characters at the beginning of a string that can be copied as they are, that is
+ * everything up to the first quotation mark or backslash. If stop_at_control is set, this also
+ * stops at control characters, which have to be escaped when printing.
+ * Long runs without such characters are scanned 16 or 32 bytes at a time if the compiler targets
+ * SSE2 or AVX2. The last bytes and the block that contains a match are handled one at a time. */
+static size_t count_plain_characters(const unsigned char * const string, const size_t length, const cJSON_bool stop_at_control)
+{
+    size_t position = 0;
+
+#if defined(CJSON_SIMD_AVX2)
+    const __m256i quotes = _mm256_set1_epi8('\"');
+    const __m256i backslashes = _mm256_set1_epi8('\\');
+    const __m256i last_control = _mm256_set1_epi8(31);
+    while ((length - position) >= sizeof(__m256i))
+    {
+        __m256i block = _mm256_loadu_si256((const __m256i*)(string + position));
+        __m256i matches = _mm256_or_si256(_mm256_cmpeq_epi8(block, quotes), _mm256_cmpeq_epi8(block, backslashes));
+        if (stop_at_control)
+        {
+            /* unsigned block <= 31 */
+            matches = _mm256_or_si256(matches, _mm256_cmpeq_epi8(_mm256_min_epu8(block, last_control), block));
+        }
+        if (_mm256_movemask_epi8(matches) != 0)
+        {
+            break;
+        }
+        position += sizeof(__m256i);
+    }
+#elif defined(CJSON_SIMD_SSE2)
+    const __m128i quotes = _mm_set1_epi8('\"');
+    const __m128i backslashes = _mm_set1_epi8('\\');
+    const __m128i last_control = _mm_set1_epi8(31);
+    while ((length - position) >= sizeof(__m128i))
+    {
+        __m128i block = _mm_loadu_si128((const __m128i*)(string + position));
+        __m128i matches = _mm_or_si128(_mm_cmpeq_epi8(block, quotes), _mm_cmpeq_epi8(block, backslashes));
+        if (stop_at_control)
+        {
+            /* unsigned block <= 31 */
+            matches = _mm_or_si128(matches, _mm_cmpeq_epi8(_mm_min_epu8(block, last_control), block));
+        }
+        if (_mm_movemask_epi8(matches) != 0)
+        {
+            break;
+        }
+        position += sizeof(__m128i);
+    }
+#endif
+
+    while ((position < length)
+            && (string[position] != '\"')
+            && (string[position] != '\\')
+            && (!stop_at_control || (string[position] > 31)))
+    {
+        position++;
+    }
+
+    return position;
+}
+
+/* Parse the input text into an unescaped cinput, and populate item. */
+/* allow_inline lets short strings be stored in the item itself with CJSON_COMPACT_NODES, which can't be done for keys */
+static cJSON_bool parse_string_literal(cJSON * const item, parse_buffer * const input_buffer, const cJSON_bool allow_inline)
+{
+    const unsigned char *input_pointer = buffer_at_offset(input_buffer) + 1;
+    const unsigned char *input_end = buffer_at_offset(input_buffer) + 1;
+    unsigned char *output_pointer = NULL;
+    unsigned char *output = NULL;
+    cJSON_bool output_is_inline = false;
+
+    /* not a string */
+    if (buffer_at_offset(input_buffer)[0] != '\"')
+    {
+        goto fail;
+    }
+
+    {
+        /* calculate approximate size of the output (overestimate) */
+        size_t allocation_length = 0;
+        size_t skipped_bytes = 0;
+        while ((size_t)(input_end - input_buffer->content) < input_buffer->length)
+        {
+            input_end += count_plain_characters(input_end, input_buffer->length - (size_t)(input_end - input_buffer->content), false);
+            if (((size_t)(input_end - input_buffer->content) >= input_buffer->length) || (*input_end == '\"'))
+            {
+                break;
+            }
+
+            /* is escape sequence */
+            if (input_end[0] == '\\')
+            {
+                if ((size_t)(input_end + 1 - input_buffer->content) >= input_buffer->length)
+                {
+                    /* prevent buffer overflow when last input character is a backslash */
+                    goto fail;
+                }
+                skipped_bytes++;
+                input_end++;
+            }
+            input_end++;
+        }
+        if (((size_t)(input_end - input_buffer->content) >= input_buffer->length) || (*input_end != '\"'))
+        {
+            goto fail; /* string ended unexpectedly */
+        }
+
+        if (input_buffer->in_situ != NULL)
+        {
+            /* unescaping never makes a string longer, so it can be written over itself
+             * and the terminating zero takes the place of the closing quotation mark at the latest */
+            output = input_buffer->in_situ + (input_pointer - input_buffer->content);
+        }
+        else
+        {
+            /* This is at most how much we need for the output */
+            allocation_length = (size_t) (input_end - buffer_at_offset(input_buffer)) - skipped_bytes;
+#ifdef CJSON_COMPACT_NODES
+            /* allocation_length includes the opening quotation mark, so it has room for the zero */
+            output_is_inline = allow_inline && (allocation_length <= sizeof(item->value.inline_string));
+            if (output_is_inline)
+            {
+                output = (unsigned char*)item->value.inline_string;
+            }
+            else
+#else
+            (void)allow_inline;
+#endif
+            {
+                output = (unsigned char*)parse_allocate(input_buffer, allocation_length + sizeof(""));
+            }
+            if (output == NULL)
+            {
+                goto fail; /* allocation failure */
+            }
+        }
+    }
+
+    output_pointer = output;
+    /* loop through the string literal */
+    while (input_pointer < input_end)
+    {
+        if (*input_pointer != '\\')
+        {
+            /* copy everything up to the next escape sequence */
+            size_t plain_length = count_plain_characters(input_pointer, (size_t)(input_end - input_pointer), false);
+            if (plain_length == 0)
+            {
+                /* can't happen, quotation marks inside the string are escaped. But always make progress */
+                plain_length = 1;
+            }
+            if (output_pointer != input_pointer)
+            {
+                /* when parsing in situ, the output trails the input in the same buffer */
+                memmove(output_pointer, input_pointer, plain_length);
+            }
+            output_pointer += plain_length;
+            input_pointer += plain_length;
+        }
+        /* escape sequence */
+        else
+        {
+            unsigned char sequence_length = 2;
+            if ((input_end - input_pointer) < 1)
+            {
+                goto fail;
+            }
+
+            switch (input_pointer[1])
+            {
+                case 'b':
+                    *output_pointer++ = '\b';
+                    break;
+                case 'f':
+                    *output_pointer++ = '\f';
+                    break;
+                case 'n':
+                    *output_pointer++ = '\n';
+                    break;
+                case 'r':
+                    *output_pointer++ = '\r';
+                    break;
+                case 't':
+                    *output_pointer++ = '\t';
+                    break;
+                case '\"':
+                case '\\':
+                case '/':
+                    *output_pointer++ = input_pointer[1];
+                    break;
+
+                /* UTF-16 literal */
+                case 'u':
+                    sequence_length = utf16_literal_to_utf8(input_pointer, input_end, &output_pointer);
+                    if (sequence_length == 0)
+                    {
+                        /* failed to convert UTF16-literal to UTF-8 */
+                        goto fail;
+                    }
+                    break;
+
+                default:
+                    goto fail;
+            }
+            input_pointer += sequence_length;
+        }
+    }
+
+    /* zero terminate the output */
+    *output_pointer = '\0';
+
+    item->type = cJSON_String;
+#ifdef CJSON_COMPACT_NODES
+    if (output_is_inline)
+    {
+        item->type |= cJSON_StringIsInline;
+    }
+    else
+#endif
+    {
+        set_valuestring(item, (char*)output);
+    }
+
+    input_buffer->offset = (size_t) (input_end - input_buffer->content);
+    input_buffer->offset++;
+
+    return true;
+
+fail:
+    if ((output != NULL) && (input_buffer->in_situ == NULL) && !output_is_inline)
+    {
+        parse_deallocate(input_buffer, output);
+    }
+    if (output_is_inline)
+    {
+        /* the characters that have been unescaped already overwrote the string pointer */
+        set_valuestring(item, NULL);
+    }
+
+    if (input_pointer != NULL)
+    {
+        input_buffer->offset = (size_t)(input_pointer - input_buffer->content);
+    }
+
+    return false;
+}
+
+static cJSON_bool parse_string(cJSON * const item, parse_buffer * const input_buffer)
+{
+    return parse_string_literal(item, input_buffer, true);
+}
+
+/* number of additional characters needed for escaping a string */
+static size_t count_escape_characters(const unsigned char * const input, const unsigned char * const input_end)
+{
+    const unsigned char *input_pointer = NULL;
+    size_t escape_characters = 0;
+
+    for (input_pointer = input; input_pointer < input_end; input_pointer++)
+    {
+        input_pointer += count_plain_characters(input_pointer, (size_t)(input_end - input_pointer), true);
+        if (input_pointer == input_end)
+        {
+            break;
+        }
+
+        switch (*input_pointer)
+        {
+            case '\"':
+            case '\\':
+            case '\b':
+            case '\f':
+            case '\n':
+            case '\r':
+            case '\t':
+                /* one character escape sequence */
+                escape_characters++;
+                break;
+            default:
+                if (*input_pointer < 32)
+                {
+                    /* UTF-16 escape sequence uXXXX */
+                    escape_characters += 5;
+                }
+                break;
+        }
+    }
+
+    return escape_characters;
+}
+
+/* Render the cstring provided to an escaped version that can be printed. */
+static cJSON_bool print_string_ptr(const unsigned char * const input, printbuffer * const output_buffer)
+{
+    const unsigned char *input_pointer = NULL;
+    const unsigned char *input_end = NULL;
+    unsigned char *output = NULL;
+    unsigned char *output_pointer = NULL;
+    size_t output_length = 0;
+    /* numbers of additional characters needed for escaping */
+    size_t escape_characters = 0;
+
+    if (output_buffer == NULL)
+    {
+        return false;
+    }
+
+    /* empty string */
+    if (input == NULL)
+    {
+        output = ensure(output_buffer, sizeof("\"\""));
+        if (output == NULL)
+        {
+            return false;
+        }
+        strcpy((char*)output, "\"\"");
+
+        return true;
+    }
+
+    input_end = input + strlen((const char*)input);
+    escape_characters = count_escape_characters(input, input_end);
+    output_length = (size_t)(input_end - input) + escape_characters;
+
+    output = ensure(output_buffer, output_length + sizeof("\"\""));
+    if (output == NULL)
+    {
+        return false;
+    }
+
+    /* no characters have to be escaped */
+    if (escape_characters == 0)
+    {
+        output[0] = '\"';
+        memcpy(output + 1, input, output_length);
+        output[output_length + 1] = '\"';
+        output[output_length + 2] = '\0';
+
+        return true;
+    }
+
+    output[0] = '\"';
+    output_pointer = output + 1;
+    /* copy the string */
+    for (input_pointer = input; input_pointer < input_end; (void)input_pointer++, output_pointer++)
+    {
+        if ((*input_pointer > 31) && (*input_pointer != '\"') && (*input_pointer != '\\'))
+        {
+            /* normal characters, copy up to the next one that needs to be escaped */
+            size_t plain_length = count_plain_characters(input_pointer, (size_t)(input_end - input_pointer), true);
+            memcpy(output_pointer, input_pointer, plain_length);
+            output_pointer += plain_length - 1;
+            input_pointer += plain_length - 1;
+        }
+        else
+        {
+            /* character needs to be escaped */
+            *output_pointer++ = '\\';
+            switch (*input_pointer)
+            {
+                case '\\':
+                    *output_pointer = '\\';
+                    break;
+                case '\"':
+                    *output_pointer = '\"';
+                    break;
+                case '\b':
+                    *output_pointer = 'b';
+                    break;
+                case '\f':
+                    *output_pointer = 'f';
+                    break;
+                case '\n':
+                    *output_pointer = 'n';
+                    break;
+                case '\r':
+                    *output_pointer = 'r';
+                    break;
+                case '\t':
+                    *output_pointer = 't';
+                    break;
+                default:
+                    /* escape and print as unicode codepoint */
+                    sprintf((char*)output_pointer, "u%04x", *input_pointer);
+                    output_pointer += 4;
+                    break;
+            }
+        }
+    }
+    output[output_length + 1] = '\"';
+    output[output_length + 2] = '\0';
+
+    return true;
+}
+
+/* Invoke print_string_ptr (which is useful) on an item. */
+static cJSON_bool print_string(const cJSON * const item, printbuffer * const p)
+{
+    return print_string_ptr((unsigned char*)item_valuestring(item), p);
+}
+
+/* Predeclare these prototypes. */
+static cJSON_bool parse_value(cJSON * const item, parse_buffer * const input_buffer);
+static cJSON_bool print_value(const cJSON * const item, printbuffer * const output_buffer);
+static cJSON_bool parse_array(cJSON * const item, parse_buffer * const input_buffer);
+static cJSON_bool parse_array_elements(cJSON * const item, parse_buffer * const input_buffer, cJSON *head);
+static cJSON_bool print_array(const cJSON * const item, printbuffer * const output_buffer);
+static cJSON_bool parse_object(cJSON * const item, parse_buffer * const input_buffer);
+static cJSON_bool print_object(const cJSON * const item, printbuffer * const output_buffer);
+static cJSON_bool materialize(const cJSON * const item);
+static cJSON_bool make_writable(cJSON * const item, cJSON ** const child);
+static cJSON_bool printed_length(const cJSON * const item, const cJSON_bool format, const size_t depth, size_t * const length);
+static cJSON *create_number_list(const double * const numbers, const size_t count, const internal_hooks * const hooks);
+
+/* The first child of an array or object for reading, lazy items are parsed first. */
+static cJSON_bool read_children(const cJSON * const item, cJSON ** const child)
+{
+    if (!materialize(item))
+    {
+        return false;
+    }
+
+    *child = item->child;
+    return true;
+}
+
+/* Utility to jump whitespace and cr/lf */
+static parse_buffer *buffer_skip_whitespace(parse_buffer * const buffer)
+{
+    if ((buffer == NULL) || (buffer->content == NULL))
+    {
+        return NULL;
+    }
+
+    while (can_access_at_index(buffer, 0) && (buffer_at_offset(buffer)[0] <= 32))
+    {
+       buffer->offset++;
+    }
+
+    if (buffer->offset == buffer->length)
+    {
+        buffer->offset--;
+    }
+
+    return buffer;
+}
+
+/* skip whitespace up to the end of the buffer or a null terminator, returns false if anything else follows */
+static cJSON_bool buffer_is_at_end(parse_buffer * const buffer)
+{
+    while (can_access_at_index(buffer, 0) && (buffer_at_offset(buffer)[0] != '\0') && (buffer_at_offset(buffer)[0] <= 32))
+    {
+        buffer->offset++;
+    }
+
+    return cannot_access_at_index(buffer, 0) || (buffer_at_offset(buffer)[0] == '\0');
+}
+
+/* skip the UTF-8 BOM (byte order mark) if it is at the beginning of a buffer */
+static parse_buffer *skip_utf8_bom(parse_buffer * const buffer)
+{
+    if ((buffer == NULL) || (buffer->content == NULL) || (buffer->offset != 0))
+    {
+        return NULL;
+    }
+
+    if (can_access_at_index(buffer, 4) && (strncmp((const char*)buffer_at_offset(buffer), "\xEF\xBB\xBF", 3) == 0))
+    {
+        buffer->offset += 3;
+    }
+
+    return buffer;
+}
+
+/* Parse a whole document from the buffer. On failure the offset of the buffer is where the error occurred.
+ * If the buffer already has an arena, the document is added to it, otherwise use_arena creates a new one. */
+static cJSON *parse_document(parse_buffer * const buffer, const cJSON_bool require_null_terminated, const cJSON_bool use_arena)
+{
+    arena_document *document = NULL;
+    cJSON *item = NULL;
+
+    if (buffer->arena != NULL)
+    {
+        item = parse_new_item(buffer);
+        if (item == NULL) /* memory fail */
+        {
+            return NULL;
+        }
+    }
+    else if (use_arena)
+    {
+        document = arena_create(buffer->length, &buffer->hooks);
+        if (document == NULL) /* memory fail */
+        {
+            return NULL;
+        }
+        buffer->arena = &document->arena;
+        item = &document->root.item;
+    }
+    else
+    {
+        item = cJSON_New_Item(&buffer->hooks);
+        if (item == NULL) /* memory fail */
+        {
+            return NULL;
+        }
+    }
+
+    if (!parse_value(item, buffer_skip_whitespace(skip_utf8_bom(buffer))))
+    {
+        /* parse failure. ep is set. */
+        goto fail;
+    }
+    parse_finish_item(buffer, item);
+    if (document != NULL)
+    {
+        item->type |= cJSON_IsArenaRoot;
+    }
+
+    /* if we require null-terminated JSON without appended garbage, skip and then check for a null terminator,
+     * the end of a buffer without one counts as well */
+    if (require_null_terminated && !buffer_is_at_end(buffer))
+    {
+        goto fail;
+    }
+
+    return item;
+
+fail:
+    if (document != NULL)
+    {
+        arena_release(&document->arena);
+    }
+    else if (buffer->arena == NULL)
+    {
+        delete_item(item, &buffer->hooks);
+    }
+    /* a document in the arena of the caller is released together with the arena */
+
+    return NULL;
+}
+
+/* Parse an object - create a new root, and populate. */
+static cJSON *parse_root(const char *value, const char **return_parse_end, cJSON_bool require_null_terminated, cJSON_bool use_arena, char *in_situ, const internal_hooks * const hooks, const size_t lazy_depth, const cJSON_bool pack_numbers, cJSON_KeyTable * const keys)
+{
+    parse_buffer buffer = { 0, 0, 0, 0, { 0, 0, 0, NULL }, NULL, NULL, 0, 0, NULL };
+    cJSON *item = NULL;
+
+    /* reset error position */
+    global_error.json = NULL;
+    global_error.position = 0;
+
+    if (value == NULL)
+    {
+        return NULL;
+    }
+
+    buffer.content = (const unsigned char*)value;
+    buffer.length = strlen((const char*)value) + sizeof("");
+    buffer.offset = 0;
+    buffer.hooks = *hooks;
+    buffer.in_situ = (unsigned char*)in_situ;
+    buffer.lazy_depth = lazy_depth;
+    buffer.pack_numbers = pack_numbers;
+    buffer.keys = keys;
+
+    item = parse_document(&buffer, require_null_terminated, use_arena);
+    if (item != NULL)
+    {
+        if (return_parse_end)
+        {
+            *return_parse_end = (const char*)buffer_at_offset(&buffer);
+        }
+
+        return item;
+    }
+
+    {
+        error local_error;
+        local_error.json = (const unsigned char*)value;
+        local_error.position = 0;
+
+        if (buffer.offset < buffer.length)
+        {
+            local_error.position = buffer.offset;
+        }
+        else if (buffer.length > 0)
+        {
+            local_error.position = buffer.length - 1;
+        }
+
+        if (return_parse_end != NULL)
+        {
+            *return_parse_end = (const char*)local_error.json + local_error.position;
+        }
+
+        global_error = local_error;
+    }
+
+    return NULL;
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_ParseWithOpts(const char *value, const char **return_parse_end, cJSON_bool require_null_terminated)
+{
+    return parse_root(value, return_parse_end, require_null_terminated, false, NULL, &global_hooks, 0, false, NULL);
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_ParseWithContext(const char *value, const char **return_parse_end, cJSON_bool require_null_terminated, const cJSON_Context *context)
+{
+    internal_hooks hooks = context_hooks(context);
+    return parse_root(value, return_parse_end, require_null_terminated, false, NULL, &hooks, 0, false, NULL);
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_ParseWithKeyTable(const char *value, const char **return_parse_end, cJSON_bool require_null_terminated, cJSON_KeyTable *keys)
+{
+    if (keys == NULL)
+    {
+        return NULL;
+    }
+
+    return parse_root(value, return_parse_end, require_null_terminated, false, NULL, &global_hooks, 0, false, keys);
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_ParseWithArena(const char *value, const char **return_parse_end, cJSON_bool require_null_terminated)
+{
+    return parse_root(value, return_parse_end, require_null_terminated, true, NULL, &global_hooks, 0, false, NULL);
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_ParseInSitu(char *value)
+{
+    return parse_root(value, NULL, false, false, value, &global_hooks, 0, false, NULL);
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_ParseLazy(const char *value, const char **return_parse_end, cJSON_bool require_null_terminated, int depth)
+{
+    return parse_root(value, return_parse_end, require_null_terminated, false, NULL, &global_hooks, (depth > 1) ? (size_t)depth : 1, false, NULL);
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_ParsePacked(const char *value, const char **return_parse_end, cJSON_bool require_null_terminated)
+{
+    return parse_root(value, return_parse_end, require_null_terminated, false, NULL, &global_hooks, 0, true, NULL);
+}
+
+/* Default options for cJSON_Parse */
+CJSON_PUBLIC(cJSON *) cJSON_Parse(const char *value)
+{
+    return cJSON_ParseWithOpts(value, 0, 0);
+}
+
+/* States of the stream parser, what is expected next */
+typedef enum
+{
+    stream_value, /* a value, at the top level or after ':' or ',' in an array */
+    stream_value_or_end, /* a value or ']' after '[' */
+    stream_key, /* a key after ',' in an object */
+    stream_key_or_end, /* a key or '}' after '{' */
+    stream_colon, /* ':' after a key */
+    stream_comma_or_end, /* ',' or the end of the current object or array after a value */
+    stream_failed
+} stream_state;
+
+struct cJSON_StreamParser
+{
+    cJSON_EventCallback callback;
+    void *user_data;
+    stream_state state;
+    size_t depth;
+    /* one bit per level of nesting, set for objects */
+    unsigned char objects[(CJSON_NESTING_LIMIT + 7) / 8];
+    /* the end of the previous chunk that couldn't be parsed yet */
+    unsigned char *pending;
+    size_t pending_length;
+    size_t pending_capacity;
+    size_t offset; /* position of the start of pending in the input */
+    size_t scanned; /* how far the token at the start of pending has been scanned without finding its end */
+    size_t values; /* number of complete top level values */
+    cJSON_bool started; /* the beginning of the input has been seen, so it can't be a byte order mark anymore */
+    cJSON_bool needs_delimiter; /* the last top level value was a number or literal, so whitespace has to follow */
+    char *key; /* key of the current value, lives in strings */
+    parse_arena strings; /* memory for keys and strings, reset after every value */
+    internal_hooks hooks;
+};
+
+#define stream_in_object(parser) (((parser)->objects[((parser)->depth - 1) / 8] & (1 << (((parser)->depth - 1) % 8))) != 0)
+
+CJSON_PUBLIC(cJSON_StreamParser *) cJSON_CreateStreamParser(cJSON_EventCallback callback, void *user_data)
+{
+    cJSON_StreamParser *parser = NULL;
+
+    if (callback == NULL)
+    {
+        return NULL;
+    }
+
+    parser = (cJSON_StreamParser*)global_hooks.allocate(sizeof(cJSON_StreamParser), global_hooks.user_data);
+    if (parser == NULL)
+    {
+        return NULL;
+    }
+    memset(parser, '\0', sizeof(cJSON_StreamParser));
+
+    if (!arena_init(&parser->strings, arena_minimum_chunk_length, &global_hooks))
+    {
+        global_hooks.deallocate(parser, global_hooks.user_data);
+        return NULL;
+    }
+
+    parser->callback = callback;
+    parser->user_data = user_data;
+    parser->state = stream_value;
+    parser->hooks = global_hooks;
+
+    return parser;
+}
+
+CJSON_PUBLIC(void) cJSON_DeleteStreamParser(cJSON_StreamParser *parser)
+{
+    if (parser == NULL)
+    {
+        return;
+    }
+
+    arena_release(&parser->strings);
+    if (parser->pending != NULL)
+    {
+        parser->hooks.deallocate(parser->pending, parser->hooks.user_data);
+    }
+    parser->hooks.deallocate(parser, parser->hooks.user_data);
+}
+
+/* report an event, the memory of strings is reused afterwards unless the event is a key */
+static cJSON_bool stream_report(cJSON_StreamParser * const parser, int event, cJSON * const item)
+{
+    cJSON_bool keep_going = false;
+
+    if ((event != cJSON_EventKey) && (parser->depth > 0) && stream_in_object(parser))
+    {
+        item->string = parser->key;
+    }
+
+    keep_going = parser->callback(event, item, parser->user_data);
+
+    if (event != cJSON_EventKey)
+    {
+        parser->key = NULL;
+        arena_reset(&parser->strings);
+    }
+
+    return keep_going;
+}
+
+/* the state after a complete value */
+static void stream_value_done(cJSON_StreamParser * const parser)
+{
+    if (parser->depth == 0)
+    {
+        parser->values++;
+        parser->state = stream_value;
+    }
+    else
+    {
+        parser->state = stream_comma_or_end;
+    }
+}
+
+/* Check if the whole token at the offset is in the buffer. Tokens that can only be completed
+ * by the next chunk return false, so that they are parsed again once it has arrived. Where their
+ * scan stopped is kept in scanned, so the next chunk continues from there instead of from the start. */
+static cJSON_bool stream_token_is_complete(const parse_buffer * const buffer, const cJSON_bool final, size_t * const scanned)
+{
+    const unsigned char *token = buffer_at_offset(buffer);
+    size_t length = buffer->length - buffer->offset;
+    size_t position = (*scanned > 1) ? *scanned : 1;
+
+    *scanned = 0;
+    if (final)
+    {
+        return true;
+    }
+
+    switch (token[0])
+    {
+        case '\"':
+            while (position < length)
+            {
+                position += count_plain_characters(token + position, length - position, false);
+                if (position >= length)
+                {
+                    break;
+                }
+                if (token[position] == '\"')
+                {
+                    return true;
+                }
+                /* skip the escaped character */
+                position += 2;
+            }
+            *scanned = position;
+            return false;
+
+        case 't':
+        case 'n':
+            return length >= 4;
+
+        case 'f':
+            return length >= 5;
+
+        case '-':
+        case '0':
+        case '1':
+        case '2':
+        case '3':
+        case '4':
+        case '5':
+        case '6':
+        case '7':
+        case '8':
+        case '9':
+            /* numbers end with the first character that can't be part of them */
+            while ((position < length) && (is_digit(token[position]) || (token[position] == '.')
+                        || (token[position] == '+') || (token[position] == '-')
+                        || (token[position] == 'e') || (token[position] == 'E')))
+            {
+                position++;
+            }
+            if (position >= length)
+            {
+                *scanned = position;
+                return false;
+            }
+            return true;
+
+        default:
+            /* not a value, parse_value will fail right away */
+            return true;
+    }
+}
+
+/* Parse as much of the input as possible. Returns the number of bytes that have been parsed. */
+static size_t stream_parse(cJSON_StreamParser * const parser, const unsigned char * const input, const size_t length, const cJSON_bool final)
+{
+    parse_buffer buffer = { 0, 0, 0, 0, { 0, 0, 0, NULL }, NULL, NULL, 0, 0, NULL };
+    cJSON item[1];
+
+    buffer.content = input;
+    buffer.length = length;
+    buffer.hooks = parser->hooks;
+    buffer.arena = &parser->strings;
+
+    if (!parser->started)
+    {
+        /* skip the UTF-8 BOM (byte order mark) */
+        if (!final && ((length == 0) || ((length < 3) && (memcmp(input, "\xEF\xBB\xBF", length) == 0))))
+        {
+            return 0;
+        }
+        if ((length >= 3) && (memcmp(input, "\xEF\xBB\xBF", 3) == 0))
+        {
+            buffer.offset = 3;
+        }
+        parser->started = true;
+    }
+
+    while (parser->state != stream_failed)
+    {
+        unsigned char current = 0;
+        size_t token_start = buffer.offset;
+
+        while (can_access_at_index(&buffer, 0) && (buffer_at_offset(&buffer)[0] <= 32))
+        {
+            buffer.offset++;
+        }
+        if (buffer.offset > token_start)
+        {
+            parser->needs_delimiter = false;
+        }
+        if (cannot_access_at_index(&buffer, 0))
+        {
+            break;
+        }
+
+        current = buffer_at_offset(&buffer)[0];
+        memset(item, '\0', sizeof(item));
+        buffer.depth = parser->depth;
+
+        switch (parser->state)
+        {
+            case stream_value:
+            case stream_value_or_end:
+                if (parser->needs_delimiter)
+                {
+                    goto fail; /* like truefalse or 1null, cJSON_Parse doesn't accept them either */
+                }
+                if ((current == '{') || (current == '['))
+                {
+                    if (parser->depth >= CJSON_NESTING_LIMIT)
+                    {
+                        goto fail; /* too deeply nested */
+                    }
+
+                    if (current == '{')
+                    {
+                        parser->objects[parser->depth / 8] |= (unsigned char)(1 << (parser->depth % 8));
+                        item->type = cJSON_Object;
+                    }
+                    else
+                    {
+                        parser->objects[parser->depth / 8] &= (unsigned char)~(1 << (parser->depth % 8));
+                        item->type = cJSON_Array;
+                    }
+                    /* the key belongs to the parent */
+                    if (!stream_report(parser, (current == '{') ? cJSON_EventObjectStart : cJSON_EventArrayStart, item))
+                    {
+                        goto fail;
+                    }
+                    parser->depth++;
+                    parser->state = (current == '{') ? stream_key_or_end : stream_value_or_end;
+                    buffer.offset++;
+                    break;
+                }
+
+                if ((current == ']') && (parser->state == stream_value_or_end))
+                {
+                    goto end_container;
+                }
+
+                if (!stream_token_is_complete(&buffer, final, &parser->scanned))
+                {
+                    goto need_more;
+                }
+                if ((current == '[') || (current == '{') || !parse_value(item, &buffer))
+                {
+                    goto fail;
+                }
+                if (!stream_report(parser, cJSON_EventValue, item))
+                {
+                    goto fail;
+                }
+                /* strings end with their quote, numbers and literals need whitespace after them */
+                parser->needs_delimiter = (parser->depth == 0) && !cJSON_IsString(item);
+                stream_value_done(parser);
+                break;
+
+            case stream_key:
+            case stream_key_or_end:
+                if ((current == '}') && (parser->state == stream_key_or_end))
+                {
+                    goto end_container;
+                }
+
+                if (current != '\"')
+                {
+                    goto fail; /* keys have to be strings */
+                }
+                if (!stream_token_is_complete(&buffer, final, &parser->scanned))
+                {
+                    goto need_more;
+                }
+                if (!parse_string_literal(item, &buffer, false))
+                {
+                    goto fail;
+                }
+                parser->key = item_valuestring(item);
+                if (!stream_report(parser, cJSON_EventKey, item))
+                {
+                    goto fail;
+                }
+                parser->state = stream_colon;
+                break;
+
+            case stream_colon:
+                if (current != ':')
+                {
+                    goto fail;
+                }
+                buffer.offset++;
+                parser->state = stream_value;
+                break;
+
+            case stream_comma_or_end:
+                if (current == ',')
+                {
+                    buffer.offset++;
+                    parser->state = stream_in_object(parser) ? stream_key : stream_value;
+                    break;
+                }
+                goto end_container;
+
+            case stream_failed:
+            default:
+                goto fail;
+        }
+        continue;
+
+end_container:
+        if ((current != (stream_in_object(parser) ? '}' : ']')))
+        {
+            goto fail;
+        }
+        item->type = stream_in_object(parser) ? cJSON_Object : cJSON_Array;
+        parser->depth--;
+        if (!stream_report(parser, (item->type == cJSON_Object) ? cJSON_EventObjectEnd : cJSON_EventArrayEnd, item))
+        {
+            goto fail;
+        }
+        buffer.offset++;
+        stream_value_done(parser);
+    }
+
+need_more:
+    return buffer.offset;
+
+fail:
+    parser->state = stream_failed;
+    return buffer.offset;
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_StreamParserFeed(cJSON_StreamParser *parser, const char *chunk, size_t length)
+{
+    const unsigned char *input = (const unsigned char*)chunk;
+    size_t parsed = 0;
+
+    if ((parser == NULL) || (parser->state == stream_failed) || ((chunk == NULL) && (length > 0)))
+    {
+        return false;
+    }
+
+    if (parser->pending_length > 0)
+    {
+        /* continue the token that was cut off by the end of the previous chunk */
+        if ((parser->pending_capacity - parser->pending_length) < length)
+        {
+            unsigned char *pending = NULL;
+            size_t capacity = parser->pending_length + length;
+            if (capacity < length)
+            {
+                return false; /* overflow */
+            }
+            capacity = (capacity > (((size_t)-1) / 2)) ? capacity : (capacity * 2);
+
+            pending = (unsigned char*)parser->hooks.allocate(capacity, parser->hooks.user_data);
+            if (pending == NULL)
+            {
+                return false;
+            }
+            memcpy(pending, parser->pending, parser->pending_length);
+            parser->hooks.deallocate(parser->pending, parser->hooks.user_data);
+            parser->pending = pending;
+            parser->pending_capacity = capacity;
+        }
+        memcpy(parser->pending + parser->pending_length, input, length);
+        parser->pending_length += length;
+
+        parsed = stream_parse(parser, parser->pending, parser->pending_length, false);
+        if (parsed > 0)
+        {
+            memmove(parser->pending, parser->pending + parsed, parser->pending_length - parsed);
+            parser->pending_length -= parsed;
+        }
+        parser->offset += parsed;
+
+        return parser->state != stream_failed;
+    }
+
+    /* parse directly from the chunk and only keep what is left */
+    parsed = stream_parse(parser, input, length, false);
+    parser->offset += parsed;
+    if ((parser->state != stream_failed) && (parsed < length))
+    {
+        if (parser->pending_capacity < (length - parsed))
+        {
+            if (parser->pending != NULL)
+            {
+                parser->hooks.deallocate(parser->pending, parser->hooks.user_data);
+            }
+            parser->pending_capacity = 0;
+            parser->pending = (unsigned char*)parser->hooks.allocate(length - parsed, parser->hooks.user_data);
+            if (parser->pending == NULL)
+            {
+                parser->state = stream_failed;
+                return false;
+            }
+            parser->pending_capacity = length - parsed;
+        }
+        memcpy(parser->pending, input + parsed, length - parsed);
+        parser->pending_length = length - parsed;
+    }
+
+    return parser->state != stream_failed;
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_StreamParserFinish(cJSON_StreamParser *parser)
+{
+    size_t parsed = 0;
+
+    if ((parser == NULL) || (parser->state == stream_failed))
+    {
+        return false;
+    }
+
+    parsed = stream_parse(parser, parser->pending, parser->pending_length, true);
+    parser->offset += parsed;
+    parser->pending_length -= parsed;
+
+    /* the input has to end after a complete top level value */
+    if ((parser->state != stream_value) || (parser->depth != 0) || (parser->pending_length != 0) || (parser->values == 0))
+    {
+        parser->state = stream_failed;
+        return false;
+    }
+
+    return true;
+}
+
+CJSON_PUBLIC(size_t) cJSON_StreamParserGetOffset(const cJSON_StreamParser *parser)
+{
+    if (parser == NULL)
+    {
+        return 0;
+    }
+
+    return parser->offset;
+}
+
+/* A batch is cut into chunks of the input that the worker threads take one after another. A document belongs to the chunk
+ * its line starts in. Parsed chunks wait in a ring of slots until the calling thread has passed them to the callback.
+ * With use_arena every slot parses into its own arena that is reused for the next chunk, so the threads neither allocate
+ * per item nor free memory that another thread has allocated. */
+typedef struct
+{
+    const unsigned char *record;
+    size_t length;
+    cJSON *item;
+} batch_record;
+
+typedef struct
+{
+    batch_record *records;
+    size_t count;
+    size_t capacity;
+    parse_arena arena;
+    cJSON_bool done;
+    cJSON_bool failed;
+} batch_slot;
+
+typedef struct
+{
+    const unsigned char *content;
+    size_t length;
+    cJSON_bool use_arena;
+    internal_hooks hooks;
+    batch_slot *slots;
+    size_t slot_count;
+    size_t chunk_count;
+    size_t next_chunk; /* the next chunk a worker can take */
+    size_t delivered_chunks; /* chunks before this have been passed to the callback, their slots can be reused */
+    cJSON_bool stop;
+#if defined(CJSON_PTHREADS)
+    pthread_mutex_t mutex;
+    pthread_cond_t slot_free;
+    pthread_cond_t chunk_done;
+#elif defined(CJSON_WIN32_THREADS)
+    CRITICAL_SECTION mutex;
+    CONDITION_VARIABLE slot_free;
+    CONDITION_VARIABLE chunk_done;
+#endif
+} batch_parser;
+
+static const size_t batch_chunk_length = 64 * 1024;
+
+/* length of the record that starts at offset, without the newline */
+static size_t batch_record_length(const batch_parser * const parser, size_t offset)
+{
+    const unsigned char *newline = (const unsigned char*)memchr(parser->content + offset, '\n', parser->length - offset);
+    if (newline == NULL)
+    {
+        return parser->length - offset;
+    }
+
+    return (size_t)(newline - (parser->content + offset));
+}
+
+/* returns false for blank records, item is NULL if the record is invalid */
+static cJSON_bool batch_parse_record(const batch_parser * const parser, parse_arena * const arena, const unsigned char * const record, const size_t length, cJSON **item)
+{
+    parse_buffer buffer = { 0, 0, 0, 0, { 0, 0, 0, NULL }, NULL, NULL, 0, 0, NULL };
+    buffer.content = record;
+    buffer.length = length;
+    buffer.hooks = parser->hooks;
+    buffer.arena = arena;
+
+    if (buffer_is_at_end(&buffer) && (buffer.offset == length))
+    {
+        return false;
+    }
+    buffer.offset = 0;
+
+    *item = parse_document(&buffer, true, false);
+    return true;
+}
+
+/* parse and deliver one record after the other on the calling thread */
+static cJSON_bool batch_parse_sequential(const batch_parser * const parser, cJSON_BatchCallback callback, void *context)
+{
+    parse_arena arena;
+    size_t offset = 0;
+    size_t index = 0;
+    cJSON_bool success = true;
+
+    if (parser->use_arena && !arena_init(&arena, arena_minimum_chunk_length, &parser->hooks))
+    {
+        return false;
+    }
+
+    while (success && (offset < parser->length))
+    {
+        const size_t length = batch_record_length(parser, offset);
+        cJSON *item = NULL;
+        if (batch_parse_record(parser, parser->use_arena ? &arena : NULL, parser->content + offset, length, &item))
+        {
+            success = callback(item, index, (const char*)parser->content + offset, length, context);
+            index++;
+            if (parser->use_arena)
+            {
+                arena_reset(&arena);
+            }
+        }
+
+        offset += length + 1;
+    }
+
+    if (parser->use_arena)
+    {
+        arena_release(&arena);
+    }
+
+    return success;
+}
+
+#if defined(CJSON_PTHREADS) || defined(CJSON_WIN32_THREADS)
+static const size_t batch_slots_per_thread = 4;
+
+static void batch_delete(const batch_parser * const parser, cJSON * const item)
+{
+    /* the items of an arena are released with the arena */
+    if (!parser->use_arena)
+    {
+        cJSON_Delete(item);
+    }
+}
+
+static cJSON_bool batch_add_record(const batch_parser * const parser, batch_slot * const slot, const unsigned char * const record, const size_t length, cJSON * const item)
+{
+    if (slot->count == slot->capacity)
+    {
+        size_t capacity = (slot->capacity == 0) ? 64 : (slot->capacity * 2);
+        batch_record *records = NULL;
+        if (capacity > ((size_t)-1 / sizeof(batch_record)))
+        {
+            return false;
+        }
+
+        records = (batch_record*)parser->hooks.allocate(capacity * sizeof(batch_record), parser->hooks.user_data);
+        if (records == NULL)
+        {
+            return false;
+        }
+        if (slot->records != NULL)
+        {
+            memcpy(records, slot->records, slot->count * sizeof(batch_record));
+            parser->hooks.deallocate(slot->records, parser->hooks.user_data);
+        }
+        slot->records = records;
+        slot->capacity = capacity;
+    }
+
+    slot->records[slot->count].record = record;
+    slot->records[slot->count].length = length;
+    slot->records[slot->count].item = item;
+    slot->count++;
+
+    return true;
+}
+
+/* parse every document whose line starts in the chunk */
+static cJSON_bool batch_parse_chunk(const batch_parser * const parser, batch_slot * const slot, const size_t chunk)
+{
+    size_t offset = chunk * batch_chunk_length;
+    const size_t end = ((parser->length - offset) > batch_chunk_length) ? (offset + batch_chunk_length) : parser->length;
+
+    if (offset > 0)
+    {
+        /* skip the rest of a line that started in an earlier chunk, only looking inside this chunk so that
+         * a long line isn't searched again by every chunk it spans */
+        const unsigned char *newline = (const unsigned char*)memchr(parser->content + offset - 1, '\n', end - (offset - 1));
+        if (newline == NULL)
+        {
+            return true;
+        }
+        offset = (size_t)(newline - parser->content) + 1;
+    }
+
+    if (parser->use_arena)
+    {
+        arena_reset(&slot->arena);
+    }
+
+    while (offset < end)
+    {
+        const size_t length = batch_record_length(parser, offset);
+        cJSON *item = NULL;
+        if (batch_parse_record(parser, parser->use_arena ? &slot->arena : NULL, parser->content + offset, length, &item)
+                && !batch_add_record(parser, slot, parser->content + offset, length, item))
+        {
+            batch_delete(parser, item);
+            return false;
+        }
+
+        offset += length + 1;
+    }
+
+    return true;
+}
+
+#if defined(CJSON_PTHREADS)
+typedef pthread_t batch_thread;
+
+static cJSON_bool batch_init_sync(batch_parser * const parser)
+{
+    if (pthread_mutex_init(&parser->mutex, NULL) != 0)
+    {
+        return false;
+    }
+    if (pthread_cond_init(&parser->slot_free, NULL) != 0)
+    {
+        pthread_mutex_destroy(&parser->mutex);
+        return false;
+    }
+    if (pthread_cond_init(&parser->chunk_done, NULL) != 0)
+    {
+        pthread_cond_destroy(&parser->slot_free);
+        pthread_mutex_destroy(&parser->mutex);
+        return false;
+    }
+
+    return true;
+}
+
+static void batch_destroy_sync(batch_parser * const parser)
+{
+    pthread_cond_destroy(&parser->chunk_done);
+    pthread_cond_destroy(&parser->slot_free);
+    pthread_mutex_destroy(&parser->mutex);
+}
+
+static void batch_lock(batch_parser * const parser)
+{
+    pthread_mutex_lock(&parser->mutex);
+}
+
+static void batch_unlock(batch_parser * const parser)
+{
+    pthread_mutex_unlock(&parser->mutex);
+}
+
+static void batch_wait_for_slot(batch_parser * const parser)
+{
+    pthread_cond_wait(&parser->slot_free, &parser->mutex);
+}
+
+static void batch_wait_for_chunk(batch_parser * const parser)
+{
+    pthread_cond_wait(&parser->chunk_done, &parser->mutex);
+}
+
+static void batch_signal_slots(batch_parser * const parser)
+{
+    pthread_cond_broadcast(&parser->slot_free);
+}
+
+static void batch_signal_chunk(batch_parser * const parser)
+{
+    pthread_cond_signal(&parser->chunk_done);
+}
+#else
+typedef HANDLE batch_thread;
+
+static cJSON_bool batch_init_sync(batch_parser * const parser)
+{
+    InitializeCriticalSection(&parser->mutex);
+    InitializeConditionVariable(&parser->slot_free);
+    InitializeConditionVariable(&parser->chunk_done);
+
+    return true;
+}
+
+static void batch_destroy_sync(batch_parser * const parser)
+{
+    DeleteCriticalSection(&parser->mutex);
+}
+
+static void batch_lock(batch_parser * const parser)
+{
+    EnterCriticalSection(&parser->mutex);
+}
+
+static void batch_unlock(batch_parser * const parser)
+{
+    LeaveCriticalSection(&parser->mutex);
+}
+
+static void batch_wait_for_slot(batch_parser * const parser)
+{
+    SleepConditionVariableCS(&parser->slot_free, &parser->mutex, INFINITE);
+}
+
+static void batch_wait_for_chunk(batch_parser * const parser)
+{
+    SleepConditionVariableCS(&parser->chunk_done, &parser->mutex, INFINITE);
+}
+
+static void batch_signal_slots(batch_parser * const parser)
+{
+    WakeAllConditionVariable(&parser->slot_free);
+}
+
+static void batch_signal_chunk(batch_parser * const parser)
+{
+    WakeConditionVariable(&parser->chunk_done);
+}
+#endif
+
+static void batch_work(batch_parser * const parser)
+{
+    batch_lock(parser);
+    for (;;)
+    {
+        size_t chunk = 0;
+        batch_slot *slot = NULL;
+        cJSON_bool success = false;
+
+        /* don't run further ahead of the callback than there are slots */
+        while (!parser->stop && (parser->next_chunk < parser->chunk_count) && ((parser->next_chunk - parser->delivered_chunks) >= parser->slot_count))
+        {
+            batch_wait_for_slot(parser);
+        }
+        if (parser->stop || (parser->next_chunk >= parser->chunk_count))
+        {
+            break;
+        }
+
+        chunk = parser->next_chunk++;
+        slot = &parser->slots[chunk % parser->slot_count];
+        batch_unlock(parser);
+
+        success = batch_parse_chunk(parser, slot, chunk);
+
+        batch_lock(parser);
+        slot->failed = !success;
+        slot->done = true;
+        batch_signal_chunk(parser);
+    }
+    batch_unlock(parser);
+}
+
+#if defined(CJSON_PTHREADS)
+static void *batch_worker(void *parser)
+{
+    batch_work((batch_parser*)parser);
+    return NULL;
+}
+
+static cJSON_bool batch_start_thread(batch_thread * const thread, batch_parser * const parser)
+{
+    return pthread_create(thread, NULL, batch_worker, parser) == 0;
+}
+
+static void batch_join_thread(batch_thread thread)
+{
+    pthread_join(thread, NULL);
+}
+#else
+static DWORD WINAPI batch_worker(LPVOID parser)
+{
+    batch_work((batch_parser*)parser);
+    return 0;
+}
+
+static cJSON_bool batch_start_thread(batch_thread * const thread, batch_parser * const parser)
+{
+    *thread = CreateThread(NULL, 0, batch_worker, parser, 0, NULL);
+    return *thread != NULL;
+}
+
+static void batch_join_thread(batch_thread thread)
+{
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+}
+#endif
+
+/* pass the chunks to the callback in order while the workers parse the next ones */
+static cJSON_bool batch_deliver(batch_parser * const parser, cJSON_BatchCallback callback, void *context)
+{
+    size_t chunk = 0;
+    size_t index = 0;
+
+    for (chunk = 0; chunk < parser->chunk_count; chunk++)
+    {
+        batch_slot *slot = &parser->slots[chunk % parser->slot_count];
+        size_t i = 0;
+
+        batch_lock(parser);
+        while (!slot->done)
+        {
+            batch_wait_for_chunk(parser);
+        }
+        batch_unlock(parser);
+
+        if (slot->failed)
+        {
+            return false;
+        }
+
+        for (i = 0; i < slot->count; i++)
+        {
+            batch_record *record = &slot->records[i];
+            cJSON *item = record->item;
+            record->item = NULL;
+            if (!callback(item, index, (const char*)record->record, record->length, context))
+            {
+                return false;
+            }
+            index++;
+        }
+
+        batch_lock(parser);
+        slot->count = 0;
+        slot->done = false;
+        parser->delivered_chunks++;
+        batch_signal_slots(parser);
+        batch_unlock(parser);
+    }
+
+    return true;
+}
+
+static cJSON_bool batch_parse_parallel(batch_parser * const parser, int thread_count, cJSON_BatchCallback callback, void *context)
+{
+    batch_thread *threads = NULL;
+    cJSON_bool success = false;
+    int started = 0;
+    size_t i = 0;
+
+    if ((size_t)thread_count > ((size_t)-1 / (batch_slots_per_thread * sizeof(batch_slot))))
+    {
+        return false;
+    }
+    parser->slot_count = (size_t)thread_count * batch_slots_per_thread;
+    parser->slots = (batch_slot*)parser->hooks.allocate(parser->slot_count * sizeof(batch_slot), parser->hooks.user_data);
+    if (parser->slots == NULL)
+    {
+        return false;
+    }
+    memset(parser->slots, '\0', parser->slot_count * sizeof(batch_slot));
+
+    threads = (batch_thread*)parser->hooks.allocate((size_t)thread_count * sizeof(batch_thread), parser->hooks.user_data);
+    if (threads == NULL)
+    {
+        goto cleanup;
+    }
+
+    if (parser->use_arena)
+    {
+        for (i = 0; i < parser->slot_count; i++)
+        {
+            if (!arena_init(&parser->slots[i].arena, arena_minimum_chunk_length, &parser->hooks))
+            {
+                goto cleanup;
+            }
+        }
+    }
+
+    if (!batch_init_sync(parser))
+    {
+        goto cleanup;
+    }
+
+    for (started = 0; started < thread_count; started++)
+    {
+        if (!batch_start_thread(&threads[started], parser))
+        {
+            break;
+        }
+    }
+
+    if (started > 0)
+    {
+        success = batch_deliver(parser, callback, context);
+    }
+    else
+    {
+        success = batch_parse_sequential(parser, callback, context);
+    }
+
+    batch_lock(parser);
+    parser->stop = true;
+    batch_signal_slots(parser);
+    batch_unlock(parser);
+    while (started > 0)
+    {
+        batch_join_thread(threads[--started]);
+    }
+    batch_destroy_sync(parser);
+
+cleanup:
+    /* documents that haven't been passed to the callback because it stopped */
+    for (i = 0; i < parser->slot_count; i++)
+    {
+        batch_slot *slot = &parser->slots[i];
+        size_t record = 0;
+        for (record = 0; record < slot->count; record++)
+        {
+            if (slot->records[record].item != NULL)
+            {
+                batch_delete(parser, slot->records[record].item);
+            }
+        }
+        if (slot->records != NULL)
+        {
+            parser->hooks.deallocate(slot->records, parser->hooks.user_data);
+        }
+        if (slot->arena.chunks != NULL)
+        {
+            arena_release(&slot->arena);
+        }
+    }
+    parser->hooks.deallocate(parser->slots, parser->hooks.user_data);
+    if (threads != NULL)
+    {
+        parser->hooks.deallocate(threads, parser->hooks.user_data);
+    }
+
+    return success;
+}
+#endif
+
+CJSON_PUBLIC(cJSON_bool) cJSON_ParseBatch(const char *buffer, size_t length, int thread_count, cJSON_bool use_arena, cJSON_BatchCallback callback, void *context)
+{
+    batch_parser parser;
+
+    if (((buffer == NULL) && (length > 0)) || (callback == NULL))
+    {
+        return false;
+    }
+
+    memset(&parser, '\0', sizeof(parser));
+    parser.content = (const unsigned char*)buffer;
+    parser.length = length;
+    parser.use_arena = use_arena;
+    parser.hooks = global_hooks;
+    parser.chunk_count = (length / batch_chunk_length) + (((length % batch_chunk_length) != 0) ? 1 : 0);
+
+#if defined(CJSON_PTHREADS) || defined(CJSON_WIN32_THREADS)
+    /* a single chunk can't be parsed in parallel */
+    if ((thread_count > 1) && (parser.chunk_count > 1))
+    {
+        return batch_parse_parallel(&parser, thread_count, callback, context);
+    }
+#else
+    (void)thread_count;
+#endif
+
+    return batch_parse_sequential(&parser, callback, context);
+}
+
+#define cjson_min(a, b) ((a < b) ? a : b)
+
+static unsigned char *print(const cJSON * const item, cJSON_bool format, const internal_hooks * const hooks)
+{
+    static const size_t default_buffer_size = 256;
+    printbuffer buffer[1];
+    unsigned char *printed = NULL;
+
+    memset(buffer, 0, sizeof(buffer));
+
+    /* create buffer */
+    buffer->buffer = (unsigned char*) hooks->allocate(default_buffer_size, hooks->user_data);
+    buffer->length = default_buffer_size;
+    buffer->format = format;
+    buffer->hooks = *hooks;
+    if (buffer->buffer == NULL)
+    {
+        goto fail;
+    }
+
+    /* print the value */
+    if (!print_value(item, buffer))
+    {
+        goto fail;
+    }
+    update_offset(buffer);
+
+    /* check if reallocate is available */
+    if (hooks->reallocate != NULL)
+    {
+        printed = (unsigned char*) hooks->reallocate(buffer->buffer, buffer->offset + 1, hooks->user_data);
+        if (printed == NULL) {
+            goto fail;
+        }
+        buffer->buffer = NULL;
+    }
+    else /* otherwise copy the JSON over to a new buffer */
+    {
+        printed = (unsigned char*) hooks->allocate(buffer->offset + 1, hooks->user_data);
+        if (printed == NULL)
+        {
+            goto fail;
+        }
+        memcpy(printed, buffer->buffer, cjson_min(buffer->length, buffer->offset + 1));
+        printed[buffer->offset] = '\0'; /* just to be sure */
+
+        /* free the buffer */
+        hooks->deallocate(buffer->buffer, hooks->user_data);
+    }
+
+    return printed;
+
+fail:
+    if (buffer->buffer != NULL)
+    {
+        hooks->deallocate(buffer->buffer, hooks->user_data);
+    }
+
+    if (printed != NULL)
+    {
+        hooks->deallocate(printed, hooks->user_data);
+    }
+
+    return NULL;
+}
+
+/* Render a cJSON item/entity/structure to text. */
+CJSON_PUBLIC(char *) cJSON_Print(const cJSON *item)
+{
+    return (char*)print(item, true, &global_hooks);
+}
+
+CJSON_PUBLIC(char *) cJSON_PrintUnformatted(const cJSON *item)
+{
+    return (char*)print(item, false, &global_hooks);
+}
+
+CJSON_PUBLIC(char *) cJSON_PrintWithContext(const cJSON *item, cJSON_bool format, const cJSON_Context *context)
+{
+    internal_hooks hooks = context_hooks(context);
+    return (char*)print(item, format, &hooks);
+}
+
+CJSON_PUBLIC(char *) cJSON_PrintBuffered(const cJSON *item, int prebuffer, cJSON_bool fmt)
+{
+    printbuffer p = { 0, 0, 0, 0, 0, 0, { 0, 0, 0, NULL }, NULL, NULL };
+
+    if (prebuffer < 0)
+    {
+        return NULL;
+    }
+
+    p.buffer = (unsigned char*)global_hooks.allocate((size_t)prebuffer, global_hooks.user_data);
+    if (!p.buffer)
+    {
+        return NULL;
+    }
+
+    p.length = (size_t)prebuffer;
+    p.offset = 0;
+    p.noalloc = false;
+    p.format = fmt;
+    p.hooks = global_hooks;
+
+    if (!print_value(item, &p))
+    {
+        global_hooks.deallocate(p.buffer, global_hooks.user_data);
+        return NULL;
+    }
+
+    return (char*)p.buffer;
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_PrintPreallocated(cJSON *item, char *buf, const int len, const cJSON_bool fmt)
+{
+    printbuffer p = { 0, 0, 0, 0, 0, 0, { 0, 0, 0, NULL }, NULL, NULL };
+
+    if ((len < 0) || (buf == NULL))
+    {
+        return false;
+    }
+
+    p.buffer = (unsigned char*)buf;
+    p.length = (size_t)len;
+    p.offset = 0;
+    p.noalloc = true;
+    p.format = fmt;
+    p.hooks = global_hooks;
+
+    return print_value(item, &p);
+}
+
+CJSON_PUBLIC(size_t) cJSON_PrintedLength(const cJSON *item, cJSON_bool format)
+{
+    size_t length = 0;
+
+    if (!printed_length(item, format, 0, &length))
+    {
+        return 0;
+    }
+
+    return length;
+}
+
+struct cJSON_PrintBuffer
+{
+    unsigned char *buffer;
+    size_t length;
+    internal_hooks hooks;
+};
+
+CJSON_PUBLIC(cJSON_PrintBuffer *) cJSON_CreatePrintBuffer(size_t initial_size)
+{
+    cJSON_PrintBuffer *print_buffer = (cJSON_PrintBuffer*)global_hooks.allocate(sizeof(cJSON_PrintBuffer), global_hooks.user_data);
+    if (print_buffer == NULL)
+    {
+        return NULL;
+    }
+    memset(print_buffer, '\0', sizeof(cJSON_PrintBuffer));
+    print_buffer->hooks = global_hooks;
+
+    if (initial_size > 0)
+    {
+        print_buffer->buffer = (unsigned char*)global_hooks.allocate(initial_size, global_hooks.user_data);
+        if (print_buffer->buffer == NULL)
+        {
+            global_hooks.deallocate(print_buffer, global_hooks.user_data);
+            return NULL;
+        }
+        print_buffer->length = initial_size;
+    }
+
+    return print_buffer;
+}
+
+CJSON_PUBLIC(const char *) cJSON_PrintToBuffer(cJSON_PrintBuffer *print_buffer, const cJSON *item, cJSON_bool format, size_t *length)
+{
+    printbuffer p = { 0, 0, 0, 0, 0, 0, { 0, 0, 0, NULL }, NULL, NULL };
+    cJSON_bool success = false;
+
+    if ((print_buffer == NULL) || (item == NULL))
+    {
+        return NULL;
+    }
+
+    if (print_buffer->buffer == NULL)
+    {
+        /* the first print (or the one after a failed one) allocates exactly what it needs */
+        size_t needed = 0;
+        if (!printed_length(item, format, 0, &needed))
+        {
+            return NULL;
+        }
+        print_buffer->buffer = (unsigned char*)print_buffer->hooks.allocate(needed + 1, print_buffer->hooks.user_data);
+        if (print_buffer->buffer == NULL)
+        {
+            return NULL;
+        }
+        print_buffer->length = needed + 1;
+    }
+
+    p.buffer = print_buffer->buffer;
+    p.length = print_buffer->length;
+    p.format = format;
+    p.hooks = print_buffer->hooks;
+
+    success = print_value(item, &p);
+    if (success)
+    {
+        update_offset(&p);
+    }
+
+    /* ensure may have grown the buffer, or freed it if that failed */
+    print_buffer->buffer = p.buffer;
+    print_buffer->length = (p.buffer != NULL) ? p.length : 0;
+    if (!success)
+    {
+        return NULL;
+    }
+
+    if (length != NULL)
+    {
+        *length = p.offset;
+    }
+
+    return (const char*)p.buffer;
+}
+
+CJSON_PUBLIC(void) cJSON_DeletePrintBuffer(cJSON_PrintBuffer *print_buffer)
+{
+    if (print_buffer == NULL)
+    {
+        return;
+    }
+
+    if (print_buffer->buffer != NULL)
+    {
+        print_buffer->hooks.deallocate(print_buffer->buffer, print_buffer->hooks.user_data);
+    }
+    print_buffer->hooks.deallocate(print_buffer, print_buffer->hooks.user_data);
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_PrintToWriter(const cJSON *item, cJSON_bool format, cJSON_WriteCallback write_callback, void *context)
+{
+    static const size_t writer_buffer_size = 4096;
+    printbuffer p = { 0, 0, 0, 0, 0, 0, { 0, 0, 0, NULL }, NULL, NULL };
+    cJSON_bool success = false;
+
+    if ((item == NULL) || (write_callback == NULL))
+    {
+        return false;
+    }
+
+    /* the buffer only grows beyond this if a single string or number doesn't fit */
+    p.buffer = (unsigned char*)global_hooks.allocate(writer_buffer_size, global_hooks.user_data);
+    if (p.buffer == NULL)
+    {
+        return false;
+    }
+    p.length = writer_buffer_size;
+    p.format = format;
+    p.hooks = global_hooks;
+    p.write = write_callback;
+    p.write_context = context;
+
+    if (print_value(item, &p))
+    {
+        update_offset(&p);
+        success = flush_printbuffer(&p);
+    }
+
+    /* ensure frees the buffer if it fails to grow it */
+    if (p.buffer != NULL)
+    {
+        global_hooks.deallocate(p.buffer, global_hooks.user_data);
+    }
+
+    return success;
+}
+
+#ifdef CJSON_FD_WRITE
+static cJSON_bool CJSON_CDECL write_to_fd(const char *data, size_t length, void *context)
+{
+    const int fd = *(const int*)context;
+
+    while (length > 0)
+    {
+#if defined(_WIN32)
+        const int written = _write(fd, data, (length > INT_MAX) ? INT_MAX : (unsigned int)length);
+#else
+        const ssize_t written = write(fd, data, length);
+        if ((written < 0) && (errno == EINTR))
+        {
+            continue;
+        }
+#endif
+        if (written <= 0)
+        {
+            return false;
+        }
+        data += written;
+        length -= (size_t)written;
+    }
+
+    return true;
+}
+#endif
+
+CJSON_PUBLIC(cJSON_bool) cJSON_PrintToFd(const cJSON *item, cJSON_bool format, int fd)
+{
+#ifdef CJSON_FD_WRITE
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    return cJSON_PrintToWriter(item, format, write_to_fd, &fd);
+#else
+    (void)item;
+    (void)format;
+    (void)fd;
+
+    return false;
+#endif
+}
+
+/* Skip an array or object by looking for its closing bracket, strings are skipped as a whole.
+ * The nesting limit is checked here for everything inside, so materialize doesn't have to know how deep the item is.
+ * Everything else is only checked once the text is parsed, see materialize. */
+static cJSON_bool skip_container(parse_buffer * const input_buffer)
+{
+    const unsigned char *content = input_buffer->content;
+    size_t position = input_buffer->offset;
+    size_t depth = 0;
+
+    for (; position < input_buffer->length; position++)
+    {
+        switch (content[position])
+        {
+            case '\"':
+                for (position++; (position < input_buffer->length) && (content[position] != '\"'); position++)
+                {
+                    if (content[position] == '\\')
+                    {
+                        position++; /* skip the escaped character */
+                    }
+                }
+                break;
+
+            case '[':
+            case '{':
+                depth++;
+                if ((input_buffer->depth + depth) > CJSON_NESTING_LIMIT)
+                {
+                    return false; /* to deeply nested */
+                }
+                break;
+
+            case ']':
+            case '}':
+                depth--;
+                if (depth == 0)
+                {
+                    input_buffer->offset = position + 1;
+                    return true;
+                }
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    return false;
+}
+
+/* Remember where an array or object starts and ends instead of parsing it */
+static cJSON_bool parse_lazy(cJSON * const item, parse_buffer * const input_buffer, const int type)
+{
+    size_t start = input_buffer->offset;
+    size_t length = 0;
+
+    if (!skip_container(input_buffer))
+    {
+        return false;
+    }
+
+    length = input_buffer->offset - start;
+    if (length > INT_MAX)
+    {
+        /* too long to be remembered */
+        input_buffer->offset = start;
+        return (type == cJSON_Array) ? parse_array(item, input_buffer) : parse_object(item, input_buffer);
+    }
+
+    item->type = type | cJSON_IsLazy;
+    set_valuestring(item, (char*)cast_away_const(input_buffer->content + start));
+    item->valueint = (int)length;
+
+    return true;
+}
+
+#define parse_is_lazy(buffer) (((buffer)->lazy_depth != 0) && ((buffer)->depth >= (buffer)->lazy_depth))
+
+#define starts_number(character) (((character) == '-') || (((character) >= '0') && ((character) <= '9')))
+
+/* Parse an array of numbers into a packed array. Arrays that are empty or don't start with a number are left to parse_array,
+ * if anything else than a number follows, the numbers in front of it become items and parse_array_elements continues from there. */
+static cJSON_bool parse_packed_array(cJSON * const item, parse_buffer * const input_buffer)
+{
+    size_t separator = input_buffer->offset;
+    double *numbers = NULL;
+    size_t count = 0;
+    size_t capacity = 0;
+    cJSON *head = NULL;
+    cJSON number;
+
+    if ((input_buffer->depth >= CJSON_NESTING_LIMIT) || (input_buffer->arena != NULL))
+    {
+        return parse_array(item, input_buffer);
+    }
+
+    do
+    {
+        separator = input_buffer->offset;
+        input_buffer->offset++;
+        buffer_skip_whitespace(input_buffer);
+        if (cannot_access_at_index(input_buffer, 0) || !starts_number(buffer_at_offset(input_buffer)[0]))
+        {
+            goto unpack; /* empty or not a number */
+        }
+
+        memset(&number, '\0', sizeof(number));
+        if (!parse_number(&number, input_buffer))
+        {
+            goto fail;
+        }
+
+        if (count == capacity)
+        {
+            double *new_numbers = NULL;
+            size_t new_capacity = (capacity == 0) ? 16 : (capacity * 2);
+            if ((new_capacity > (size_t)INT_MAX) || (new_capacity > ((size_t)-1 / sizeof(double))))
+            {
+                goto unpack; /* the count has to fit into valueint */
+            }
+            if (input_buffer->hooks.reallocate != NULL)
+            {
+                new_numbers = (double*)input_buffer->hooks.reallocate(numbers, new_capacity * sizeof(double), input_buffer->hooks.user_data);
+                if (new_numbers == NULL)
+                {
+                    goto fail;
+                }
+            }
+            else
+            {
+                new_numbers = (double*)input_buffer->hooks.allocate(new_capacity * sizeof(double), input_buffer->hooks.user_data);
+                if (new_numbers == NULL)
+                {
+                    goto fail;
+                }
+                if (numbers != NULL)
+                {
+                    memcpy(new_numbers, numbers, count * sizeof(double));
+                    input_buffer->hooks.deallocate(numbers, input_buffer->hooks.user_data);
+                }
+            }
+            numbers = new_numbers;
+            capacity = new_capacity;
+        }
+        numbers[count++] = item_number(&number);
+
+        buffer_skip_whitespace(input_buffer);
+    }
+    while (can_access_at_index(input_buffer, 0) && (buffer_at_offset(input_buffer)[0] == ','));
+
+    if (cannot_access_at_index(input_buffer, 0) || (buffer_at_offset(input_buffer)[0] != ']'))
+    {
+        goto fail;
+    }
+    input_buffer->offset++;
+
+    if ((count < capacity) && (input_buffer->hooks.reallocate != NULL))
+    {
+        /* give back what wasn't needed, it is fine to keep it if that fails */
+        double *new_numbers = (double*)input_buffer->hooks.reallocate(numbers, count * sizeof(double), input_buffer->hooks.user_data);
+        if (new_numbers != NULL)
+        {
+            numbers = new_numbers;
+        }
+    }
+
+    item->type = cJSON_Array | cJSON_IsLazy | cJSON_IsPacked;
+    set_valuestring(item, (char*)(void*)numbers);
+    item->valueint = (int)count;
+
+    return true;
+
+unpack:
+    input_buffer->offset = separator;
+    if (count == 0)
+    {
+        return parse_array(item, input_buffer);
+    }
+    head = create_number_list(numbers, count, &input_buffer->hooks);
+    input_buffer->hooks.deallocate(numbers, input_buffer->hooks.user_data);
+    if (head == NULL)
+    {
+        return false;
+    }
+    input_buffer->depth++;
+
+    return parse_array_elements(item, input_buffer, head);
+
+fail:
+    if (numbers != NULL)
+    {
+        input_buffer->hooks.deallocate(numbers, input_buffer->hooks.user_data);
+    }
+
+    return false;
+}
+
+/* Parser core - when encountering text, process appropriately. */
+static cJSON_bool parse_value(cJSON * const item, parse_buffer * const input_buffer)
+{
+    if ((input_buffer == NULL) || (input_buffer->content == NULL))
+    {
+        return false; /* no input */
+    }
+
+    /* parse the different types of values */
+    /* null */
+    if (can_read(input_buffer, 4) && (strncmp((const char*)buffer_at_offset(input_buffer), "null", 4) == 0))
+    {
+        item->type = cJSON_NULL;
+        input_buffer->offset += 4;
+        return true;
+    }
+    /* false */
+    if (can_read(input_buffer, 5) && (strncmp((const char*)buffer_at_offset(input_buffer), "false", 5) == 0))
+    {
+        item->type = cJSON_False;
+        input_buffer->offset += 5;
+        return true;
+    }
+    /* true */
+    if (can_read(input_buffer, 4) && (strncmp((const char*)buffer_at_offset(input_buffer), "true", 4) == 0))
+    {
+        item->type = cJSON_True;
+        item->valueint = 1;
+        input_buffer->offset += 4;
+        return true;
+    }
+    /* string */
+    if (can_access_at_index(input_buffer, 0) && (buffer_at_offset(input_buffer)[0] == '\"'))
+    {
+        return parse_string(item, input_buffer);
+    }
+    /* number */
+    if (can_access_at_index(input_buffer, 0) && ((buffer_at_offset(input_buffer)[0] == '-') || ((buffer_at_offset(input_buffer)[0] >= '0') && (buffer_at_offset(input_buffer)[0] <= '9'))))
+    {
+        return parse_number(item, input_buffer);
+    }
+    /* array */
+    if (can_access_at_index(input_buffer, 0) && (buffer_at_offset(input_buffer)[0] == '['))
+    {
+        if (parse_is_lazy(input_buffer))
+        {
+            return parse_lazy(item, input_buffer, cJSON_Array);
+        }
+        if (input_buffer->pack_numbers)
+        {
+            return parse_packed_array(item, input_buffer);
+        }
+        return parse_array(item, input_buffer);
+    }
+    /* object */
+    if (can_access_at_index(input_buffer, 0) && (buffer_at_offset(input_buffer)[0] == '{'))
+    {
+        if (parse_is_lazy(input_buffer))
+        {
+            return parse_lazy(item, input_buffer, cJSON_Object);
+        }
+        return parse_object(item, input_buffer);
+    }
+
+    return false;
+}
+
+/* Render a value to text. */
+static cJSON_bool print_value(const cJSON * const item, printbuffer * const output_buffer)
+{
+    unsigned char *output = NULL;
+
+    if ((item == NULL) || (output_buffer == NULL))
+    {
+        return false;
+    }
+
+    switch ((item->type) & 0xFF)
+    {
+        case cJSON_NULL:
+            output = ensure(output_buffer, 5);
+            if (output == NULL)
+            {
+                return false;
+            }
+            strcpy((char*)output, "null");
+            return true;
+
+        case cJSON_False:
+            output = ensure(output_buffer, 6);
+            if (output == NULL)
+            {
+                return false;
+            }
+            strcpy((char*)output, "false");
+            return true;
+
+        case cJSON_True:
+            output = ensure(output_buffer, 5);
+            if (output == NULL)
+            {
+                return false;
+            }
+            strcpy((char*)output, "true");
+            return true;
+
+        case cJSON_Number:
+            return print_number(item, output_buffer);
+
+        case cJSON_Raw:
+        {
+            size_t raw_length = 0;
+            if (item_valuestring(item) == NULL)
+            {
+                return false;
+            }
+
+            raw_length = strlen(item_valuestring(item)) + sizeof("");
+            output = ensure(output_buffer, raw_length);
+            if (output == NULL)
+            {
+                return false;
+            }
+            memcpy(output, item_valuestring(item), raw_length);
+            return true;
+        }
+
+        case cJSON_String:
+            return print_string(item, output_buffer);
+
+        case cJSON_Array:
+            return print_array(item, output_buffer);
+
+        case cJSON_Object:
+            return print_object(item, output_buffer);
+
+        default:
+            return false;
+    }
+}
+
+/* Add the length of the text that print_value produces for an item at the given depth to length, without the terminating zero.
+ * This has to stay in sync with print_value, print_array and print_object. */
+static cJSON_bool printed_length(const cJSON * const item, const cJSON_bool format, const size_t depth, size_t * const length)
+{
+    unsigned char number_buffer[NUMBER_BUFFER_LENGTH];
+    unsigned char decimal_point = '.';
+    const unsigned char *string = NULL;
+    cJSON *current_item = NULL;
+    int number_length = 0;
+    size_t i = 0;
+
+    if (item == NULL)
+    {
+        return false;
+    }
+
+    if (item_is_packed(item))
+    {
+        /* brackets and separators */
+        *length += 2;
+        if (item->valueint > 0)
+        {
+            *length += (size_t)(item->valueint - 1) * (size_t)(format ? 2 : 1);
+        }
+        for (i = 0; i < (size_t)item->valueint; i++)
+        {
+            number_length = format_double(packed_numbers(item)[i], number_buffer, &decimal_point);
+            if (number_length < 0)
+            {
+                return false;
+            }
+            *length += (size_t)number_length;
+        }
+        return true;
+    }
+
+    switch ((item->type) & 0xFF)
+    {
+        case cJSON_NULL:
+        case cJSON_True:
+            *length += 4;
+            return true;
+
+        case cJSON_False:
+            *length += 5;
+            return true;
+
+        case cJSON_Number:
+            number_length = format_double(item_number(item), number_buffer, &decimal_point);
+            if (number_length < 0)
+            {
+                return false;
+            }
+            *length += (size_t)number_length;
+            return true;
+
+        case cJSON_Raw:
+            if (item_valuestring(item) == NULL)
+            {
+                return false;
+            }
+            *length += strlen(item_valuestring(item));
+            return true;
+
+        case cJSON_String:
+            string = (const unsigned char*)item_valuestring(item);
+            *length += 2;
+            if (string != NULL)
+            {
+                const unsigned char *string_end = string + strlen((const char*)string);
+                *length += (size_t)(string_end - string) + count_escape_characters(string, string_end);
+            }
+            return true;
+
+        case cJSON_Array:
+            if (!read_children(item, &current_item))
+            {
+                return false;
+            }
+            /* [] */
+            *length += 2;
+            for (; current_item != NULL; current_item = current_item->next)
+            {
+                if (!printed_length(current_item, format, depth + 1, length))
+                {
+                    return false;
+                }
+                if (current_item->next != NULL)
+                {
+                    /* fmt: ", " */
+                    *length += (size_t)(format ? 2 : 1);
+                }
+            }
+            return true;
+
+        case cJSON_Object:
+            if (!read_children(item, &current_item))
+            {
+                return false;
+            }
+            /* {} and fmt: a newline after { and the indentation before } */
+            *length += format ? (3 + depth) : 2;
+            for (; current_item != NULL; current_item = current_item->next)
+            {
+                string = (const unsigned char*)current_item->string;
+                /* "": and fmt: indentation, a tab after : and a newline after each member */
+                *length += format ? (depth + 1 + 5) : 3;
+                if (string != NULL)
+                {
+                    const unsigned char *string_end = string + strlen((const char*)string);
+                    *length += (size_t)(string_end - string) + count_escape_characters(string, string_end);
+                }
+                if (!printed_length(current_item, format, depth + 1, length))
+                {
+                    return false;
+                }
+                if (current_item->next != NULL)
+                {
+                    *length += 1;
+                }
+            }
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+/* Build an array from input text. */
+static cJSON_bool parse_array(cJSON * const item, parse_buffer * const input_buffer)
+{
+    if (input_buffer->depth >= CJSON_NESTING_LIMIT)
+    {
+        return false; /* to deeply nested */
+    }
+    input_buffer->depth++;
+
+    if (buffer_at_offset(input_buffer)[0] != '[')
+    {
+        /* not an array */
+        return false;
+    }
+
+    input_buffer->offset++;
+    buffer_skip_whitespace(input_buffer);
+    if (can_access_at_index(input_buffer, 0) && (buffer_at_offset(input_buffer)[0] == ']'))
+    {
+        /* empty array */
+        input_buffer->depth--;
+        item->type = cJSON_Array;
+        input_buffer->offset++;
+        return true;
+    }
+
+    /* check if we skipped to the end of the buffer */
+    if (cannot_access_at_index(input_buffer, 0))
+    {
+        input_buffer->offset--;
+        return false;
+    }
+
+    /* step back to character in front of the first element */
+    input_buffer->offset--;
+
+    return parse_array_elements(item, input_buffer, NULL);
+}
+
+/* Parse the remaining elements of an array and append them to head (which can be NULL),
+ * the offset is at the character in front of the next element. */
+static cJSON_bool parse_array_elements(cJSON * const item, parse_buffer * const input_buffer, cJSON *head)
+{
+    cJSON *current_item = (head != NULL) ? head->prev : NULL;
+
+    /* loop through the comma separated array elements */
+    do
+    {
+        /* allocate next item */
+        cJSON *new_item = parse_new_item(input_buffer);
+        if (new_item == NULL)
+        {
+            goto fail; /* allocation failure */
+        }
+
+        /* attach next item to list */
+        if (head == NULL)
+        {
+            /* start the linked list */
+            current_item = head = new_item;
+        }
+        else
+        {
+            /* add to the end and advance */
+            current_item->next = new_item;
+            new_item->prev = current_item;
+            current_item = new_item;
+        }
+
+        /* parse next value */
+        input_buffer->offset++;
+        buffer_skip_whitespace(input_buffer);
+        if (!parse_value(current_item, input_buffer))
+        {
+            goto fail; /* failed to parse value */
+        }
+        parse_finish_item(input_buffer, current_item);
+        buffer_skip_whitespace(input_buffer);
+    }
+    while (can_access_at_index(input_buffer, 0) && (buffer_at_offset(input_buffer)[0] == ','));
+
+    if (cannot_access_at_index(input_buffer, 0) || buffer_at_offset(input_buffer)[0] != ']')
+    {
+        goto fail; /* expected end of array */
+    }
+
+    input_buffer->depth--;
+
+    head->prev = current_item;
+
+    item->type = cJSON_Array;
+    item->child = head;
+
+    input_buffer->offset++;
+
+    return true;
+
+fail:
+    if ((head != NULL) && (input_buffer->arena == NULL))
+    {
+        /* the unfinished item can already point into an in situ buffer */
+        parse_finish_item(input_buffer, current_item);
+        delete_item(head, &input_buffer->hooks);
+    }
+
+    return false;
+}
+
+/* Render an array to text */
+static cJSON_bool print_packed_array(const cJSON * const item, printbuffer * const output_buffer)
+{
+    unsigned char *output_pointer = NULL;
+    const double *numbers = packed_numbers(item);
+    size_t count = (size_t)item->valueint;
+    size_t i = 0;
+
+    output_pointer = ensure(output_buffer, 1);
+    if (output_pointer == NULL)
+    {
+        return false;
+    }
+    *output_pointer = '[';
+    output_buffer->offset++;
+
+    for (i = 0; i < count; i++)
+    {
+        if (i > 0)
+        {
+            size_t length = (size_t)(output_buffer->format ? 2 : 1);
+            output_pointer = ensure(output_buffer, length);
+            if (output_pointer == NULL)
+            {
+                return false;
+            }
+            *output_pointer++ = ',';
+            if (output_buffer->format)
+            {
+                *output_pointer = ' ';
+            }
+            output_buffer->offset += length;
+        }
+        if (!print_double(numbers[i], output_buffer))
+        {
+            return false;
+        }
+    }
+
+    output_pointer = ensure(output_buffer, 2);
+    if (output_pointer == NULL)
+    {
+        return false;
+    }
+    *output_pointer++ = ']';
+    *output_pointer = '\0';
+
+    return true;
+}
+
+static cJSON_bool print_array(const cJSON * const item, printbuffer * const output_buffer)
+{
+    unsigned char *output_pointer = NULL;
+    size_t length = 0;
+    cJSON *current_element = NULL;
+
+    if ((output_buffer != NULL) && item_is_packed(item))
+    {
+        return print_packed_array(item, output_buffer);
+    }
+    if ((output_buffer == NULL) || !read_children(item, &current_element))
+    {
+        return false;
+    }
+
+    /* Compose the output array. */
+    /* opening square bracket */
+    output_pointer = ensure(output_buffer, 1);
+    if (output_pointer == NULL)
+    {
+        return false;
+    }
+
+    *output_pointer = '[';
+    output_buffer->offset++;
+    output_buffer->depth++;
+
+    while (current_element != NULL)
+    {
+        if (!print_value(current_element, output_buffer))
+        {
+            return false;
+        }
+        update_offset(output_buffer);
+        if (current_element->next)
+        {
+            length = (size_t) (output_buffer->format ? 2 : 1);
+            output_pointer = ensure(output_buffer, length + 1);
+            if (output_pointer == NULL)
+            {
+                return false;
+            }
+            *output_pointer++ = ',';
+            if(output_buffer->format)
+            {
+                *output_pointer++ = ' ';
+            }
+            *output_pointer = '\0';
+            output_buffer->offset += length;
+        }
+        current_element = current_element->next;
+    }
+
+    output_pointer = ensure(output_buffer, 2);
+    if (output_pointer == NULL)
+    {
+        return false;
+    }
+    *output_pointer++ = ']';
+    *output_pointer = '\0';
+    output_buffer->depth--;
+
+    return true;
+}
+
+/* Parse the name of an object member into item->string, through the key table if there is one. */
+static cJSON_bool parse_key(cJSON * const item, parse_buffer * const input_buffer)
+{
+    char *parsed = NULL;
+
+    if ((input_buffer->keys != NULL) && can_access_at_index(input_buffer, 1) && (buffer_at_offset(input_buffer)[0] == '\"'))
+    {
+        /* keys without escape sequences are looked up right in the input */
+        const unsigned char *key = buffer_at_offset(input_buffer) + 1;
+        size_t remaining = input_buffer->length - input_buffer->offset - 1;
+        size_t length = count_plain_characters(key, remaining, false);
+        if ((length < remaining) && (key[length] == '\"'))
+        {
+            item->string = (char*)cast_away_const(key_table_intern(input_buffer->keys, key, length));
+            if (item->string == NULL)
+            {
+                return false;
+            }
+            input_buffer->offset += length + 2;
+
+            return true;
+        }
+    }
+
+    if (!parse_string_literal(item, input_buffer, false))
+    {
+        return false;
+    }
+
+    /* swap valuestring and string, because we parsed the name */
+    item->string = item_valuestring(item);
+    set_valuestring(item, NULL);
+
+    if (input_buffer->keys != NULL)
+    {
+        parsed = item->string;
+        item->string = (char*)cast_away_const(key_table_intern(input_buffer->keys, (const unsigned char*)parsed, strlen(parsed)));
+        if (input_buffer->in_situ == NULL)
+        {
+            parse_deallocate(input_buffer, parsed);
+        }
+        if (item->string == NULL)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/* Build an object from the text. */
+static cJSON_bool parse_object(cJSON * const item, parse_buffer * const input_buffer)
+{
+    cJSON *head = NULL; /* linked list head */
+    cJSON *current_item = NULL;
+
+    if (input_buffer->depth >= CJSON_NESTING_LIMIT)
+    {
+        return false; /* to deeply nested */
+    }
+    input_buffer->depth++;
+
+    if (cannot_access_at_index(input_buffer, 0) || (buffer_at_offset(input_buffer)[0] != '{'))
+    {
+        goto fail; /* not an object */
+    }
+
+    input_buffer->offset++;
+    buffer_skip_whitespace(input_buffer);
+    if (can_access_at_index(input_buffer, 0) && (buffer_at_offset(input_buffer)[0] == '}'))
+    {
+        goto success; /* empty object */
+    }
+
+    /* check if we skipped to the end of the buffer */
+    if (cannot_access_at_index(input_buffer, 0))
+    {
+        input_buffer->offset--;
+        goto fail;
+    }
+
+    /* step back to character in front of the first element */
+    input_buffer->offset--;
+    /* loop through the comma separated array elements */
+    do
+    {
+        /* allocate next item */
+        cJSON *new_item = parse_new_item(input_buffer);
+        if (new_item == NULL)
+        {
+            goto fail; /* allocation failure */
+        }
+
+        /* attach next item to list */
+        if (head == NULL)
+        {
+            /* start the linked list */
+            current_item = head = new_item;
+        }
+        else
+        {
+            /* add to the end and advance */
+            current_item->next = new_item;
+            new_item->prev = current_item;
+            current_item = new_item;
+        }
+
+        /* parse the name of the child */
+        input_buffer->offset++;
+        buffer_skip_whitespace(input_buffer);
+        if (!parse_key(current_item, input_buffer))
+        {
+            goto fail; /* failed to parse name */
+        }
+        buffer_skip_whitespace(input_buffer);
+
+        if (cannot_access_at_index(input_buffer, 0) || (buffer_at_offset(input_buffer)[0] != ':'))
+        {
+            goto fail; /* invalid object */
+        }
+
+        /* parse the value */
+        input_buffer->offset++;
+        buffer_skip_whitespace(input_buffer);
+        if (!parse_value(current_item, input_buffer))
+        {
+            goto fail; /* failed to parse value */
+        }
+        parse_finish_item(input_buffer, current_item);
+        buffer_skip_whitespace(input_buffer);
+    }
+    while (can_access_at_index(input_buffer, 0) && (buffer_at_offset(input_buffer)[0] == ','));
+
+    if (cannot_access_at_index(input_buffer, 0) || (buffer_at_offset(input_buffer)[0] != '}'))
+    {
+        goto fail; /* expected end of object */
+    }
+
+success:
+    input_buffer->depth--;
+
+    if (head != NULL)
+    {
+        head->prev = current_item;
+    }
+
+    item->type = cJSON_Object;
+    item->child = head;
+
+    input_buffer->offset++;
+    return true;
+
+fail:
+    if ((head != NULL) && (input_buffer->arena == NULL))
+    {
+        /* the unfinished item can already point into an in situ buffer */
+        parse_finish_item(input_buffer, current_item);
+        delete_item(head, &input_buffer->hooks);
+    }
+
+    return false;
+}
+
+/* The validator follows parse_value, parse_string_literal, parse_array and parse_object step by step,
+ * so it accepts the same input and fails at the same offsets, but it only moves through the input. */
+static cJSON_bool validate_value(parse_buffer * const input_buffer);
+
+/* Unlike buffer_skip_whitespace this doesn't step back at the end of the buffer. The parser always sees the null terminator there,
+ * the validator has to stop at the end of the buffer instead, which puts errors at the same position. */
+static void validate_skip_whitespace(parse_buffer * const buffer)
+{
+    while (can_access_at_index(buffer, 0) && (buffer_at_offset(buffer)[0] <= 32))
+    {
+        buffer->offset++;
+    }
+}
+
+static cJSON_bool validate_string(parse_buffer * const input_buffer)
 {
     const unsigned char *input_pointer = buffer_at_offset(input_buffer) + 1;
     const unsigned char *input_end = buffer_at_offset(input_buffer) + 1;
+    const unsigned char *content_end = input_buffer->content + input_buffer->length;
+    cJSON_bool has_escapes = false;
+
+    /* not a string */
+    if (buffer_at_offset(input_buffer)[0] != '\"')
+    {
+        goto fail;
+    }
+
+    /* find the end of the string */
+    while (input_end < content_end)
+    {
+        input_end += count_plain_characters(input_end, (size_t)(content_end - input_end), false);
+        if ((input_end >= content_end) || (*input_end == '\"'))
+        {
+            break;
+        }
+
+        /* is escape sequence */
+        if ((input_end + 1) >= content_end)
+        {
+            goto fail;
+        }
+        has_escapes = true;
+        input_end += 2;
+    }
+    if ((input_end >= content_end) || (*input_end != '\"'))
+    {
+        goto fail; /* string ended unexpectedly */
+    }
+
+    /* check the escape sequences */
+    while (has_escapes && (input_pointer < input_end))
+    {
+        unsigned char sequence_length = 2;
+        unsigned char utf8[4];
+        unsigned char *utf8_pointer = utf8;
+
+        input_pointer += count_plain_characters(input_pointer, (size_t)(input_end - input_pointer), false);
+        if (input_pointer >= input_end)
+        {
+            break;
+        }
+
+        switch (input_pointer[1])
+        {
+            case 'b':
+            case 'f':
+            case 'n':
+            case 'r':
+            case 't':
+            case '\"':
+            case '\\':
+            case '/':
+                break;
+
+            /* UTF-16 literal */
+            case 'u':
+                sequence_length = utf16_literal_to_utf8(input_pointer, input_end, &utf8_pointer);
+                if (sequence_length == 0)
+                {
+                    goto fail;
+                }
+                break;
+
+            default:
+                goto fail;
+        }
+        input_pointer += sequence_length;
+    }
+
+    input_buffer->offset = (size_t)(input_end - input_buffer->content) + 1;
+
+    return true;
+
+fail:
+    input_buffer->offset = (size_t)(input_pointer - input_buffer->content);
+
+    return false;
+}
+
+/* Returns the length of the number that parse_decimal_number reads from input without calculating its value.
+ * This follows the grammar of strtod, numbers that don't fit into the buffer of parse_number_strtod are left to parse_decimal_number. */
+static size_t validate_number(const unsigned char * const input, const size_t length)
+{
+    size_t position = 0;
+    size_t mantissa_end = 0;
+    size_t digits = 0;
+    double number = 0;
+
+    if ((position < length) && ((input[position] == '-') || (input[position] == '+')))
+    {
+        position++;
+    }
+    for (; (position < length) && is_digit(input[position]); position++)
+    {
+        digits++;
+    }
+    if ((position < length) && (input[position] == '.'))
+    {
+        for (position++; (position < length) && is_digit(input[position]); position++)
+        {
+            digits++;
+        }
+    }
+    if (digits == 0)
+    {
+        return 0;
+    }
+
+    /* an exponent without digits isn't part of the number */
+    mantissa_end = position;
+    if ((position < length) && ((input[position] == 'e') || (input[position] == 'E')))
+    {
+        position++;
+        if ((position < length) && ((input[position] == '+') || (input[position] == '-')))
+        {
+            position++;
+        }
+        if ((position >= length) || !is_digit(input[position]))
+        {
+            position = mantissa_end;
+        }
+        while ((position < length) && is_digit(input[position]))
+        {
+            position++;
+        }
+    }
+
+    if (position >= 64)
+    {
+        return parse_decimal_number(input, length, '.', &number);
+    }
+
+    return position;
+}
+
+static cJSON_bool validate_array(parse_buffer * const input_buffer)
+{
+    if (input_buffer->depth >= CJSON_NESTING_LIMIT)
+    {
+        return false; /* to deeply nested */
+    }
+    input_buffer->depth++;
+
+    input_buffer->offset++;
+    validate_skip_whitespace(input_buffer);
+    if (can_access_at_index(input_buffer, 0) && (buffer_at_offset(input_buffer)[0] == ']'))
+    {
+        goto success; /* empty array */
+    }
+
+    /* check if we skipped to the end of the buffer */
+    if (cannot_access_at_index(input_buffer, 0))
+    {
+        return false;
+    }
+
+    /* step back to character in front of the first element */
+    input_buffer->offset--;
+    do
+    {
+        input_buffer->offset++;
+        validate_skip_whitespace(input_buffer);
+        if (!validate_value(input_buffer))
+        {
+            return false;
+        }
+        validate_skip_whitespace(input_buffer);
+    }
+    while (can_access_at_index(input_buffer, 0) && (buffer_at_offset(input_buffer)[0] == ','));
+
+    if (cannot_access_at_index(input_buffer, 0) || (buffer_at_offset(input_buffer)[0] != ']'))
+    {
+        return false; /* expected end of array */
+    }
+
+success:
+    input_buffer->depth--;
+    input_buffer->offset++;
+
+    return true;
+}
+
+static cJSON_bool validate_object(parse_buffer * const input_buffer)
+{
+    if (input_buffer->depth >= CJSON_NESTING_LIMIT)
+    {
+        return false; /* to deeply nested */
+    }
+    input_buffer->depth++;
+
+    input_buffer->offset++;
+    validate_skip_whitespace(input_buffer);
+    if (can_access_at_index(input_buffer, 0) && (buffer_at_offset(input_buffer)[0] == '}'))
+    {
+        goto success; /* empty object */
+    }
+
+    /* check if we skipped to the end of the buffer */
+    if (cannot_access_at_index(input_buffer, 0))
+    {
+        return false;
+    }
+
+    /* step back to character in front of the first element */
+    input_buffer->offset--;
+    do
+    {
+        /* the name */
+        input_buffer->offset++;
+        validate_skip_whitespace(input_buffer);
+        if (!validate_string(input_buffer))
+        {
+            return false;
+        }
+        validate_skip_whitespace(input_buffer);
+
+        if (cannot_access_at_index(input_buffer, 0) || (buffer_at_offset(input_buffer)[0] != ':'))
+        {
+            return false; /* invalid object */
+        }
+
+        /* the value */
+        input_buffer->offset++;
+        validate_skip_whitespace(input_buffer);
+        if (!validate_value(input_buffer))
+        {
+            return false;
+        }
+        validate_skip_whitespace(input_buffer);
+    }
+    while (can_access_at_index(input_buffer, 0) && (buffer_at_offset(input_buffer)[0] == ','));
+
+    if (cannot_access_at_index(input_buffer, 0) || (buffer_at_offset(input_buffer)[0] != '}'))
+    {
+        return false; /* expected end of object */
+    }
+
+success:
+    input_buffer->depth--;
+    input_buffer->offset++;
+
+    return true;
+}
+
+static cJSON_bool validate_value(parse_buffer * const input_buffer)
+{
+    size_t number_length = 0;
+
+    if ((input_buffer == NULL) || (input_buffer->content == NULL))
+    {
+        return false; /* no input */
+    }
+
+    if (can_read(input_buffer, 4) && (strncmp((const char*)buffer_at_offset(input_buffer), "null", 4) == 0))
+    {
+        input_buffer->offset += 4;
+        return true;
+    }
+    if (can_read(input_buffer, 5) && (strncmp((const char*)buffer_at_offset(input_buffer), "false", 5) == 0))
+    {
+        input_buffer->offset += 5;
+        return true;
+    }
+    if (can_read(input_buffer, 4) && (strncmp((const char*)buffer_at_offset(input_buffer), "true", 4) == 0))
+    {
+        input_buffer->offset += 4;
+        return true;
+    }
+    if (cannot_access_at_index(input_buffer, 0))
+    {
+        return false;
+    }
+
+    switch (buffer_at_offset(input_buffer)[0])
+    {
+        case '\"':
+            return validate_string(input_buffer);
+
+        case '[':
+            return validate_array(input_buffer);
+
+        case '{':
+            return validate_object(input_buffer);
+
+        case '-':
+        case '0':
+        case '1':
+        case '2':
+        case '3':
+        case '4':
+        case '5':
+        case '6':
+        case '7':
+        case '8':
+        case '9':
+            number_length = validate_number(buffer_at_offset(input_buffer), input_buffer->length - input_buffer->offset);
+            if (number_length == 0)
+            {
+                return false;
+            }
+            input_buffer->offset += number_length;
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_Validate(const char *json, size_t length, const char **error_ptr)
+{
+    parse_buffer buffer = { 0, 0, 0, 0, { 0, 0, 0, NULL }, NULL, NULL, 0, 0, NULL };
+    const char *end = NULL;
+
+    if (error_ptr != NULL)
+    {
+        *error_ptr = NULL;
+    }
+
+    if (json == NULL)
+    {
+        return false;
+    }
+
+    /* a null character ends the input for the parser as well, so nothing after it can make the document valid */
+    end = (const char*)memchr(json, '\0', length);
+    if (end != NULL)
+    {
+        length = (size_t)(end - json);
+    }
+
+    buffer.content = (const unsigned char*)json;
+    buffer.length = length;
+
+    skip_utf8_bom(&buffer);
+    validate_skip_whitespace(&buffer);
+    if (validate_value(&buffer) && buffer_is_at_end(&buffer))
+    {
+        return true;
+    }
+
+    if (error_ptr != NULL)
+    {
+        *error_ptr = json + ((buffer.offset < length) ? buffer.offset : length);
+    }
+
+    return false;
+}
+
+/* The projection parser builds only the parts of a document that JSON pointers select. It follows the pointers with the
+ * key and index rules of cJSONUtils_GetPointer, parses the selected values with parse_value and skips everything else
+ * with the validator, so values that aren't selected are checked but never allocated or unescaped. */
+typedef struct
+{
+    size_t pointer; /* index into pointers and results */
+    const unsigned char *rest; /* the part of the pointer after the current value */
+} projection_path;
+
+typedef struct
+{
+    cJSON **results;
+    /* for every pointer, one more than the depth at which it last matched a name, so that
+     * only the first of duplicate names is followed */
+    size_t *matched_depth;
+    cJSON_bool case_sensitive;
+} projection_state;
+
+/* compare the next token of a pointer with a name, decoding ~0 and ~1 */
+static cJSON_bool pointer_token_equals(const unsigned char *token, const unsigned char * const name, const size_t name_length, const cJSON_bool case_sensitive)
+{
+    size_t position = 0;
+
+    for (; (*token != '\0') && (*token != '/'); (void)token++, position++)
+    {
+        unsigned char character = *token;
+        if (position >= name_length)
+        {
+            return false;
+        }
+        if (character == '~')
+        {
+            if ((token[1] != '0') && (token[1] != '1'))
+            {
+                return false; /* invalid escape sequence */
+            }
+            character = (token[1] == '0') ? '~' : '/';
+            token++;
+        }
+        if (case_sensitive ? (character != name[position]) : (tolower(character) != tolower(name[position])))
+        {
+            return false;
+        }
+    }
+
+    return position == name_length;
+}
+
+/* the same rules as decode_array_index_from_pointer in cJSON_Utils */
+static cJSON_bool pointer_token_index(const unsigned char * const token, size_t * const index)
+{
+    size_t parsed_index = 0;
+    size_t position = 0;
+
+    if ((token[0] == '0') && (token[1] != '\0') && (token[1] != '/'))
+    {
+        return false; /* leading zeroes are not permitted */
+    }
+
+    for (position = 0; (token[position] >= '0') && (token[position] <= '9'); position++)
+    {
+        parsed_index = (10 * parsed_index) + (size_t)(token[position] - '0');
+    }
+
+    if ((position == 0) || ((token[position] != '\0') && (token[position] != '/')))
+    {
+        return false;
+    }
+
+    *index = parsed_index;
+
+    return true;
+}
+
+/* the rest of a pointer after its next token */
+static const unsigned char *pointer_skip_token(const unsigned char *token)
+{
+    while ((*token != '\0') && (*token != '/'))
+    {
+        token++;
+    }
+
+    return token;
+}
+
+/* follow the rest of a pointer into a value that was parsed completely */
+static cJSON *get_projected_item(cJSON *item, const unsigned char *rest, const cJSON_bool case_sensitive)
+{
+    while ((rest[0] == '/') && (item != NULL))
+    {
+        const unsigned char *token = rest + 1;
+        if (cJSON_IsArray(item))
+        {
+            size_t index = 0;
+            if (!pointer_token_index(token, &index))
+            {
+                return NULL;
+            }
+            for (item = item->child; (item != NULL) && (index > 0); index--)
+            {
+                item = item->next;
+            }
+        }
+        else if (cJSON_IsObject(item))
+        {
+            for (item = item->child; item != NULL; item = item->next)
+            {
+                if ((item->string != NULL) && pointer_token_equals(token, (const unsigned char*)item->string, strlen(item->string), case_sensitive))
+                {
+                    break;
+                }
+            }
+        }
+        else
+        {
+            return NULL;
+        }
+
+        rest = pointer_skip_token(token);
+    }
+
+    return item;
+}
+
+/* parse a selected value completely and resolve all pointers that end in it */
+static cJSON_bool project_whole_value(cJSON * const item, parse_buffer * const input_buffer, const projection_state * const state, const projection_path * const paths, const size_t path_count)
+{
+    size_t i = 0;
+
+    if (!parse_value(item, input_buffer))
+    {
+        return false;
+    }
+
+    for (i = 0; i < path_count; i++)
+    {
+        if (state->results[paths[i].pointer] == NULL)
+        {
+            state->results[paths[i].pointer] = get_projected_item(item, paths[i].rest, state->case_sensitive);
+        }
+    }
+
+    return true;
+}
+
+static void projection_append(cJSON * const parent, cJSON ** const tail, cJSON * const item)
+{
+    if (*tail == NULL)
+    {
+        parent->child = item;
+    }
+    else
+    {
+        (*tail)->next = item;
+        item->prev = *tail;
+    }
+    *tail = item;
+    parent->child->prev = item;
+}
+
+static cJSON_bool project_value(cJSON * const item, parse_buffer * const input_buffer, const projection_state * const state, projection_path * const paths, const size_t path_count, cJSON_bool * const found);
+
+/* paths has room for the paths of the children after its own */
+static cJSON_bool project_array(cJSON * const item, parse_buffer * const input_buffer, const projection_state * const state, projection_path * const paths, const size_t path_count, cJSON_bool * const found)
+{
+    projection_path * const child_paths = paths + path_count;
+    cJSON *tail = NULL;
+    size_t index = 0;
+
+    if (input_buffer->depth >= CJSON_NESTING_LIMIT)
+    {
+        return false; /* to deeply nested */
+    }
+    input_buffer->depth++;
+    item->type = cJSON_Array;
+
+    input_buffer->offset++;
+    buffer_skip_whitespace(input_buffer);
+    if (can_access_at_index(input_buffer, 0) && (buffer_at_offset(input_buffer)[0] == ']'))
+    {
+        goto success; /* empty array */
+    }
+
+    /* check if we skipped to the end of the buffer */
+    if (cannot_access_at_index(input_buffer, 0))
+    {
+        input_buffer->offset--;
+        return false;
+    }
+
+    /* step back to character in front of the first element */
+    input_buffer->offset--;
+    do
+    {
+        size_t child_count = 0;
+        size_t i = 0;
+
+        input_buffer->offset++;
+        buffer_skip_whitespace(input_buffer);
+
+        for (i = 0; i < path_count; i++)
+        {
+            size_t path_index = 0;
+            if ((paths[i].rest[0] == '/') && pointer_token_index(paths[i].rest + 1, &path_index) && (path_index == index))
+            {
+                child_paths[child_count].pointer = paths[i].pointer;
+                child_paths[child_count].rest = pointer_skip_token(paths[i].rest + 1);
+                child_count++;
+            }
+        }
+
+        if (child_count == 0)
+        {
+            if (!validate_value(input_buffer))
+            {
+                return false;
+            }
+        }
+        else
+        {
+            cJSON_bool child_found = false;
+            cJSON *child = parse_new_item(input_buffer);
+            if (child == NULL)
+            {
+                return false; /* allocation failure */
+            }
+            if (!project_value(child, input_buffer, state, child_paths, child_count, &child_found))
+            {
+                delete_item(child, &input_buffer->hooks);
+                return false;
+            }
+            parse_finish_item(input_buffer, child);
+            if (child_found)
+            {
+                projection_append(item, &tail, child);
+                *found = true;
+            }
+            else
+            {
+                delete_item(child, &input_buffer->hooks);
+            }
+        }
+        buffer_skip_whitespace(input_buffer);
+        index++;
+    }
+    while (can_access_at_index(input_buffer, 0) && (buffer_at_offset(input_buffer)[0] == ','));
+
+    if (cannot_access_at_index(input_buffer, 0) || (buffer_at_offset(input_buffer)[0] != ']'))
+    {
+        return false; /* expected end of array */
+    }
+
+success:
+    input_buffer->depth--;
+    input_buffer->offset++;
+
+    return true;
+}
+
+static cJSON_bool project_object(cJSON * const item, parse_buffer * const input_buffer, const projection_state * const state, projection_path * const paths, const size_t path_count, cJSON_bool * const found)
+{
+    projection_path * const child_paths = paths + path_count;
+    cJSON *tail = NULL;
+    cJSON *child = NULL;
+
+    if (input_buffer->depth >= CJSON_NESTING_LIMIT)
+    {
+        return false; /* to deeply nested */
+    }
+    input_buffer->depth++;
+    item->type = cJSON_Object;
+
+    input_buffer->offset++;
+    buffer_skip_whitespace(input_buffer);
+    if (can_access_at_index(input_buffer, 0) && (buffer_at_offset(input_buffer)[0] == '}'))
+    {
+        goto success; /* empty object */
+    }
+
+    /* check if we skipped to the end of the buffer */
+    if (cannot_access_at_index(input_buffer, 0))
+    {
+        input_buffer->offset--;
+        return false;
+    }
+
+    /* step back to character in front of the first element */
+    input_buffer->offset--;
+    do
+    {
+        const unsigned char *name = NULL;
+        size_t name_length = 0;
+        size_t name_start = 0;
+        size_t child_count = 0;
+        size_t i = 0;
+
+        /* scan the name, it is only copied if it is selected or has escape sequences */
+        input_buffer->offset++;
+        buffer_skip_whitespace(input_buffer);
+        name_start = input_buffer->offset;
+        if (!validate_string(input_buffer))
+        {
+            return false; /* failed to parse name */
+        }
+        name = input_buffer->content + name_start + 1;
+        name_length = input_buffer->offset - name_start - 2;
+        if (memchr(name, '\\', name_length) != NULL)
+        {
+            child = parse_new_item(input_buffer);
+            if (child == NULL)
+            {
+                return false; /* allocation failure */
+            }
+            input_buffer->offset = name_start;
+            if (!parse_string_literal(child, input_buffer, false))
+            {
+                goto fail;
+            }
+            name = (const unsigned char*)item_valuestring(child);
+            name_length = strlen((const char*)name);
+        }
+
+        for (i = 0; i < path_count; i++)
+        {
+            size_t pointer = paths[i].pointer;
+            if ((paths[i].rest[0] == '/') && (state->matched_depth[pointer] <= input_buffer->depth)
+                    && pointer_token_equals(paths[i].rest + 1, name, name_length, state->case_sensitive))
+            {
+                state->matched_depth[pointer] = input_buffer->depth + 1;
+                child_paths[child_count].pointer = pointer;
+                child_paths[child_count].rest = pointer_skip_token(paths[i].rest + 1);
+                child_count++;
+            }
+        }
+
+        if ((child_count == 0) && (child != NULL))
+        {
+            delete_item(child, &input_buffer->hooks);
+            child = NULL;
+        }
+        else if ((child_count > 0) && (child == NULL))
+        {
+            child = parse_new_item(input_buffer);
+            if (child == NULL)
+            {
+                return false; /* allocation failure */
+            }
+            input_buffer->offset = name_start;
+            if (!parse_string_literal(child, input_buffer, false))
+            {
+                goto fail;
+            }
+        }
+        if (child != NULL)
+        {
+            /* swap valuestring and string, because we parsed the name */
+            child->string = item_valuestring(child);
+            set_valuestring(child, NULL);
+        }
+
+        buffer_skip_whitespace(input_buffer);
+        if (cannot_access_at_index(input_buffer, 0) || (buffer_at_offset(input_buffer)[0] != ':'))
+        {
+            goto fail; /* invalid object */
+        }
+        input_buffer->offset++;
+        buffer_skip_whitespace(input_buffer);
+
+        if (child == NULL)
+        {
+            if (!validate_value(input_buffer))
+            {
+                return false;
+            }
+        }
+        else
+        {
+            cJSON_bool child_found = false;
+            if (!project_value(child, input_buffer, state, child_paths, child_count, &child_found))
+            {
+                goto fail;
+            }
+            parse_finish_item(input_buffer, child);
+            if (child_found)
+            {
+                projection_append(item, &tail, child);
+                *found = true;
+            }
+            else
+            {
+                delete_item(child, &input_buffer->hooks);
+            }
+            child = NULL;
+        }
+        buffer_skip_whitespace(input_buffer);
+    }
+    while (can_access_at_index(input_buffer, 0) && (buffer_at_offset(input_buffer)[0] == ','));
+
+    if (cannot_access_at_index(input_buffer, 0) || (buffer_at_offset(input_buffer)[0] != '}'))
+    {
+        return false; /* expected end of object */
+    }
+
+success:
+    input_buffer->depth--;
+    input_buffer->offset++;
+
+    return true;
+
+fail:
+    delete_item(child, &input_buffer->hooks);
+
+    return false;
+}
+
+static cJSON_bool project_value(cJSON * const item, parse_buffer * const input_buffer, const projection_state * const state, projection_path * const paths, const size_t path_count, cJSON_bool * const found)
+{
+    size_t i = 0;
+
+    for (i = 0; i < path_count; i++)
+    {
+        if (paths[i].rest[0] != '/')
+        {
+            /* a pointer ends here, so the value is needed as a whole */
+            *found = true;
+            return project_whole_value(item, input_buffer, state, paths, path_count);
+        }
+    }
+
+    if (cannot_access_at_index(input_buffer, 0))
+    {
+        return false;
+    }
+    switch (buffer_at_offset(input_buffer)[0])
+    {
+        case '[':
+            return project_array(item, input_buffer, state, paths, path_count, found);
+
+        case '{':
+            return project_object(item, input_buffer, state, paths, path_count, found);
+
+        default:
+            /* the pointers continue, but this value has no children */
+            return validate_value(input_buffer);
+    }
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_ParseProjection(const char *value, const char * const *pointers, size_t count, cJSON_bool case_sensitive, cJSON **results)
+{
+    parse_buffer buffer = { 0, 0, 0, 0, { 0, 0, 0, NULL }, NULL, NULL, 0, 0, NULL };
+    projection_state state;
+    projection_path *paths = NULL;
+    size_t path_count = 0;
+    size_t levels = 1;
+    size_t i = 0;
+    cJSON *item = NULL;
+    cJSON_bool found = false;
+    cJSON_bool success = false;
+
+    /* reset error position */
+    global_error.json = NULL;
+    global_error.position = 0;
+
+    if ((results != NULL) && (count > 0))
+    {
+        memset(results, '\0', count * sizeof(cJSON*));
+    }
+    if ((value == NULL) || ((pointers == NULL) && (count > 0)))
+    {
+        return NULL;
+    }
+
+    /* every level of the document gets a list with at most count paths */
+    for (i = 0; i < count; i++)
+    {
+        const char *slash = pointers[i];
+        size_t tokens = 1;
+        while ((slash != NULL) && ((slash = strchr(slash, '/')) != NULL))
+        {
+            tokens++;
+            slash++;
+        }
+        if (tokens > levels)
+        {
+            levels = tokens;
+        }
+    }
+
+    state.case_sensitive = case_sensitive;
+    state.results = (cJSON**)global_hooks.allocate(count * sizeof(cJSON*) + sizeof(cJSON*), global_hooks.user_data);
+    state.matched_depth = (size_t*)global_hooks.allocate(count * sizeof(size_t) + sizeof(size_t), global_hooks.user_data);
+    paths = (projection_path*)global_hooks.allocate(count * levels * sizeof(projection_path) + sizeof(projection_path), global_hooks.user_data);
+    item = cJSON_New_Item(&global_hooks);
+    if ((state.results == NULL) || (state.matched_depth == NULL) || (paths == NULL) || (item == NULL))
+    {
+        goto cleanup; /* memory fail */
+    }
+    for (i = 0; i < count; i++)
+    {
+        state.results[i] = NULL;
+        state.matched_depth[i] = 0;
+        if (pointers[i] != NULL)
+        {
+            paths[path_count].pointer = i;
+            paths[path_count].rest = (const unsigned char*)pointers[i];
+            path_count++;
+        }
+    }
+
+    buffer.content = (const unsigned char*)value;
+    buffer.length = strlen(value) + sizeof("");
+    buffer.hooks = global_hooks;
+
+    buffer_skip_whitespace(skip_utf8_bom(&buffer));
+    if (can_access_at_index(&buffer, 0) && ((buffer_at_offset(&buffer)[0] == '[') || (buffer_at_offset(&buffer)[0] == '{')))
+    {
+        success = project_value(item, &buffer, &state, paths, path_count, &found);
+    }
+    else
+    {
+        /* the whole document is a single value */
+        success = project_whole_value(item, &buffer, &state, paths, path_count);
+    }
+
+    if (success)
+    {
+        if (results != NULL)
+        {
+            memcpy(results, state.results, count * sizeof(cJSON*));
+        }
+    }
+    else
+    {
+        global_error.json = (const unsigned char*)value;
+        global_error.position = (buffer.offset < buffer.length) ? buffer.offset : (buffer.length - 1);
+    }
+
+cleanup:
+    if (state.results != NULL)
+    {
+        global_hooks.deallocate(state.results, global_hooks.user_data);
+    }
+    if (state.matched_depth != NULL)
+    {
+        global_hooks.deallocate(state.matched_depth, global_hooks.user_data);
+    }
+    if (paths != NULL)
+    {
+        global_hooks.deallocate(paths, global_hooks.user_data);
+    }
+    if (!success && (item != NULL))
+    {
+        delete_item(item, &global_hooks);
+        item = NULL;
+    }
+
+    return item;
+}
+
+/* Render an object to text. */
+static cJSON_bool print_object(const cJSON * const item, printbuffer * const output_buffer)
+{
     unsigned char *output_pointer = NULL;
-    unsigned char *output = NULL;
+    size_t length = 0;
+    cJSON *current_item = NULL;
+
+    if ((output_buffer == NULL) || !read_children(item, &current_item))
+    {
+        return false;
+    }
+
+    /* Compose the output: */
+    length = (size_t) (output_buffer->format ? 2 : 1); /* fmt: {\n */
+    output_pointer = ensure(output_buffer, length + 1);
+    if (output_pointer == NULL)
+    {
+        return false;
+    }
+
+    *output_pointer++ = '{';
+    output_buffer->depth++;
+    if (output_buffer->format)
+    {
+        *output_pointer++ = '\n';
+    }
+    output_buffer->offset += length;
+
+    while (current_item)
+    {
+        if (output_buffer->format)
+        {
+            size_t i;
+            output_pointer = ensure(output_buffer, output_buffer->depth);
+            if (output_pointer == NULL)
+            {
+                return false;
+            }
+            for (i = 0; i < output_buffer->depth; i++)
+            {
+                *output_pointer++ = '\t';
+            }
+            output_buffer->offset += output_buffer->depth;
+        }
+
+        /* print key */
+        if (!print_string_ptr((unsigned char*)current_item->string, output_buffer))
+        {
+            return false;
+        }
+        update_offset(output_buffer);
+
+        length = (size_t) (output_buffer->format ? 2 : 1);
+        output_pointer = ensure(output_buffer, length);
+        if (output_pointer == NULL)
+        {
+            return false;
+        }
+        *output_pointer++ = ':';
+        if (output_buffer->format)
+        {
+            *output_pointer++ = '\t';
+        }
+        output_buffer->offset += length;
+
+        /* print value */
+        if (!print_value(current_item, output_buffer))
+        {
+            return false;
+        }
+        update_offset(output_buffer);
+
+        /* print comma if not last */
+        length = ((size_t)(output_buffer->format ? 1 : 0) + (size_t)(current_item->next ? 1 : 0));
+        output_pointer = ensure(output_buffer, length + 1);
+        if (output_pointer == NULL)
+        {
+            return false;
+        }
+        if (current_item->next)
+        {
+            *output_pointer++ = ',';
+        }
+
+        if (output_buffer->format)
+        {
+            *output_pointer++ = '\n';
+        }
+        *output_pointer = '\0';
+        output_buffer->offset += length;
+
+        current_item = current_item->next;
+    }
+
+    output_pointer = ensure(output_buffer, output_buffer->format ? (output_buffer->depth + 1) : 2);
+    if (output_pointer == NULL)
+    {
+        return false;
+    }
+    if (output_buffer->format)
+    {
+        size_t i;
+        for (i = 0; i < (output_buffer->depth - 1); i++)
+        {
+            *output_pointer++ = '\t';
+        }
+    }
+    *output_pointer++ = '}';
+    *output_pointer = '\0';
+    output_buffer->depth--;
+
+    return true;
+}
+
+/* Create a list of number items with the given hooks, returns NULL on failure */
+static cJSON *create_number_list(const double * const numbers, const size_t count, const internal_hooks * const hooks)
+{
+    cJSON *head = NULL;
+    cJSON *current_item = NULL;
+    size_t i = 0;
+
+    for (i = 0; i < count; i++)
+    {
+        cJSON *new_item = cJSON_New_Item(hooks);
+        if (new_item == NULL)
+        {
+            delete_item(head, hooks);
+            return NULL;
+        }
+        new_item->type = cJSON_Number;
+        cJSON_SetNumberHelper(new_item, numbers[i]);
+        if (head == NULL)
+        {
+            head = new_item;
+        }
+        else
+        {
+            current_item->next = new_item;
+            new_item->prev = current_item;
+        }
+        current_item = new_item;
+    }
+    if (head != NULL)
+    {
+        head->prev = current_item;
+    }
+
+    return head;
+}
+
+/* Create the items of a packed array, if that fails it stays packed.
+ * Packed arrays are only made by the parser with the global hooks, see duplicate_item. */
+static cJSON_bool unpack(cJSON * const item)
+{
+    cJSON *head = create_number_list(packed_numbers(item), (size_t)item->valueint, &global_hooks);
+
+    if (head == NULL)
+    {
+        return false;
+    }
+
+    global_hooks.deallocate(packed_numbers(item), global_hooks.user_data);
+    set_valuestring(item, NULL);
+    item->valueint = 0;
+    item->child = head;
+    item->type &= ~(cJSON_IsLazy | cJSON_IsPacked);
+
+    return true;
+}
+
+/* Parse the text of a lazy array or object, the arrays and objects in it stay lazy.
+ * It is only checked now, so an invalid text leaves the item as it is.
+ * This writes to the item although readers only have a const pointer, which is why lazy trees can't be read concurrently. */
+static cJSON_bool materialize(const cJSON * const item)
+{
+    parse_buffer buffer = { 0, 0, 0, 0, { 0, 0, 0, NULL }, NULL, NULL, 0, 0, NULL };
+    cJSON *lazy_item = (cJSON*)cast_away_const(item);
+    cJSON parsed;
+
+    if (!item_is_lazy(item))
+    {
+        return true;
+    }
+    if (item_is_packed(item))
+    {
+        return unpack(lazy_item);
+    }
+
+    memset(&parsed, '\0', sizeof(parsed));
+    buffer.content = lazy_text(item);
+    buffer.length = (size_t)item->valueint;
+    buffer.hooks = global_hooks;
+    buffer.lazy_depth = 1;
+
+    if (!parse_value(&parsed, &buffer))
+    {
+        return false;
+    }
+    if ((buffer.offset != buffer.length) || ((parsed.type & 0xFF) != (item->type & 0xFF)))
+    {
+        delete_item(parsed.child, &global_hooks);
+        return false;
+    }
+
+    set_valuestring(lazy_item, NULL);
+    lazy_item->valueint = 0;
+    lazy_item->child = parsed.child;
+    lazy_item->type &= ~cJSON_IsLazy;
+
+    return true;
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_Materialize(const cJSON *item)
+{
+    if (item == NULL)
+    {
+        return false;
+    }
+
+    return materialize(item);
+}
+
+/* CBOR (RFC 8949), see cJSON_PrintCBOR and cJSON_ParseCBOR.
+ * Integers up to 2^53 are stored as integers, other numbers as the shortest float that holds them exactly.
+ * Raw items are byte strings with tag 262 (embedded JSON). */
+#define CBOR_UNSIGNED 0
+#define CBOR_NEGATIVE 1
+#define CBOR_BYTES 2
+#define CBOR_TEXT 3
+#define CBOR_ARRAY 4
+#define CBOR_MAP 5
+#define CBOR_TAG 6
+#define CBOR_SIMPLE 7
+
+#define CBOR_INDEFINITE 31
+#define CBOR_BREAK 0xFF
+#define CBOR_TAG_EMBEDDED_JSON 262
+
+/* the largest integer below which every integer is exactly representable as double */
+#define CBOR_MAX_EXACT_INTEGER 9007199254740992.0
+
+static cJSON_bool is_little_endian(void)
+{
+    const unsigned int one = 1;
+    return *((const unsigned char*)&one) == 1;
+}
 
-    /* not a string */
-    if (buffer_at_offset(input_buffer)[0] != '\"')
+/* copy between big endian bytes and a float or double in memory */
+static void copy_big_endian(unsigned char * const output, const unsigned char * const input, const size_t length)
+{
+    size_t i = 0;
+
+    if (!is_little_endian())
     {
-        goto fail;
+        memcpy(output, input, length);
+        return;
     }
 
+    for (i = 0; i < length; i++)
     {
-        /* calculate approximate size of the output (overestimate) */
-        size_t allocation_length = 0;
-        size_t skipped_bytes = 0;
-        while (((size_t)(input_end - input_buffer->content) < input_buffer->length) && (*input_end != '\"'))
-        {
-            /* is escape sequence */
-            if (input_end[0] == '\\')
-            {
-                if ((size_t)(input_end + 1 - input_buffer->content) >= input_buffer->length)
-                {
-                    /* prevent buffer overflow when last input character is a backslash */
-                    goto fail;
-                }
-                skipped_bytes++;
-                input_end++;
-            }
-            input_end++;
-        }
-        if (((size_t)(input_end - input_buffer->content) >= input_buffer->length) || (*input_end != '\"'))
-        {
-            goto fail; /* string ended unexpectedly */
-        }
+        output[i] = input[length - 1 - i];
+    }
+}
 
-        /* This is at most how much we need for the output */
-        allocation_length = (size_t) (input_end - buffer_at_offset(input_buffer)) - skipped_bytes;
-        output = (unsigned char*)input_buffer->hooks.allocate(allocation_length + sizeof(""));
-        if (output == NULL)
+static cJSON_bool is_negative_zero(const double number)
+{
+    unsigned char bytes[sizeof(double)];
+
+    if (number != 0)
+    {
+        return false;
+    }
+
+    /* the sign bit is the highest bit of the most significant byte */
+    memcpy(bytes, &number, sizeof(double));
+    return (bytes[is_little_endian() ? (sizeof(double) - 1) : 0] & 0x80) != 0;
+}
+
+/* the bits of a half precision float if it holds number exactly */
+static cJSON_bool double_to_half(const double number, unsigned int * const half)
+{
+    unsigned int sign = ((number < 0) || is_negative_zero(number)) ? 0x8000 : 0;
+    double magnitude = fabs(number);
+    double mantissa = 0;
+    int exponent = 0;
+
+    if (magnitude == 0)
+    {
+        *half = sign;
+        return true;
+    }
+    if (magnitude > 65504.0)
+    {
+        if (magnitude > DBL_MAX)
         {
-            goto fail; /* allocation failure */
+            /* infinity */
+            *half = sign | 0x7C00;
+            return true;
         }
+        return false;
     }
 
-    output_pointer = output;
-    /* loop through the string literal */
-    while (input_pointer < input_end)
+    /* magnitude = mantissa * 2^exponent with mantissa in [0.5, 1) */
+    mantissa = frexp(magnitude, &exponent);
+    if ((exponent + 14) >= 1)
     {
-        if (*input_pointer != '\\')
+        /* normal, 10 bits after the implicit one */
+        mantissa = (mantissa * 2 - 1) * 1024;
+        if (mantissa != floor(mantissa))
         {
-            *output_pointer++ = *input_pointer++;
+            return false;
         }
-        /* escape sequence */
-        else
-        {
-            unsigned char sequence_length = 2;
-            if ((input_end - input_pointer) < 1)
-            {
-                goto fail;
-            }
+        *half = sign | ((unsigned int)(exponent + 14) << 10) | (unsigned int)mantissa;
+        return true;
+    }
 
-            switch (input_pointer[1])
-            {
-                case 'b':
-                    *output_pointer++ = '\b';
-                    break;
-                case 'f':
-                    *output_pointer++ = '\f';
-                    break;
-                case 'n':
-                    *output_pointer++ = '\n';
-                    break;
-                case 'r':
-                    *output_pointer++ = '\r';
-                    break;
-                case 't':
-                    *output_pointer++ = '\t';
-                    break;
-                case '\"':
-                case '\\':
-                case '/':
-                    *output_pointer++ = input_pointer[1];
-                    break;
+    /* subnormal, multiples of 2^-24 */
+    mantissa = ldexp(magnitude, 24);
+    if (mantissa != floor(mantissa))
+    {
+        return false;
+    }
+    *half = sign | (unsigned int)mantissa;
 
-                /* UTF-16 literal */
-                case 'u':
-                    sequence_length = utf16_literal_to_utf8(input_pointer, input_end, &output_pointer);
-                    if (sequence_length == 0)
-                    {
-                        /* failed to convert UTF16-literal to UTF-8 */
-                        goto fail;
-                    }
-                    break;
+    return true;
+}
 
-                default:
-                    goto fail;
-            }
-            input_pointer += sequence_length;
-        }
+static double half_to_double(const unsigned int half)
+{
+    unsigned int exponent = (half >> 10) & 0x1F;
+    double mantissa = (double)(half & 0x3FF);
+    double number = 0;
+
+    if (exponent == 0)
+    {
+        number = ldexp(mantissa, -24);
+    }
+    else if (exponent == 31)
+    {
+        number = (mantissa == 0) ? HUGE_VAL : NAN;
+    }
+    else
+    {
+        number = ldexp(mantissa + 1024, (int)exponent - 25);
     }
 
-    /* zero terminate the output */
-    *output_pointer = '\0';
+    return (half & 0x8000) ? -number : number;
+}
 
-    item->type = cJSON_String;
-    item->valuestring = (char*)output;
+/* the head of a data item: the major type and an unsigned argument, in as few bytes as possible */
+static cJSON_bool print_cbor_head(printbuffer * const output_buffer, const unsigned char major_type, double argument)
+{
+    unsigned char *output_pointer = NULL;
+    size_t length = 0;
+    size_t i = 0;
+    unsigned char additional = 0;
 
-    input_buffer->offset = (size_t) (input_end - input_buffer->content);
-    input_buffer->offset++;
+    if (argument < 24)
+    {
+        additional = (unsigned char)argument;
+    }
+    else if (argument < 256.0)
+    {
+        additional = 24;
+        length = 1;
+    }
+    else if (argument < 65536.0)
+    {
+        additional = 25;
+        length = 2;
+    }
+    else if (argument < 4294967296.0)
+    {
+        additional = 26;
+        length = 4;
+    }
+    else
+    {
+        additional = 27;
+        length = 8;
+    }
+
+    output_pointer = ensure(output_buffer, length + 1);
+    if (output_pointer == NULL)
+    {
+        return false;
+    }
+
+    output_pointer[0] = (unsigned char)((major_type << 5) | additional);
+    for (i = length; i > 0; i--)
+    {
+        double high = floor(argument / 256);
+        output_pointer[i] = (unsigned char)(argument - high * 256);
+        argument = high;
+    }
+    output_buffer->offset += length + 1;
 
     return true;
+}
 
-fail:
-    if (output != NULL)
+static cJSON_bool print_cbor_bytes(printbuffer * const output_buffer, const unsigned char major_type, const unsigned char * const bytes)
+{
+    size_t length = (bytes != NULL) ? strlen((const char*)bytes) : 0;
+    unsigned char *output_pointer = NULL;
+
+    if (!print_cbor_head(output_buffer, major_type, (double)length))
     {
-        input_buffer->hooks.deallocate(output);
+        return false;
     }
 
-    if (input_pointer != NULL)
+    output_pointer = ensure(output_buffer, length);
+    if (output_pointer == NULL)
     {
-        input_buffer->offset = (size_t)(input_pointer - input_buffer->content);
+        return false;
+    }
+    if (length > 0)
+    {
+        memcpy(output_pointer, bytes, length);
     }
+    output_buffer->offset += length;
 
-    return false;
+    return true;
 }
 
-/* Render the cstring provided to an escaped version that can be printed. */
-static cJSON_bool print_string_ptr(const unsigned char * const input, printbuffer * const output_buffer)
+static cJSON_bool print_cbor_number(const double number, printbuffer * const output_buffer)
 {
-    const unsigned char *input_pointer = NULL;
-    unsigned char *output = NULL;
     unsigned char *output_pointer = NULL;
-    size_t output_length = 0;
-    /* numbers of additional characters needed for escaping */
-    size_t escape_characters = 0;
+    unsigned int half = 0;
 
-    if (output_buffer == NULL)
+    if ((number == floor(number)) && (fabs(number) <= CBOR_MAX_EXACT_INTEGER) && !is_negative_zero(number))
+    {
+        if (number < 0)
+        {
+            return print_cbor_head(output_buffer, CBOR_NEGATIVE, -1 - number);
+        }
+        return print_cbor_head(output_buffer, CBOR_UNSIGNED, number);
+    }
+
+    output_pointer = ensure(output_buffer, 9);
+    if (output_pointer == NULL)
     {
         return false;
     }
 
-    /* empty string */
-    if (input == NULL)
+    if (number != number)
     {
-        output = ensure(output_buffer, sizeof("\"\""));
-        if (output == NULL)
+        /* the canonical NaN */
+        half = 0x7E00;
+    }
+    if ((half != 0) || double_to_half(number, &half))
+    {
+        output_pointer[0] = (CBOR_SIMPLE << 5) | 25;
+        output_pointer[1] = (unsigned char)(half >> 8);
+        output_pointer[2] = (unsigned char)(half & 0xFF);
+        output_buffer->offset += 3;
+    }
+    else if ((fabs(number) <= (double)FLT_MAX) && ((double)(float)number == number))
+    {
+        float single = (float)number;
+        output_pointer[0] = (CBOR_SIMPLE << 5) | 26;
+        copy_big_endian(output_pointer + 1, (const unsigned char*)&single, sizeof(single));
+        output_buffer->offset += 1 + sizeof(single);
+    }
+    else
+    {
+        output_pointer[0] = (CBOR_SIMPLE << 5) | 27;
+        copy_big_endian(output_pointer + 1, (const unsigned char*)&number, sizeof(number));
+        output_buffer->offset += 1 + sizeof(number);
+    }
+
+    return true;
+}
+
+static cJSON_bool print_cbor_value(const cJSON * const item, printbuffer * const output_buffer)
+{
+    cJSON *children = NULL;
+    const cJSON *child = NULL;
+    unsigned char *output_pointer = NULL;
+    size_t count = 0;
+
+    if ((item != NULL) && item_is_packed(item))
+    {
+        if (!print_cbor_head(output_buffer, CBOR_ARRAY, (double)item->valueint))
         {
             return false;
         }
-        strcpy((char*)output, "\"\"");
-
+        for (count = 0; count < (size_t)item->valueint; count++)
+        {
+            if (!print_cbor_number(packed_numbers(item)[count], output_buffer))
+            {
+                return false;
+            }
+        }
         return true;
     }
+    if ((item == NULL) || !read_children(item, &children))
+    {
+        return false;
+    }
 
-    /* set "flag" to 1 if something needs to be escaped */
-    for (input_pointer = input; *input_pointer; input_pointer++)
+    switch ((item->type) & 0xFF)
     {
-        switch (*input_pointer)
-        {
-            case '\"':
-            case '\\':
-            case '\b':
-            case '\f':
-            case '\n':
-            case '\r':
-            case '\t':
-                /* one character escape sequence */
-                escape_characters++;
-                break;
-            default:
-                if (*input_pointer < 32)
+        case cJSON_NULL:
+        case cJSON_False:
+        case cJSON_True:
+            output_pointer = ensure(output_buffer, 1);
+            if (output_pointer == NULL)
+            {
+                return false;
+            }
+            *output_pointer = (unsigned char)((CBOR_SIMPLE << 5) | ((item->type & 0xFF) == cJSON_NULL ? 22 : ((item->type & 0xFF) == cJSON_True ? 21 : 20)));
+            output_buffer->offset++;
+            return true;
+
+        case cJSON_Number:
+            return print_cbor_number(item_number(item), output_buffer);
+
+        case cJSON_String:
+            return print_cbor_bytes(output_buffer, CBOR_TEXT, (const unsigned char*)item_valuestring(item));
+
+        case cJSON_Raw:
+            if (item_valuestring(item) == NULL)
+            {
+                return false;
+            }
+            return print_cbor_head(output_buffer, CBOR_TAG, CBOR_TAG_EMBEDDED_JSON)
+                && print_cbor_bytes(output_buffer, CBOR_BYTES, (const unsigned char*)item_valuestring(item));
+
+        case cJSON_Array:
+        case cJSON_Object:
+            for (child = children; child != NULL; child = child->next)
+            {
+                count++;
+            }
+            if (!print_cbor_head(output_buffer, cJSON_IsArray(item) ? CBOR_ARRAY : CBOR_MAP, (double)count))
+            {
+                return false;
+            }
+            for (child = children; child != NULL; child = child->next)
+            {
+                if (cJSON_IsObject(item) && !print_cbor_bytes(output_buffer, CBOR_TEXT, (const unsigned char*)child->string))
                 {
-                    /* UTF-16 escape sequence uXXXX */
-                    escape_characters += 5;
+                    return false;
                 }
-                break;
-        }
+                if (!print_cbor_value(child, output_buffer))
+                {
+                    return false;
+                }
+            }
+            return true;
+
+        default:
+            return false;
     }
-    output_length = (size_t)(input_pointer - input) + escape_characters;
+}
 
-    output = ensure(output_buffer, output_length + sizeof("\"\""));
-    if (output == NULL)
+CJSON_PUBLIC(unsigned char *) cJSON_PrintCBOR(const cJSON *item, size_t *length)
+{
+    static const size_t default_buffer_size = 256;
+    printbuffer buffer[1];
+    unsigned char *printed = NULL;
+
+    if (length != NULL)
     {
-        return false;
+        *length = 0;
     }
 
-    /* no characters have to be escaped */
-    if (escape_characters == 0)
+    memset(buffer, 0, sizeof(buffer));
+    buffer->buffer = (unsigned char*)global_hooks.allocate(default_buffer_size, global_hooks.user_data);
+    buffer->length = default_buffer_size;
+    buffer->hooks = global_hooks;
+    if (buffer->buffer == NULL)
     {
-        output[0] = '\"';
-        memcpy(output + 1, input, output_length);
-        output[output_length + 1] = '\"';
-        output[output_length + 2] = '\0';
+        return NULL;
+    }
 
-        return true;
+    if (!print_cbor_value(item, buffer))
+    {
+        if (buffer->buffer != NULL)
+        {
+            global_hooks.deallocate(buffer->buffer, global_hooks.user_data);
+        }
+        return NULL;
     }
 
-    output[0] = '\"';
-    output_pointer = output + 1;
-    /* copy the string */
-    for (input_pointer = input; *input_pointer != '\0'; (void)input_pointer++, output_pointer++)
+    /* shrink the buffer to the output */
+    if (global_hooks.reallocate != NULL)
     {
-        if ((*input_pointer > 31) && (*input_pointer != '\"') && (*input_pointer != '\\'))
+        printed = (unsigned char*)global_hooks.reallocate(buffer->buffer, buffer->offset + 1, global_hooks.user_data);
+        if (printed == NULL)
         {
-            /* normal character, copy */
-            *output_pointer = *input_pointer;
+            global_hooks.deallocate(buffer->buffer, global_hooks.user_data);
         }
-        else
+    }
+    else
+    {
+        printed = (unsigned char*)global_hooks.allocate(buffer->offset + 1, global_hooks.user_data);
+        if (printed != NULL)
         {
-            /* character needs to be escaped */
-            *output_pointer++ = '\\';
-            switch (*input_pointer)
-            {
-                case '\\':
-                    *output_pointer = '\\';
-                    break;
-                case '\"':
-                    *output_pointer = '\"';
-                    break;
-                case '\b':
-                    *output_pointer = 'b';
-                    break;
-                case '\f':
-                    *output_pointer = 'f';
-                    break;
-                case '\n':
-                    *output_pointer = 'n';
-                    break;
-                case '\r':
-                    *output_pointer = 'r';
-                    break;
-                case '\t':
-                    *output_pointer = 't';
-                    break;
-                default:
-                    /* escape and print as unicode codepoint */
-                    sprintf((char*)output_pointer, "u%04x", *input_pointer);
-                    output_pointer += 4;
-                    break;
-            }
+            memcpy(printed, buffer->buffer, buffer->offset);
         }
+        global_hooks.deallocate(buffer->buffer, global_hooks.user_data);
+    }
+    if ((printed != NULL) && (length != NULL))
+    {
+        *length = buffer->offset;
     }
-    output[output_length + 1] = '\"';
-    output[output_length + 2] = '\0';
 
-    return true;
+    return printed;
 }
 
-/* Invoke print_string_ptr (which is useful) on an item. */
-static cJSON_bool print_string(const cJSON * const item, printbuffer * const p)
+/* reads the head of the data item at the current offset. The argument of floats is left for the caller. */
+static cJSON_bool parse_cbor_head(parse_buffer * const input_buffer, unsigned char * const major_type, unsigned char * const additional, double * const argument)
 {
-    return print_string_ptr((unsigned char*)item->valuestring, p);
-}
-
-/* Predeclare these prototypes. */
-static cJSON_bool parse_value(cJSON * const item, parse_buffer * const input_buffer);
-static cJSON_bool print_value(const cJSON * const item, printbuffer * const output_buffer);
-static cJSON_bool parse_array(cJSON * const item, parse_buffer * const input_buffer);
-static cJSON_bool print_array(const cJSON * const item, printbuffer * const output_buffer);
-static cJSON_bool parse_object(cJSON * const item, parse_buffer * const input_buffer);
-static cJSON_bool print_object(const cJSON * const item, printbuffer * const output_buffer);
+    size_t length = 0;
+    size_t i = 0;
 
-/* Utility to jump whitespace and cr/lf */
-static parse_buffer *buffer_skip_whitespace(parse_buffer * const buffer)
-{
-    if ((buffer == NULL) || (buffer->content == NULL))
+    if (!can_read(input_buffer, 1))
     {
-        return NULL;
+        return false;
     }
 
-    while (can_access_at_index(buffer, 0) && (buffer_at_offset(buffer)[0] <= 32))
+    *major_type = (unsigned char)(buffer_at_offset(input_buffer)[0] >> 5);
+    *additional = (unsigned char)(buffer_at_offset(input_buffer)[0] & 0x1F);
+    *argument = 0;
+
+    if ((*additional >= 28) && (*additional != CBOR_INDEFINITE))
     {
-       buffer->offset++;
+        /* reserved */
+        return false;
     }
-
-    if (buffer->offset == buffer->length)
+    if ((*additional == CBOR_INDEFINITE) && ((*major_type < CBOR_BYTES) || (*major_type == CBOR_TAG)))
     {
-        buffer->offset--;
+        return false;
     }
+    input_buffer->offset++;
 
-    return buffer;
-}
-
-/* skip the UTF-8 BOM (byte order mark) if it is at the beginning of a buffer */
-static parse_buffer *skip_utf8_bom(parse_buffer * const buffer)
-{
-    if ((buffer == NULL) || (buffer->content == NULL) || (buffer->offset != 0))
+    if (*additional < 24)
     {
-        return NULL;
+        *argument = (double)*additional;
+        return true;
+    }
+    if ((*additional == CBOR_INDEFINITE) || (*major_type == CBOR_SIMPLE))
+    {
+        return true;
     }
 
-    if (can_access_at_index(buffer, 4) && (strncmp((const char*)buffer_at_offset(buffer), "\xEF\xBB\xBF", 3) == 0))
+    length = (size_t)1 << (*additional - 24);
+    if (!can_read(input_buffer, length))
     {
-        buffer->offset += 3;
+        return false;
+    }
+    for (i = 0; i < length; i++)
+    {
+        *argument = *argument * 256 + (double)buffer_at_offset(input_buffer)[i];
     }
+    input_buffer->offset += length;
 
-    return buffer;
+    return true;
 }
 
-/* Parse an object - create a new root, and populate. */
-CJSON_PUBLIC(cJSON *) cJSON_ParseWithOpts(const char *value, const char **return_parse_end, cJSON_bool require_null_terminated)
+/* the number of items or bytes that follow can't be more than what is left of the input */
+static cJSON_bool cbor_length_fits(const parse_buffer * const input_buffer, const double length)
 {
-    parse_buffer buffer = { 0, 0, 0, 0, { 0, 0, 0 } };
-    cJSON *item = NULL;
+    return length <= (double)(input_buffer->length - input_buffer->offset);
+}
 
-    /* reset error position */
-    global_error.json = NULL;
-    global_error.position = 0;
+/* Parses a text string (or a byte string for raw items), either into the key of item or its value.
+ * Strings of indefinite length are made of chunks of definite length that are joined. */
+static cJSON_bool parse_cbor_string(cJSON * const item, parse_buffer * const input_buffer, const unsigned char major_type, const unsigned char additional, const double argument, const cJSON_bool is_key)
+{
+    size_t length = 0;
+    size_t start = input_buffer->offset;
+    unsigned char *output = NULL;
+    unsigned char chunk_type = 0;
+    unsigned char chunk_additional = 0;
+    double chunk_length = 0;
+    cJSON_bool output_is_inline = false;
 
-    if (value == NULL)
+    if (additional != CBOR_INDEFINITE)
     {
-        goto fail;
+        if (!cbor_length_fits(input_buffer, argument))
+        {
+            return false;
+        }
+        length = (size_t)argument;
     }
-
-    buffer.content = (const unsigned char*)value;
-    buffer.length = strlen((const char*)value) + sizeof("");
-    buffer.offset = 0;
-    buffer.hooks = global_hooks;
-
-    item = cJSON_New_Item(&global_hooks);
-    if (item == NULL) /* memory fail */
+    else
     {
-        goto fail;
+        /* add up the chunks first */
+        while (can_read(input_buffer, 1) && (buffer_at_offset(input_buffer)[0] != CBOR_BREAK))
+        {
+            size_t chunk_start = input_buffer->offset;
+            if (!parse_cbor_head(input_buffer, &chunk_type, &chunk_additional, &chunk_length)
+                    || (chunk_type != major_type) || (chunk_additional == CBOR_INDEFINITE) || !cbor_length_fits(input_buffer, chunk_length))
+            {
+                input_buffer->offset = chunk_start;
+                return false;
+            }
+            length += (size_t)chunk_length;
+            input_buffer->offset += (size_t)chunk_length;
+        }
+        if (!can_read(input_buffer, 1))
+        {
+            return false;
+        }
+        input_buffer->offset = start;
     }
 
-    if (!parse_value(item, buffer_skip_whitespace(skip_utf8_bom(&buffer))))
+#ifdef CJSON_COMPACT_NODES
+    output_is_inline = !is_key && (major_type == CBOR_TEXT) && (length < sizeof(item->value.inline_string));
+    if (output_is_inline)
     {
-        /* parse failure. ep is set. */
-        goto fail;
+        output = (unsigned char*)item->value.inline_string;
     }
-
-    /* if we require null-terminated JSON without appended garbage, skip and then check for a null terminator */
-    if (require_null_terminated)
+    else
+#endif
     {
-        buffer_skip_whitespace(&buffer);
-        if ((buffer.offset >= buffer.length) || buffer_at_offset(&buffer)[0] != '\0')
+        output = (unsigned char*)parse_allocate(input_buffer, length + 1);
+        if (output == NULL)
         {
-            goto fail;
+            return false;
         }
     }
-    if (return_parse_end)
+
+    if (additional != CBOR_INDEFINITE)
     {
-        *return_parse_end = (const char*)buffer_at_offset(&buffer);
+        memcpy(output, buffer_at_offset(input_buffer), length);
+        input_buffer->offset += length;
     }
-
-    return item;
-
-fail:
-    if (item != NULL)
+    else
     {
-        cJSON_Delete(item);
+        size_t copied = 0;
+        while (buffer_at_offset(input_buffer)[0] != CBOR_BREAK)
+        {
+            parse_cbor_head(input_buffer, &chunk_type, &chunk_additional, &chunk_length);
+            memcpy(output + copied, buffer_at_offset(input_buffer), (size_t)chunk_length);
+            copied += (size_t)chunk_length;
+            input_buffer->offset += (size_t)chunk_length;
+        }
+        input_buffer->offset++;
     }
+    output[length] = '\0';
 
-    if (value != NULL)
+    /* cJSON strings end at the first zero */
+    if (memchr(output, '\0', length) != NULL)
     {
-        error local_error;
-        local_error.json = (const unsigned char*)value;
-        local_error.position = 0;
-
-        if (buffer.offset < buffer.length)
+        if (!output_is_inline)
         {
-            local_error.position = buffer.offset;
+            parse_deallocate(input_buffer, output);
         }
-        else if (buffer.length > 0)
+        else
         {
-            local_error.position = buffer.length - 1;
+            set_valuestring(item, NULL);
         }
+        input_buffer->offset = start;
+        return false;
+    }
 
-        if (return_parse_end != NULL)
-        {
-            *return_parse_end = (const char*)local_error.json + local_error.position;
-        }
+    if (is_key)
+    {
+        item->string = (char*)output;
+        return true;
+    }
 
-        global_error = local_error;
+    item->type = (major_type == CBOR_TEXT) ? cJSON_String : cJSON_Raw;
+#ifdef CJSON_COMPACT_NODES
+    if (output_is_inline)
+    {
+        item->type |= cJSON_StringIsInline;
+        return true;
     }
+#endif
+    set_valuestring(item, (char*)output);
 
-    return NULL;
+    return true;
 }
 
-/* Default options for cJSON_Parse */
-CJSON_PUBLIC(cJSON *) cJSON_Parse(const char *value)
+static void set_parsed_number(cJSON * const item, const double number)
 {
-    return cJSON_ParseWithOpts(value, 0, 0);
+    item->type = cJSON_Number;
+    item_number(item) = number;
+
+    if (number >= INT_MAX)
+    {
+        item->valueint = INT_MAX;
+    }
+    else if (number <= (double)INT_MIN)
+    {
+        item->valueint = INT_MIN;
+    }
+    else if (number == number)
+    {
+        item->valueint = (int)number;
+    }
 }
 
-#define cjson_min(a, b) ((a < b) ? a : b)
+static cJSON_bool parse_cbor_value(cJSON * const item, parse_buffer * const input_buffer);
 
-static unsigned char *print(const cJSON * const item, cJSON_bool format, const internal_hooks * const hooks)
+static cJSON_bool parse_cbor_container(cJSON * const item, parse_buffer * const input_buffer, const unsigned char major_type, const unsigned char additional, const double argument)
 {
-    static const size_t default_buffer_size = 256;
-    printbuffer buffer[1];
-    unsigned char *printed = NULL;
-
-    memset(buffer, 0, sizeof(buffer));
+    cJSON *head = NULL;
+    cJSON *current_item = NULL;
+    double count = 0;
 
-    /* create buffer */
-    buffer->buffer = (unsigned char*) hooks->allocate(default_buffer_size);
-    buffer->length = default_buffer_size;
-    buffer->format = format;
-    buffer->hooks = *hooks;
-    if (buffer->buffer == NULL)
+    if (input_buffer->depth >= CJSON_NESTING_LIMIT)
     {
-        goto fail;
+        return false;
     }
-
-    /* print the value */
-    if (!print_value(item, buffer))
+    /* every item takes at least one byte */
+    if ((additional != CBOR_INDEFINITE) && !cbor_length_fits(input_buffer, argument))
     {
-        goto fail;
+        return false;
     }
-    update_offset(buffer);
+    input_buffer->depth++;
+
+    for (count = 0; (additional == CBOR_INDEFINITE) ? (can_read(input_buffer, 1) && (buffer_at_offset(input_buffer)[0] != CBOR_BREAK)) : (count < argument); count++)
+    {
+        cJSON *new_item = parse_new_item(input_buffer);
+        if (new_item == NULL)
+        {
+            goto fail;
+        }
+
+        if (head == NULL)
+        {
+            head = current_item = new_item;
+        }
+        else
+        {
+            current_item->next = new_item;
+            new_item->prev = current_item;
+            current_item = new_item;
+        }
+
+        if (major_type == CBOR_MAP)
+        {
+            unsigned char key_type = 0;
+            unsigned char key_additional = 0;
+            double key_argument = 0;
+            size_t key_start = input_buffer->offset;
+            if (!parse_cbor_head(input_buffer, &key_type, &key_additional, &key_argument))
+            {
+                goto fail;
+            }
+            if (key_type != CBOR_TEXT)
+            {
+                input_buffer->offset = key_start;
+                goto fail;
+            }
+            if (!parse_cbor_string(current_item, input_buffer, key_type, key_additional, key_argument, true))
+            {
+                goto fail;
+            }
+        }
 
-    /* check if reallocate is available */
-    if (hooks->reallocate != NULL)
-    {
-        printed = (unsigned char*) hooks->reallocate(buffer->buffer, buffer->offset + 1);
-        if (printed == NULL) {
+        if (!parse_cbor_value(current_item, input_buffer))
+        {
             goto fail;
         }
-        buffer->buffer = NULL;
+        parse_finish_item(input_buffer, current_item);
     }
-    else /* otherwise copy the JSON over to a new buffer */
+    if (additional == CBOR_INDEFINITE)
     {
-        printed = (unsigned char*) hooks->allocate(buffer->offset + 1);
-        if (printed == NULL)
+        if (!can_read(input_buffer, 1))
         {
             goto fail;
         }
-        memcpy(printed, buffer->buffer, cjson_min(buffer->length, buffer->offset + 1));
-        printed[buffer->offset] = '\0'; /* just to be sure */
-
-        /* free the buffer */
-        hooks->deallocate(buffer->buffer);
+        input_buffer->offset++;
     }
+    input_buffer->depth--;
 
-    return printed;
-
-fail:
-    if (buffer->buffer != NULL)
+    if (head != NULL)
     {
-        hooks->deallocate(buffer->buffer);
+        head->prev = current_item;
     }
+    item->type = (major_type == CBOR_ARRAY) ? cJSON_Array : cJSON_Object;
+    item->child = head;
 
-    if (printed != NULL)
+    return true;
+
+fail:
+    if ((head != NULL) && (input_buffer->arena == NULL))
     {
-        hooks->deallocate(printed);
+        delete_item(head, &input_buffer->hooks);
     }
 
-    return NULL;
-}
-
-/* Render a cJSON item/entity/structure to text. */
-CJSON_PUBLIC(char *) cJSON_Print(const cJSON *item)
-{
-    return (char*)print(item, true, &global_hooks);
-}
-
-CJSON_PUBLIC(char *) cJSON_PrintUnformatted(const cJSON *item)
-{
-    return (char*)print(item, false, &global_hooks);
+    return false;
 }
 
-CJSON_PUBLIC(char *) cJSON_PrintBuffered(const cJSON *item, int prebuffer, cJSON_bool fmt)
+static cJSON_bool parse_cbor_value(cJSON * const item, parse_buffer * const input_buffer)
 {
-    printbuffer p = { 0, 0, 0, 0, 0, 0, { 0, 0, 0 } };
+    unsigned char major_type = 0;
+    unsigned char additional = 0;
+    double argument = 0;
+    size_t start = input_buffer->offset;
+    size_t tags = 0;
+    cJSON_bool embedded_json = false;
 
-    if (prebuffer < 0)
+    if (!parse_cbor_head(input_buffer, &major_type, &additional, &argument))
     {
-        return NULL;
+        return false;
     }
 
-    p.buffer = (unsigned char*)global_hooks.allocate((size_t)prebuffer);
-    if (!p.buffer)
+    /* tags describe the item that follows, only embedded JSON is kept */
+    while (major_type == CBOR_TAG)
     {
-        return NULL;
+        embedded_json = (argument == CBOR_TAG_EMBEDDED_JSON);
+        start = input_buffer->offset;
+        if ((++tags > CJSON_NESTING_LIMIT) || !parse_cbor_head(input_buffer, &major_type, &additional, &argument))
+        {
+            return false;
+        }
     }
-
-    p.length = (size_t)prebuffer;
-    p.offset = 0;
-    p.noalloc = false;
-    p.format = fmt;
-    p.hooks = global_hooks;
-
-    if (!print_value(item, &p))
+    if (embedded_json != (major_type == CBOR_BYTES))
     {
-        global_hooks.deallocate(p.buffer);
-        return NULL;
+        /* byte strings are only supported for raw items */
+        input_buffer->offset = start;
+        return false;
     }
 
-    return (char*)p.buffer;
-}
+    switch (major_type)
+    {
+        case CBOR_UNSIGNED:
+            set_parsed_number(item, argument);
+            return true;
 
-CJSON_PUBLIC(cJSON_bool) cJSON_PrintPreallocated(cJSON *item, char *buf, const int len, const cJSON_bool fmt)
-{
-    printbuffer p = { 0, 0, 0, 0, 0, 0, { 0, 0, 0 } };
+        case CBOR_NEGATIVE:
+            set_parsed_number(item, -1 - argument);
+            return true;
 
-    if ((len < 0) || (buf == NULL))
-    {
-        return false;
+        case CBOR_BYTES:
+        case CBOR_TEXT:
+            return parse_cbor_string(item, input_buffer, major_type, additional, argument, false);
+
+        case CBOR_ARRAY:
+        case CBOR_MAP:
+            return parse_cbor_container(item, input_buffer, major_type, additional, argument);
+
+        default:
+            break;
     }
 
-    p.buffer = (unsigned char*)buf;
-    p.length = (size_t)len;
-    p.offset = 0;
-    p.noalloc = true;
-    p.format = fmt;
-    p.hooks = global_hooks;
+    /* simple values and floats */
+    switch (additional)
+    {
+        case 20:
+            item->type = cJSON_False;
+            return true;
 
-    return print_value(item, &p);
+        case 21:
+            item->type = cJSON_True;
+            item->valueint = 1;
+            return true;
+
+        case 22:
+        case 23: /* undefined */
+            item->type = cJSON_NULL;
+            return true;
+
+        case 25:
+            if (!can_read(input_buffer, 2))
+            {
+                return false;
+            }
+            set_parsed_number(item, half_to_double(((unsigned int)buffer_at_offset(input_buffer)[0] << 8) | buffer_at_offset(input_buffer)[1]));
+            input_buffer->offset += 2;
+            return true;
+
+        case 26:
+        {
+            float single = 0;
+            if (!can_read(input_buffer, sizeof(single)))
+            {
+                return false;
+            }
+            copy_big_endian((unsigned char*)&single, buffer_at_offset(input_buffer), sizeof(single));
+            set_parsed_number(item, (double)single);
+            input_buffer->offset += sizeof(single);
+            return true;
+        }
+
+        case 27:
+        {
+            double number = 0;
+            if (!can_read(input_buffer, sizeof(number)))
+            {
+                return false;
+            }
+            copy_big_endian((unsigned char*)&number, buffer_at_offset(input_buffer), sizeof(number));
+            set_parsed_number(item, number);
+            input_buffer->offset += sizeof(number);
+            return true;
+        }
+
+        default:
+            /* other simple values and unexpected breaks */
+            input_buffer->offset = start;
+            return false;
+    }
 }
 
-/* Parser core - when encountering text, process appropriately. */
-static cJSON_bool parse_value(cJSON * const item, parse_buffer * const input_buffer)
+CJSON_PUBLIC(cJSON *) cJSON_ParseCBOR(const unsigned char *data, size_t length, size_t *consumed)
 {
-    if ((input_buffer == NULL) || (input_buffer->content == NULL))
+    parse_buffer buffer = { 0, 0, 0, 0, { 0, 0, 0, NULL }, NULL, NULL, 0, 0, NULL };
+    cJSON *item = NULL;
+
+    global_error.json = NULL;
+    global_error.position = 0;
+
+    if (data == NULL)
     {
-        return false; /* no input */
+        return NULL;
     }
 
-    /* parse the different types of values */
-    /* null */
-    if (can_read(input_buffer, 4) && (strncmp((const char*)buffer_at_offset(input_buffer), "null", 4) == 0))
+    buffer.content = data;
+    buffer.length = length;
+    buffer.hooks = global_hooks;
+
+    item = cJSON_New_Item(&global_hooks);
+    if (item == NULL)
     {
-        item->type = cJSON_NULL;
-        input_buffer->offset += 4;
-        return true;
+        return NULL;
     }
-    /* false */
-    if (can_read(input_buffer, 5) && (strncmp((const char*)buffer_at_offset(input_buffer), "false", 5) == 0))
+
+    if (!parse_cbor_value(item, &buffer) || ((consumed == NULL) && (buffer.offset != buffer.length)))
     {
-        item->type = cJSON_False;
-        input_buffer->offset += 5;
-        return true;
+        delete_item(item, &global_hooks);
+
+        global_error.json = data;
+        global_error.position = (buffer.offset < buffer.length) ? buffer.offset : length;
+        if (consumed != NULL)
+        {
+            *consumed = global_error.position;
+        }
+        return NULL;
     }
-    /* true */
-    if (can_read(input_buffer, 4) && (strncmp((const char*)buffer_at_offset(input_buffer), "true", 4) == 0))
+
+    if (consumed != NULL)
     {
-        item->type = cJSON_True;
-        item->valueint = 1;
-        input_buffer->offset += 4;
-        return true;
+        *consumed = buffer.offset;
     }
-    /* string */
-    if (can_access_at_index(input_buffer, 0) && (buffer_at_offset(input_buffer)[0] == '\"'))
+
+    return item;
+}
+
+/* Get Array size/item / object item. */
+CJSON_PUBLIC(int) cJSON_GetArraySize(const cJSON *array)
+{
+    cJSON *child = NULL;
+    size_t size = 0;
+
+    if ((array != NULL) && item_is_packed(array))
     {
-        return parse_string(item, input_buffer);
+        return array->valueint;
     }
-    /* number */
-    if (can_access_at_index(input_buffer, 0) && ((buffer_at_offset(input_buffer)[0] == '-') || ((buffer_at_offset(input_buffer)[0] >= '0') && (buffer_at_offset(input_buffer)[0] <= '9'))))
+    if ((array == NULL) || !read_children(array, &child))
     {
-        return parse_number(item, input_buffer);
+        return 0;
     }
-    /* array */
-    if (can_access_at_index(input_buffer, 0) && (buffer_at_offset(input_buffer)[0] == '['))
+
+    if (index_of(array) != NULL)
     {
-        return parse_array(item, input_buffer);
+        size = index_of(array)->count;
+        return (int)size;
     }
-    /* object */
-    if (can_access_at_index(input_buffer, 0) && (buffer_at_offset(input_buffer)[0] == '{'))
+
+    while(child != NULL)
     {
-        return parse_object(item, input_buffer);
+        size++;
+        child = child->next;
     }
 
-    return false;
+    /* FIXME: Can overflow here. Cannot be fixed without breaking the API */
+
+    return (int)size;
 }
 
-/* Render a value to text. */
-static cJSON_bool print_value(const cJSON * const item, printbuffer * const output_buffer)
+static cJSON* get_array_item(const cJSON *array, size_t index)
 {
-    unsigned char *output = NULL;
+    cJSON *current_child = NULL;
 
-    if ((item == NULL) || (output_buffer == NULL))
+    if ((array == NULL) || !materialize(array))
     {
-        return false;
+        return NULL;
     }
 
-    switch ((item->type) & 0xFF)
+    if ((index_of(array) != NULL) && (index_of(array)->items != NULL))
     {
-        case cJSON_NULL:
-            output = ensure(output_buffer, 5);
-            if (output == NULL)
-            {
-                return false;
-            }
-            strcpy((char*)output, "null");
-            return true;
-
-        case cJSON_False:
-            output = ensure(output_buffer, 6);
-            if (output == NULL)
-            {
-                return false;
-            }
-            strcpy((char*)output, "false");
-            return true;
-
-        case cJSON_True:
-            output = ensure(output_buffer, 5);
-            if (output == NULL)
-            {
-                return false;
-            }
-            strcpy((char*)output, "true");
-            return true;
-
-        case cJSON_Number:
-            return print_number(item, output_buffer);
-
-        case cJSON_Raw:
-        {
-            size_t raw_length = 0;
-            if (item->valuestring == NULL)
-            {
-                return false;
-            }
-
-            raw_length = strlen(item->valuestring) + sizeof("");
-            output = ensure(output_buffer, raw_length);
-            if (output == NULL)
-            {
-                return false;
-            }
-            memcpy(output, item->valuestring, raw_length);
-            return true;
-        }
-
-        case cJSON_String:
-            return print_string(item, output_buffer);
+        return (index < index_of(array)->count) ? index_of(array)->items[index] : NULL;
+    }
 
-        case cJSON_Array:
-            return print_array(item, output_buffer);
+    current_child = array->child;
+    while ((current_child != NULL) && (index > 0))
+    {
+        index--;
+        current_child = current_child->next;
+    }
 
-        case cJSON_Object:
-            return print_object(item, output_buffer);
+    return current_child;
+}
 
-        default:
-            return false;
+CJSON_PUBLIC(cJSON *) cJSON_GetArrayItem(const cJSON *array, int index)
+{
+    if (index < 0)
+    {
+        return NULL;
     }
+
+    return get_array_item(array, (size_t)index);
 }
 
-/* Build an array from input text. */
-static cJSON_bool parse_array(cJSON * const item, parse_buffer * const input_buffer)
+CJSON_PUBLIC(cJSON_bool) cJSON_GetDoubleArray(const cJSON *array, double *numbers, size_t count)
 {
-    cJSON *head = NULL; /* head of the linked list */
-    cJSON *current_item = NULL;
+    const cJSON *child = NULL;
+    size_t i = 0;
 
-    if (input_buffer->depth >= CJSON_NESTING_LIMIT)
+    if (!cJSON_IsArray(array) || ((numbers == NULL) && (count > 0)))
     {
-        return false; /* to deeply nested */
+        return false;
     }
-    input_buffer->depth++;
 
-    if (buffer_at_offset(input_buffer)[0] != '[')
+    if (item_is_packed(array))
     {
-        /* not an array */
-        goto fail;
+        if (count > (size_t)array->valueint)
+        {
+            return false;
+        }
+        if (count > 0)
+        {
+            memcpy(numbers, packed_numbers(array), count * sizeof(double));
+        }
+        return true;
     }
 
-    input_buffer->offset++;
-    buffer_skip_whitespace(input_buffer);
-    if (can_access_at_index(input_buffer, 0) && (buffer_at_offset(input_buffer)[0] == ']'))
+    if (!materialize(array))
     {
-        /* empty array */
-        goto success;
+        return false;
+    }
+    for (child = array->child; i < count; child = child->next, i++)
+    {
+        if (!cJSON_IsNumber(child))
+        {
+            return false; /* also if there are less than count items */
+        }
+        numbers[i] = item_number(child);
     }
 
-    /* check if we skipped to the end of the buffer */
-    if (cannot_access_at_index(input_buffer, 0))
+    return true;
+}
+
+static cJSON *get_object_item(const cJSON * const object, const char * const name, const cJSON_bool case_sensitive)
+{
+    cJSON *current_element = NULL;
+    size_t walked = 0;
+
+    if ((object == NULL) || (name == NULL) || !materialize(object))
     {
-        input_buffer->offset--;
-        goto fail;
+        return NULL;
     }
 
-    /* step back to character in front of the first element */
-    input_buffer->offset--;
-    /* loop through the comma separated array elements */
-    do
+    if (index_of(object) != NULL)
     {
-        /* allocate next item */
-        cJSON *new_item = cJSON_New_Item(&(input_buffer->hooks));
-        if (new_item == NULL)
-        {
-            goto fail; /* allocation failure */
-        }
+        return index_lookup(index_of(object), name, case_sensitive);
+    }
 
-        /* attach next item to list */
-        if (head == NULL)
-        {
-            /* start the linked list */
-            current_item = head = new_item;
-        }
-        else
+    current_element = object->child;
+    /* keys from a key table are found by their address, see cJSON_InternKey */
+    if (case_sensitive)
+    {
+        while ((current_element != NULL) && (current_element->string != NULL) && (name != current_element->string) && (strcmp(name, current_element->string) != 0))
         {
-            /* add to the end and advance */
-            current_item->next = new_item;
-            new_item->prev = current_item;
-            current_item = new_item;
+            current_element = current_element->next;
+            walked++;
         }
-
-        /* parse next value */
-        input_buffer->offset++;
-        buffer_skip_whitespace(input_buffer);
-        if (!parse_value(current_item, input_buffer))
+    }
+    else
+    {
+        while ((current_element != NULL) && (name != current_element->string) && (case_insensitive_strcmp((const unsigned char*)name, (const unsigned char*)(current_element->string)) != 0))
         {
-            goto fail; /* failed to parse value */
+            current_element = current_element->next;
+            walked++;
         }
-        buffer_skip_whitespace(input_buffer);
     }
-    while (can_access_at_index(input_buffer, 0) && (buffer_at_offset(input_buffer)[0] == ','));
 
-    if (cannot_access_at_index(input_buffer, 0) || buffer_at_offset(input_buffer)[0] != ']')
+#if CJSON_OBJECT_INDEX_THRESHOLD > 0
+    /* big objects get an index so that the next lookups don't have to walk the list again.
+     * References don't own their children, so their index could go stale. Shared items are only read. */
+    if ((walked >= CJSON_OBJECT_INDEX_THRESHOLD) && cJSON_IsObject(object) && item_is_writable(object) && !(object->type & cJSON_IsReference))
     {
-        goto fail; /* expected end of array */
+        attach_index((cJSON*)cast_away_const(object), create_object_index(object));
     }
+#else
+    (void)walked;
+#endif
 
-success:
-    input_buffer->depth--;
-
-    item->type = cJSON_Array;
-    item->child = head;
-
-    input_buffer->offset++;
+    if ((current_element == NULL) || (current_element->string == NULL)) {
+        return NULL;
+    }
 
-    return true;
+    return current_element;
+}
 
-fail:
-    if (head != NULL)
-    {
-        cJSON_Delete(head);
-    }
+CJSON_PUBLIC(cJSON *) cJSON_GetObjectItem(const cJSON * const object, const char * const string)
+{
+    return get_object_item(object, string, false);
+}
 
-    return false;
+CJSON_PUBLIC(cJSON *) cJSON_GetObjectItemCaseSensitive(const cJSON * const object, const char * const string)
+{
+    return get_object_item(object, string, true);
 }
 
-/* Render an array to text */
-static cJSON_bool print_array(const cJSON * const item, printbuffer * const output_buffer)
+CJSON_PUBLIC(cJSON_bool) cJSON_HasObjectItem(const cJSON *object, const char *string)
 {
-    unsigned char *output_pointer = NULL;
-    size_t length = 0;
-    cJSON *current_element = item->child;
+    return cJSON_GetObjectItem(object, string) ? 1 : 0;
+}
 
-    if (output_buffer == NULL)
+CJSON_PUBLIC(cJSON_bool) cJSON_IndexObject(cJSON *object)
+{
+    if (!cJSON_IsObject(object) || (object->type & cJSON_IsReference) || !make_writable(object, NULL))
     {
         return false;
     }
 
-    /* Compose the output array. */
-    /* opening square bracket */
-    output_pointer = ensure(output_buffer, 1);
-    if (output_pointer == NULL)
+    drop_index(object);
+    attach_index(object, create_object_index(object));
+
+    return index_of(object) != NULL;
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_IndexArray(cJSON *array)
+{
+    if (!cJSON_IsArray(array) || (array->type & cJSON_IsReference) || !make_writable(array, NULL))
     {
         return false;
     }
 
-    *output_pointer = '[';
-    output_buffer->offset++;
-    output_buffer->depth++;
+    drop_index(array);
+    attach_index(array, create_array_index(array));
 
-    while (current_element != NULL)
-    {
-        if (!print_value(current_element, output_buffer))
-        {
-            return false;
-        }
-        update_offset(output_buffer);
-        if (current_element->next)
-        {
-            length = (size_t) (output_buffer->format ? 2 : 1);
-            output_pointer = ensure(output_buffer, length + 1);
-            if (output_pointer == NULL)
-            {
-                return false;
-            }
-            *output_pointer++ = ',';
-            if(output_buffer->format)
-            {
-                *output_pointer++ = ' ';
-            }
-            *output_pointer = '\0';
-            output_buffer->offset += length;
-        }
-        current_element = current_element->next;
-    }
+    return index_of(array) != NULL;
+}
 
-    output_pointer = ensure(output_buffer, 2);
-    if (output_pointer == NULL)
-    {
-        return false;
-    }
-    *output_pointer++ = ']';
-    *output_pointer = '\0';
-    output_buffer->depth--;
+CJSON_PUBLIC(cJSON_bool) cJSON_IsIndexed(const cJSON * const item)
+{
+    return (item != NULL) && (index_of(item) != NULL);
+}
 
-    return true;
+/* Utility for array list handling. */
+static void suffix_object(cJSON *prev, cJSON *item)
+{
+    prev->next = item;
+    item->prev = prev;
 }
 
-/* Build an object from the text. */
-static cJSON_bool parse_object(cJSON * const item, parse_buffer * const input_buffer)
+/* Utility for handling references. */
+static cJSON *create_reference(const cJSON *item, const internal_hooks * const hooks)
 {
-    cJSON *head = NULL; /* linked list head */
-    cJSON *current_item = NULL;
+    cJSON *reference = NULL;
+    if (item == NULL)
+    {
+        return NULL;
+    }
 
-    if (input_buffer->depth >= CJSON_NESTING_LIMIT)
+    /* the numbers of a packed array belong to the original, the reference shares its items instead */
+    if (item_is_packed(item) && !materialize(item))
     {
-        return false; /* to deeply nested */
+        return NULL;
     }
-    input_buffer->depth++;
 
-    if (cannot_access_at_index(input_buffer, 0) || (buffer_at_offset(input_buffer)[0] != '{'))
+    reference = cJSON_New_Item(hooks);
+    if (reference == NULL)
     {
-        goto fail; /* not an object */
+        return NULL;
     }
 
-    input_buffer->offset++;
-    buffer_skip_whitespace(input_buffer);
-    if (can_access_at_index(input_buffer, 0) && (buffer_at_offset(input_buffer)[0] == '}'))
+    memcpy(reference, item, sizeof(cJSON));
+    reference->string = NULL;
+    reference->type |= cJSON_IsReference;
+    reference->type &= ~(cJSON_IsArenaItem | cJSON_IsArenaRoot);
+    reference->next = reference->prev = NULL;
+    /* the index belongs to the original */
+    if (index_of(reference) != NULL)
     {
-        goto success; /* empty object */
+        set_index(reference, NULL);
     }
+    if (item_is_shared(reference))
+    {
+        /* so does the block, the reference can only read it */
+        set_valuestring(reference, NULL);
+        reference->type &= ~cJSON_IsShared;
+        reference->type |= cJSON_IsReadOnly;
+    }
+    return reference;
+}
 
-    /* check if we skipped to the end of the buffer */
-    if (cannot_access_at_index(input_buffer, 0))
+static cJSON_bool add_item_to_array(cJSON *array, cJSON *item)
+{
+    cJSON *child = NULL;
+
+    if ((item == NULL) || (array == NULL) || (array == item) || !make_writable(array, NULL) || !arena_adopt_child(array, item))
     {
-        input_buffer->offset--;
-        goto fail;
+        return false;
     }
 
-    /* step back to character in front of the first element */
-    input_buffer->offset--;
-    /* loop through the comma separated array elements */
-    do
+    child = array->child;
+    /*
+     * To find the last item in the array quickly, the prev pointer
+     * of the first item always points to the last one.
+     */
+    if (child == NULL)
     {
-        /* allocate next item */
-        cJSON *new_item = cJSON_New_Item(&(input_buffer->hooks));
-        if (new_item == NULL)
+        /* list is empty, start new one */
+        array->child = item;
+        item->prev = item;
+    }
+    else
+    {
+        cJSON *last = child->prev;
+        if (last == NULL)
         {
-            goto fail; /* allocation failure */
+            /* the list was linked by hand, find the end the slow way */
+            last = child;
+            while (last->next)
+            {
+                last = last->next;
+            }
         }
+        /* append to the end */
+        suffix_object(last, item);
+        child->prev = item;
+    }
 
-        /* attach next item to list */
-        if (head == NULL)
-        {
-            /* start the linked list */
-            current_item = head = new_item;
-        }
-        else
-        {
-            /* add to the end and advance */
-            current_item->next = new_item;
-            new_item->prev = current_item;
-            current_item = new_item;
-        }
+    index_item_added(array, item);
 
-        /* parse the name of the child */
-        input_buffer->offset++;
-        buffer_skip_whitespace(input_buffer);
-        if (!parse_string(current_item, input_buffer))
-        {
-            goto fail; /* failed to parse name */
-        }
-        buffer_skip_whitespace(input_buffer);
+    return true;
+}
+
+/* Add item to array/object. */
+CJSON_PUBLIC(cJSON_bool) cJSON_AddItemToArray(cJSON *array, cJSON *item)
+{
+    return add_item_to_array(array, item);
+}
+
+
+
+static cJSON_bool add_item_to_object(cJSON * const object, const char * const string, cJSON * const item, const internal_hooks * const hooks, const cJSON_bool constant_key)
+{
+    char *new_key = NULL;
+    int new_type = cJSON_Invalid;
 
-        /* swap valuestring and string, because we parsed the name */
-        current_item->string = current_item->valuestring;
-        current_item->valuestring = NULL;
+    if ((object == NULL) || (string == NULL) || (item == NULL) || !make_writable(object, NULL))
+    {
+        return false;
+    }
 
-        if (cannot_access_at_index(input_buffer, 0) || (buffer_at_offset(input_buffer)[0] != ':'))
+    if (constant_key)
+    {
+        new_key = (char*)cast_away_const(string);
+        new_type = item->type | cJSON_StringIsConst;
+    }
+    else
+    {
+        new_key = (char*)cJSON_strdup((const unsigned char*)string, hooks);
+        if (new_key == NULL)
         {
-            goto fail; /* invalid object */
+            return false;
         }
-
-        /* parse the value */
-        input_buffer->offset++;
-        buffer_skip_whitespace(input_buffer);
-        if (!parse_value(current_item, input_buffer))
+        if (!arena_adopt(item))
         {
-            goto fail; /* failed to parse value */
+            hooks->deallocate(new_key, hooks->user_data);
+            return false;
         }
-        buffer_skip_whitespace(input_buffer);
+
+        new_type = item->type & ~cJSON_StringIsConst;
     }
-    while (can_access_at_index(input_buffer, 0) && (buffer_at_offset(input_buffer)[0] == ','));
 
-    if (cannot_access_at_index(input_buffer, 0) || (buffer_at_offset(input_buffer)[0] != '}'))
+    if (!(item->type & cJSON_StringIsConst) && (item->string != NULL))
     {
-        goto fail; /* expected end of object */
+        hooks->deallocate(item->string, hooks->user_data);
     }
 
-success:
-    input_buffer->depth--;
+    item->string = new_key;
+    item->type = new_type;
 
-    item->type = cJSON_Object;
-    item->child = head;
+    return add_item_to_array(object, item);
+}
 
-    input_buffer->offset++;
-    return true;
+CJSON_PUBLIC(cJSON_bool) cJSON_AddItemToObject(cJSON *object, const char *string, cJSON *item)
+{
+    return add_item_to_object(object, string, item, &global_hooks, false);
+}
 
-fail:
-    if (head != NULL)
-    {
-        cJSON_Delete(head);
-    }
+CJSON_PUBLIC(cJSON_bool) cJSON_AddItemToObjectWithContext(cJSON *object, const char *string, cJSON *item, const cJSON_Context *context)
+{
+    internal_hooks hooks = context_hooks(context);
+    return add_item_to_object(object, string, item, &hooks, false);
+}
 
-    return false;
+/* Add an item to an object with constant string as key */
+CJSON_PUBLIC(cJSON_bool) cJSON_AddItemToObjectCS(cJSON *object, const char *string, cJSON *item)
+{
+    return add_item_to_object(object, string, item, &global_hooks, true);
 }
 
-/* Render an object to text. */
-static cJSON_bool print_object(const cJSON * const item, printbuffer * const output_buffer)
+CJSON_PUBLIC(cJSON_bool) cJSON_AddItemReferenceToArray(cJSON *array, cJSON *item)
 {
-    unsigned char *output_pointer = NULL;
-    size_t length = 0;
-    cJSON *current_item = item->child;
+    cJSON *reference = NULL;
 
-    if (output_buffer == NULL)
+    if (array == NULL)
     {
         return false;
     }
 
-    /* Compose the output: */
-    length = (size_t) (output_buffer->format ? 2 : 1); /* fmt: {\n */
-    output_pointer = ensure(output_buffer, length + 1);
-    if (output_pointer == NULL)
+    reference = create_reference(item, &global_hooks);
+    if (!add_item_to_array(array, reference))
     {
+        /* only the reference itself */
+        cJSON_Delete(reference);
         return false;
     }
 
-    *output_pointer++ = '{';
-    output_buffer->depth++;
-    if (output_buffer->format)
+    return true;
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_AddItemReferenceToObject(cJSON *object, const char *string, cJSON *item)
+{
+    cJSON *reference = NULL;
+
+    if ((object == NULL) || (string == NULL))
     {
-        *output_pointer++ = '\n';
+        return false;
     }
-    output_buffer->offset += length;
 
-    while (current_item)
+    reference = create_reference(item, &global_hooks);
+    if (!add_item_to_object(object, string, reference, &global_hooks, false))
     {
-        if (output_buffer->format)
-        {
-            size_t i;
-            output_pointer = ensure(output_buffer, output_buffer->depth);
-            if (output_pointer == NULL)
-            {
-                return false;
-            }
-            for (i = 0; i < output_buffer->depth; i++)
-            {
-                *output_pointer++ = '\t';
-            }
-            output_buffer->offset += output_buffer->depth;
-        }
+        cJSON_Delete(reference);
+        return false;
+    }
 
-        /* print key */
-        if (!print_string_ptr((unsigned char*)current_item->string, output_buffer))
-        {
-            return false;
-        }
-        update_offset(output_buffer);
+    return true;
+}
 
-        length = (size_t) (output_buffer->format ? 2 : 1);
-        output_pointer = ensure(output_buffer, length);
-        if (output_pointer == NULL)
-        {
-            return false;
-        }
-        *output_pointer++ = ':';
-        if (output_buffer->format)
-        {
-            *output_pointer++ = '\t';
-        }
-        output_buffer->offset += length;
+CJSON_PUBLIC(cJSON*) cJSON_AddNullToObject(cJSON * const object, const char * const name)
+{
+    cJSON *null = cJSON_CreateNull();
+    if (add_item_to_object(object, name, null, &global_hooks, false))
+    {
+        return null;
+    }
 
-        /* print value */
-        if (!print_value(current_item, output_buffer))
-        {
-            return false;
-        }
-        update_offset(output_buffer);
+    cJSON_Delete(null);
+    return NULL;
+}
 
-        /* print comma if not last */
-        length = ((size_t)(output_buffer->format ? 1 : 0) + (size_t)(current_item->next ? 1 : 0));
-        output_pointer = ensure(output_buffer, length + 1);
-        if (output_pointer == NULL)
-        {
-            return false;
-        }
-        if (current_item->next)
-        {
-            *output_pointer++ = ',';
-        }
+CJSON_PUBLIC(cJSON*) cJSON_AddTrueToObject(cJSON * const object, const char * const name)
+{
+    cJSON *true_item = cJSON_CreateTrue();
+    if (add_item_to_object(object, name, true_item, &global_hooks, false))
+    {
+        return true_item;
+    }
 
-        if (output_buffer->format)
-        {
-            *output_pointer++ = '\n';
-        }
-        *output_pointer = '\0';
-        output_buffer->offset += length;
+    cJSON_Delete(true_item);
+    return NULL;
+}
 
-        current_item = current_item->next;
+CJSON_PUBLIC(cJSON*) cJSON_AddFalseToObject(cJSON * const object, const char * const name)
+{
+    cJSON *false_item = cJSON_CreateFalse();
+    if (add_item_to_object(object, name, false_item, &global_hooks, false))
+    {
+        return false_item;
     }
 
-    output_pointer = ensure(output_buffer, output_buffer->format ? (output_buffer->depth + 1) : 2);
-    if (output_pointer == NULL)
+    cJSON_Delete(false_item);
+    return NULL;
+}
+
+CJSON_PUBLIC(cJSON*) cJSON_AddBoolToObject(cJSON * const object, const char * const name, const cJSON_bool boolean)
+{
+    cJSON *bool_item = cJSON_CreateBool(boolean);
+    if (add_item_to_object(object, name, bool_item, &global_hooks, false))
     {
-        return false;
+        return bool_item;
     }
-    if (output_buffer->format)
+
+    cJSON_Delete(bool_item);
+    return NULL;
+}
+
+CJSON_PUBLIC(cJSON*) cJSON_AddNumberToObject(cJSON * const object, const char * const name, const double number)
+{
+    cJSON *number_item = cJSON_CreateNumber(number);
+    if (add_item_to_object(object, name, number_item, &global_hooks, false))
     {
-        size_t i;
-        for (i = 0; i < (output_buffer->depth - 1); i++)
-        {
-            *output_pointer++ = '\t';
-        }
+        return number_item;
     }
-    *output_pointer++ = '}';
-    *output_pointer = '\0';
-    output_buffer->depth--;
 
-    return true;
+    cJSON_Delete(number_item);
+    return NULL;
 }
 
-/* Get Array size/item / object item. */
-CJSON_PUBLIC(int) cJSON_GetArraySize(const cJSON *array)
+CJSON_PUBLIC(cJSON*) cJSON_AddStringToObject(cJSON * const object, const char * const name, const char * const string)
 {
-    cJSON *child = NULL;
-    size_t size = 0;
-
-    if (array == NULL)
+    cJSON *string_item = cJSON_CreateString(string);
+    if (add_item_to_object(object, name, string_item, &global_hooks, false))
     {
-        return 0;
+        return string_item;
     }
 
-    child = array->child;
+    cJSON_Delete(string_item);
+    return NULL;
+}
 
-    while(child != NULL)
+CJSON_PUBLIC(cJSON*) cJSON_AddRawToObject(cJSON * const object, const char * const name, const char * const raw)
+{
+    cJSON *raw_item = cJSON_CreateRaw(raw);
+    if (add_item_to_object(object, name, raw_item, &global_hooks, false))
     {
-        size++;
-        child = child->next;
+        return raw_item;
     }
 
-    /* FIXME: Can overflow here. Cannot be fixed without breaking the API */
-
-    return (int)size;
+    cJSON_Delete(raw_item);
+    return NULL;
 }
 
-static cJSON* get_array_item(const cJSON *array, size_t index)
+CJSON_PUBLIC(cJSON*) cJSON_AddObjectToObject(cJSON * const object, const char * const name)
 {
-    cJSON *current_child = NULL;
-
-    if (array == NULL)
+    cJSON *object_item = cJSON_CreateObject();
+    if (add_item_to_object(object, name, object_item, &global_hooks, false))
     {
-        return NULL;
+        return object_item;
     }
 
-    current_child = array->child;
-    while ((current_child != NULL) && (index > 0))
+    cJSON_Delete(object_item);
+    return NULL;
+}
+
+CJSON_PUBLIC(cJSON*) cJSON_AddArrayToObject(cJSON * const object, const char * const name)
+{
+    cJSON *array = cJSON_CreateArray();
+    if (add_item_to_object(object, name, array, &global_hooks, false))
     {
-        index--;
-        current_child = current_child->next;
+        return array;
     }
 
-    return current_child;
+    cJSON_Delete(array);
+    return NULL;
 }
 
-CJSON_PUBLIC(cJSON *) cJSON_GetArrayItem(const cJSON *array, int index)
+CJSON_PUBLIC(cJSON *) cJSON_DetachItemViaPointer(cJSON *parent, cJSON * const item)
 {
-    if (index < 0)
+    if ((parent == NULL) || (item == NULL))
     {
         return NULL;
     }
 
-    return get_array_item(array, (size_t)index);
-}
-
-static cJSON *get_object_item(const cJSON * const object, const char * const name, const cJSON_bool case_sensitive)
-{
-    cJSON *current_element = NULL;
+    if (!item_is_writable(parent))
+    {
+        /* item is in a shared block, detach its copy */
+        cJSON *copy = item;
+        return make_writable(parent, &copy) ? cJSON_DetachItemViaPointer(parent, copy) : NULL;
+    }
 
-    if ((object == NULL) || (name == NULL))
+    if ((item != parent->child) && (item->prev != NULL))
     {
-        return NULL;
+        /* not the first element */
+        item->prev->next = item->next;
+    }
+    if (item->next != NULL)
+    {
+        /* not the last element */
+        item->next->prev = item->prev;
     }
 
-    current_element = object->child;
-    if (case_sensitive)
+    if (item == parent->child)
     {
-        while ((current_element != NULL) && (current_element->string != NULL) && (strcmp(name, current_element->string) != 0))
-        {
-            current_element = current_element->next;
-        }
+        /* first element */
+        parent->child = item->next;
     }
-    else
+    else if ((item->next == NULL) && (parent->child->prev == item))
     {
-        while ((current_element != NULL) && (case_insensitive_strcmp((const unsigned char*)name, (const unsigned char*)(current_element->string)) != 0))
-        {
-            current_element = current_element->next;
-        }
+        /* last element, the first one has to point to the new end */
+        parent->child->prev = item->prev;
     }
+    index_item_removed(parent, item);
+    /* make sure the detached item doesn't point anywhere anymore */
+    item->prev = NULL;
+    item->next = NULL;
 
-    if ((current_element == NULL) || (current_element->string == NULL)) {
+    return item;
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_DetachItemFromArray(cJSON *array, int which)
+{
+    if (which < 0)
+    {
         return NULL;
     }
 
-    return current_element;
+    return cJSON_DetachItemViaPointer(array, get_array_item(array, (size_t)which));
 }
 
-CJSON_PUBLIC(cJSON *) cJSON_GetObjectItem(const cJSON * const object, const char * const string)
+CJSON_PUBLIC(void) cJSON_DeleteItemFromArray(cJSON *array, int which)
 {
-    return get_object_item(object, string, false);
+    cJSON_Delete(cJSON_DetachItemFromArray(array, which));
 }
 
-CJSON_PUBLIC(cJSON *) cJSON_GetObjectItemCaseSensitive(const cJSON * const object, const char * const string)
+CJSON_PUBLIC(cJSON *) cJSON_DetachItemFromObject(cJSON *object, const char *string)
 {
-    return get_object_item(object, string, true);
+    cJSON *to_detach = cJSON_GetObjectItem(object, string);
+
+    return cJSON_DetachItemViaPointer(object, to_detach);
 }
 
-CJSON_PUBLIC(cJSON_bool) cJSON_HasObjectItem(const cJSON *object, const char *string)
+CJSON_PUBLIC(cJSON *) cJSON_DetachItemFromObjectCaseSensitive(cJSON *object, const char *string)
 {
-    return cJSON_GetObjectItem(object, string) ? 1 : 0;
+    cJSON *to_detach = cJSON_GetObjectItemCaseSensitive(object, string);
+
+    return cJSON_DetachItemViaPointer(object, to_detach);
 }
 
-/* Utility for array list handling. */
-static void suffix_object(cJSON *prev, cJSON *item)
+CJSON_PUBLIC(void) cJSON_DeleteItemFromObject(cJSON *object, const char *string)
 {
-    prev->next = item;
-    item->prev = prev;
+    cJSON_Delete(cJSON_DetachItemFromObject(object, string));
 }
 
-/* Utility for handling references. */
-static cJSON *create_reference(const cJSON *item, const internal_hooks * const hooks)
+CJSON_PUBLIC(void) cJSON_DeleteItemFromObjectCaseSensitive(cJSON *object, const char *string)
 {
-    cJSON *reference = NULL;
-    if (item == NULL)
+    cJSON_Delete(cJSON_DetachItemFromObjectCaseSensitive(object, string));
+}
+
+/* Replace array/object items with new ones. */
+CJSON_PUBLIC(cJSON_bool) cJSON_InsertItemInArray(cJSON *array, int which, cJSON *newitem)
+{
+    cJSON *after_inserted = NULL;
+
+    if ((which < 0) || (array == NULL) || (newitem == NULL) || (array == newitem) || !make_writable(array, NULL))
     {
-        return NULL;
+        return false;
     }
 
-    reference = cJSON_New_Item(hooks);
-    if (reference == NULL)
+    after_inserted = get_array_item(array, (size_t)which);
+    if (after_inserted == NULL)
     {
-        return NULL;
+        return add_item_to_array(array, newitem);
+    }
+    if (!arena_adopt_child(array, newitem))
+    {
+        return false;
     }
 
-    memcpy(reference, item, sizeof(cJSON));
-    reference->string = NULL;
-    reference->type |= cJSON_IsReference;
-    reference->next = reference->prev = NULL;
-    return reference;
+    index_item_inserted(array, (size_t)which, newitem);
+
+    newitem->next = after_inserted;
+    newitem->prev = after_inserted->prev;
+    after_inserted->prev = newitem;
+    if (after_inserted == array->child)
+    {
+        array->child = newitem;
+    }
+    else
+    {
+        newitem->prev->next = newitem;
+    }
+
+    return true;
 }
 
-static cJSON_bool add_item_to_array(cJSON *array, cJSON *item)
+CJSON_PUBLIC(cJSON_bool) cJSON_ReplaceItemViaPointer(cJSON * const parent, cJSON * const item, cJSON * replacement)
 {
-    cJSON *child = NULL;
+    if ((parent == NULL) || (replacement == NULL) || (item == NULL))
+    {
+        return false;
+    }
+
+    if (replacement == item)
+    {
+        return true;
+    }
 
-    if ((item == NULL) || (array == NULL))
+    if (!item_is_writable(parent))
+    {
+        /* item is in a shared block, replace its copy */
+        cJSON *copy = item;
+        return make_writable(parent, &copy) && cJSON_ReplaceItemViaPointer(parent, copy, replacement);
+    }
+    if (!arena_adopt_child(parent, replacement))
     {
         return false;
     }
 
-    child = array->child;
+    index_item_replaced(parent, item, replacement);
 
-    if (child == NULL)
+    replacement->next = item->next;
+    replacement->prev = item->prev;
+
+    if (replacement->next != NULL)
     {
-        /* list is empty, start new one */
-        array->child = item;
+        replacement->next->prev = replacement;
+    }
+    if (parent->child == item)
+    {
+        if (item->prev == item)
+        {
+            /* the only element points to itself as the last one */
+            replacement->prev = replacement;
+        }
+        parent->child = replacement;
     }
     else
     {
-        /* append to the end */
-        while (child->next)
+        /* the prev pointer of the first element isn't followed by next, so only update it here */
+        if (replacement->prev != NULL)
+        {
+            replacement->prev->next = replacement;
+        }
+        if ((replacement->next == NULL) && (parent->child->prev == item))
         {
-            child = child->next;
+            parent->child->prev = replacement;
         }
-        suffix_object(child, item);
     }
 
+    item->next = NULL;
+    item->prev = NULL;
+    cJSON_Delete(item);
+
     return true;
 }
 
-/* Add item to array/object. */
-CJSON_PUBLIC(void) cJSON_AddItemToArray(cJSON *array, cJSON *item)
+CJSON_PUBLIC(cJSON_bool) cJSON_ReplaceItemInArray(cJSON *array, int which, cJSON *newitem)
 {
-    add_item_to_array(array, item);
-}
+    if (which < 0)
+    {
+        return false;
+    }
 
-#if defined(__clang__) || (defined(__GNUC__)  && ((__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ > 5))))
-    #pragma GCC diagnostic push
-#endif
-#ifdef __GNUC__
-#pragma GCC diagnostic ignored "-Wcast-qual"
-#endif
-/* helper function to cast away const */
-static void* cast_away_const(const void* string)
-{
-    return (void*)string;
+    return cJSON_ReplaceItemViaPointer(array, get_array_item(array, (size_t)which), newitem);
 }
-#if defined(__clang__) || (defined(__GNUC__)  && ((__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ > 5))))
-    #pragma GCC diagnostic pop
-#endif
-
 
-static cJSON_bool add_item_to_object(cJSON * const object, const char * const string, cJSON * const item, const internal_hooks * const hooks, const cJSON_bool constant_key)
+static cJSON_bool replace_item_in_object(cJSON *object, const char *string, cJSON *replacement, cJSON_bool case_sensitive)
 {
-    char *new_key = NULL;
-    int new_type = cJSON_Invalid;
+    cJSON *item = NULL;
+    char *key = NULL;
 
-    if ((object == NULL) || (string == NULL) || (item == NULL))
+    if ((replacement == NULL) || (string == NULL))
     {
         return false;
     }
 
-    if (constant_key)
+    /* the replacement stays as it is if there is nothing to replace */
+    item = get_object_item(object, string, case_sensitive);
+    if ((item == NULL) || !make_writable(object, &item))
     {
-        new_key = (char*)cast_away_const(string);
-        new_type = item->type | cJSON_StringIsConst;
+        return false;
     }
-    else
+    key = (char*)cJSON_strdup((const unsigned char*)string, &global_hooks);
+    if (key == NULL)
     {
-        new_key = (char*)cJSON_strdup((const unsigned char*)string, hooks);
-        if (new_key == NULL)
-        {
-            return false;
-        }
-
-        new_type = item->type & ~cJSON_StringIsConst;
+        return false;
     }
-
-    if (!(item->type & cJSON_StringIsConst) && (item->string != NULL))
+    if (!arena_adopt(replacement))
     {
-        hooks->deallocate(item->string);
+        cJSON_free(key);
+        return false;
     }
 
-    item->string = new_key;
-    item->type = new_type;
+    /* replace the name in the replacement */
+    if (!(replacement->type & cJSON_StringIsConst) && (replacement->string != NULL))
+    {
+        cJSON_free(replacement->string);
+    }
+    replacement->string = key;
+    replacement->type &= ~cJSON_StringIsConst;
 
-    return add_item_to_array(object, item);
+    return cJSON_ReplaceItemViaPointer(object, item, replacement);
 }
 
-CJSON_PUBLIC(void) cJSON_AddItemToObject(cJSON *object, const char *string, cJSON *item)
+CJSON_PUBLIC(cJSON_bool) cJSON_ReplaceItemInObject(cJSON *object, const char *string, cJSON *newitem)
 {
-    add_item_to_object(object, string, item, &global_hooks, false);
+    return replace_item_in_object(object, string, newitem, false);
 }
 
-/* Add an item to an object with constant string as key */
-CJSON_PUBLIC(void) cJSON_AddItemToObjectCS(cJSON *object, const char *string, cJSON *item)
+CJSON_PUBLIC(cJSON_bool) cJSON_ReplaceItemInObjectCaseSensitive(cJSON *object, const char *string, cJSON *newitem)
 {
-    add_item_to_object(object, string, item, &global_hooks, true);
+    return replace_item_in_object(object, string, newitem, true);
 }
 
-CJSON_PUBLIC(void) cJSON_AddItemReferenceToArray(cJSON *array, cJSON *item)
+CJSON_PUBLIC(cJSON_bool) cJSON_ReplaceItemValue(cJSON * const item, cJSON * const replacement)
 {
-    if (array == NULL)
+    cJSON *next = NULL;
+    cJSON *prev = NULL;
+    char *string = NULL;
+    int kept = 0;
+
+    /* the root of an arena can't leave it */
+    if ((item == NULL) || (replacement == NULL) || (item == replacement)
+            || ((item->type | replacement->type) & cJSON_IsReadOnly) || (replacement->type & cJSON_IsArenaRoot)
+            || !arena_adopt(item))
     {
-        return;
+        return false;
     }
 
-    add_item_to_array(array, create_reference(item, &global_hooks));
-}
-
-CJSON_PUBLIC(void) cJSON_AddItemReferenceToObject(cJSON *object, const char *string, cJSON *item)
-{
-    if ((object == NULL) || (string == NULL))
+    /* the old value is freed, the key stays */
+    next = item->next;
+    prev = item->prev;
+    string = item->string;
+    kept = item->type & (cJSON_StringIsConst | cJSON_IsArenaItem | cJSON_IsArenaRoot);
+    item->string = NULL;
+    if (!(item->type & (cJSON_IsReference | cJSON_IsShared)))
     {
-        return;
+        delete_item(item->child, &global_hooks);
     }
+    delete_contents(item, &global_hooks);
 
-    add_item_to_object(object, string, create_reference(item, &global_hooks), &global_hooks, false);
-}
+    if (!(replacement->type & cJSON_StringIsConst) && (replacement->string != NULL))
+    {
+        global_hooks.deallocate(replacement->string, global_hooks.user_data);
+    }
+    memcpy(item, replacement, sizeof(cJSON));
+    item->next = next;
+    item->prev = prev;
+    item->string = string;
+    item->type = (item->type & ~(cJSON_StringIsConst | cJSON_IsArenaItem | cJSON_IsArenaRoot)) | kept;
 
-CJSON_PUBLIC(cJSON*) cJSON_AddNullToObject(cJSON * const object, const char * const name)
-{
-    cJSON *null = cJSON_CreateNull();
-    if (add_item_to_object(object, name, null, &global_hooks, false))
+    if (replacement->type & cJSON_IsArenaItem)
     {
-        return null;
+        clear_arena_item(replacement);
+    }
+    else
+    {
+        global_hooks.deallocate(replacement, global_hooks.user_data);
     }
 
-    cJSON_Delete(null);
-    return NULL;
+    return true;
 }
 
-CJSON_PUBLIC(cJSON*) cJSON_AddTrueToObject(cJSON * const object, const char * const name)
+/* Create basic types: */
+CJSON_PUBLIC(cJSON *) cJSON_CreateNull(void)
 {
-    cJSON *true_item = cJSON_CreateTrue();
-    if (add_item_to_object(object, name, true_item, &global_hooks, false))
+    return cJSON_CreateNullWithContext(NULL);
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_CreateNullWithContext(const cJSON_Context *context)
+{
+    internal_hooks hooks = context_hooks(context);
+    cJSON *item = cJSON_New_Item(&hooks);
+    if(item)
     {
-        return true_item;
+        item->type = cJSON_NULL;
     }
 
-    cJSON_Delete(true_item);
-    return NULL;
+    return item;
 }
 
-CJSON_PUBLIC(cJSON*) cJSON_AddFalseToObject(cJSON * const object, const char * const name)
+CJSON_PUBLIC(cJSON *) cJSON_CreateTrue(void)
 {
-    cJSON *false_item = cJSON_CreateFalse();
-    if (add_item_to_object(object, name, false_item, &global_hooks, false))
+    cJSON *item = cJSON_New_Item(&global_hooks);
+    if(item)
     {
-        return false_item;
+        item->type = cJSON_True;
     }
 
-    cJSON_Delete(false_item);
-    return NULL;
+    return item;
 }
 
-CJSON_PUBLIC(cJSON*) cJSON_AddBoolToObject(cJSON * const object, const char * const name, const cJSON_bool boolean)
+CJSON_PUBLIC(cJSON *) cJSON_CreateFalse(void)
 {
-    cJSON *bool_item = cJSON_CreateBool(boolean);
-    if (add_item_to_object(object, name, bool_item, &global_hooks, false))
+    cJSON *item = cJSON_New_Item(&global_hooks);
+    if(item)
     {
-        return bool_item;
+        item->type = cJSON_False;
     }
 
-    cJSON_Delete(bool_item);
-    return NULL;
+    return item;
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_CreateBool(cJSON_bool b)
+{
+    return cJSON_CreateBoolWithContext(b, NULL);
 }
 
-CJSON_PUBLIC(cJSON*) cJSON_AddNumberToObject(cJSON * const object, const char * const name, const double number)
+CJSON_PUBLIC(cJSON *) cJSON_CreateBoolWithContext(cJSON_bool b, const cJSON_Context *context)
 {
-    cJSON *number_item = cJSON_CreateNumber(number);
-    if (add_item_to_object(object, name, number_item, &global_hooks, false))
+    internal_hooks hooks = context_hooks(context);
+    cJSON *item = cJSON_New_Item(&hooks);
+    if(item)
     {
-        return number_item;
+        item->type = b ? cJSON_True : cJSON_False;
     }
 
-    cJSON_Delete(number_item);
-    return NULL;
+    return item;
 }
 
-CJSON_PUBLIC(cJSON*) cJSON_AddStringToObject(cJSON * const object, const char * const name, const char * const string)
+CJSON_PUBLIC(cJSON *) cJSON_CreateNumber(double num)
 {
-    cJSON *string_item = cJSON_CreateString(string);
-    if (add_item_to_object(object, name, string_item, &global_hooks, false))
-    {
-        return string_item;
-    }
-
-    cJSON_Delete(string_item);
-    return NULL;
+    return cJSON_CreateNumberWithContext(num, NULL);
 }
 
-CJSON_PUBLIC(cJSON*) cJSON_AddRawToObject(cJSON * const object, const char * const name, const char * const raw)
+CJSON_PUBLIC(cJSON *) cJSON_CreateNumberWithContext(double num, const cJSON_Context *context)
 {
-    cJSON *raw_item = cJSON_CreateRaw(raw);
-    if (add_item_to_object(object, name, raw_item, &global_hooks, false))
+    internal_hooks hooks = context_hooks(context);
+    cJSON *item = cJSON_New_Item(&hooks);
+    if(item)
     {
-        return raw_item;
+        item->type = cJSON_Number;
+        item_number(item) = num;
+
+        /* use saturation in case of overflow */
+        if (num >= INT_MAX)
+        {
+            item->valueint = INT_MAX;
+        }
+        else if (num <= (double)INT_MIN)
+        {
+            item->valueint = INT_MIN;
+        }
+        else if (num == num)
+        {
+            /* NaN can't be converted */
+            item->valueint = (int)num;
+        }
     }
 
-    cJSON_Delete(raw_item);
-    return NULL;
+    return item;
 }
 
-CJSON_PUBLIC(cJSON*) cJSON_AddObjectToObject(cJSON * const object, const char * const name)
+CJSON_PUBLIC(cJSON *) cJSON_CreateString(const char *string)
 {
-    cJSON *object_item = cJSON_CreateObject();
-    if (add_item_to_object(object, name, object_item, &global_hooks, false))
+    return cJSON_CreateStringWithContext(string, NULL);
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_CreateStringWithContext(const char *string, const cJSON_Context *context)
+{
+    internal_hooks hooks = context_hooks(context);
+    cJSON *item = cJSON_New_Item(&hooks);
+    if(item)
     {
-        return object_item;
+        item->type = cJSON_String;
+#ifdef CJSON_COMPACT_NODES
+        if ((string != NULL) && (strlen(string) < sizeof(item->value.inline_string)))
+        {
+            /* short strings are stored in the item itself */
+            strcpy(item->value.inline_string, string);
+            item->type |= cJSON_StringIsInline;
+            return item;
+        }
+#endif
+        set_valuestring(item, (char*)cJSON_strdup((const unsigned char*)string, &hooks));
+        if(!item_valuestring(item))
+        {
+            delete_item(item, &hooks);
+            return NULL;
+        }
     }
 
-    cJSON_Delete(object_item);
-    return NULL;
+    return item;
 }
 
-CJSON_PUBLIC(cJSON*) cJSON_AddArrayToObject(cJSON * const object, const char * const name)
+CJSON_PUBLIC(cJSON *) cJSON_CreateStringReference(const char *string)
 {
-    cJSON *array = cJSON_CreateArray();
-    if (add_item_to_object(object, name, array, &global_hooks, false))
+    cJSON *item = cJSON_New_Item(&global_hooks);
+    if (item != NULL)
     {
-        return array;
+        item->type = cJSON_String | cJSON_IsReference;
+        set_valuestring(item, (char*)cast_away_const(string));
     }
 
-    cJSON_Delete(array);
-    return NULL;
+    return item;
 }
 
-CJSON_PUBLIC(cJSON *) cJSON_DetachItemViaPointer(cJSON *parent, cJSON * const item)
+CJSON_PUBLIC(cJSON *) cJSON_CreateObjectReference(const cJSON *child)
 {
-    if ((parent == NULL) || (item == NULL))
-    {
-        return NULL;
+    cJSON *item = cJSON_New_Item(&global_hooks);
+    if (item != NULL) {
+        item->type = cJSON_Object | cJSON_IsReference;
+        item->child = (cJSON*)cast_away_const(child);
     }
 
-    if (item->prev != NULL)
-    {
-        /* not the first element */
-        item->prev->next = item->next;
-    }
-    if (item->next != NULL)
-    {
-        /* not the last element */
-        item->next->prev = item->prev;
-    }
+    return item;
+}
 
-    if (item == parent->child)
-    {
-        /* first element */
-        parent->child = item->next;
+CJSON_PUBLIC(cJSON *) cJSON_CreateArrayReference(const cJSON *child) {
+    cJSON *item = cJSON_New_Item(&global_hooks);
+    if (item != NULL) {
+        item->type = cJSON_Array | cJSON_IsReference;
+        item->child = (cJSON*)cast_away_const(child);
     }
-    /* make sure the detached item doesn't point anywhere anymore */
-    item->prev = NULL;
-    item->next = NULL;
 
     return item;
 }
 
-CJSON_PUBLIC(cJSON *) cJSON_DetachItemFromArray(cJSON *array, int which)
+CJSON_PUBLIC(cJSON *) cJSON_CreateRaw(const char *raw)
 {
-    if (which < 0)
+    return cJSON_CreateRawWithContext(raw, NULL);
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_CreateRawWithContext(const char *raw, const cJSON_Context *context)
+{
+    internal_hooks hooks = context_hooks(context);
+    cJSON *item = cJSON_New_Item(&hooks);
+    if(item)
     {
-        return NULL;
+        item->type = cJSON_Raw;
+        set_valuestring(item, (char*)cJSON_strdup((const unsigned char*)raw, &hooks));
+        if(!item_valuestring(item))
+        {
+            delete_item(item, &hooks);
+            return NULL;
+        }
     }
 
-    return cJSON_DetachItemViaPointer(array, get_array_item(array, (size_t)which));
+    return item;
 }
 
-CJSON_PUBLIC(void) cJSON_DeleteItemFromArray(cJSON *array, int which)
+CJSON_PUBLIC(cJSON *) cJSON_CreateArray(void)
 {
-    cJSON_Delete(cJSON_DetachItemFromArray(array, which));
+    return cJSON_CreateArrayWithContext(NULL);
 }
 
-CJSON_PUBLIC(cJSON *) cJSON_DetachItemFromObject(cJSON *object, const char *string)
+CJSON_PUBLIC(cJSON *) cJSON_CreateArrayWithContext(const cJSON_Context *context)
 {
-    cJSON *to_detach = cJSON_GetObjectItem(object, string);
+    internal_hooks hooks = context_hooks(context);
+    cJSON *item = cJSON_New_Item(&hooks);
+    if(item)
+    {
+        item->type=cJSON_Array;
+    }
 
-    return cJSON_DetachItemViaPointer(object, to_detach);
+    return item;
 }
 
-CJSON_PUBLIC(cJSON *) cJSON_DetachItemFromObjectCaseSensitive(cJSON *object, const char *string)
+CJSON_PUBLIC(cJSON *) cJSON_CreateObject(void)
 {
-    cJSON *to_detach = cJSON_GetObjectItemCaseSensitive(object, string);
-
-    return cJSON_DetachItemViaPointer(object, to_detach);
+    return cJSON_CreateObjectWithContext(NULL);
 }
 
-CJSON_PUBLIC(void) cJSON_DeleteItemFromObject(cJSON *object, const char *string)
+CJSON_PUBLIC(cJSON *) cJSON_CreateObjectWithContext(const cJSON_Context *context)
 {
-    cJSON_Delete(cJSON_DetachItemFromObject(object, string));
-}
+    internal_hooks hooks = context_hooks(context);
+    cJSON *item = cJSON_New_Item(&hooks);
+    if (item)
+    {
+        item->type = cJSON_Object;
+    }
 
-CJSON_PUBLIC(void) cJSON_DeleteItemFromObjectCaseSensitive(cJSON *object, const char *string)
-{
-    cJSON_Delete(cJSON_DetachItemFromObjectCaseSensitive(object, string));
+    return item;
 }
 
-/* Replace array/object items with new ones. */
-CJSON_PUBLIC(void) cJSON_InsertItemInArray(cJSON *array, int which, cJSON *newitem)
+/* Create Arrays: */
+CJSON_PUBLIC(cJSON *) cJSON_CreateIntArray(const int *numbers, int count)
 {
-    cJSON *after_inserted = NULL;
+    size_t i = 0;
+    cJSON *n = NULL;
+    cJSON *p = NULL;
+    cJSON *a = NULL;
 
-    if (which < 0)
+    if ((count < 0) || (numbers == NULL))
     {
-        return;
+        return NULL;
     }
 
-    after_inserted = get_array_item(array, (size_t)which);
-    if (after_inserted == NULL)
+    a = cJSON_CreateArray();
+    for(i = 0; a && (i < (size_t)count); i++)
     {
-        add_item_to_array(array, newitem);
-        return;
+        n = cJSON_CreateNumber(numbers[i]);
+        if (!n)
+        {
+            cJSON_Delete(a);
+            return NULL;
+        }
+        if(!i)
+        {
+            a->child = n;
+        }
+        else
+        {
+            suffix_object(p, n);
+        }
+        p = n;
     }
 
-    newitem->next = after_inserted;
-    newitem->prev = after_inserted->prev;
-    after_inserted->prev = newitem;
-    if (after_inserted == array->child)
-    {
-        array->child = newitem;
-    }
-    else
+    if (a && a->child)
     {
-        newitem->prev->next = newitem;
+        a->child->prev = n;
     }
+
+    return a;
 }
 
-CJSON_PUBLIC(cJSON_bool) cJSON_ReplaceItemViaPointer(cJSON * const parent, cJSON * const item, cJSON * replacement)
+CJSON_PUBLIC(cJSON *) cJSON_CreateFloatArray(const float *numbers, int count)
 {
-    if ((parent == NULL) || (replacement == NULL) || (item == NULL))
+    size_t i = 0;
+    cJSON *n = NULL;
+    cJSON *p = NULL;
+    cJSON *a = NULL;
+
+    if ((count < 0) || (numbers == NULL))
     {
-        return false;
+        return NULL;
     }
 
-    if (replacement == item)
+    a = cJSON_CreateArray();
+
+    for(i = 0; a && (i < (size_t)count); i++)
     {
-        return true;
+        n = cJSON_CreateNumber((double)numbers[i]);
+        if(!n)
+        {
+            cJSON_Delete(a);
+            return NULL;
+        }
+        if(!i)
+        {
+            a->child = n;
+        }
+        else
+        {
+            suffix_object(p, n);
+        }
+        p = n;
     }
 
-    replacement->next = item->next;
-    replacement->prev = item->prev;
+    if (a && a->child)
+    {
+        a->child->prev = n;
+    }
 
-    if (replacement->next != NULL)
+    return a;
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_CreateDoubleArray(const double *numbers, int count)
+{
+    size_t i = 0;
+    cJSON *n = NULL;
+    cJSON *p = NULL;
+    cJSON *a = NULL;
+
+    if ((count < 0) || (numbers == NULL))
     {
-        replacement->next->prev = replacement;
+        return NULL;
     }
-    if (replacement->prev != NULL)
+
+    a = cJSON_CreateArray();
+
+    for(i = 0;a && (i < (size_t)count); i++)
     {
-        replacement->prev->next = replacement;
+        n = cJSON_CreateNumber(numbers[i]);
+        if(!n)
+        {
+            cJSON_Delete(a);
+            return NULL;
+        }
+        if(!i)
+        {
+            a->child = n;
+        }
+        else
+        {
+            suffix_object(p, n);
+        }
+        p = n;
     }
-    if (parent->child == item)
+
+    if (a && a->child)
     {
-        parent->child = replacement;
+        a->child->prev = n;
     }
 
-    item->next = NULL;
-    item->prev = NULL;
-    cJSON_Delete(item);
-
-    return true;
+    return a;
 }
 
-CJSON_PUBLIC(void) cJSON_ReplaceItemInArray(cJSON *array, int which, cJSON *newitem)
+CJSON_PUBLIC(cJSON *) cJSON_CreatePackedDoubleArray(const double *numbers, int count)
 {
-    if (which < 0)
+    double *copy = NULL;
+    cJSON *a = NULL;
+
+    if ((count < 0) || (numbers == NULL))
     {
-        return;
+        return NULL;
     }
 
-    cJSON_ReplaceItemViaPointer(array, get_array_item(array, (size_t)which), newitem);
-}
-
-static cJSON_bool replace_item_in_object(cJSON *object, const char *string, cJSON *replacement, cJSON_bool case_sensitive)
-{
-    if ((replacement == NULL) || (string == NULL))
+    a = cJSON_CreateArray();
+    if ((a == NULL) || (count == 0))
     {
-        return false;
+        /* empty arrays are never packed */
+        return a;
     }
 
-    /* replace the name in the replacement */
-    if (!(replacement->type & cJSON_StringIsConst) && (replacement->string != NULL))
+    copy = (double*)global_hooks.allocate((size_t)count * sizeof(double), global_hooks.user_data);
+    if (copy == NULL)
     {
-        cJSON_free(replacement->string);
+        cJSON_Delete(a);
+        return NULL;
     }
-    replacement->string = (char*)cJSON_strdup((const unsigned char*)string, &global_hooks);
-    replacement->type &= ~cJSON_StringIsConst;
-
-    cJSON_ReplaceItemViaPointer(object, get_object_item(object, string, case_sensitive), replacement);
+    memcpy(copy, numbers, (size_t)count * sizeof(double));
 
-    return true;
-}
+    a->type = cJSON_Array | cJSON_IsLazy | cJSON_IsPacked;
+    set_valuestring(a, (char*)(void*)copy);
+    a->valueint = count;
 
-CJSON_PUBLIC(void) cJSON_ReplaceItemInObject(cJSON *object, const char *string, cJSON *newitem)
-{
-    replace_item_in_object(object, string, newitem, false);
+    return a;
 }
 
-CJSON_PUBLIC(void) cJSON_ReplaceItemInObjectCaseSensitive(cJSON *object, const char *string, cJSON *newitem)
+CJSON_PUBLIC(cJSON *) cJSON_CreateStringArray(const char **strings, int count)
 {
-    replace_item_in_object(object, string, newitem, true);
-}
+    size_t i = 0;
+    cJSON *n = NULL;
+    cJSON *p = NULL;
+    cJSON *a = NULL;
 
-/* Create basic types: */
-CJSON_PUBLIC(cJSON *) cJSON_CreateNull(void)
-{
-    cJSON *item = cJSON_New_Item(&global_hooks);
-    if(item)
+    if ((count < 0) || (strings == NULL))
     {
-        item->type = cJSON_NULL;
+        return NULL;
     }
 
-    return item;
-}
+    a = cJSON_CreateArray();
 
-CJSON_PUBLIC(cJSON *) cJSON_CreateTrue(void)
-{
-    cJSON *item = cJSON_New_Item(&global_hooks);
-    if(item)
+    for (i = 0; a && (i < (size_t)count); i++)
     {
-        item->type = cJSON_True;
+        n = cJSON_CreateString(strings[i]);
+        if(!n)
+        {
+            cJSON_Delete(a);
+            return NULL;
+        }
+        if(!i)
+        {
+            a->child = n;
+        }
+        else
+        {
+            suffix_object(p,n);
+        }
+        p = n;
     }
 
-    return item;
-}
-
-CJSON_PUBLIC(cJSON *) cJSON_CreateFalse(void)
-{
-    cJSON *item = cJSON_New_Item(&global_hooks);
-    if(item)
+    if (a && a->child)
     {
-        item->type = cJSON_False;
+        a->child->prev = n;
     }
 
-    return item;
+    return a;
 }
 
-CJSON_PUBLIC(cJSON *) cJSON_CreateBool(cJSON_bool b)
+/* Duplication */
+static cJSON *duplicate_item(const cJSON *item, cJSON_bool recurse, const internal_hooks * const hooks)
 {
-    cJSON *item = cJSON_New_Item(&global_hooks);
-    if(item)
+    cJSON *newitem = NULL;
+    cJSON *child = NULL;
+    cJSON *next = NULL;
+    cJSON *newchild = NULL;
+
+    /* Bail on bad ptr, the copy doesn't refer to the text of a lazy item */
+    if (!item || (!item_is_packed(item) && !materialize(item)))
     {
-        item->type = b ? cJSON_True : cJSON_False;
+        goto fail;
     }
-
-    return item;
-}
-
-CJSON_PUBLIC(cJSON *) cJSON_CreateNumber(double num)
-{
-    cJSON *item = cJSON_New_Item(&global_hooks);
-    if(item)
+    /* Create new item */
+    newitem = cJSON_New_Item(hooks);
+    if (!newitem)
     {
-        item->type = cJSON_Number;
-        item->valuedouble = num;
-
-        /* use saturation in case of overflow */
-        if (num >= INT_MAX)
+        goto fail;
+    }
+    /* Copy over all vars, the copy gets children of its own */
+    newitem->type = item->type & (~(cJSON_IsReference | cJSON_IsArenaItem | cJSON_IsArenaRoot | cJSON_IsShared | cJSON_IsReadOnly));
+    newitem->valueint = item->valueint;
+#ifdef CJSON_COMPACT_NODES
+    if (cJSON_IsNumber(item) || string_is_inline(item))
+    {
+        /* stored in the item itself */
+        newitem->value = item->value;
+    }
+#else
+    newitem->valuedouble = item->valuedouble;
+#endif
+    if (item_is_packed(item) && !recurse)
+    {
+        /* the numbers are its children */
+        newitem->type &= ~(cJSON_IsLazy | cJSON_IsPacked);
+        newitem->valueint = 0;
+    }
+    else if (item_is_packed(item) && !hooks_are_global(hooks))
+    {
+        /* unpack would free the numbers and create the items with the global hooks, so the copy is a normal array */
+        newitem->type &= ~(cJSON_IsLazy | cJSON_IsPacked);
+        newitem->valueint = 0;
+        newitem->child = create_number_list(packed_numbers(item), (size_t)item->valueint, hooks);
+        if (newitem->child == NULL)
         {
-            item->valueint = INT_MAX;
+            goto fail;
         }
-        else if (num <= (double)INT_MIN)
+    }
+    else if (item_is_packed(item))
+    {
+        double *numbers = (double*)hooks->allocate((size_t)item->valueint * sizeof(double), hooks->user_data);
+        if (numbers == NULL)
         {
-            item->valueint = INT_MIN;
+            goto fail;
         }
-        else
+        memcpy(numbers, packed_numbers(item), (size_t)item->valueint * sizeof(double));
+        set_valuestring(newitem, (char*)(void*)numbers);
+    }
+    else if ((item_valuestring(item) != NULL) && !string_is_inline(item))
+    {
+        set_valuestring(newitem, (char*)cJSON_strdup((unsigned char*)item_valuestring(item), hooks));
+        if (!item_valuestring(newitem))
         {
-            item->valueint = (int)num;
+            goto fail;
         }
     }
-
-    return item;
-}
-
-CJSON_PUBLIC(cJSON *) cJSON_CreateString(const char *string)
-{
-    cJSON *item = cJSON_New_Item(&global_hooks);
-    if(item)
+    if (item->string)
     {
-        item->type = cJSON_String;
-        item->valuestring = (char*)cJSON_strdup((const unsigned char*)string, &global_hooks);
-        if(!item->valuestring)
+        /* keys of arena items are only constant as long as the arena exists */
+        if (item->type & cJSON_IsArenaItem)
         {
-            cJSON_Delete(item);
-            return NULL;
+            newitem->type &= ~cJSON_StringIsConst;
+        }
+        newitem->string = (newitem->type&cJSON_StringIsConst) ? item->string : (char*)cJSON_strdup((unsigned char*)item->string, hooks);
+        if (!newitem->string)
+        {
+            goto fail;
+        }
+    }
+    /* If non-recursive, then we're done! */
+    if (!recurse)
+    {
+        return newitem;
+    }
+    /* Walk the ->next chain for the child. */
+    child = item->child;
+    while (child != NULL)
+    {
+        newchild = duplicate_item(child, true, hooks); /* Duplicate (with recurse) each item in the ->next chain */
+        if (!newchild)
+        {
+            goto fail;
+        }
+        if (next != NULL)
+        {
+            /* If newitem->child already set, then crosswire ->prev and ->next and move on */
+            next->next = newchild;
+            newchild->prev = next;
+            next = newchild;
+        }
+        else
+        {
+            /* Set newitem->child and move to it */
+            newitem->child = newchild;
+            next = newchild;
         }
+        child = child->next;
+    }
+    if (newitem && newitem->child)
+    {
+        newitem->child->prev = newchild;
     }
 
-    return item;
-}
+    return newitem;
 
-CJSON_PUBLIC(cJSON *) cJSON_CreateStringReference(const char *string)
-{
-    cJSON *item = cJSON_New_Item(&global_hooks);
-    if (item != NULL)
+fail:
+    if (newitem != NULL)
     {
-        item->type = cJSON_String | cJSON_IsReference;
-        item->valuestring = (char*)cast_away_const(string);
+        delete_item(newitem, hooks);
     }
 
-    return item;
+    return NULL;
 }
 
-CJSON_PUBLIC(cJSON *) cJSON_CreateObjectReference(const cJSON *child)
+CJSON_PUBLIC(cJSON *) cJSON_Duplicate(const cJSON *item, cJSON_bool recurse)
 {
-    cJSON *item = cJSON_New_Item(&global_hooks);
-    if (item != NULL) {
-        item->type = cJSON_Object | cJSON_IsReference;
-        item->child = (cJSON*)cast_away_const(child);
-    }
-
-    return item;
+    return duplicate_item(item, recurse, &global_hooks);
 }
 
-CJSON_PUBLIC(cJSON *) cJSON_CreateArrayReference(const cJSON *child) {
-    cJSON *item = cJSON_New_Item(&global_hooks);
-    if (item != NULL) {
-        item->type = cJSON_Array | cJSON_IsReference;
-        item->child = (cJSON*)cast_away_const(child);
-    }
-
-    return item;
+CJSON_PUBLIC(cJSON *) cJSON_DuplicateWithContext(const cJSON *item, cJSON_bool recurse, const cJSON_Context *context)
+{
+    internal_hooks hooks = context_hooks(context);
+    return duplicate_item(item, recurse, &hooks);
 }
 
-CJSON_PUBLIC(cJSON *) cJSON_CreateRaw(const char *raw)
+static shared_children *freeze_children(const cJSON * const item, const internal_hooks * const hooks);
+
+/* A copy of item for a block. Arrays and objects that share a block already share it with the copy,
+ * the others get a block of their own, so every level only has to be copied once. */
+static cJSON *freeze_item(const cJSON * const item, const internal_hooks * const hooks)
 {
-    cJSON *item = cJSON_New_Item(&global_hooks);
-    if(item)
+    shared_children *shared = NULL;
+    cJSON *copy = NULL;
+
+    if (item_is_shared(item))
     {
-        item->type = cJSON_Raw;
-        item->valuestring = (char*)cJSON_strdup((const unsigned char*)raw, &global_hooks);
-        if(!item->valuestring)
+        shared = shared_of(item);
+        acquire_shared(shared);
+    }
+    else if ((cJSON_IsArray(item) || cJSON_IsObject(item)) && (item_is_lazy(item) || (item->child != NULL)))
+    {
+        shared = freeze_children(item, hooks);
+        if (shared == NULL)
         {
-            cJSON_Delete(item);
             return NULL;
         }
     }
 
-    return item;
-}
-
-CJSON_PUBLIC(cJSON *) cJSON_CreateArray(void)
-{
-    cJSON *item = cJSON_New_Item(&global_hooks);
-    if(item)
+    /* without its children */
+    copy = duplicate_item(item, false, hooks);
+    if (copy == NULL)
     {
-        item->type=cJSON_Array;
+        if (shared != NULL)
+        {
+            release_block(shared);
+        }
+        return NULL;
     }
-
-    return item;
-}
-
-CJSON_PUBLIC(cJSON *) cJSON_CreateObject(void)
-{
-    cJSON *item = cJSON_New_Item(&global_hooks);
-    if (item)
+    copy->type |= cJSON_IsReadOnly;
+    if (shared != NULL)
     {
-        item->type = cJSON_Object;
+        set_valuestring(copy, (char*)(void*)shared);
+        copy->child = shared->child;
+        copy->type |= cJSON_IsShared;
     }
 
-    return item;
+    return copy;
 }
 
-/* Create Arrays: */
-CJSON_PUBLIC(cJSON *) cJSON_CreateIntArray(const int *numbers, int count)
+/* Copy the children of an array or object into a new block */
+static shared_children *freeze_children(const cJSON * const item, const internal_hooks * const hooks)
 {
-    size_t i = 0;
-    cJSON *n = NULL;
-    cJSON *p = NULL;
-    cJSON *a = NULL;
+    shared_children *shared = NULL;
+    cJSON *head = NULL;
+    cJSON *current_item = NULL;
+    cJSON *child = NULL;
 
-    if ((count < 0) || (numbers == NULL))
+    if (item_is_packed(item))
     {
-        return NULL;
+        /* the numbers are read where they are, they don't need to be unpacked */
+        head = create_number_list(packed_numbers(item), (size_t)item->valueint, hooks);
+        if (head == NULL)
+        {
+            return NULL;
+        }
+        for (child = head; child != NULL; child = child->next)
+        {
+            child->type |= cJSON_IsReadOnly;
+        }
     }
-
-    a = cJSON_CreateArray();
-    for(i = 0; a && (i < (size_t)count); i++)
+    else
     {
-        n = cJSON_CreateNumber(numbers[i]);
-        if (!n)
+        if (!read_children(item, &child))
         {
-            cJSON_Delete(a);
             return NULL;
         }
-        if(!i)
+        for (; child != NULL; child = child->next)
         {
-            a->child = n;
+            cJSON *copy = freeze_item(child, hooks);
+            if (copy == NULL)
+            {
+                delete_item(head, hooks);
+                return NULL;
+            }
+            if (head == NULL)
+            {
+                head = copy;
+            }
+            else
+            {
+                current_item->next = copy;
+                copy->prev = current_item;
+            }
+            current_item = copy;
         }
-        else
+        if (head != NULL)
         {
-            suffix_object(p, n);
+            head->prev = current_item;
         }
-        p = n;
     }
 
-    return a;
-}
-
-CJSON_PUBLIC(cJSON *) cJSON_CreateFloatArray(const float *numbers, int count)
-{
-    size_t i = 0;
-    cJSON *n = NULL;
-    cJSON *p = NULL;
-    cJSON *a = NULL;
-
-    if ((count < 0) || (numbers == NULL))
+    shared = (shared_children*)hooks->allocate(sizeof(shared_children), hooks->user_data);
+    if (shared == NULL)
     {
+        delete_item(head, hooks);
         return NULL;
     }
+    shared->child = head;
+    shared->hooks = *hooks;
+    shared->references = 1;
 
-    a = cJSON_CreateArray();
+    return shared;
+}
 
-    for(i = 0; a && (i < (size_t)count); i++)
+/* Give a shared array or object children of its own. Only one level is copied, the arrays
+ * and objects among the children keep sharing their blocks. */
+static cJSON_bool unshare(cJSON * const item)
+{
+    shared_children *shared = shared_of(item);
+    internal_hooks hooks = shared->hooks;
+    cJSON *head = NULL;
+    cJSON *current_item = NULL;
+    cJSON *child = NULL;
+
+    if (shared_is_unique(shared))
     {
-        n = cJSON_CreateNumber((double)numbers[i]);
-        if(!n)
+        /* nobody else shares them, so they are taken over */
+        head = shared->child;
+        for (child = head; child != NULL; child = child->next)
         {
-            cJSON_Delete(a);
-            return NULL;
+            child->type &= ~cJSON_IsReadOnly;
         }
-        if(!i)
+        hooks.deallocate(shared, hooks.user_data);
+    }
+    else
+    {
+        for (child = shared->child; child != NULL; child = child->next)
         {
-            a->child = n;
+            cJSON *copy = freeze_item(child, &hooks);
+            if (copy == NULL)
+            {
+                delete_item(head, &hooks);
+                return false;
+            }
+            copy->type &= ~cJSON_IsReadOnly;
+            if (head == NULL)
+            {
+                head = copy;
+            }
+            else
+            {
+                current_item->next = copy;
+                copy->prev = current_item;
+            }
+            current_item = copy;
         }
-        else
+        if (head != NULL)
         {
-            suffix_object(p, n);
+            head->prev = current_item;
         }
-        p = n;
+
+        /* the others might have let go of the block in the meantime */
+        release_block(shared);
     }
 
-    return a;
+    set_valuestring(item, NULL);
+    item->child = head;
+    item->type &= ~cJSON_IsShared;
+
+    return true;
 }
 
-CJSON_PUBLIC(cJSON *) cJSON_CreateDoubleArray(const double *numbers, int count)
+/* Prepare an array or object for changing its children: lazy items are parsed and shared children copied.
+ * If child isn't NULL, it points to one of the children and is moved to its copy. Items in a block can't be changed. */
+static cJSON_bool make_writable(cJSON * const item, cJSON ** const child)
 {
-    size_t i = 0;
-    cJSON *n = NULL;
-    cJSON *p = NULL;
-    cJSON *a = NULL;
+    cJSON *current_child = NULL;
+    size_t position = 0;
 
-    if ((count < 0) || (numbers == NULL))
+    if ((item->type & cJSON_IsReadOnly) || !materialize(item))
     {
-        return NULL;
+        return false;
+    }
+    if (!item_is_shared(item))
+    {
+        return true;
     }
 
-    a = cJSON_CreateArray();
-
-    for(i = 0;a && (i < (size_t)count); i++)
+    if (child != NULL)
     {
-        n = cJSON_CreateNumber(numbers[i]);
-        if(!n)
+        for (current_child = item->child; (current_child != NULL) && (current_child != *child); current_child = current_child->next)
         {
-            cJSON_Delete(a);
-            return NULL;
+            position++;
         }
-        if(!i)
+        if (current_child == NULL)
         {
-            a->child = n;
+            /* not one of the children */
+            return false;
         }
-        else
+    }
+
+    if (!unshare(item))
+    {
+        return false;
+    }
+
+    if (child != NULL)
+    {
+        for (current_child = item->child; position > 0; position--)
         {
-            suffix_object(p, n);
+            current_child = current_child->next;
         }
-        p = n;
+        *child = current_child;
     }
 
-    return a;
+    return true;
 }
 
-CJSON_PUBLIC(cJSON *) cJSON_CreateStringArray(const char **strings, int count)
+CJSON_PUBLIC(cJSON *) cJSON_DuplicateShared(const cJSON *item)
 {
-    size_t i = 0;
-    cJSON *n = NULL;
-    cJSON *p = NULL;
-    cJSON *a = NULL;
+    cJSON *copy = NULL;
 
-    if ((count < 0) || (strings == NULL))
+    if (item == NULL)
     {
         return NULL;
     }
 
-    a = cJSON_CreateArray();
+    copy = freeze_item(item, &global_hooks);
+    if (copy != NULL)
+    {
+        /* only its children are in a block */
+        copy->type &= ~cJSON_IsReadOnly;
+    }
 
-    for (i = 0; a && (i < (size_t)count); i++)
+    return copy;
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_Unshare(cJSON *item)
+{
+    if (item == NULL)
     {
-        n = cJSON_CreateString(strings[i]);
-        if(!n)
-        {
-            cJSON_Delete(a);
-            return NULL;
-        }
-        if(!i)
+        return false;
+    }
+    if (!cJSON_IsArray(item) && !cJSON_IsObject(item))
+    {
+        /* no children to copy */
+        return true;
+    }
+
+    return make_writable(item, NULL);
+}
+
+/* Finds item below parent, the positions of the children on the path to it are stored once its depth is known */
+static cJSON_bool find_path(const cJSON * const parent, const cJSON * const item, const size_t depth, size_t ** const positions, size_t * const length)
+{
+    const cJSON *child = NULL;
+    size_t position = 0;
+
+    /* lazy items have no children yet, so item can't be among them */
+    for (child = parent->child; child != NULL; (void)(child = child->next), position++)
+    {
+        if (child == item)
         {
-            a->child = n;
+            *positions = (size_t*)global_hooks.allocate((depth + 1) * sizeof(size_t), global_hooks.user_data);
+            if (*positions == NULL)
+            {
+                return false;
+            }
+            *length = depth + 1;
         }
-        else
+        else if ((child->child == NULL) || !find_path(child, item, depth + 1, positions, length))
         {
-            suffix_object(p,n);
+            continue;
         }
-        p = n;
+
+        (*positions)[depth] = position;
+        return true;
     }
 
-    return a;
+    return false;
 }
 
-/* Duplication */
-CJSON_PUBLIC(cJSON *) cJSON_Duplicate(const cJSON *item, cJSON_bool recurse)
+CJSON_PUBLIC(cJSON *) cJSON_UnshareItem(cJSON *root, const cJSON *item)
 {
-    cJSON *newitem = NULL;
-    cJSON *child = NULL;
-    cJSON *next = NULL;
-    cJSON *newchild = NULL;
+    size_t *positions = NULL;
+    size_t length = 0;
+    size_t level = 0;
+    size_t position = 0;
+    cJSON *current_item = root;
 
-    /* Bail on bad ptr */
-    if (!item)
+    if ((root == NULL) || (item == NULL))
     {
-        goto fail;
+        return NULL;
     }
-    /* Create new item */
-    newitem = cJSON_New_Item(&global_hooks);
-    if (!newitem)
+    if ((root != item) && !find_path(root, item, 0, &positions, &length))
     {
-        goto fail;
+        return NULL;
     }
-    /* Copy over all vars */
-    newitem->type = item->type & (~cJSON_IsReference);
-    newitem->valueint = item->valueint;
-    newitem->valuedouble = item->valuedouble;
-    if (item->valuestring)
+
+    /* unsharing keeps the children in their order */
+    for (level = 0; (level < length) && (current_item != NULL); level++)
     {
-        newitem->valuestring = (char*)cJSON_strdup((unsigned char*)item->valuestring, &global_hooks);
-        if (!newitem->valuestring)
+        if (!make_writable(current_item, NULL))
         {
-            goto fail;
+            current_item = NULL;
+            break;
         }
-    }
-    if (item->string)
-    {
-        newitem->string = (item->type&cJSON_StringIsConst) ? item->string : (char*)cJSON_strdup((unsigned char*)item->string, &global_hooks);
-        if (!newitem->string)
+        current_item = current_item->child;
+        for (position = positions[level]; position > 0; position--)
         {
-            goto fail;
+            current_item = current_item->next;
         }
     }
-    /* If non-recursive, then we're done! */
-    if (!recurse)
+    if (positions != NULL)
     {
-        return newitem;
+        global_hooks.deallocate(positions, global_hooks.user_data);
     }
-    /* Walk the ->next chain for the child. */
-    child = item->child;
-    while (child != NULL)
+
+    if ((current_item != NULL) && !cJSON_Unshare(current_item))
     {
-        newchild = cJSON_Duplicate(child, true); /* Duplicate (with recurse) each item in the ->next chain */
-        if (!newchild)
+        return NULL;
+    }
+
+    return current_item;
+}
+
+#define is_minify_whitespace(character) (((character) == ' ') || ((character) == '\t') || ((character) == '\r') || ((character) == '\n'))
+
+/* Move whole blocks that contain neither strings nor comments, 16 or 32 at a time with SSE2 or AVX2.
+ * Blocks without whitespace are stored as they are, blocks of only whitespace are dropped.
+ * Stops at the first block that needs a closer look. */
+static void minify_blocks(unsigned char * const json, const size_t length, size_t * const position, size_t * const output)
+{
+#if defined(CJSON_SIMD_AVX2)
+    const __m256i spaces = _mm256_set1_epi8(' ');
+    const __m256i tabs = _mm256_set1_epi8('\t');
+    const __m256i carriage_returns = _mm256_set1_epi8('\r');
+    const __m256i newlines = _mm256_set1_epi8('\n');
+    const __m256i quotes = _mm256_set1_epi8('\"');
+    const __m256i slashes = _mm256_set1_epi8('/');
+    while ((length - *position) >= sizeof(__m256i))
+    {
+        __m256i block = _mm256_loadu_si256((const __m256i*)(json + *position));
+        unsigned int whitespace = (unsigned int)_mm256_movemask_epi8(_mm256_or_si256(
+                _mm256_or_si256(_mm256_cmpeq_epi8(block, spaces), _mm256_cmpeq_epi8(block, tabs)),
+                _mm256_or_si256(_mm256_cmpeq_epi8(block, carriage_returns), _mm256_cmpeq_epi8(block, newlines))));
+        if (_mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(block, quotes), _mm256_cmpeq_epi8(block, slashes))) != 0)
         {
-            goto fail;
+            return;
         }
-        if (next != NULL)
+        if (whitespace == 0)
         {
-            /* If newitem->child already set, then crosswire ->prev and ->next and move on */
-            next->next = newchild;
-            newchild->prev = next;
-            next = newchild;
+            _mm256_storeu_si256((__m256i*)(json + *output), block);
+            *output += sizeof(__m256i);
         }
-        else
+        else if (whitespace != 0xFFFFFFFFU)
         {
-            /* Set newitem->child and move to it */
-            newitem->child = newchild;
-            next = newchild;
+            return;
         }
-        child = child->next;
-    }
-
-    return newitem;
-
-fail:
-    if (newitem != NULL)
-    {
-        cJSON_Delete(newitem);
+        *position += sizeof(__m256i);
+    }
+#elif defined(CJSON_SIMD_SSE2)
+    const __m128i spaces = _mm_set1_epi8(' ');
+    const __m128i tabs = _mm_set1_epi8('\t');
+    const __m128i carriage_returns = _mm_set1_epi8('\r');
+    const __m128i newlines = _mm_set1_epi8('\n');
+    const __m128i quotes = _mm_set1_epi8('\"');
+    const __m128i slashes = _mm_set1_epi8('/');
+    while ((length - *position) >= sizeof(__m128i))
+    {
+        __m128i block = _mm_loadu_si128((const __m128i*)(json + *position));
+        int whitespace = _mm_movemask_epi8(_mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(block, spaces), _mm_cmpeq_epi8(block, tabs)),
+                _mm_or_si128(_mm_cmpeq_epi8(block, carriage_returns), _mm_cmpeq_epi8(block, newlines))));
+        if (_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(block, quotes), _mm_cmpeq_epi8(block, slashes))) != 0)
+        {
+            return;
+        }
+        if (whitespace == 0)
+        {
+            _mm_storeu_si128((__m128i*)(json + *output), block);
+            *output += sizeof(__m128i);
+        }
+        else if (whitespace != 0xFFFF)
+        {
+            return;
+        }
+        *position += sizeof(__m128i);
     }
-
-    return NULL;
+#else
+    (void)json;
+    (void)length;
+    (void)position;
+    (void)output;
+#endif
 }
 
-static void skip_oneline_comment(char **input)
+/* The length of the rest of a string that starts after its opening quotation mark, including the closing one.
+ * Only \" counts as an escape sequence, which keeps the output the same as that of older versions. */
+static size_t minify_string_length(const unsigned char * const input, const size_t length)
 {
-    *input += static_strlen("//");
+    size_t position = 0;
 
-    for (; (*input)[0] != '\0'; ++(*input))
+    while (position < length)
     {
-        if ((*input)[0] == '\n') {
-            *input += static_strlen("\n");
-            return;
+        position += count_plain_characters(input + position, length - position, false);
+        if (position >= length)
+        {
+            break;
+        }
+        if (input[position] == '\"')
+        {
+            return position + static_strlen("\"");
+        }
+
+        /* backslash */
+        if (((position + 1) < length) && (input[position + 1] == '\"'))
+        {
+            position += static_strlen("\\\"");
+        }
+        else
+        {
+            position++;
         }
     }
+
+    return length;
 }
 
-static void skip_multiline_comment(char **input)
+/* Runs between tokens and most strings are short, so their first characters are copied one at a time
+ * and only longer runs are handed to minify_blocks or minify_string_length. */
+#define MINIFY_SCALAR_RUN 32
+
+/* Remove whitespace and comments from the first length bytes of json, returns the new length */
+static size_t minify(unsigned char * const json, const size_t length)
 {
-    *input += static_strlen("/*");
+    size_t position = 0;
+    size_t output = 0;
 
-    for (; (*input)[0] != '\0'; ++(*input))
+    while (position < length)
     {
-        if (((*input)[0] == '*') && ((*input)[1] == '/'))
+        size_t run_end = 0;
+        size_t copied = 0;
+        const unsigned char *end = NULL;
+
+        switch (json[position])
         {
-            *input += static_strlen("*/");
-            return;
-        }
-    }
-}
+            case '/':
+                if (((position + 1) < length) && (json[position + 1] == '/'))
+                {
+                    /* up to and including the end of the line */
+                    position += static_strlen("//");
+                    end = (const unsigned char*)memchr(json + position, '\n', length - position);
+                    position = (end != NULL) ? (size_t)(end - json) + static_strlen("\n") : length;
+                }
+                else if (((position + 1) < length) && (json[position + 1] == '*'))
+                {
+                    position += static_strlen("/*");
+                    for (;;)
+                    {
+                        end = (const unsigned char*)memchr(json + position, '*', length - position);
+                        if ((end == NULL) || ((size_t)(end - json) + 1 >= length))
+                        {
+                            position = length;
+                            break;
+                        }
+                        position = (size_t)(end - json) + 1;
+                        if (json[position] == '/')
+                        {
+                            position += static_strlen("/");
+                            break;
+                        }
+                    }
+                }
+                else
+                {
+                    /* a single slash can't be part of JSON */
+                    position++;
+                }
+                continue;
 
-static void minify_string(char **input, char **output) {
-    (*output)[0] = (*input)[0];
-    *input += static_strlen("\"");
-    *output += static_strlen("\"");
+            case '\"':
+                run_end = ((length - position) > MINIFY_SCALAR_RUN) ? (position + MINIFY_SCALAR_RUN) : length;
+                do
+                {
+                    json[output++] = json[position++];
+                } while ((position < run_end) && (json[position] != '\"') && (json[position] != '\\'));
+                if ((position < run_end) && (json[position] == '\"'))
+                {
+                    json[output++] = json[position++];
+                    continue;
+                }
 
+                copied = minify_string_length(json + position, length - position);
+                if (output != position)
+                {
+                    memmove(json + output, json + position, copied);
+                }
+                output += copied;
+                position += copied;
+                continue;
 
-    for (; (*input)[0] != '\0'; (void)++(*input), ++(*output)) {
-        (*output)[0] = (*input)[0];
+            default:
+                break;
+        }
 
-        if ((*input)[0] == '\"') {
-            (*output)[0] = '\"';
-            *input += static_strlen("\"");
-            *output += static_strlen("\"");
-            return;
-        } else if (((*input)[0] == '\\') && ((*input)[1] == '\"')) {
-            (*output)[1] = (*input)[1];
-            *input += static_strlen("\"");
-            *output += static_strlen("\"");
+        /* tokens and whitespace up to the next string or comment */
+        run_end = ((length - position) > MINIFY_SCALAR_RUN) ? (position + MINIFY_SCALAR_RUN) : length;
+        for (; (position < run_end) && (json[position] != '\"') && (json[position] != '/'); position++)
+        {
+            /* always store, but only keep what isn't whitespace */
+            json[output] = json[position];
+            output += is_minify_whitespace(json[position]) ? 0 : 1;
+        }
+        if (position == run_end)
+        {
+            minify_blocks(json, length, &position, &output);
         }
     }
+
+    return output;
 }
 
 CJSON_PUBLIC(void) cJSON_Minify(char *json)
 {
-    char *into = json;
-
     if (json == NULL)
     {
         return;
-    }
-
-    while (json[0] != '\0')
-    {
-        switch (json[0])
-        {
-            case ' ':
-            case '\t':
-            case '\r':
-            case '\n':
-                json++;
-                break;
+    }
 
-            case '/':
-                if (json[1] == '/')
-                {
-                    skip_oneline_comment(&json);
-                }
-                else if (json[1] == '*')
-                {
-                    skip_multiline_comment(&json);
-                }
-                break;
+    json[minify((unsigned char*)json, strlen(json))] = '\0';
+}
 
-            case '\"':
-                minify_string(&json, (char**)&into);
-                break;
+CJSON_PUBLIC(size_t) cJSON_MinifyLen(char *json, size_t length)
+{
+    size_t minified_length = 0;
 
-            default:
-                into[0] = json[0];
-                json++;
-                into++;
-        }
+    if (json == NULL)
+    {
+        return 0;
     }
 
-    /* and null-terminate. */
-    *into = '\0';
+    minified_length = minify((unsigned char*)json, length);
+    if (minified_length < length)
+    {
+        json[minified_length] = '\0';
+    }
+
+    return minified_length;
 }
 
 CJSON_PUBLIC(cJSON_bool) cJSON_IsInvalid(const cJSON * const item)
@@ -2835,6 +9074,375 @@ CJSON_PUBLIC(cJSON_bool) cJSON_IsRaw(const cJSON * const item)
     return (item->type & 0xFF) == cJSON_Raw;
 }
 
+/* finalizer of MurmurHash3, spreads every bit of the input over the whole hash */
+static unsigned long mix_hash(unsigned long hash)
+{
+    hash ^= hash >> 16;
+    hash = (hash * 0x85EBCA6BUL) & 0xFFFFFFFFUL;
+    hash ^= hash >> 13;
+    hash = (hash * 0xC2B2AE35UL) & 0xFFFFFFFFUL;
+    hash ^= hash >> 16;
+
+    return hash;
+}
+
+/* 32 bit FNV-1a */
+static unsigned long hash_string(unsigned long hash, const unsigned char *string, const cJSON_bool case_sensitive)
+{
+    for (; *string != '\0'; string++)
+    {
+        hash = ((hash ^ (unsigned long)(case_sensitive ? *string : tolower(*string))) * 16777619UL) & 0xFFFFFFFFUL;
+    }
+
+    return hash;
+}
+
+/* hashes of arrays and objects by their address, open addressing with linear probing */
+struct cJSON_HashMemo
+{
+    const cJSON **items; /* NULL for free slots */
+    unsigned long *hashes;
+    size_t capacity; /* always a power of 2 */
+    size_t count;
+    cJSON_bool case_sensitive;
+};
+
+static const size_t minimum_hash_memo_capacity = 64;
+
+/* items are at least pointer aligned, so the lowest bits of their address don't say anything */
+#define hash_memo_slot(memo, item) ((((size_t)(const void*)(item) / sizeof(void*)) * 2654435761UL) & ((memo)->capacity - 1))
+
+static cJSON_bool hash_memo_lookup(const cJSON_HashMemo * const memo, const cJSON * const item, unsigned long * const hash)
+{
+    size_t slot = hash_memo_slot(memo, item);
+
+    while (memo->items[slot] != NULL)
+    {
+        if (memo->items[slot] == item)
+        {
+            *hash = memo->hashes[slot];
+            return true;
+        }
+        slot = (slot + 1) & (memo->capacity - 1);
+    }
+
+    return false;
+}
+
+static cJSON_bool hash_memo_resize(cJSON_HashMemo * const memo, const size_t capacity)
+{
+    const cJSON **items = NULL;
+    unsigned long *hashes = NULL;
+    const cJSON **old_items = memo->items;
+    unsigned long *old_hashes = memo->hashes;
+    size_t old_capacity = memo->capacity;
+    size_t i = 0;
+
+    if (capacity > ((size_t)-1 / sizeof(unsigned long)))
+    {
+        return false;
+    }
+    items = (const cJSON**)global_hooks.allocate(capacity * sizeof(cJSON*), global_hooks.user_data);
+    hashes = (unsigned long*)global_hooks.allocate(capacity * sizeof(unsigned long), global_hooks.user_data);
+    if ((items == NULL) || (hashes == NULL))
+    {
+        if (items != NULL)
+        {
+            global_hooks.deallocate((void*)items, global_hooks.user_data);
+        }
+        if (hashes != NULL)
+        {
+            global_hooks.deallocate(hashes, global_hooks.user_data);
+        }
+        return false;
+    }
+    memset((void*)items, '\0', capacity * sizeof(cJSON*));
+
+    memo->items = items;
+    memo->hashes = hashes;
+    memo->capacity = capacity;
+    for (i = 0; i < old_capacity; i++)
+    {
+        if (old_items[i] != NULL)
+        {
+            size_t slot = hash_memo_slot(memo, old_items[i]);
+            while (items[slot] != NULL)
+            {
+                slot = (slot + 1) & (capacity - 1);
+            }
+            items[slot] = old_items[i];
+            hashes[slot] = old_hashes[i];
+        }
+    }
+
+    if (old_items != NULL)
+    {
+        global_hooks.deallocate((void*)old_items, global_hooks.user_data);
+        global_hooks.deallocate(old_hashes, global_hooks.user_data);
+    }
+
+    return true;
+}
+
+/* a hash that can't be remembered is computed again the next time */
+static void hash_memo_store(cJSON_HashMemo * const memo, const cJSON * const item, const unsigned long hash)
+{
+    size_t slot = 0;
+
+    if (((memo->count + 1) * 2 > memo->capacity) && !hash_memo_resize(memo, memo->capacity * 2))
+    {
+        return;
+    }
+
+    slot = hash_memo_slot(memo, item);
+    while (memo->items[slot] != NULL)
+    {
+        slot = (slot + 1) & (memo->capacity - 1);
+    }
+    memo->items[slot] = item;
+    memo->hashes[slot] = hash;
+    memo->count++;
+}
+
+static unsigned long hash_item(const cJSON * const item, const cJSON_bool case_sensitive, cJSON_HashMemo * const memo);
+
+/* hash of an array or object, from the memo if it has seen it before */
+static unsigned long hash_container(const cJSON * const item, const cJSON_bool case_sensitive, cJSON_HashMemo * const memo)
+{
+    unsigned long hash = 0;
+
+    if (memo == NULL)
+    {
+        return hash_item(item, case_sensitive, NULL);
+    }
+    if (!hash_memo_lookup(memo, item, &hash))
+    {
+        hash = hash_item(item, case_sensitive, memo);
+        hash_memo_store(memo, item, hash);
+    }
+
+    return hash;
+}
+
+/* the hash of a child, only arrays and objects are worth remembering */
+#define hash_child(child, case_sensitive, memo) ((((child)->type & (cJSON_Array | cJSON_Object)) != 0) ? hash_container(child, case_sensitive, memo) : hash_item(child, case_sensitive, NULL))
+
+static unsigned long hash_item(const cJSON * const item, const cJSON_bool case_sensitive, cJSON_HashMemo * const memo)
+{
+    unsigned long hash = 2166136261UL ^ (unsigned long)(item->type & 0xFF);
+    unsigned long members = 0;
+    const unsigned char *string = NULL;
+    cJSON *child = NULL;
+    double number = 0;
+    size_t i = 0;
+
+    if (item_is_packed(item))
+    {
+        /* hashed like the numbers it holds, without unpacking them */
+        cJSON number_item;
+        memset(&number_item, '\0', sizeof(number_item));
+        number_item.type = cJSON_Number;
+        for (i = 0; i < (size_t)item->valueint; i++)
+        {
+            item_number(&number_item) = packed_numbers(item)[i];
+            hash = mix_hash((hash * 31UL + hash_item(&number_item, case_sensitive, NULL)) & 0xFFFFFFFFUL);
+        }
+        return hash;
+    }
+    if (!read_children(item, &child))
+    {
+        return hash;
+    }
+
+    switch (item->type & 0xFF)
+    {
+        case cJSON_Number:
+            number = item_number(item);
+            if (number == 0)
+            {
+                /* -0 and 0 are equal */
+                number = 0;
+            }
+            string = (const unsigned char*)&number;
+            for (i = 0; i < sizeof(number); i++)
+            {
+                hash = ((hash ^ string[i]) * 16777619UL) & 0xFFFFFFFFUL;
+            }
+            return mix_hash(hash);
+
+        case cJSON_String:
+        case cJSON_Raw:
+            if (item_valuestring(item) != NULL)
+            {
+                hash = hash_string(hash, (const unsigned char*)item_valuestring(item), true);
+            }
+            return mix_hash(hash);
+
+        case cJSON_Array:
+            for (; child != NULL; child = child->next)
+            {
+                hash = mix_hash((hash * 31UL + hash_child(child, case_sensitive, memo)) & 0xFFFFFFFFUL);
+            }
+            break;
+
+        case cJSON_Object:
+            /* the sum doesn't depend on the order of the members */
+            for (; child != NULL; child = child->next)
+            {
+                unsigned long key = hash_string(2166136261UL, (const unsigned char*)((child->string != NULL) ? child->string : ""), case_sensitive);
+                members += mix_hash((key * 31UL + hash_child(child, case_sensitive, memo)) & 0xFFFFFFFFUL);
+            }
+            hash = mix_hash((hash + members) & 0xFFFFFFFFUL);
+            break;
+
+        default:
+            return mix_hash(hash);
+    }
+
+    return hash;
+}
+
+CJSON_PUBLIC(unsigned long) cJSON_Hash(const cJSON * const item, const cJSON_bool case_sensitive)
+{
+    if (item == NULL)
+    {
+        return 0;
+    }
+
+    return hash_item(item, case_sensitive ? true : false, NULL);
+}
+
+CJSON_PUBLIC(cJSON_HashMemo *) cJSON_CreateHashMemo(const cJSON_bool case_sensitive)
+{
+    cJSON_HashMemo *memo = (cJSON_HashMemo*)global_hooks.allocate(sizeof(cJSON_HashMemo), global_hooks.user_data);
+    if (memo == NULL)
+    {
+        return NULL;
+    }
+    memset(memo, '\0', sizeof(cJSON_HashMemo));
+    memo->case_sensitive = case_sensitive ? true : false;
+
+    if (!hash_memo_resize(memo, minimum_hash_memo_capacity))
+    {
+        global_hooks.deallocate(memo, global_hooks.user_data);
+        return NULL;
+    }
+
+    return memo;
+}
+
+CJSON_PUBLIC(unsigned long) cJSON_HashWithMemo(cJSON_HashMemo * const memo, const cJSON * const item)
+{
+    if ((memo == NULL) || (item == NULL))
+    {
+        return 0;
+    }
+
+    return hash_child(item, memo->case_sensitive, memo);
+}
+
+CJSON_PUBLIC(void) cJSON_DeleteHashMemo(cJSON_HashMemo *memo)
+{
+    if (memo == NULL)
+    {
+        return;
+    }
+
+    global_hooks.deallocate((void*)memo->items, global_hooks.user_data);
+    global_hooks.deallocate(memo->hashes, global_hooks.user_data);
+    global_hooks.deallocate(memo, global_hooks.user_data);
+}
+
+static cJSON_bool keys_equal(const char * const a, const char * const b, const cJSON_bool case_sensitive)
+{
+    if (case_sensitive)
+    {
+        return strcmp(a, b) == 0;
+    }
+
+    return case_insensitive_strcmp((const unsigned char*)a, (const unsigned char*)b) == 0;
+}
+
+/* objects smaller than this are compared without building a hash table */
+static const size_t compare_join_threshold = 8;
+
+/* Members with the same key are matched in the order they appear in both objects. */
+static cJSON_bool compare_objects(const cJSON * const a, const cJSON * const b, const cJSON_bool case_sensitive)
+{
+    struct cJSON_Index *b_members = NULL;
+    cJSON *a_element = NULL;
+    cJSON *b_element = NULL;
+    size_t a_count = 0;
+    size_t b_count = 0;
+    cJSON_bool equal = true;
+
+    for (a_element = a->child; a_element != NULL; a_element = a_element->next)
+    {
+        if (a_element->string == NULL)
+        {
+            return false;
+        }
+        a_count++;
+    }
+    for (b_element = b->child; b_element != NULL; b_element = b_element->next)
+    {
+        b_count++;
+    }
+    /* with the same number of members, every member of b is matched by one of a */
+    if (a_count != b_count)
+    {
+        return false;
+    }
+
+    if (a_count >= compare_join_threshold)
+    {
+        /* the members of b are looked up in a hash table, matched ones are removed from it */
+        b_members = create_object_index(b);
+    }
+
+    for (a_element = a->child; equal && (a_element != NULL); a_element = a_element->next)
+    {
+        if (b_members != NULL)
+        {
+            b_element = index_lookup(b_members, a_element->string, case_sensitive);
+            if (b_element != NULL)
+            {
+                index_find_entry(b_members, b_element)->item = &deleted_index_entry;
+            }
+        }
+        else
+        {
+            /* skip the members of b that earlier members of a with the same key were matched with */
+            const cJSON *earlier = NULL;
+            size_t occurrence = 0;
+            for (earlier = a->child; earlier != a_element; earlier = earlier->next)
+            {
+                if (keys_equal(earlier->string, a_element->string, case_sensitive))
+                {
+                    occurrence++;
+                }
+            }
+            for (b_element = b->child; b_element != NULL; b_element = b_element->next)
+            {
+                if ((b_element->string != NULL) && keys_equal(b_element->string, a_element->string, case_sensitive))
+                {
+                    if (occurrence == 0)
+                    {
+                        break;
+                    }
+                    occurrence--;
+                }
+            }
+        }
+
+        equal = (b_element != NULL) && cJSON_Compare(a_element, b_element, case_sensitive);
+    }
+
+    index_free(b_members);
+
+    return equal;
+}
+
 CJSON_PUBLIC(cJSON_bool) cJSON_Compare(const cJSON * const a, const cJSON * const b, const cJSON_bool case_sensitive)
 {
     if ((a == NULL) || (b == NULL) || ((a->type & 0xFF) != (b->type & 0xFF)) || cJSON_IsInvalid(a))
@@ -2865,6 +9473,34 @@ CJSON_PUBLIC(cJSON_bool) cJSON_Compare(const cJSON * const a, const cJSON * cons
         return true;
     }
 
+    /* and so are copies that still share their children */
+    if (item_is_shared(a) && item_is_shared(b) && (shared_of(a) == shared_of(b)))
+    {
+        return true;
+    }
+
+    if (item_is_packed(a) && item_is_packed(b))
+    {
+        size_t i = 0;
+        if (a->valueint != b->valueint)
+        {
+            return false;
+        }
+        for (i = 0; i < (size_t)a->valueint; i++)
+        {
+            if (packed_numbers(a)[i] != packed_numbers(b)[i])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    if (!materialize(a) || !materialize(b))
+    {
+        return false;
+    }
+
     switch (a->type & 0xFF)
     {
         /* in these cases and equal type is enough */
@@ -2874,7 +9510,7 @@ CJSON_PUBLIC(cJSON_bool) cJSON_Compare(const cJSON * const a, const cJSON * cons
             return true;
 
         case cJSON_Number:
-            if (a->valuedouble == b->valuedouble)
+            if (item_number(a) == item_number(b))
             {
                 return true;
             }
@@ -2882,11 +9518,11 @@ CJSON_PUBLIC(cJSON_bool) cJSON_Compare(const cJSON * const a, const cJSON * cons
 
         case cJSON_String:
         case cJSON_Raw:
-            if ((a->valuestring == NULL) || (b->valuestring == NULL))
+            if ((item_valuestring(a) == NULL) || (item_valuestring(b) == NULL))
             {
                 return false;
             }
-            if (strcmp(a->valuestring, b->valuestring) == 0)
+            if (strcmp(item_valuestring(a), item_valuestring(b)) == 0)
             {
                 return true;
             }
@@ -2918,42 +9554,7 @@ CJSON_PUBLIC(cJSON_bool) cJSON_Compare(const cJSON * const a, const cJSON * cons
         }
 
         case cJSON_Object:
-        {
-            cJSON *a_element = NULL;
-            cJSON *b_element = NULL;
-            cJSON_ArrayForEach(a_element, a)
-            {
-                /* TODO This has O(n^2) runtime, which is horrible! */
-                b_element = get_object_item(b, a_element->string, case_sensitive);
-                if (b_element == NULL)
-                {
-                    return false;
-                }
-
-                if (!cJSON_Compare(a_element, b_element, case_sensitive))
-                {
-                    return false;
-                }
-            }
-
-            /* doing this twice, once on a and b to prevent true comparison if a subset of b
-             * TODO: Do this the proper way, this is just a fix for now */
-            cJSON_ArrayForEach(b_element, b)
-            {
-                a_element = get_object_item(a, b_element->string, case_sensitive);
-                if (a_element == NULL)
-                {
-                    return false;
-                }
-
-                if (!cJSON_Compare(b_element, a_element, case_sensitive))
-                {
-                    return false;
-                }
-            }
-
-            return true;
-        }
+            return compare_objects(a, b, case_sensitive);
 
         default:
             return false;
@@ -2962,10 +9563,10 @@ CJSON_PUBLIC(cJSON_bool) cJSON_Compare(const cJSON * const a, const cJSON * cons
 
 CJSON_PUBLIC(void *) cJSON_malloc(size_t size)
 {
-    return global_hooks.allocate(size);
+    return global_hooks.allocate(size, global_hooks.user_data);
 }
 
 CJSON_PUBLIC(void) cJSON_free(void *object)
 {
-    global_hooks.deallocate(object);
+    global_hooks.deallocate(object, global_hooks.user_data);
 }
@@ -98,11 +98,54 @@ then using the CJSON_API_VISIBILITY flag to "export" the same symbols the way CJ
 
 #define cJSON_IsReference 256
 #define cJSON_StringIsConst 512
+#define cJSON_IsArenaItem 1024 /* the item itself lives in an arena, see cJSON_ParseWithArena */
+#define cJSON_IsLazy 4096 /* an array or object that is only parsed when it is accessed, see cJSON_ParseLazy */
+#define cJSON_IsPacked 8192 /* a lazy array that keeps its numbers in a double array, see cJSON_ParsePacked */
+#define cJSON_IsShared 16384 /* an array or object whose children are in a block that is shared with its copies, see cJSON_DuplicateShared */
+#define cJSON_IsReadOnly 32768 /* an item in a shared block, cJSON doesn't change it, see cJSON_DuplicateShared */
+#define cJSON_IsArenaRoot 65536 /* the root of a tree from cJSON_ParseWithArena, deleting it releases the arena */
 
 /* The cJSON structure: */
+#ifdef CJSON_COMPACT_NODES
+#define cJSON_StringIsInline 2048 /* the string is stored inside of the item itself, see cJSON_GetStringValue */
+
+/* Compact layout: only one of the string, number or index of an item can be set, depending on its type,
+ * so they share their memory. Use cJSON_GetStringValue/cJSON_GetNumberValue to read them. */
+typedef struct cJSON
+{
+    /* next/prev allow you to walk array/object chains. Alternatively, use GetArraySize/GetArrayItem/GetObjectItem */
+    /* prev of the first item in a chain points to the last item, next of the last item is NULL */
+    struct cJSON *next;
+    struct cJSON *prev;
+    /* An array or object item will have a child pointer pointing to a chain of the items in the array/object. */
+    struct cJSON *child;
+
+    /* The item's name string, if this item is the child of, or is in the list of subitems of an object. */
+    char *string;
+
+    union
+    {
+        /* The item's string, if type==cJSON_String  and type == cJSON_Raw */
+        char *string;
+        /* short strings of type==cJSON_String with the cJSON_StringIsInline flag */
+        char inline_string[sizeof(double)];
+        /* The item's number, if type==cJSON_Number */
+        double number;
+        /* Lookup index of big objects and indexed arrays, maintained by cJSON. */
+        struct cJSON_Index *index;
+    } value;
+
+    /* The type of the item, as above. */
+    int type;
+
+    /* writing to valueint is DEPRECATED, use cJSON_SetNumberValue instead */
+    int valueint;
+} cJSON;
+#else
 typedef struct cJSON
 {
     /* next/prev allow you to walk array/object chains. Alternatively, use GetArraySize/GetArrayItem/GetObjectItem */
+    /* prev of the first item in a chain points to the last item, next of the last item is NULL */
     struct cJSON *next;
     struct cJSON *prev;
     /* An array or object item will have a child pointer pointing to a chain of the items in the array/object. */
@@ -111,7 +154,7 @@ typedef struct cJSON
     /* The type of the item, as above. */
     int type;
 
-    /* The item's string, if type==cJSON_String  and type == cJSON_Raw */
+    /* The item's string, if type==cJSON_String  and type == cJSON_Raw. Arrays and objects use it internally. */
     char *valuestring;
     /* writing to valueint is DEPRECATED, use cJSON_SetNumberValue instead */
     int valueint;
@@ -121,6 +164,7 @@ typedef struct cJSON
     /* The item's name string, if this item is the child of, or is in the list of subitems of an object. */
     char *string;
 } cJSON;
+#endif
 
 typedef struct cJSON_Hooks
 {
@@ -129,6 +173,16 @@ typedef struct cJSON_Hooks
       void (CJSON_CDECL *free_fn)(void *ptr);
 } cJSON_Hooks;
 
+/* Allocation functions with a user pointer for the *WithContext variants, e.g. to give every thread its own pool.
+ * realloc_fn may be NULL, then buffers are grown by allocating, copying and freeing. */
+typedef struct cJSON_Context
+{
+      void *(CJSON_CDECL *malloc_fn)(size_t size, void *user_data);
+      void (CJSON_CDECL *free_fn)(void *pointer, void *user_data);
+      void *(CJSON_CDECL *realloc_fn)(void *pointer, size_t size, void *user_data);
+      void *user_data;
+} cJSON_Context;
+
 typedef int cJSON_bool;
 
 /* Limits how deeply nested arrays/objects can be before cJSON rejects to parse them.
@@ -137,18 +191,136 @@ typedef int cJSON_bool;
 #define CJSON_NESTING_LIMIT 1000
 #endif
 
+/* Objects get a hash index for their keys once a lookup has to walk over this many items, if it isn't 0.
+ * Such lookups change the object, so it can't be read from several threads at once anymore.
+ * By default indexes are only created explicitly with cJSON_IndexObject and cJSON_IndexArray. */
+#ifndef CJSON_OBJECT_INDEX_THRESHOLD
+#define CJSON_OBJECT_INDEX_THRESHOLD 0
+#endif
+
+/* Events reported by the stream parser: */
+#define cJSON_EventObjectStart 1
+#define cJSON_EventObjectEnd   2
+#define cJSON_EventArrayStart  3
+#define cJSON_EventArrayEnd    4
+#define cJSON_EventKey         5
+#define cJSON_EventValue       6
+
+/* Called for every event of the stream parser. Return 0 to stop parsing.
+ * item is only valid during the call, see cJSON_CreateStreamParser. */
+typedef cJSON_bool (CJSON_CDECL *cJSON_EventCallback)(int event, const cJSON *item, void *user_data);
+
+typedef struct cJSON_StreamParser cJSON_StreamParser;
+
+typedef struct cJSON_KeyTable cJSON_KeyTable;
+
+typedef struct cJSON_HashMemo cJSON_HashMemo;
+
+/* Called by cJSON_ParseBatch for every document, in input order and on the calling thread. Return 0 to stop parsing.
+ * item is NULL if the record isn't valid JSON, see cJSON_ParseBatch for who owns it otherwise. */
+typedef cJSON_bool (CJSON_CDECL *cJSON_BatchCallback)(cJSON *item, size_t index, const char *record, size_t record_length, void *context);
+
+/* Called by cJSON_PrintToWriter with the next piece of output. Return 0 to stop printing. */
+typedef cJSON_bool (CJSON_CDECL *cJSON_WriteCallback)(const char *data, size_t length, void *context);
+
+typedef struct cJSON_PrintBuffer cJSON_PrintBuffer;
+
 /* returns the version of cJSON as a string */
 CJSON_PUBLIC(const char*) cJSON_Version(void);
 
 /* Supply malloc, realloc and free functions to cJSON */
 CJSON_PUBLIC(void) cJSON_InitHooks(cJSON_Hooks* hooks);
 
+/* These variants allocate with the functions of a context instead of the ones of cJSON_InitHooks, a NULL context means the latter.
+ * A tree that was created with a context has to be released with cJSON_DeleteWithContext and the same context, printed text with its free_fn.
+ * Functions without a context that allocate or free (like cJSON_AddItemToObject, cJSON_ReplaceItemInArray or cJSON_DeleteItemFromObject)
+ * use the global hooks, so detach items instead and delete them with the context. Lookup indexes always use the global hooks. */
+CJSON_PUBLIC(cJSON *) cJSON_ParseWithContext(const char *value, const char **return_parse_end, cJSON_bool require_null_terminated, const cJSON_Context *context);
+CJSON_PUBLIC(char *) cJSON_PrintWithContext(const cJSON *item, cJSON_bool format, const cJSON_Context *context);
+CJSON_PUBLIC(void) cJSON_DeleteWithContext(cJSON *item, const cJSON_Context *context);
+CJSON_PUBLIC(cJSON *) cJSON_DuplicateWithContext(const cJSON *item, cJSON_bool recurse, const cJSON_Context *context);
+CJSON_PUBLIC(cJSON *) cJSON_CreateNullWithContext(const cJSON_Context *context);
+CJSON_PUBLIC(cJSON *) cJSON_CreateBoolWithContext(cJSON_bool boolean, const cJSON_Context *context);
+CJSON_PUBLIC(cJSON *) cJSON_CreateNumberWithContext(double num, const cJSON_Context *context);
+CJSON_PUBLIC(cJSON *) cJSON_CreateStringWithContext(const char *string, const cJSON_Context *context);
+CJSON_PUBLIC(cJSON *) cJSON_CreateRawWithContext(const char *raw, const cJSON_Context *context);
+CJSON_PUBLIC(cJSON *) cJSON_CreateArrayWithContext(const cJSON_Context *context);
+CJSON_PUBLIC(cJSON *) cJSON_CreateObjectWithContext(const cJSON_Context *context);
+/* copies string with the context, returns 0 if that fails */
+CJSON_PUBLIC(cJSON_bool) cJSON_AddItemToObjectWithContext(cJSON *object, const char *string, cJSON *item, const cJSON_Context *context);
+
 /* Memory Management: the caller is always responsible to free the results from all variants of cJSON_Parse (with cJSON_Delete) and cJSON_Print (with stdlib free, cJSON_Hooks.free_fn, or cJSON_free as appropriate). The exception is cJSON_PrintPreallocated, where the caller has full responsibility of the buffer. */
 /* Supply a block of JSON, and this returns a cJSON object you can interrogate. */
 CJSON_PUBLIC(cJSON *) cJSON_Parse(const char *value);
 /* ParseWithOpts allows you to require (and check) that the JSON is null terminated, and to retrieve the pointer to the final byte parsed. */
 /* If you supply a ptr in return_parse_end and parsing fails, then return_parse_end will contain a pointer to the error so will match cJSON_GetErrorPtr(). */
 CJSON_PUBLIC(cJSON *) cJSON_ParseWithOpts(const char *value, const char **return_parse_end, cJSON_bool require_null_terminated);
+/* ParseWithArena works like ParseWithOpts, but places all items, keys and strings of the tree in a few big chunks of memory.
+ * cJSON_Delete (or cJSON_ArenaDelete) of the root frees the chunks at once, together with the items that have been added after parsing.
+ * Items detached from such a tree still live in the arena, so they must not be used after the root has been deleted. */
+CJSON_PUBLIC(cJSON *) cJSON_ParseWithArena(const char *value, const char **return_parse_end, cJSON_bool require_null_terminated);
+/* ParseInSitu unescapes keys and strings inside of value and points the tree into it instead of copying them,
+ * they are marked with cJSON_StringIsConst/cJSON_IsReference like strings added by cJSON_AddItemToObjectCS/cJSON_CreateStringReference.
+ * value is overwritten, even if parsing fails, and has to outlive the tree and any duplicates of it. */
+CJSON_PUBLIC(cJSON *) cJSON_ParseInSitu(char *value);
+/* ParseLazy works like ParseWithOpts, but arrays and objects that are nested in depth (at least 1) or more arrays and objects are only scanned
+ * for their closing bracket and marked with cJSON_IsLazy. They are parsed one level at a time when they are first accessed with cJSON_GetObjectItem,
+ * cJSON_GetArrayItem, cJSON_GetArraySize, cJSON_ArrayForEach or cJSON_Materialize, their own arrays and objects stay lazy.
+ * Until then they point into value, which has to outlive the tree. Errors inside of them are only found then, the accessors return NULL.
+ * Accessing a lazy item changes it even through a const pointer, so a tree with lazy items left must not be read by several threads at once. */
+CJSON_PUBLIC(cJSON *) cJSON_ParseLazy(const char *value, const char **return_parse_end, cJSON_bool require_null_terminated, int depth);
+/* Parses a lazy array or object, so that its child can be used directly. Returns 0 for NULL or if its text is invalid, 1 for all other items. */
+CJSON_PUBLIC(cJSON_bool) cJSON_Materialize(const cJSON *item);
+/* ParsePacked works like ParseWithOpts, but arrays that only contain numbers are stored as a single item with a double array instead of an item per
+ * number. They have the flags cJSON_IsLazy and cJSON_IsPacked. Printing, cJSON_GetArraySize, cJSON_GetDoubleArray, cJSON_Compare of two packed
+ * arrays and cJSON_Duplicate use the numbers directly. Everything that needs the items of the array, like cJSON_GetArrayItem and
+ * cJSON_ArrayForEach, turns it into a normal array first (see cJSON_Materialize). That always uses the global hooks, so
+ * cJSON_DuplicateWithContext with other hooks makes a normal array instead of a packed one. */
+CJSON_PUBLIC(cJSON *) cJSON_ParsePacked(const char *value, const char **return_parse_end, cJSON_bool require_null_terminated);
+/* A key table keeps one copy of every distinct object key, so documents with the same keys don't each allocate their own.
+ * cJSON_ParseWithKeyTable works like ParseWithOpts, but the keys of the tree point into the table and are marked cJSON_StringIsConst.
+ * The table has to outlive every tree parsed with it (and their duplicates, which share the keys). It grows with every new key
+ * and is not thread safe, use one table per thread or serialize the parses. */
+CJSON_PUBLIC(cJSON_KeyTable *) cJSON_CreateKeyTable(void);
+CJSON_PUBLIC(cJSON *) cJSON_ParseWithKeyTable(const char *value, const char **return_parse_end, cJSON_bool require_null_terminated, cJSON_KeyTable *keys);
+/* The shared copy of a key, it is added to the table if it isn't there yet. Returns NULL on failure.
+ * Looking up this pointer with cJSON_GetObjectItem* finds keys from the same table by their address instead of comparing the strings. */
+CJSON_PUBLIC(const char *) cJSON_InternKey(cJSON_KeyTable *table, const char *key);
+/* Number of distinct keys in the table. */
+CJSON_PUBLIC(size_t) cJSON_GetKeyTableSize(const cJSON_KeyTable *table);
+CJSON_PUBLIC(void) cJSON_DeleteKeyTable(cJSON_KeyTable *table);
+/* Checks if the first length bytes of json are a single value (surrounded by whitespace) with the rules of cJSON_ParseWithOpts and require_null_terminated,
+ * without building a tree or allocating any memory. A zero byte ends the input early. If it isn't valid and error_ptr isn't NULL,
+ * error_ptr is set to the position of the error that cJSON_GetErrorPtr would report. */
+CJSON_PUBLIC(cJSON_bool) cJSON_Validate(const char *json, size_t length, const char **error_ptr);
+/* Parses only the values that the count JSON pointers (with the syntax of cJSONUtils_GetPointer, NULL entries are ignored) select, together with
+ * the arrays and objects on the way to them. Everything else is validated, but not allocated, copied or unescaped. Arrays only keep their selected
+ * elements, so indices in the result differ from the document. If results isn't NULL, results[i] is set to the item that pointers[i] selects
+ * (the same item as cJSONUtils_GetPointer(CaseSensitive) would find in the whole document) or NULL if it doesn't exist. The result is one tree,
+ * only delete the returned root. Returns NULL for invalid JSON, cJSON_GetErrorPtr reports the position. */
+CJSON_PUBLIC(cJSON *) cJSON_ParseProjection(const char *value, const char * const *pointers, size_t count, cJSON_bool case_sensitive, cJSON **results);
+
+/* The stream parser reports the contents of a document to a callback instead of building a tree, and it accepts the input in chunks of any size.
+ * Events are reported for the start and the end of every object and array, for every key and for every other value.
+ * The item passed to the callback has the type (and value) of the object, array or value. For values and the starts of objects and arrays
+ * inside of objects, string is the key. For cJSON_EventKey, valuestring is the key. Keys and strings are only valid during the call, no items
+ * are allocated. Several top level values can follow each other, like in newline delimited JSON. Nesting is limited by CJSON_NESTING_LIMIT. */
+CJSON_PUBLIC(cJSON_StreamParser *) cJSON_CreateStreamParser(cJSON_EventCallback callback, void *user_data);
+/* Parse the next chunk of the input. Returns 0 if the input is invalid or the callback stopped parsing. */
+CJSON_PUBLIC(cJSON_bool) cJSON_StreamParserFeed(cJSON_StreamParser *parser, const char *chunk, size_t length);
+/* Signal the end of the input. Returns 0 unless the input consisted of complete values. */
+CJSON_PUBLIC(cJSON_bool) cJSON_StreamParserFinish(cJSON_StreamParser *parser);
+/* Number of bytes that have been parsed. After a failure, this is the position of the error. */
+CJSON_PUBLIC(size_t) cJSON_StreamParserGetOffset(const cJSON_StreamParser *parser);
+CJSON_PUBLIC(void) cJSON_DeleteStreamParser(cJSON_StreamParser *parser);
+/* Parse newline delimited JSON, one document per line, on thread_count worker threads. Lines that only contain whitespace are skipped.
+ * The documents are passed to the callback in input order, index counts them from 0. Without use_arena the callback owns item and
+ * has to release it with cJSON_Delete. With use_arena the documents are parsed into arenas that belong to the workers and are reused,
+ * item is only valid during the call then (use cJSON_Duplicate to keep it) and must not be deleted. That avoids an allocation per item
+ * and one thread freeing the memory of another, which is much faster. With a thread_count of 0 or 1, or if cJSON was built without
+ * threads, the calling thread parses everything. The allocator set with cJSON_InitHooks has to be thread safe.
+ * Returns 0 if the callback stopped parsing or memory ran out. */
+CJSON_PUBLIC(cJSON_bool) cJSON_ParseBatch(const char *buffer, size_t length, int thread_count, cJSON_bool use_arena, cJSON_BatchCallback callback, void *context);
 
 /* Render a cJSON entity to text for transfer/storage. */
 CJSON_PUBLIC(char *) cJSON_Print(const cJSON *item);
@@ -157,24 +329,66 @@ CJSON_PUBLIC(char *) cJSON_PrintUnformatted(const cJSON *item);
 /* Render a cJSON entity to text using a buffered strategy. prebuffer is a guess at the final size. guessing well reduces reallocation. fmt=0 gives unformatted, =1 gives formatted */
 CJSON_PUBLIC(char *) cJSON_PrintBuffered(const cJSON *item, int prebuffer, cJSON_bool fmt);
 /* Render a cJSON entity to text using a buffer already allocated in memory with given length. Returns 1 on success and 0 on failure. */
-/* NOTE: cJSON is not always 100% accurate in estimating how much memory it will use, so to be safe allocate 5 bytes more than you actually need */
+/* The output and the terminating zero need cJSON_PrintedLength(item, format) + 1 bytes. */
 CJSON_PUBLIC(cJSON_bool) cJSON_PrintPreallocated(cJSON *item, char *buffer, const int length, const cJSON_bool format);
+/* Exact length of what cJSON_Print (format) or cJSON_PrintUnformatted would return, without the terminating zero.
+ * Computed without printing, returns 0 if the item can't be printed. */
+CJSON_PUBLIC(size_t) cJSON_PrintedLength(const cJSON *item, cJSON_bool format);
+/* A buffer that is kept between prints, so printing documents of similar size repeatedly doesn't allocate.
+ * initial_size may be 0, then the first print allocates exactly the size of its output. */
+CJSON_PUBLIC(cJSON_PrintBuffer *) cJSON_CreatePrintBuffer(size_t initial_size);
+/* Render a cJSON entity to text in the print buffer, growing it if needed. Returns the zero terminated text, which is owned by the
+ * print buffer and valid until the next print or cJSON_DeletePrintBuffer, or NULL on failure. The length without the zero is stored in length if not NULL. */
+CJSON_PUBLIC(const char *) cJSON_PrintToBuffer(cJSON_PrintBuffer *print_buffer, const cJSON *item, cJSON_bool format, size_t *length);
+CJSON_PUBLIC(void) cJSON_DeletePrintBuffer(cJSON_PrintBuffer *print_buffer);
+/* Render a cJSON entity to text through a small fixed-size buffer that is handed to write_callback whenever it fills up,
+ * so the whole document is never held in memory. The output is the same as that of cJSON_Print/cJSON_PrintUnformatted,
+ * without the terminating zero. Returns 1 on success and 0 if printing or the callback failed. */
+CJSON_PUBLIC(cJSON_bool) cJSON_PrintToWriter(const cJSON *item, cJSON_bool format, cJSON_WriteCallback write_callback, void *context);
+/* cJSON_PrintToWriter to a file descriptor (POSIX write/Windows _write). Returns 0 on write errors. */
+CJSON_PUBLIC(cJSON_bool) cJSON_PrintToFd(const cJSON *item, cJSON_bool format, int fd);
+/* Render a cJSON entity as CBOR (RFC 8949) instead of text. Numbers that are integers up to 2^53 become CBOR integers, other numbers
+ * the smallest float that holds them exactly. Raw items become byte strings tagged as embedded JSON (262). Free the result with cJSON_free,
+ * its size is stored in length. Returns NULL on failure. */
+CJSON_PUBLIC(unsigned char *) cJSON_PrintCBOR(const cJSON *item, size_t *length);
+/* Parse a CBOR data item into the same tree that the JSON text would give. Object keys have to be text strings, byte strings are
+ * only accepted as embedded JSON (tag 262), which becomes a raw item, and other tags are ignored. If consumed is NULL, data has to
+ * hold exactly one item, otherwise it is set to the number of bytes that were parsed, so that a sequence of items can be read.
+ * On failure, cJSON_GetErrorPtr (and consumed) point to the offending byte. */
+CJSON_PUBLIC(cJSON *) cJSON_ParseCBOR(const unsigned char *data, size_t length, size_t *consumed);
 /* Delete a cJSON entity and all subentities. */
 CJSON_PUBLIC(void) cJSON_Delete(cJSON *c);
+/* Delete a tree that was returned by cJSON_ParseWithArena, other items are left alone. */
+CJSON_PUBLIC(void) cJSON_ArenaDelete(cJSON *root);
 
 /* Returns the number of items in an array (or object). */
 CJSON_PUBLIC(int) cJSON_GetArraySize(const cJSON *array);
 /* Retrieve item number "index" from array "array". Returns NULL if unsuccessful. */
 CJSON_PUBLIC(cJSON *) cJSON_GetArrayItem(const cJSON *array, int index);
+/* Copies the first count numbers of an array to numbers, without creating items for packed arrays.
+ * Returns 0 if array isn't an array, it has less than count items or one of them isn't a number. */
+CJSON_PUBLIC(cJSON_bool) cJSON_GetDoubleArray(const cJSON *array, double *numbers, size_t count);
+/* Create a table of the items of an array, so that cJSON_GetArrayItem and cJSON_GetArraySize take constant time.
+ * The table is kept up to date by the functions that add, insert, detach, replace and delete items. If you modify
+ * the child list by hand, call this again to rebuild it. Returns 0 on failure. */
+CJSON_PUBLIC(cJSON_bool) cJSON_IndexArray(cJSON *array);
 /* Get item "string" from object. Case insensitive. */
 CJSON_PUBLIC(cJSON *) cJSON_GetObjectItem(const cJSON * const object, const char * const string);
 CJSON_PUBLIC(cJSON *) cJSON_GetObjectItemCaseSensitive(const cJSON * const object, const char * const string);
 CJSON_PUBLIC(cJSON_bool) cJSON_HasObjectItem(const cJSON *object, const char *string);
+/* Create a hash index for the keys of an object, so that getting items by key takes constant time on average.
+ * The index is kept up to date by the functions that add, detach, replace and delete items. If you modify the
+ * child list or the keys by hand, call this again to rebuild it. Returns 0 on failure. */
+CJSON_PUBLIC(cJSON_bool) cJSON_IndexObject(cJSON *object);
+/* Returns 1 if the array or object has an index from cJSON_IndexObject or cJSON_IndexArray. */
+CJSON_PUBLIC(cJSON_bool) cJSON_IsIndexed(const cJSON * const item);
 /* For analysing failed parses. This returns a pointer to the parse error. You'll probably need to look a few chars back to make sense of it. Defined when cJSON_Parse() returns 0. 0 when cJSON_Parse() succeeds. */
 CJSON_PUBLIC(const char *) cJSON_GetErrorPtr(void);
 
 /* Check if the item is a string and return its valuestring */
-CJSON_PUBLIC(char *) cJSON_GetStringValue(cJSON *item);
+CJSON_PUBLIC(char *) cJSON_GetStringValue(const cJSON * const item);
+/* Check if the item is a number and return its valuedouble, NaN otherwise */
+CJSON_PUBLIC(double) cJSON_GetNumberValue(const cJSON * const item);
 
 /* These functions check the type of an item */
 CJSON_PUBLIC(cJSON_bool) cJSON_IsInvalid(const cJSON * const item);
@@ -212,20 +426,24 @@ CJSON_PUBLIC(cJSON *) cJSON_CreateArrayReference(const cJSON *child);
 CJSON_PUBLIC(cJSON *) cJSON_CreateIntArray(const int *numbers, int count);
 CJSON_PUBLIC(cJSON *) cJSON_CreateFloatArray(const float *numbers, int count);
 CJSON_PUBLIC(cJSON *) cJSON_CreateDoubleArray(const double *numbers, int count);
+/* Like cJSON_CreateDoubleArray, but the numbers are copied into a packed array, see cJSON_ParsePacked. */
+CJSON_PUBLIC(cJSON *) cJSON_CreatePackedDoubleArray(const double *numbers, int count);
 CJSON_PUBLIC(cJSON *) cJSON_CreateStringArray(const char **strings, int count);
 
-/* Append item to the specified array/object. */
-CJSON_PUBLIC(void) cJSON_AddItemToArray(cJSON *array, cJSON *item);
-CJSON_PUBLIC(void) cJSON_AddItemToObject(cJSON *object, const char *string, cJSON *item);
+/* Append item to the specified array/object. Returns 0 on failure, then item still belongs to the caller.
+ * This includes arrays and objects with cJSON_IsReadOnly, see cJSON_DuplicateShared and cJSON_UnshareItem. */
+CJSON_PUBLIC(cJSON_bool) cJSON_AddItemToArray(cJSON *array, cJSON *item);
+CJSON_PUBLIC(cJSON_bool) cJSON_AddItemToObject(cJSON *object, const char *string, cJSON *item);
 /* Use this when string is definitely const (i.e. a literal, or as good as), and will definitely survive the cJSON object.
  * WARNING: When this function was used, make sure to always check that (item->type & cJSON_StringIsConst) is zero before
  * writing to `item->string` */
-CJSON_PUBLIC(void) cJSON_AddItemToObjectCS(cJSON *object, const char *string, cJSON *item);
+CJSON_PUBLIC(cJSON_bool) cJSON_AddItemToObjectCS(cJSON *object, const char *string, cJSON *item);
 /* Append reference to item to the specified array/object. Use this when you want to add an existing cJSON to a new cJSON, but don't want to corrupt your existing cJSON. */
-CJSON_PUBLIC(void) cJSON_AddItemReferenceToArray(cJSON *array, cJSON *item);
-CJSON_PUBLIC(void) cJSON_AddItemReferenceToObject(cJSON *object, const char *string, cJSON *item);
+CJSON_PUBLIC(cJSON_bool) cJSON_AddItemReferenceToArray(cJSON *array, cJSON *item);
+CJSON_PUBLIC(cJSON_bool) cJSON_AddItemReferenceToObject(cJSON *object, const char *string, cJSON *item);
 
-/* Remove/Detatch items from Arrays/Objects. */
+/* Remove/Detatch items from Arrays/Objects. Detaching returns NULL and deleting doesn't do anything
+ * if the item isn't found or the parent has cJSON_IsReadOnly. */
 CJSON_PUBLIC(cJSON *) cJSON_DetachItemViaPointer(cJSON *parent, cJSON * const item);
 CJSON_PUBLIC(cJSON *) cJSON_DetachItemFromArray(cJSON *array, int which);
 CJSON_PUBLIC(void) cJSON_DeleteItemFromArray(cJSON *array, int which);
@@ -234,24 +452,59 @@ CJSON_PUBLIC(cJSON *) cJSON_DetachItemFromObjectCaseSensitive(cJSON *object, con
 CJSON_PUBLIC(void) cJSON_DeleteItemFromObject(cJSON *object, const char *string);
 CJSON_PUBLIC(void) cJSON_DeleteItemFromObjectCaseSensitive(cJSON *object, const char *string);
 
-/* Update array items. */
-CJSON_PUBLIC(void) cJSON_InsertItemInArray(cJSON *array, int which, cJSON *newitem); /* Shifts pre-existing items to the right. */
+/* Update array items. Like adding, they return 0 on failure (also for parents with cJSON_IsReadOnly), then the new item still belongs to the caller. */
+CJSON_PUBLIC(cJSON_bool) cJSON_InsertItemInArray(cJSON *array, int which, cJSON *newitem); /* Shifts pre-existing items to the right. */
 CJSON_PUBLIC(cJSON_bool) cJSON_ReplaceItemViaPointer(cJSON * const parent, cJSON * const item, cJSON * replacement);
-CJSON_PUBLIC(void) cJSON_ReplaceItemInArray(cJSON *array, int which, cJSON *newitem);
-CJSON_PUBLIC(void) cJSON_ReplaceItemInObject(cJSON *object,const char *string,cJSON *newitem);
-CJSON_PUBLIC(void) cJSON_ReplaceItemInObjectCaseSensitive(cJSON *object,const char *string,cJSON *newitem);
+CJSON_PUBLIC(cJSON_bool) cJSON_ReplaceItemInArray(cJSON *array, int which, cJSON *newitem);
+CJSON_PUBLIC(cJSON_bool) cJSON_ReplaceItemInObject(cJSON *object,const char *string,cJSON *newitem);
+CJSON_PUBLIC(cJSON_bool) cJSON_ReplaceItemInObjectCaseSensitive(cJSON *object,const char *string,cJSON *newitem);
+/* Move the value of replacement into item, which keeps its key and its place in the tree, e.g. to replace a root.
+ * The old value and the replacement are freed, on failure (for items with cJSON_IsReadOnly) nothing changes. */
+CJSON_PUBLIC(cJSON_bool) cJSON_ReplaceItemValue(cJSON * const item, cJSON * const replacement);
 
 /* Duplicate a cJSON item */
 CJSON_PUBLIC(cJSON *) cJSON_Duplicate(const cJSON *item, cJSON_bool recurse);
 /* Duplicate will create a new, identical cJSON item to the one you pass, in new memory that will
 need to be released. With recurse!=0, it will duplicate any children connected to the item.
 The item->next and ->prev pointers are always zero on return from Duplicate. */
+/* DuplicateShared makes a copy of item for snapshots of a tree that changes. The children of its arrays and objects are copied into
+ * reference counted blocks that are marked cJSON_IsReadOnly and never change, item itself isn't touched. Arrays and objects that share
+ * a block already (cJSON_IsShared) share it with the copy as well, so copies of copies only take a single item, and only the levels that
+ * were changed in between are copied again. Shared children are read where they are, including ->child and cJSON_ArrayForEach.
+ * Adding, detaching, replacing and deleting items of a shared array or object copies only its own level first (see cJSON_Unshare),
+ * items inside of a block (found with the getters) can't be changed until their parent was unshared, cJSON_UnshareItem unshares the
+ * whole path from the root to one of them. Blocks are allocated with the global hooks.
+ * Returns NULL on failure. */
+CJSON_PUBLIC(cJSON *) cJSON_DuplicateShared(const cJSON *item);
+/* Gives a shared array or object a copy of its children (only one level), so that they can be changed. Returns 0 for NULL, for arrays
+ * and objects inside of a block (cJSON_IsReadOnly) and on failure, 1 otherwise. Lazy and packed arrays are parsed or unpacked. */
+CJSON_PUBLIC(cJSON_bool) cJSON_Unshare(cJSON *item);
+/* Unshares root and every array and object on the path from it to item, which can be an item found in a shared copy.
+ * Returns the item that takes the place of item and can be changed, NULL if item isn't below root or on failure.
+ * cJSONUtils_UnsharePointer does the same for a JSON pointer. */
+CJSON_PUBLIC(cJSON *) cJSON_UnshareItem(cJSON *root, const cJSON *item);
 /* Recursively compare two cJSON items for equality. If either a or b is NULL or invalid, they will be considered unequal.
- * case_sensitive determines if object keys are treated case sensitive (1) or case insensitive (0) */
+ * case_sensitive determines if object keys are treated case sensitive (1) or case insensitive (0)
+ * Members of objects can be in any order, members with the same key are matched in the order they appear. */
 CJSON_PUBLIC(cJSON_bool) cJSON_Compare(const cJSON * const a, const cJSON * const b, const cJSON_bool case_sensitive);
-
-
+/* 32 bit hash of an item and everything below it. Items that cJSON_Compare considers equal have the same hash,
+ * so the order of the members of objects doesn't matter, but the order of the elements of arrays does.
+ * The hash is computed from scratch on every call, nothing is stored in the tree. It only uses the lowest 32 bits
+ * of the unsigned long, the others are always 0, so it is the same on every platform. */
+CJSON_PUBLIC(unsigned long) cJSON_Hash(const cJSON * const item, const cJSON_bool case_sensitive);
+/* A memo remembers the hashes of the arrays and objects it has seen by their address, so hashing items that contain
+ * each other, like the elements of nested arrays, only walks every item once. cJSON_HashWithMemo returns the same
+ * hash as cJSON_Hash. Delete the memo before any item it has seen is changed or freed, or it returns old hashes. */
+CJSON_PUBLIC(cJSON_HashMemo *) cJSON_CreateHashMemo(const cJSON_bool case_sensitive);
+CJSON_PUBLIC(unsigned long) cJSON_HashWithMemo(cJSON_HashMemo * const memo, const cJSON * const item);
+CJSON_PUBLIC(void) cJSON_DeleteHashMemo(cJSON_HashMemo *memo);
+
+
+/* Remove whitespace and comments from a null terminated JSON text in place. */
 CJSON_PUBLIC(void) cJSON_Minify(char *json);
+/* Remove whitespace and comments from the first length bytes of json in place, which don't have to be null terminated.
+ * Returns the new length, the result is null terminated if it got shorter. */
+CJSON_PUBLIC(size_t) cJSON_MinifyLen(char *json, size_t length);
 
 /* Helper functions for creating and adding items to an object at the same time.
  * They return the added item or NULL on failure. */
@@ -265,14 +518,16 @@ CJSON_PUBLIC(cJSON*) cJSON_AddRawToObject(cJSON * const object, const char * con
 CJSON_PUBLIC(cJSON*) cJSON_AddObjectToObject(cJSON * const object, const char * const name);
 CJSON_PUBLIC(cJSON*) cJSON_AddArrayToObject(cJSON * const object, const char * const name);
 
-/* When assigning an integer value, it needs to be propagated to valuedouble too. */
-#define cJSON_SetIntValue(object, number) ((object) ? (object)->valueint = (object)->valuedouble = (number) : (number))
-/* helper for the cJSON_SetNumberValue macro */
+/* When assigning an integer value, it needs to be propagated to valuedouble too.
+ * The helper returns the valueint of the item afterwards, items with cJSON_IsReadOnly are left as they are. */
+CJSON_PUBLIC(int) cJSON_SetIntHelper(cJSON *object, double number);
+#define cJSON_SetIntValue(object, number) ((object != NULL) ? cJSON_SetIntHelper(object, (double)(number)) : (number))
+/* helper for the cJSON_SetNumberValue macro, items with cJSON_IsReadOnly are left as they are */
 CJSON_PUBLIC(double) cJSON_SetNumberHelper(cJSON *object, double number);
 #define cJSON_SetNumberValue(object, number) ((object != NULL) ? cJSON_SetNumberHelper(object, (double)number) : (number))
 
 /* Macro for iterating over an array or object */
-#define cJSON_ArrayForEach(element, array) for(element = (array != NULL) ? (array)->child : NULL; element != NULL; element = element->next)
+#define cJSON_ArrayForEach(element, array) for(element = cJSON_Materialize(array) ? (array)->child : NULL; element != NULL; element = element->next)
 
 /* malloc/free objects using the malloc/free functions that have been set with cJSON_InitHooks */
 CJSON_PUBLIC(void *) cJSON_malloc(size_t size);
@@ -248,7 +248,7 @@ CJSON_PUBLIC(char *) cJSONUtils_FindPointerFromObjectTo(const cJSON * const obje
 /* non broken version of cJSON_GetArrayItem */
 static cJSON *get_array_item(const cJSON *array, size_t item)
 {
-    cJSON *child = array ? array->child : NULL;
+    cJSON *child = cJSON_Materialize(array) ? array->child : NULL;
     while ((child != NULL) && (item > 0))
     {
         item--;
@@ -285,7 +285,8 @@ static cJSON_bool decode_array_index_from_pointer(const unsigned char * const po
     return 1;
 }
 
-static cJSON *get_item_from_pointer(cJSON * const object, const char * pointer, const cJSON_bool case_sensitive)
+/* with writable, the shared children on the path are copied so the item can be changed, see cJSON_Unshare */
+static cJSON *get_item_from_pointer(cJSON * const object, const char * pointer, const cJSON_bool case_sensitive, const cJSON_bool writable)
 {
     cJSON *current_element = object;
 
@@ -298,6 +299,10 @@ static cJSON *get_item_from_pointer(cJSON * const object, const char * pointer,
     while ((pointer[0] == '/') && (current_element != NULL))
     {
         pointer++;
+        if (writable && !cJSON_Unshare(current_element))
+        {
+            return NULL;
+        }
         if (cJSON_IsArray(current_element))
         {
             size_t index = 0;
@@ -310,7 +315,7 @@ static cJSON *get_item_from_pointer(cJSON * const object, const char * pointer,
         }
         else if (cJSON_IsObject(current_element))
         {
-            current_element = current_element->child;
+            current_element = cJSON_Materialize(current_element) ? current_element->child : NULL;
             /* GetObjectItem. */
             while ((current_element != NULL) && !compare_pointers((unsigned char*)current_element->string, (const unsigned char*)pointer, case_sensitive))
             {
@@ -329,17 +334,408 @@ static cJSON *get_item_from_pointer(cJSON * const object, const char * pointer,
         }
     }
 
+    if (writable && (current_element != NULL) && !cJSON_Unshare(current_element))
+    {
+        return NULL;
+    }
+
     return current_element;
 }
 
 CJSON_PUBLIC(cJSON *) cJSONUtils_GetPointer(cJSON * const object, const char *pointer)
 {
-    return get_item_from_pointer(object, pointer, false);
+    return get_item_from_pointer(object, pointer, false, false);
 }
 
 CJSON_PUBLIC(cJSON *) cJSONUtils_GetPointerCaseSensitive(cJSON * const object, const char *pointer)
 {
-    return get_item_from_pointer(object, pointer, true);
+    return get_item_from_pointer(object, pointer, true, false);
+}
+
+CJSON_PUBLIC(cJSON *) cJSONUtils_UnsharePointer(cJSON * const object, const char *pointer)
+{
+    return get_item_from_pointer(object, pointer, false, true);
+}
+
+CJSON_PUBLIC(cJSON *) cJSONUtils_UnsharePointerCaseSensitive(cJSON * const object, const char *pointer)
+{
+    return get_item_from_pointer(object, pointer, true, true);
+}
+
+/* one path element of a compiled JSON pointer */
+typedef struct
+{
+    /* decoded name, NULL if it contains an invalid escape sequence and can't match anything */
+    const unsigned char *name;
+    /* only valid if is_index */
+    size_t index;
+    cJSON_bool is_index;
+} pointer_token;
+
+struct cJSONUtils_Pointer
+{
+    size_t token_count;
+    pointer_token *tokens;
+};
+
+CJSON_PUBLIC(cJSONUtils_Pointer *) cJSONUtils_CompilePointer(const char *pointer)
+{
+    cJSONUtils_Pointer *compiled = NULL;
+    unsigned char *names = NULL;
+    size_t token_count = 0;
+    size_t position = 0;
+
+    if (pointer == NULL)
+    {
+        return NULL;
+    }
+
+    /* like get_item_from_pointer, anything that doesn't start with '/' points to the root */
+    if (pointer[0] == '/')
+    {
+        for (position = 0; pointer[position] != '\0'; position++)
+        {
+            if (pointer[position] == '/')
+            {
+                token_count++;
+            }
+        }
+    }
+
+    /* everything in one allocation: the tokens follow the header, the decoded names follow the tokens */
+    compiled = (cJSONUtils_Pointer*)cJSON_malloc(sizeof(cJSONUtils_Pointer) + (token_count * sizeof(pointer_token)) + position + sizeof(""));
+    if (compiled == NULL)
+    {
+        return NULL;
+    }
+    compiled->token_count = token_count;
+    compiled->tokens = (pointer_token*)(compiled + 1);
+    names = (unsigned char*)(compiled->tokens + token_count);
+
+    for (token_count = 0; token_count < compiled->token_count; token_count++)
+    {
+        pointer_token *token = &compiled->tokens[token_count];
+        pointer++;
+
+        token->is_index = decode_array_index_from_pointer((const unsigned char*)pointer, &token->index);
+        token->name = names;
+        for (; (pointer[0] != '\0') && (pointer[0] != '/'); pointer++)
+        {
+            if (pointer[0] == '~')
+            {
+                if ((pointer[1] == '0') || (pointer[1] == '1'))
+                {
+                    *names++ = (pointer[1] == '0') ? '~' : '/';
+                    pointer++;
+                    continue;
+                }
+
+                /* invalid escape sequence */
+                token->name = NULL;
+            }
+            *names++ = (unsigned char)pointer[0];
+        }
+        *names++ = '\0';
+    }
+
+    return compiled;
+}
+
+CJSON_PUBLIC(void) cJSONUtils_DeleteCompiledPointer(cJSONUtils_Pointer *pointer)
+{
+    cJSON_free(pointer);
+}
+
+static cJSON *get_item_from_compiled_pointer(cJSON * const object, const cJSONUtils_Pointer * const pointer, const cJSON_bool case_sensitive)
+{
+    cJSON *current_element = object;
+    size_t token = 0;
+
+    if (pointer == NULL)
+    {
+        return NULL;
+    }
+
+    for (token = 0; (token < pointer->token_count) && (current_element != NULL); token++)
+    {
+        if (cJSON_IsArray(current_element))
+        {
+            if (!pointer->tokens[token].is_index)
+            {
+                return NULL;
+            }
+
+            current_element = get_array_item(current_element, pointer->tokens[token].index);
+        }
+        else if (cJSON_IsObject(current_element))
+        {
+            current_element = cJSON_Materialize(current_element) ? current_element->child : NULL;
+            while ((current_element != NULL) && (compare_strings((unsigned char*)current_element->string, pointer->tokens[token].name, case_sensitive) != 0))
+            {
+                current_element = current_element->next;
+            }
+        }
+        else
+        {
+            return NULL;
+        }
+    }
+
+    return current_element;
+}
+
+CJSON_PUBLIC(cJSON *) cJSONUtils_GetCompiledPointer(cJSON * const object, const cJSONUtils_Pointer * const pointer)
+{
+    return get_item_from_compiled_pointer(object, pointer, false);
+}
+
+CJSON_PUBLIC(cJSON *) cJSONUtils_GetCompiledPointerCaseSensitive(cJSON * const object, const cJSONUtils_Pointer * const pointer)
+{
+    return get_item_from_compiled_pointer(object, pointer, true);
+}
+
+/* state shared by the recursion of cJSONUtils_GetCompiledPointers */
+typedef struct
+{
+    cJSONUtils_Pointer * const *pointers;
+    cJSON **results;
+    /* for sorting */
+    size_t *scratch;
+    /* depth + 1 at which a pointer matched a member of an object, so duplicate keys only match once */
+    size_t *matched_depth;
+    cJSON_bool case_sensitive;
+} pointer_evaluation;
+
+/* Order two pointers by their token at depth. Array indexes are sorted numerically and in front of the tokens
+ * that aren't valid indexes, object keys are sorted by name and in front of names with invalid escape sequences. */
+static int compare_pointer_tokens(const pointer_evaluation * const evaluation, const size_t a, const size_t b, const size_t depth, const cJSON_bool array)
+{
+    const pointer_token *token_a = &evaluation->pointers[a]->tokens[depth];
+    const pointer_token *token_b = &evaluation->pointers[b]->tokens[depth];
+
+    if (array)
+    {
+        if (token_a->is_index != token_b->is_index)
+        {
+            return token_a->is_index ? -1 : 1;
+        }
+        if (!token_a->is_index || (token_a->index == token_b->index))
+        {
+            return 0;
+        }
+        return (token_a->index < token_b->index) ? -1 : 1;
+    }
+
+    if ((token_a->name == NULL) || (token_b->name == NULL))
+    {
+        return (token_a->name == NULL) - (token_b->name == NULL);
+    }
+    return compare_strings(token_a->name, token_b->name, evaluation->case_sensitive);
+}
+
+/* bottom up merge sort of pending by the tokens at depth */
+static void sort_pending_pointers(const pointer_evaluation * const evaluation, size_t * const pending, const size_t count, const size_t depth, const cJSON_bool array)
+{
+    size_t width = 0;
+    size_t start = 0;
+
+    for (width = 1; width < count; width *= 2)
+    {
+        for (start = 0; (start + width) < count; start += 2 * width)
+        {
+            size_t middle = start + width;
+            size_t end = ((count - start) > (2 * width)) ? (start + (2 * width)) : count;
+            size_t left = start;
+            size_t right = middle;
+            size_t output = start;
+
+            if (compare_pointer_tokens(evaluation, pending[middle - 1], pending[middle], depth, array) <= 0)
+            {
+                /* already in order */
+                continue;
+            }
+
+            while ((left < middle) && (right < end))
+            {
+                if (compare_pointer_tokens(evaluation, pending[right], pending[left], depth, array) < 0)
+                {
+                    evaluation->scratch[output++] = pending[right++];
+                }
+                else
+                {
+                    evaluation->scratch[output++] = pending[left++];
+                }
+            }
+            while (left < middle)
+            {
+                evaluation->scratch[output++] = pending[left++];
+            }
+            memcpy(pending + start, evaluation->scratch + start, (right - start) * sizeof(size_t));
+        }
+    }
+}
+
+/* Resolve the pointers whose first depth tokens lead to item, pending holds their indexes in pointers.
+ * They are sorted by their next token, so every child is visited at most once: array elements in step
+ * with the sorted indexes, object members with a binary search for their key. */
+static void get_items_from_compiled_pointers(const pointer_evaluation * const evaluation, cJSON * const item, size_t * const pending, const size_t pending_count, const size_t depth)
+{
+    cJSON *child = NULL;
+    size_t child_index = 0;
+    size_t resolved = 0;
+    size_t end = 0;
+    size_t unmatched = 0;
+    size_t position = 0;
+    size_t swap = 0;
+    cJSON_bool array = cJSON_IsArray(item);
+
+    /* pointers that end here */
+    for (position = 0; position < pending_count; position++)
+    {
+        if (evaluation->pointers[pending[position]]->token_count == depth)
+        {
+            evaluation->results[pending[position]] = item;
+            swap = pending[position];
+            pending[position] = pending[resolved];
+            pending[resolved] = swap;
+            resolved++;
+        }
+    }
+
+    if ((resolved == pending_count) || !(array || cJSON_IsObject(item)) || !cJSON_Materialize(item))
+    {
+        /* the rest isn't found, results are already NULL */
+        return;
+    }
+
+    sort_pending_pointers(evaluation, pending + resolved, pending_count - resolved, depth, array);
+    /* tokens that can't match anything are sorted to the end */
+    for (end = pending_count; end > resolved; end--)
+    {
+        const pointer_token *token = &evaluation->pointers[pending[end - 1]]->tokens[depth];
+        if (array ? token->is_index : (token->name != NULL))
+        {
+            break;
+        }
+    }
+
+    unmatched = end - resolved;
+    for (child = item->child; (child != NULL) && (unmatched > 0); (void)(child = child->next), child_index++)
+    {
+        size_t group_start = 0;
+        size_t group_end = 0;
+
+        if (array)
+        {
+            if (evaluation->pointers[pending[resolved]]->tokens[depth].index != child_index)
+            {
+                continue;
+            }
+            group_start = resolved;
+        }
+        else
+        {
+            /* lower bound of the key */
+            size_t low = resolved;
+            size_t high = end;
+            if (child->string == NULL)
+            {
+                continue;
+            }
+            while (low < high)
+            {
+                size_t middle = low + ((high - low) / 2);
+                if (compare_strings(evaluation->pointers[pending[middle]]->tokens[depth].name, (unsigned char*)child->string, evaluation->case_sensitive) < 0)
+                {
+                    low = middle + 1;
+                }
+                else
+                {
+                    high = middle;
+                }
+            }
+            if ((low == end)
+                || (compare_strings(evaluation->pointers[pending[low]]->tokens[depth].name, (unsigned char*)child->string, evaluation->case_sensitive) != 0)
+                || (evaluation->matched_depth[pending[low]] > depth))
+            {
+                /* not wanted, or a duplicate key that already matched */
+                continue;
+            }
+            group_start = low;
+        }
+
+        for (group_end = group_start + 1; (group_end < end) && (compare_pointer_tokens(evaluation, pending[group_start], pending[group_end], depth, array) == 0); group_end++)
+        {
+        }
+        for (position = group_start; position < group_end; position++)
+        {
+            evaluation->matched_depth[pending[position]] = depth + 1;
+        }
+
+        get_items_from_compiled_pointers(evaluation, child, pending + group_start, group_end - group_start, depth + 1);
+        unmatched -= group_end - group_start;
+        if (array)
+        {
+            resolved = group_end;
+        }
+    }
+}
+
+static cJSON_bool get_compiled_pointers(cJSON * const object, cJSONUtils_Pointer * const * const pointers, const size_t count, cJSON ** const results, const cJSON_bool case_sensitive)
+{
+    pointer_evaluation evaluation;
+    size_t *pending = NULL;
+    size_t pending_count = 0;
+    size_t position = 0;
+
+    if ((pointers == NULL) || (results == NULL))
+    {
+        return false;
+    }
+
+    for (position = 0; position < count; position++)
+    {
+        results[position] = NULL;
+    }
+    if ((object == NULL) || (count == 0))
+    {
+        return true;
+    }
+
+    /* pending, scratch and matched_depth in one allocation */
+    pending = (size_t*)cJSON_malloc(3 * count * sizeof(size_t));
+    if (pending == NULL)
+    {
+        return false;
+    }
+    for (position = 0; position < count; position++)
+    {
+        if (pointers[position] != NULL)
+        {
+            pending[pending_count++] = position;
+        }
+    }
+    evaluation.pointers = pointers;
+    evaluation.results = results;
+    evaluation.scratch = pending + count;
+    evaluation.matched_depth = pending + (2 * count);
+    evaluation.case_sensitive = case_sensitive;
+    memset(evaluation.matched_depth, 0, count * sizeof(size_t));
+
+    get_items_from_compiled_pointers(&evaluation, object, pending, pending_count, 0);
+    cJSON_free(pending);
+
+    return true;
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSONUtils_GetCompiledPointers(cJSON * const object, cJSONUtils_Pointer * const * const pointers, size_t count, cJSON **results)
+{
+    return get_compiled_pointers(object, pointers, count, results, false);
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSONUtils_GetCompiledPointersCaseSensitive(cJSON * const object, cJSONUtils_Pointer * const * const pointers, size_t count, cJSON **results)
+{
+    return get_compiled_pointers(object, pointers, count, results, true);
 }
 
 /* JSON Patch implementation. */
@@ -379,7 +775,7 @@ static void decode_pointer_inplace(unsigned char *string)
 /* non-broken cJSON_DetachItemFromArray */
 static cJSON *detach_item_from_array(cJSON *array, size_t which)
 {
-    cJSON *c = array->child;
+    cJSON *c = cJSON_Materialize(array) ? array->child : NULL;
     while (c && (which > 0))
     {
         c = c->next;
@@ -390,23 +786,8 @@ static cJSON *detach_item_from_array(cJSON *array, size_t which)
         /* item doesn't exist */
         return NULL;
     }
-    if (c->prev)
-    {
-        /* not the first element */
-        c->prev->next = c->next;
-    }
-    if (c->next)
-    {
-        c->next->prev = c->prev;
-    }
-    if (c==array->child)
-    {
-        array->child = c->next;
-    }
-    /* make sure the detached item doesn't point anywhere anymore */
-    c->prev = c->next = NULL;
 
-    return c;
+    return cJSON_DetachItemViaPointer(array, c);
 }
 
 /* detach an item at the given path */
@@ -432,7 +813,7 @@ static cJSON *detach_path(cJSON *object, const unsigned char *path, const cJSON_
     child_pointer[0] = '\0';
     child_pointer++;
 
-    parent = get_item_from_pointer(object, (char*)parent_pointer, case_sensitive);
+    parent = get_item_from_pointer(object, (char*)parent_pointer, case_sensitive, true);
     decode_pointer_inplace(child_pointer);
 
     if (cJSON_IsArray(parent))
@@ -577,25 +958,56 @@ static cJSON *sort_list(cJSON *list, const cJSON_bool case_sensitive)
 
 static void sort_object(cJSON * const object, const cJSON_bool case_sensitive)
 {
-    if (object == NULL)
+    cJSON *last = NULL;
+
+    if (!cJSON_Unshare(object) || (object->child == NULL))
     {
         return;
     }
+
+    /* the first item points to the last one, which isn't part of the list for sorting */
+    object->child->prev = NULL;
     object->child = sort_list(object->child, case_sensitive);
+
+    for (last = object->child; last->next != NULL; last = last->next)
+    {
+    }
+    object->child->prev = last;
+
+    /* the order of the keys has changed */
+    if (cJSON_IsIndexed(object))
+    {
+        cJSON_IndexObject(object);
+    }
 }
 
-static cJSON_bool compare_json(cJSON *a, cJSON *b, const cJSON_bool case_sensitive)
+/* Objects are sorted for comparing them, which items in a shared block can't be (see cJSON_DuplicateShared).
+ * Those are compared through a copy that has to be deleted afterwards. Returns NULL on failure. */
+static cJSON *writable_item(cJSON * const item, cJSON ** const copy)
 {
-    if ((a == NULL) || (b == NULL) || ((a->type & 0xFF) != (b->type & 0xFF)))
+    *copy = NULL;
+    if (cJSON_Unshare(item))
     {
-        /* mismatched type. */
-        return false;
+        return item;
+    }
+    if (!(item->type & cJSON_IsReadOnly))
+    {
+        return NULL;
     }
+
+    *copy = cJSON_Duplicate(item, true);
+    return *copy;
+}
+
+static cJSON_bool compare_json(cJSON *a, cJSON *b, const cJSON_bool case_sensitive);
+
+static cJSON_bool compare_writable_json(cJSON *a, cJSON *b, const cJSON_bool case_sensitive)
+{
     switch (a->type & 0xFF)
     {
         case cJSON_Number:
             /* numeric mismatch. */
-            if ((a->valueint != b->valueint) || (a->valuedouble != b->valuedouble))
+            if ((a->valueint != b->valueint) || (cJSON_GetNumberValue(a) != cJSON_GetNumberValue(b)))
             {
                 return false;
             }
@@ -606,7 +1018,7 @@ static cJSON_bool compare_json(cJSON *a, cJSON *b, const cJSON_bool case_sensiti
 
         case cJSON_String:
             /* string mismatch. */
-            if (strcmp(a->valuestring, b->valuestring) != 0)
+            if (strcmp(cJSON_GetStringValue(a), cJSON_GetStringValue(b)) != 0)
             {
                 return false;
             }
@@ -672,40 +1084,38 @@ static cJSON_bool compare_json(cJSON *a, cJSON *b, const cJSON_bool case_sensiti
     return true;
 }
 
-/* non broken version of cJSON_InsertItemInArray */
-static cJSON_bool insert_item_in_array(cJSON *array, size_t which, cJSON *newitem)
+static cJSON_bool compare_json(cJSON *a, cJSON *b, const cJSON_bool case_sensitive)
 {
-    cJSON *child = array->child;
-    while (child && (which > 0))
+    cJSON *a_copy = NULL;
+    cJSON *b_copy = NULL;
+    cJSON_bool identical = false;
+
+    if ((a == NULL) || (b == NULL) || ((a->type & 0xFF) != (b->type & 0xFF)))
     {
-        child = child->next;
-        which--;
+        /* mismatched type. */
+        return false;
     }
-    if (which > 0)
+
+    a = writable_item(a, &a_copy);
+    b = writable_item(b, &b_copy);
+    identical = (a != NULL) && (b != NULL) && compare_writable_json(a, b, case_sensitive);
+    cJSON_Delete(a_copy);
+    cJSON_Delete(b_copy);
+
+    return identical;
+}
+
+/* non broken version of cJSON_InsertItemInArray */
+static cJSON_bool insert_item_in_array(cJSON *array, size_t which, cJSON *newitem)
+{
+    if ((which > INT_MAX) || ((int)which > cJSON_GetArraySize(array)))
     {
         /* item is after the end of the array */
         return 0;
     }
-    if (child == NULL)
-    {
-        cJSON_AddItemToArray(array, newitem);
-        return 1;
-    }
 
-    /* insert into the linked list */
-    newitem->next = child;
-    newitem->prev = child->prev;
-    child->prev = newitem;
-
-    /* was it at the beginning */
-    if (child == array->child)
-    {
-        array->child = newitem;
-    }
-    else
-    {
-        newitem->prev->next = newitem;
-    }
+    /* this also keeps the index of the array up to date */
+    cJSON_InsertItemInArray(array, (int)which, newitem);
 
     return 1;
 }
@@ -725,37 +1135,39 @@ enum patch_operation { INVALID, ADD, REMOVE, REPLACE, MOVE, COPY, TEST };
 static enum patch_operation decode_patch_operation(const cJSON * const patch, const cJSON_bool case_sensitive)
 {
     cJSON *operation = get_object_item(patch, "op", case_sensitive);
+    const char *name = NULL;
     if (!cJSON_IsString(operation))
     {
         return INVALID;
     }
+    name = cJSON_GetStringValue(operation);
 
-    if (strcmp(operation->valuestring, "add") == 0)
+    if (strcmp(name, "add") == 0)
     {
         return ADD;
     }
 
-    if (strcmp(operation->valuestring, "remove") == 0)
+    if (strcmp(name, "remove") == 0)
     {
         return REMOVE;
     }
 
-    if (strcmp(operation->valuestring, "replace") == 0)
+    if (strcmp(name, "replace") == 0)
     {
         return REPLACE;
     }
 
-    if (strcmp(operation->valuestring, "move") == 0)
+    if (strcmp(name, "move") == 0)
     {
         return MOVE;
     }
 
-    if (strcmp(operation->valuestring, "copy") == 0)
+    if (strcmp(name, "copy") == 0)
     {
         return COPY;
     }
 
-    if (strcmp(operation->valuestring, "test") == 0)
+    if (strcmp(name, "test") == 0)
     {
         return TEST;
     }
@@ -763,30 +1175,6 @@ static enum patch_operation decode_patch_operation(const cJSON * const patch, co
     return INVALID;
 }
 
-/* overwrite and existing item with another one and free resources on the way */
-static void overwrite_item(cJSON * const root, const cJSON replacement)
-{
-    if (root == NULL)
-    {
-        return;
-    }
-
-    if (root->string != NULL)
-    {
-        cJSON_free(root->string);
-    }
-    if (root->valuestring != NULL)
-    {
-        cJSON_free(root->valuestring);
-    }
-    if (root->child != NULL)
-    {
-        cJSON_Delete(root->child);
-    }
-
-    memcpy(root, &replacement, sizeof(cJSON));
-}
-
 static int apply_patch(cJSON *object, const cJSON *patch, const cJSON_bool case_sensitive)
 {
     cJSON *path = NULL;
@@ -814,18 +1202,29 @@ static int apply_patch(cJSON *object, const cJSON *patch, const cJSON_bool case_
     else if (opcode == TEST)
     {
         /* compare value: {...} with the given path */
-        status = !compare_json(get_item_from_pointer(object, path->valuestring, case_sensitive), get_object_item(patch, "value", case_sensitive), case_sensitive);
+        status = !compare_json(get_item_from_pointer(object, cJSON_GetStringValue(path), case_sensitive, true), get_object_item(patch, "value", case_sensitive), case_sensitive);
         goto cleanup;
     }
 
     /* special case for replacing the root */
-    if (path->valuestring[0] == '\0')
+    if (cJSON_GetStringValue(path)[0] == '\0')
     {
         if (opcode == REMOVE)
         {
-            static const cJSON invalid = { NULL, NULL, NULL, cJSON_Invalid, NULL, 0, 0, NULL};
+            value = cJSON_CreateNull();
+            if (value == NULL)
+            {
+                status = 8;
+                goto cleanup;
+            }
+            value->type = cJSON_Invalid;
 
-            overwrite_item(object, invalid);
+            if (!cJSON_ReplaceItemValue(object, value))
+            {
+                status = 8;
+                goto cleanup;
+            }
+            value = NULL;
 
             status = 0;
             goto cleanup;
@@ -849,18 +1248,13 @@ static int apply_patch(cJSON *object, const cJSON *patch, const cJSON_bool case_
                 goto cleanup;
             }
 
-            overwrite_item(object, *value);
-
-            /* delete the duplicated value */
-            cJSON_free(value);
-            value = NULL;
-
-            /* the string "value" isn't needed */
-            if (object->string != NULL)
+            /* the root keeps its place, also in an arena */
+            if (!cJSON_ReplaceItemValue(object, value))
             {
-                cJSON_free(object->string);
-                object->string = NULL;
+                status = 8;
+                goto cleanup;
             }
+            value = NULL;
 
             status = 0;
             goto cleanup;
@@ -870,7 +1264,7 @@ static int apply_patch(cJSON *object, const cJSON *patch, const cJSON_bool case_
     if ((opcode == REMOVE) || (opcode == REPLACE))
     {
         /* Get rid of old. */
-        cJSON *old_item = detach_path(object, (unsigned char*)path->valuestring, case_sensitive);
+        cJSON *old_item = detach_path(object, (unsigned char*)cJSON_GetStringValue(path), case_sensitive);
         if (old_item == NULL)
         {
             status = 13;
@@ -898,11 +1292,11 @@ static int apply_patch(cJSON *object, const cJSON *patch, const cJSON_bool case_
 
         if (opcode == MOVE)
         {
-            value = detach_path(object, (unsigned char*)from->valuestring, case_sensitive);
+            value = detach_path(object, (unsigned char*)cJSON_GetStringValue(from), case_sensitive);
         }
         if (opcode == COPY)
         {
-            value = get_item_from_pointer(object, from->valuestring, case_sensitive);
+            value = get_item_from_pointer(object, cJSON_GetStringValue(from), case_sensitive, false);
         }
         if (value == NULL)
         {
@@ -942,14 +1336,14 @@ static int apply_patch(cJSON *object, const cJSON *patch, const cJSON_bool case_
     /* Now, just add "value" to "path". */
 
     /* split pointer in parent and child */
-    parent_pointer = cJSONUtils_strdup((unsigned char*)path->valuestring);
+    parent_pointer = cJSONUtils_strdup((unsigned char*)cJSON_GetStringValue(path));
     child_pointer = (unsigned char*)strrchr((char*)parent_pointer, '/');
     if (child_pointer != NULL)
     {
         child_pointer[0] = '\0';
         child_pointer++;
     }
-    parent = get_item_from_pointer(object, (char*)parent_pointer, case_sensitive);
+    parent = get_item_from_pointer(object, (char*)parent_pointer, case_sensitive, true);
     decode_pointer_inplace(child_pointer);
 
     /* add, remove, replace, move, copy, test. */
@@ -1027,7 +1421,7 @@ CJSON_PUBLIC(int) cJSONUtils_ApplyPatches(cJSON * const object, const cJSON * co
         return 1;
     }
 
-    if (patches != NULL)
+    if (cJSON_Materialize(patches))
     {
         current_patch = patches->child;
     }
@@ -1056,7 +1450,7 @@ CJSON_PUBLIC(int) cJSONUtils_ApplyPatchesCaseSensitive(cJSON * const object, con
         return 1;
     }
 
-    if (patches != NULL)
+    if (cJSON_Materialize(patches))
     {
         current_patch = patches->child;
     }
@@ -1119,30 +1513,434 @@ CJSON_PUBLIC(void) cJSONUtils_AddPatchToArray(cJSON * const array, const char *
     compose_patch(array, (const unsigned char*)operation, (const unsigned char*)path, NULL, value);
 }
 
-static void create_patches(cJSON * const patches, const unsigned char * const path, cJSON * const from, cJSON * const to, const cJSON_bool case_sensitive)
+static void compose_move_patch(cJSON * const patches, const unsigned char * const path, const size_t from_index, const size_t to_index)
 {
-    if ((from == NULL) || (to == NULL))
+    cJSON *patch = NULL;
+    unsigned char *full_path = (unsigned char*)cJSON_malloc(strlen((const char*)path) + 20 + sizeof("/")); /* Allow space for 64bit int. log10(2^64) = 20 */
+
+    if (full_path == NULL)
     {
         return;
     }
-
-    if ((from->type & 0xFF) != (to->type & 0xFF))
+    patch = cJSON_CreateObject();
+    if (patch == NULL)
     {
-        compose_patch(patches, (const unsigned char*)"replace", path, 0, to);
+        cJSON_free(full_path);
         return;
     }
 
+    cJSON_AddItemToObject(patch, "op", cJSON_CreateString("move"));
+    sprintf((char*)full_path, "%s/%lu", path, (unsigned long)from_index);
+    cJSON_AddItemToObject(patch, "from", cJSON_CreateString((const char*)full_path));
+    sprintf((char*)full_path, "%s/%lu", path, (unsigned long)to_index);
+    cJSON_AddItemToObject(patch, "path", cJSON_CreateString((const char*)full_path));
+    cJSON_AddItemToArray(patches, patch);
+    cJSON_free(full_path);
+}
+
+/* an element that is added to or removed from an array in the alignment found by create_array_patches */
+typedef struct
+{
+    /* position in from and to where the edit happens */
+    size_t from_index;
+    size_t to_index;
+    cJSON_bool insert;
+    /* an equal element that is removed/added somewhere else, which turns both edits into a move */
+    size_t partner;
+    cJSON_bool done;
+} array_edit;
+
+#define NO_PARTNER ((size_t)-1)
+
+/* the elements of from and to with their hashes */
+typedef struct
+{
+    cJSON **from;
+    cJSON **to;
+    unsigned long *from_hashes;
+    unsigned long *to_hashes;
+    cJSON_bool case_sensitive;
+} array_alignment;
+
+static cJSON_bool aligned_elements_equal(const array_alignment * const alignment, const size_t from_index, const size_t to_index)
+{
+    return (alignment->from_hashes[from_index] == alignment->to_hashes[to_index])
+        && compare_json(alignment->from[from_index], alignment->to[to_index], alignment->case_sensitive);
+}
+
+/* Find the shortest sequence of inserted and removed elements between from[start, from_end) and to[start, to_end)
+ * with the O(ND) algorithm by Myers. Returns the number of edits in *edits, or false if there are more than limit of them
+ * or allocation fails. The edits are in order. */
+static cJSON_bool align_arrays(const array_alignment * const alignment, const size_t start, const size_t from_end, const size_t to_end, const size_t limit, array_edit ** const edits, size_t * const edit_count)
+{
+    /* the furthest x reached on every diagonal k for every number of edits d, at trace[d * d + d + k] */
+    size_t *trace = NULL;
+    size_t trace_size = 0;
+    const size_t from_length = from_end - start;
+    const size_t to_length = to_end - start;
+    size_t distance = 0;
+    size_t x = 0;
+    size_t y = 0;
+    cJSON_bool found = false;
+
+    *edits = NULL;
+    *edit_count = 0;
+
+    for (distance = 0; (distance <= limit) && (distance <= (from_length + to_length)) && !found; distance++)
+    {
+        const size_t *previous = (distance > 0) ? (trace + ((distance - 1) * (distance - 1)) + (distance - 1)) : NULL;
+        size_t *current = NULL;
+        size_t diagonal = 0;
+
+        if (((distance + 1) * (distance + 1)) > trace_size)
+        {
+            /* grow by doubling, the bands have 2d+1 entries */
+            size_t new_size = (trace_size == 0) ? 64 : (2 * trace_size);
+            size_t *new_trace = NULL;
+            while (new_size < ((distance + 1) * (distance + 1)))
+            {
+                new_size *= 2;
+            }
+            new_trace = (size_t*)cJSON_malloc(new_size * sizeof(size_t));
+            if (new_trace == NULL)
+            {
+                cJSON_free(trace);
+                return false;
+            }
+            if (trace != NULL)
+            {
+                memcpy(new_trace, trace, trace_size * sizeof(size_t));
+                cJSON_free(trace);
+            }
+            trace = new_trace;
+            trace_size = new_size;
+            previous = (distance > 0) ? (trace + ((distance - 1) * (distance - 1)) + (distance - 1)) : NULL;
+        }
+        current = trace + (distance * distance) + distance;
+
+        /* k = diagonal - distance goes from -d to d in steps of 2, x - y = k */
+        for (diagonal = 0; diagonal <= (2 * distance); diagonal += 2)
+        {
+            long k = (long)diagonal - (long)distance;
+            if (distance == 0)
+            {
+                x = 0;
+            }
+            else if ((k == -(long)distance) || ((k != (long)distance) && (previous[k - 1] < previous[k + 1])))
+            {
+                /* an insertion, coming from diagonal k + 1 */
+                x = previous[k + 1];
+            }
+            else
+            {
+                /* a removal, coming from diagonal k - 1 */
+                x = previous[k - 1] + 1;
+            }
+            y = (size_t)((long)x - k);
+
+            while ((x < from_length) && (y < to_length) && aligned_elements_equal(alignment, start + x, start + y))
+            {
+                x++;
+                y++;
+            }
+            current[k] = x;
+
+            if ((x >= from_length) && (y >= to_length))
+            {
+                found = true;
+                break;
+            }
+        }
+    }
+
+    if (!found)
+    {
+        cJSON_free(trace);
+        return false;
+    }
+
+    /* walk back through the trace to collect the edits */
+    distance--;
+    *edit_count = distance;
+    if (distance > 0)
+    {
+        *edits = (array_edit*)cJSON_malloc(distance * sizeof(array_edit));
+        if (*edits == NULL)
+        {
+            cJSON_free(trace);
+            return false;
+        }
+    }
+    x = from_length;
+    y = to_length;
+    for (; distance > 0; distance--)
+    {
+        const size_t *previous = trace + ((distance - 1) * (distance - 1)) + (distance - 1);
+        array_edit *edit = &(*edits)[distance - 1];
+        long k = (long)x - (long)y;
+        long previous_k = 0;
+        size_t previous_x = 0;
+        size_t previous_y = 0;
+
+        if ((k == -(long)distance) || ((k != (long)distance) && (previous[k - 1] < previous[k + 1])))
+        {
+            previous_k = k + 1;
+        }
+        else
+        {
+            previous_k = k - 1;
+        }
+        previous_x = previous[previous_k];
+        previous_y = (size_t)((long)previous_x - previous_k);
+
+        edit->insert = (previous_k == (k + 1));
+        edit->from_index = start + previous_x;
+        edit->to_index = start + previous_y;
+        edit->partner = NO_PARTNER;
+        edit->done = false;
+
+        x = previous_x;
+        y = previous_y;
+    }
+
+    cJSON_free(trace);
+    return true;
+}
+
+/* position of from[from_index] in the simulated array, NO_PARTNER if it isn't there */
+static size_t find_simulated_element(const size_t * const current, const size_t current_length, const size_t from_index)
+{
+    size_t position = 0;
+    for (position = 0; position < current_length; position++)
+    {
+        if (current[position] == from_index)
+        {
+            return position;
+        }
+    }
+
+    return NO_PARTNER;
+}
+
+static void create_patches(cJSON * const patches, const unsigned char * const path, cJSON * const from, cJSON * const to, const cJSON_bool case_sensitive, const size_t array_diff_limit, cJSON_HashMemo * const memo);
+
+/* the memo is missing if it couldn't be allocated or below copies, which are freed while patches are created */
+static unsigned long hash_with_memo(cJSON_HashMemo * const memo, const cJSON * const item, const cJSON_bool case_sensitive)
+{
+    if (memo == NULL)
+    {
+        return cJSON_Hash(item, case_sensitive);
+    }
+
+    return cJSON_HashWithMemo(memo, item);
+}
+
+/* Diff two arrays by aligning equal elements, so inserting or removing an element only creates one patch.
+ * Removed elements that are added again somewhere else become moves, a removal next to an addition is
+ * diffed as the same element. Returns false if there are more than limit insertions and removals. */
+static cJSON_bool create_array_patches(cJSON * const patches, const unsigned char * const path, cJSON * const from, cJSON * const to, const cJSON_bool case_sensitive, const size_t limit, cJSON_HashMemo * const memo)
+{
+    array_alignment alignment;
+    array_edit *edits = NULL;
+    size_t edit_count = 0;
+    size_t from_length = 0;
+    size_t to_length = 0;
+    size_t start = 0;
+    size_t from_end = 0;
+    size_t to_end = 0;
+    size_t i = 0;
+    size_t j = 0;
+    /* the array while the patches are applied, from elements by their index and added ones as from_length + to index */
+    size_t *current = NULL;
+    size_t current_length = 0;
+    size_t cursor = 0;
+    size_t edit_index = 0;
+    unsigned char *new_path = NULL;
+    cJSON *child = NULL;
+    cJSON_bool success = false;
+
+    from_length = (size_t)cJSON_GetArraySize(from);
+    to_length = (size_t)cJSON_GetArraySize(to);
+
+    memset(&alignment, '\0', sizeof(alignment));
+    alignment.case_sensitive = case_sensitive;
+    alignment.from = (cJSON**)cJSON_malloc((from_length + to_length + 1) * sizeof(cJSON*));
+    alignment.from_hashes = (unsigned long*)cJSON_malloc((from_length + to_length + 1) * sizeof(unsigned long));
+    current = (size_t*)cJSON_malloc((from_length + to_length + 1) * sizeof(size_t));
+    new_path = (unsigned char*)cJSON_malloc(strlen((const char*)path) + 20 + sizeof("/")); /* Allow space for 64bit int. log10(2^64) = 20 */
+    if ((alignment.from == NULL) || (alignment.from_hashes == NULL) || (current == NULL) || (new_path == NULL))
+    {
+        goto cleanup;
+    }
+    alignment.to = alignment.from + from_length;
+    alignment.to_hashes = alignment.from_hashes + from_length;
+
+    for ((void)(i = 0), child = from->child; child != NULL; (void)(child = child->next), i++)
+    {
+        alignment.from[i] = child;
+        alignment.from_hashes[i] = hash_with_memo(memo, child, case_sensitive);
+    }
+    for ((void)(i = 0), child = to->child; child != NULL; (void)(child = child->next), i++)
+    {
+        alignment.to[i] = child;
+        alignment.to_hashes[i] = hash_with_memo(memo, child, case_sensitive);
+    }
+
+    /* the common prefix and suffix don't need to be aligned */
+    for (start = 0; (start < from_length) && (start < to_length) && aligned_elements_equal(&alignment, start, start); start++)
+    {
+    }
+    for (from_end = from_length, to_end = to_length; (from_end > start) && (to_end > start) && aligned_elements_equal(&alignment, from_end - 1, to_end - 1); (void)from_end--, to_end--)
+    {
+    }
+
+    if (!align_arrays(&alignment, start, from_end, to_end, limit, &edits, &edit_count))
+    {
+        goto cleanup;
+    }
+
+    /* pair removed and added elements that are equal */
+    for (i = 0; i < edit_count; i++)
+    {
+        if (edits[i].insert || (edits[i].partner != NO_PARTNER))
+        {
+            continue;
+        }
+        for (j = 0; j < edit_count; j++)
+        {
+            if (edits[j].insert && (edits[j].partner == NO_PARTNER) && aligned_elements_equal(&alignment, edits[i].from_index, edits[j].to_index))
+            {
+                edits[i].partner = j;
+                edits[j].partner = i;
+                break;
+            }
+        }
+    }
+
+    for (current_length = 0; current_length < from_length; current_length++)
+    {
+        current[current_length] = current_length;
+    }
+
+    /* Emit the patches in order. i and j are the positions in from and to, cursor is the position in the current array.
+     * Elements that are moved to a later position stay where they are until their destination is reached. */
+    i = start;
+    j = start;
+    cursor = start;
+    for (edit_index = 0; edit_index < edit_count; edit_index++)
+    {
+        array_edit *edit = &edits[edit_index];
+        array_edit *next = ((edit_index + 1) < edit_count) ? &edits[edit_index + 1] : NULL;
+
+        /* unchanged elements */
+        cursor += edit->from_index - i;
+        i = edit->from_index;
+        j = edit->to_index;
+
+        if (cursor > ULONG_MAX)
+        {
+            goto cleanup;
+        }
+
+        if (!edit->insert)
+        {
+            if (edit->partner != NO_PARTNER)
+            {
+                /* done if it has already been moved to an earlier position */
+                if (!edit->done)
+                {
+                    /* moved to a later position, keep it here for now */
+                    cursor++;
+                }
+            }
+            else if ((next != NULL) && next->insert && (next->partner == NO_PARTNER) && (next->from_index == (i + 1)) && (next->to_index == j))
+            {
+                /* replaced */
+                sprintf((char*)new_path, "%s/%lu", path, (unsigned long)cursor);
+                create_patches(patches, new_path, alignment.from[i], alignment.to[j], case_sensitive, limit, memo);
+                cursor++;
+                j++;
+                edit_index++;
+            }
+            else
+            {
+                sprintf((char*)new_path, "%lu", (unsigned long)cursor);
+                compose_patch(patches, (const unsigned char*)"remove", path, new_path, NULL);
+                memmove(current + cursor, current + cursor + 1, (current_length - cursor - 1) * sizeof(size_t));
+                current_length--;
+            }
+            i++;
+        }
+        else
+        {
+            if (edit->partner != NO_PARTNER)
+            {
+                size_t position = find_simulated_element(current, current_length, edits[edit->partner].from_index);
+                size_t destination = (position < cursor) ? (cursor - 1) : cursor;
+                if ((position == NO_PARTNER) || (position > ULONG_MAX))
+                {
+                    goto cleanup;
+                }
+
+                compose_move_patch(patches, path, position, destination);
+                memmove(current + position, current + position + 1, (current_length - position - 1) * sizeof(size_t));
+                memmove(current + destination + 1, current + destination, (current_length - 1 - destination) * sizeof(size_t));
+                current[destination] = edits[edit->partner].from_index;
+                if (position > cursor)
+                {
+                    cursor++;
+                }
+                edits[edit->partner].done = true;
+            }
+            else if ((next != NULL) && !next->insert && (next->partner == NO_PARTNER) && (next->from_index == i) && (next->to_index == (j + 1)))
+            {
+                /* replaced */
+                sprintf((char*)new_path, "%s/%lu", path, (unsigned long)cursor);
+                create_patches(patches, new_path, alignment.from[i], alignment.to[j], case_sensitive, limit, memo);
+                cursor++;
+                i++;
+                edit_index++;
+            }
+            else
+            {
+                sprintf((char*)new_path, "%lu", (unsigned long)cursor);
+                compose_patch(patches, (const unsigned char*)"add", path, new_path, alignment.to[j]);
+                memmove(current + cursor + 1, current + cursor, (current_length - cursor) * sizeof(size_t));
+                current[cursor] = from_length + j;
+                current_length++;
+                cursor++;
+            }
+            j++;
+        }
+    }
+
+    success = true;
+
+cleanup:
+    cJSON_free(alignment.from);
+    cJSON_free(alignment.from_hashes);
+    cJSON_free(current);
+    cJSON_free(new_path);
+    cJSON_free(edits);
+
+    return success;
+}
+
+static void create_patches(cJSON * const patches, const unsigned char * const path, cJSON * const from, cJSON * const to, const cJSON_bool case_sensitive, const size_t array_diff_limit, cJSON_HashMemo * const memo);
+
+static void create_writable_patches(cJSON * const patches, const unsigned char * const path, cJSON * const from, cJSON * const to, const cJSON_bool case_sensitive, const size_t array_diff_limit, cJSON_HashMemo * const memo)
+{
     switch (from->type & 0xFF)
     {
         case cJSON_Number:
-            if ((from->valueint != to->valueint) || (from->valuedouble != to->valuedouble))
+            if ((from->valueint != to->valueint) || (cJSON_GetNumberValue(from) != cJSON_GetNumberValue(to)))
             {
                 compose_patch(patches, (const unsigned char*)"replace", path, NULL, to);
             }
             return;
 
         case cJSON_String:
-            if (strcmp(from->valuestring, to->valuestring) != 0)
+            if (strcmp(cJSON_GetStringValue(from), cJSON_GetStringValue(to)) != 0)
             {
                 compose_patch(patches, (const unsigned char*)"replace", path, NULL, to);
             }
@@ -1153,7 +1951,14 @@ static void create_patches(cJSON * const patches, const unsigned char * const pa
             size_t index = 0;
             cJSON *from_child = from->child;
             cJSON *to_child = to->child;
-            unsigned char *new_path = (unsigned char*)cJSON_malloc(strlen((const char*)path) + 20 + sizeof("/")); /* Allow space for 64bit int. log10(2^64) = 20 */
+            unsigned char *new_path = NULL;
+
+            if ((array_diff_limit > 0) && create_array_patches(patches, path, from, to, case_sensitive, array_diff_limit, memo))
+            {
+                return;
+            }
+
+            new_path = (unsigned char*)cJSON_malloc(strlen((const char*)path) + 20 + sizeof("/")); /* Allow space for 64bit int. log10(2^64) = 20 */
 
             /* generate patches for all array elements that exist in both "from" and "to" */
             for (index = 0; (from_child != NULL) && (to_child != NULL); (void)(from_child = from_child->next), (void)(to_child = to_child->next), index++)
@@ -1167,7 +1972,7 @@ static void create_patches(cJSON * const patches, const unsigned char * const pa
                     return;
                 }
                 sprintf((char*)new_path, "%s/%lu", path, (unsigned long)index); /* path of the current array element */
-                create_patches(patches, new_path, from_child, to_child, case_sensitive);
+                create_patches(patches, new_path, from_child, to_child, case_sensitive, array_diff_limit, memo);
             }
 
             /* remove leftover elements from 'from' that are not in 'to' */
@@ -1230,7 +2035,7 @@ static void create_patches(cJSON * const patches, const unsigned char * const pa
                     encode_string_as_pointer(new_path + path_length + 1, (unsigned char*)from_child->string);
 
                     /* create a patch for the element */
-                    create_patches(patches, new_path, from_child, to_child, case_sensitive);
+                    create_patches(patches, new_path, from_child, to_child, case_sensitive, array_diff_limit, memo);
                     cJSON_free(new_path);
 
                     from_child = from_child->next;
@@ -1259,24 +2064,51 @@ static void create_patches(cJSON * const patches, const unsigned char * const pa
     }
 }
 
-CJSON_PUBLIC(cJSON *) cJSONUtils_GeneratePatches(cJSON * const from, cJSON * const to)
+static void create_patches(cJSON * const patches, const unsigned char * const path, cJSON * const from, cJSON * const to, const cJSON_bool case_sensitive, const size_t array_diff_limit, cJSON_HashMemo * const memo)
 {
-    cJSON *patches = NULL;
+    cJSON *from_copy = NULL;
+    cJSON *to_copy = NULL;
+    cJSON *writable_from = NULL;
+    cJSON *writable_to = NULL;
 
     if ((from == NULL) || (to == NULL))
     {
-        return NULL;
+        return;
     }
 
-    patches = cJSON_CreateArray();
-    create_patches(patches, (const unsigned char*)"", from, to, false);
+    if ((from->type & 0xFF) != (to->type & 0xFF))
+    {
+        compose_patch(patches, (const unsigned char*)"replace", path, 0, to);
+        return;
+    }
 
-    return patches;
+    /* Equal arrays and objects don't need to be diffed. Their hashes rule out most unequal ones without comparing them,
+     * with the memo every item is only hashed once, no matter how deep it is. */
+    if ((memo != NULL) && ((from->type & (cJSON_Array | cJSON_Object)) != 0)
+            && (cJSON_HashWithMemo(memo, from) == cJSON_HashWithMemo(memo, to)) && compare_json(from, to, case_sensitive))
+    {
+        return;
+    }
+
+    writable_from = writable_item(from, &from_copy);
+    writable_to = writable_item(to, &to_copy);
+    if ((writable_from == NULL) || (writable_to == NULL))
+    {
+        /* they couldn't be compared, replacing the item is still right */
+        compose_patch(patches, (const unsigned char*)"replace", path, 0, to);
+    }
+    else
+    {
+        create_writable_patches(patches, path, writable_from, writable_to, case_sensitive, array_diff_limit, ((from_copy == NULL) && (to_copy == NULL)) ? memo : NULL);
+    }
+    cJSON_Delete(from_copy);
+    cJSON_Delete(to_copy);
 }
 
-CJSON_PUBLIC(cJSON *) cJSONUtils_GeneratePatchesCaseSensitive(cJSON * const from, cJSON * const to)
+static cJSON *generate_patches(cJSON * const from, cJSON * const to, const cJSON_bool case_sensitive, const size_t array_diff_limit)
 {
     cJSON *patches = NULL;
+    cJSON_HashMemo *memo = NULL;
 
     if ((from == NULL) || (to == NULL))
     {
@@ -1284,11 +2116,30 @@ CJSON_PUBLIC(cJSON *) cJSONUtils_GeneratePatchesCaseSensitive(cJSON * const from
     }
 
     patches = cJSON_CreateArray();
-    create_patches(patches, (const unsigned char*)"", from, to, true);
+
+    /* without the memo subtrees are only hashed where arrays are aligned */
+    memo = cJSON_CreateHashMemo(case_sensitive);
+    create_patches(patches, (const unsigned char*)"", from, to, case_sensitive, array_diff_limit, memo);
+    cJSON_DeleteHashMemo(memo);
 
     return patches;
 }
 
+CJSON_PUBLIC(cJSON *) cJSONUtils_GeneratePatches(cJSON * const from, cJSON * const to)
+{
+    return generate_patches(from, to, false, 0);
+}
+
+CJSON_PUBLIC(cJSON *) cJSONUtils_GeneratePatchesCaseSensitive(cJSON * const from, cJSON * const to)
+{
+    return generate_patches(from, to, true, 0);
+}
+
+CJSON_PUBLIC(cJSON *) cJSONUtils_GeneratePatchesWithOpts(cJSON * const from, cJSON * const to, const cJSON_bool case_sensitive, const size_t array_diff_limit)
+{
+    return generate_patches(from, to, case_sensitive, array_diff_limit);
+}
+
 CJSON_PUBLIC(void) cJSONUtils_SortObject(cJSON * const object)
 {
     sort_object(object, false);
@@ -1316,7 +2167,7 @@ static cJSON *merge_patch(cJSON *target, const cJSON * const patch, const cJSON_
         target = cJSON_CreateObject();
     }
 
-    patch_child = patch->child;
+    patch_child = cJSON_Materialize(patch) ? patch->child : NULL;
     while (patch_child != NULL)
     {
         if (cJSON_IsNull(patch_child))
@@ -1368,20 +2219,11 @@ CJSON_PUBLIC(cJSON *) cJSONUtils_MergePatchCaseSensitive(cJSON *target, const cJ
     return merge_patch(target, patch, true);
 }
 
-static cJSON *generate_merge_patch(cJSON * const from, cJSON * const to, const cJSON_bool case_sensitive)
+static cJSON *generate_object_merge_patch(cJSON * const from, cJSON * const to, const cJSON_bool case_sensitive)
 {
     cJSON *from_child = NULL;
     cJSON *to_child = NULL;
     cJSON *patch = NULL;
-    if (to == NULL)
-    {
-        /* patch to delete everything */
-        return cJSON_CreateNull();
-    }
-    if (!cJSON_IsObject(to) || !cJSON_IsObject(from))
-    {
-        return cJSON_Duplicate(to, 1);
-    }
 
     sort_object(from, case_sensitive);
     sort_object(to, case_sensitive);
@@ -1446,6 +2288,35 @@ static cJSON *generate_merge_patch(cJSON * const from, cJSON * const to, const c
     return patch;
 }
 
+static cJSON *generate_merge_patch(cJSON * const from, cJSON * const to, const cJSON_bool case_sensitive)
+{
+    cJSON *from_copy = NULL;
+    cJSON *to_copy = NULL;
+    cJSON *writable_from = NULL;
+    cJSON *writable_to = NULL;
+    cJSON *patch = NULL;
+    if (to == NULL)
+    {
+        /* patch to delete everything */
+        return cJSON_CreateNull();
+    }
+    if (!cJSON_IsObject(to) || !cJSON_IsObject(from))
+    {
+        return cJSON_Duplicate(to, 1);
+    }
+
+    writable_from = writable_item(from, &from_copy);
+    writable_to = writable_item(to, &to_copy);
+    if ((writable_from != NULL) && (writable_to != NULL))
+    {
+        patch = generate_object_merge_patch(writable_from, writable_to, case_sensitive);
+    }
+    cJSON_Delete(from_copy);
+    cJSON_Delete(to_copy);
+
+    return patch;
+}
+
 CJSON_PUBLIC(cJSON *) cJSONUtils_GenerateMergePatch(cJSON * const from, cJSON * const to)
 {
     return generate_merge_patch(from, to, false);
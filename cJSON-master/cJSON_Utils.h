@@ -33,11 +33,35 @@ extern "C"
 /* Implement RFC6901 (https://tools.ietf.org/html/rfc6901) JSON Pointer spec. */
 CJSON_PUBLIC(cJSON *) cJSONUtils_GetPointer(cJSON * const object, const char *pointer);
 CJSON_PUBLIC(cJSON *) cJSONUtils_GetPointerCaseSensitive(cJSON * const object, const char *pointer);
+/* Like cJSONUtils_GetPointer, but object and every array and object on the path are unshared first (see cJSON_Unshare),
+ * so the item can be changed in a copy from cJSON_DuplicateShared. Returns NULL if there is no such item or on failure. */
+CJSON_PUBLIC(cJSON *) cJSONUtils_UnsharePointer(cJSON * const object, const char *pointer);
+CJSON_PUBLIC(cJSON *) cJSONUtils_UnsharePointerCaseSensitive(cJSON * const object, const char *pointer);
+
+/* A JSON pointer that has been split into its path elements once, for evaluating it against many documents.
+ * Results are the same as with cJSONUtils_GetPointer. Returns NULL if pointer is NULL or allocation fails. */
+typedef struct cJSONUtils_Pointer cJSONUtils_Pointer;
+CJSON_PUBLIC(cJSONUtils_Pointer *) cJSONUtils_CompilePointer(const char *pointer);
+CJSON_PUBLIC(void) cJSONUtils_DeleteCompiledPointer(cJSONUtils_Pointer *pointer);
+CJSON_PUBLIC(cJSON *) cJSONUtils_GetCompiledPointer(cJSON * const object, const cJSONUtils_Pointer * const pointer);
+CJSON_PUBLIC(cJSON *) cJSONUtils_GetCompiledPointerCaseSensitive(cJSON * const object, const cJSONUtils_Pointer * const pointer);
+/* Evaluate count compiled pointers in one pass over object, results[i] is set to what pointers[i] points to or NULL.
+ * NULL entries in pointers give NULL results. Returns false if pointers or results is NULL or allocation fails. */
+CJSON_PUBLIC(cJSON_bool) cJSONUtils_GetCompiledPointers(cJSON * const object, cJSONUtils_Pointer * const * const pointers, size_t count, cJSON **results);
+CJSON_PUBLIC(cJSON_bool) cJSONUtils_GetCompiledPointersCaseSensitive(cJSON * const object, cJSONUtils_Pointer * const * const pointers, size_t count, cJSON **results);
 
 /* Implement RFC6902 (https://tools.ietf.org/html/rfc6902) JSON Patch spec. */
-/* NOTE: This modifies objects in 'from' and 'to' by sorting the elements by their key */
+/* NOTE: This modifies objects in 'from' and 'to' by sorting the elements by their key.
+ * Items that are read only (see cJSON_DuplicateShared) are compared through a temporary copy instead.
+ * Arrays and objects with the same hash (see cJSON_HashWithMemo) are compared first and skipped if they are equal. */
 CJSON_PUBLIC(cJSON *) cJSONUtils_GeneratePatches(cJSON * const from, cJSON * const to);
 CJSON_PUBLIC(cJSON *) cJSONUtils_GeneratePatchesCaseSensitive(cJSON * const from, cJSON * const to);
+/* Like cJSONUtils_GeneratePatches, but if array_diff_limit isn't 0, arrays are diffed by aligning equal elements
+ * instead of by position. Inserting or removing an element then creates one "add" or "remove" instead of a
+ * "replace" for every element after it, and elements that changed their position are moved with "move".
+ * Arrays that need more than array_diff_limit insertions and removals are compared by position,
+ * which bounds the work to O((n + m) * array_diff_limit) time and O(array_diff_limit^2) memory per array. */
+CJSON_PUBLIC(cJSON *) cJSONUtils_GeneratePatchesWithOpts(cJSON * const from, cJSON * const to, const cJSON_bool case_sensitive, const size_t array_diff_limit);
 /* Utility for generating patch array entries. */
 CJSON_PUBLIC(void) cJSONUtils_AddPatchToArray(cJSON * const array, const char * const operation, const char * const path, const cJSON * const value);
 /* Returns 0 for success. */
@@ -70,14 +94,15 @@ CJSON_PUBLIC(int) cJSONUtils_ApplyPatchesCaseSensitive(cJSON * const object, con
 CJSON_PUBLIC(cJSON *) cJSONUtils_MergePatch(cJSON *target, const cJSON * const patch);
 CJSON_PUBLIC(cJSON *) cJSONUtils_MergePatchCaseSensitive(cJSON *target, const cJSON * const patch);
 /* generates a patch to move from -> to */
-/* NOTE: This modifies objects in 'from' and 'to' by sorting the elements by their key */
+/* NOTE: This modifies objects in 'from' and 'to' by sorting the elements by their key.
+ * Items that are read only (see cJSON_DuplicateShared) are compared through a temporary copy instead. */
 CJSON_PUBLIC(cJSON *) cJSONUtils_GenerateMergePatch(cJSON * const from, cJSON * const to);
 CJSON_PUBLIC(cJSON *) cJSONUtils_GenerateMergePatchCaseSensitive(cJSON * const from, cJSON * const to);
 
 /* Given a root object and a target object, construct a pointer from one to the other. */
 CJSON_PUBLIC(char *) cJSONUtils_FindPointerFromObjectTo(const cJSON * const object, const cJSON * const target);
 
-/* Sorts the members of the object into alphabetical order. */
+/* Sorts the members of the object into alphabetical order. Objects with cJSON_IsReadOnly are left as they are. */
 CJSON_PUBLIC(void) cJSONUtils_SortObject(cJSON * const object);
 CJSON_PUBLIC(void) cJSONUtils_SortObjectCaseSensitive(cJSON * const object);
 
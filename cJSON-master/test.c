@@ -53,8 +53,8 @@ static int print_preallocated(cJSON *root)
     out = cJSON_Print(root);
 
     /* create buffer to succeed */
-    /* the extra 5 bytes are because of inaccuracies when reserving memory */
-    len = strlen(out) + 5;
+    /* the text and its terminating zero */
+    len = cJSON_PrintedLength(root, 1) + 1;
     buf = (char*)malloc(len);
     if (buf == NULL)
     {
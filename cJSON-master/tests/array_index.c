@@ -0,0 +1,178 @@
+/*
+  Copyright (c) 2009-2017 Dave Gamble and cJSON contributors
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#include "unity/examples/unity_config.h"
+#include "unity/src/unity.h"
+#include "common.h"
+
+#define ARRAY_SIZE 100
+
+static cJSON *create_indexed_array(int size)
+{
+    cJSON *array = cJSON_CreateArray();
+    int i = 0;
+
+    TEST_ASSERT_NOT_NULL(array);
+    for (i = 0; i < size; i++)
+    {
+        cJSON_AddItemToArray(array, cJSON_CreateNumber(i));
+    }
+    TEST_ASSERT_TRUE(cJSON_IndexArray(array));
+
+    return array;
+}
+
+/* compare the index with the linked list */
+static void assert_index_matches_list(cJSON *array)
+{
+    cJSON *child = NULL;
+    size_t position = 0;
+
+    TEST_ASSERT_NOT_NULL(index_of(array));
+    for (child = array->child; child != NULL; child = child->next)
+    {
+        TEST_ASSERT_TRUE(position < index_of(array)->count);
+        TEST_ASSERT_EQUAL_PTR(child, index_of(array)->items[position]);
+        TEST_ASSERT_EQUAL_PTR(child, cJSON_GetArrayItem(array, (int)position));
+        position++;
+    }
+    TEST_ASSERT_EQUAL_UINT(position, index_of(array)->count);
+    TEST_ASSERT_EQUAL_INT((int)position, cJSON_GetArraySize(array));
+    TEST_ASSERT_NULL(cJSON_GetArrayItem(array, (int)position));
+}
+
+static void array_index_should_give_access_to_items(void)
+{
+    cJSON *array = create_indexed_array(ARRAY_SIZE);
+    int i = 0;
+
+    TEST_ASSERT_EQUAL_INT(ARRAY_SIZE, cJSON_GetArraySize(array));
+    for (i = 0; i < ARRAY_SIZE; i++)
+    {
+        TEST_ASSERT_EQUAL_DOUBLE((double)i, item_number(cJSON_GetArrayItem(array, i)));
+    }
+    TEST_ASSERT_NULL(cJSON_GetArrayItem(array, ARRAY_SIZE));
+    TEST_ASSERT_NULL(cJSON_GetArrayItem(array, -1));
+    assert_index_matches_list(array);
+
+    cJSON_Delete(array);
+}
+
+static void array_index_should_only_be_created_for_arrays(void)
+{
+    cJSON *object = cJSON_CreateObject();
+    cJSON *array = cJSON_CreateArray();
+    cJSON *reference = NULL;
+
+    TEST_ASSERT_NOT_NULL(object);
+    TEST_ASSERT_NOT_NULL(array);
+    reference = cJSON_CreateArrayReference(array);
+    TEST_ASSERT_NOT_NULL(reference);
+
+    TEST_ASSERT_FALSE(cJSON_IndexArray(NULL));
+    TEST_ASSERT_FALSE(cJSON_IndexArray(object));
+    TEST_ASSERT_FALSE(cJSON_IndexArray(reference));
+
+    /* empty arrays can be indexed as well */
+    TEST_ASSERT_TRUE(cJSON_IndexArray(array));
+    TEST_ASSERT_EQUAL_INT(0, cJSON_GetArraySize(array));
+    TEST_ASSERT_NULL(cJSON_GetArrayItem(array, 0));
+    cJSON_AddItemToArray(array, cJSON_CreateNull());
+    assert_index_matches_list(array);
+
+    cJSON_Delete(reference);
+    cJSON_Delete(object);
+    cJSON_Delete(array);
+}
+
+static void array_index_should_follow_insertions(void)
+{
+    cJSON *array = create_indexed_array(ARRAY_SIZE);
+
+    cJSON_InsertItemInArray(array, 0, cJSON_CreateString("beginning"));
+    cJSON_InsertItemInArray(array, 50, cJSON_CreateString("middle"));
+    cJSON_InsertItemInArray(array, ARRAY_SIZE + 2, cJSON_CreateString("end"));
+    cJSON_InsertItemInArray(array, ARRAY_SIZE * 10, cJSON_CreateString("after the end"));
+
+    assert_index_matches_list(array);
+    TEST_ASSERT_EQUAL_STRING("beginning", item_valuestring(cJSON_GetArrayItem(array, 0)));
+    TEST_ASSERT_EQUAL_STRING("middle", item_valuestring(cJSON_GetArrayItem(array, 50)));
+    TEST_ASSERT_EQUAL_STRING("end", item_valuestring(cJSON_GetArrayItem(array, ARRAY_SIZE + 2)));
+    TEST_ASSERT_EQUAL_STRING("after the end", item_valuestring(cJSON_GetArrayItem(array, ARRAY_SIZE + 3)));
+
+    cJSON_Delete(array);
+}
+
+static void array_index_should_follow_detaching_and_replacing(void)
+{
+    cJSON *array = create_indexed_array(ARRAY_SIZE);
+    cJSON *replacement = cJSON_CreateString("replacement");
+
+    cJSON_DeleteItemFromArray(array, 0);
+    cJSON_DeleteItemFromArray(array, 10);
+    cJSON_DeleteItemFromArray(array, ARRAY_SIZE - 3);
+    cJSON_DeleteItemFromArray(array, ARRAY_SIZE);
+    assert_index_matches_list(array);
+    TEST_ASSERT_EQUAL_INT(ARRAY_SIZE - 3, cJSON_GetArraySize(array));
+    TEST_ASSERT_EQUAL_DOUBLE(1, item_number(cJSON_GetArrayItem(array, 0)));
+    TEST_ASSERT_EQUAL_DOUBLE(12, item_number(cJSON_GetArrayItem(array, 10)));
+
+    cJSON_ReplaceItemInArray(array, 5, replacement);
+    assert_index_matches_list(array);
+    TEST_ASSERT_EQUAL_PTR(replacement, cJSON_GetArrayItem(array, 5));
+
+    while (array->child != NULL)
+    {
+        cJSON_DeleteItemFromArray(array, cJSON_GetArraySize(array) / 2);
+    }
+    TEST_ASSERT_NOT_NULL(index_of(array));
+    TEST_ASSERT_EQUAL_INT(0, cJSON_GetArraySize(array));
+
+    cJSON_Delete(array);
+}
+
+static void array_index_should_not_be_duplicated(void)
+{
+    cJSON *array = create_indexed_array(ARRAY_SIZE);
+    cJSON *copy = cJSON_Duplicate(array, true);
+
+    TEST_ASSERT_NOT_NULL(copy);
+    TEST_ASSERT_NULL(index_of(copy));
+    TEST_ASSERT_TRUE(cJSON_Compare(array, copy, true));
+    TEST_ASSERT_EQUAL_INT(ARRAY_SIZE, cJSON_GetArraySize(copy));
+
+    cJSON_Delete(copy);
+    cJSON_Delete(array);
+}
+
+int CJSON_CDECL main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(array_index_should_give_access_to_items);
+    RUN_TEST(array_index_should_only_be_created_for_arrays);
+    RUN_TEST(array_index_should_follow_insertions);
+    RUN_TEST(array_index_should_follow_detaching_and_replacing);
+    RUN_TEST(array_index_should_not_be_duplicated);
+
+    return UNITY_END();
+}
@@ -0,0 +1,430 @@
+/*
+  Copyright (c) 2009-2017 Dave Gamble and cJSON contributors
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+
+#include "unity/examples/unity_config.h"
+#include "unity/src/unity.h"
+#include "common.h"
+
+static size_t hex_to_bytes(const char *hex, unsigned char *bytes)
+{
+    size_t length = 0;
+
+    for (; (hex[0] != '\0') && (hex[1] != '\0'); hex += 2)
+    {
+        unsigned int byte = 0;
+        TEST_ASSERT_EQUAL_INT(1, sscanf(hex, "%2x", &byte));
+        bytes[length++] = (unsigned char)byte;
+    }
+
+    return length;
+}
+
+static void assert_prints_cbor(const char * const json, const char * const expected_hex)
+{
+    unsigned char expected[64];
+    size_t expected_length = hex_to_bytes(expected_hex, expected);
+    cJSON *item = cJSON_Parse(json);
+    unsigned char *printed = NULL;
+    size_t length = 0;
+    TEST_ASSERT_NOT_NULL_MESSAGE(item, json);
+
+    printed = cJSON_PrintCBOR(item, &length);
+    TEST_ASSERT_NOT_NULL_MESSAGE(printed, json);
+    TEST_ASSERT_EQUAL_UINT_MESSAGE((unsigned int)expected_length, (unsigned int)length, json);
+    TEST_ASSERT_EQUAL_MEMORY_MESSAGE(expected, printed, length, json);
+
+    cJSON_free(printed);
+    cJSON_Delete(item);
+}
+
+static void assert_prints_cbor_number(const double number, const char * const expected_hex)
+{
+    unsigned char expected[16];
+    size_t expected_length = hex_to_bytes(expected_hex, expected);
+    cJSON *item = cJSON_CreateNumber(number);
+    unsigned char *printed = NULL;
+    size_t length = 0;
+    TEST_ASSERT_NOT_NULL(item);
+
+    printed = cJSON_PrintCBOR(item, &length);
+    TEST_ASSERT_NOT_NULL_MESSAGE(printed, expected_hex);
+    TEST_ASSERT_EQUAL_UINT_MESSAGE((unsigned int)expected_length, (unsigned int)length, expected_hex);
+    TEST_ASSERT_EQUAL_MEMORY_MESSAGE(expected, printed, length, expected_hex);
+
+    cJSON_free(printed);
+    cJSON_Delete(item);
+}
+
+static cJSON *parse_hex(const char * const hex)
+{
+    unsigned char bytes[64];
+    size_t length = hex_to_bytes(hex, bytes);
+
+    return cJSON_ParseCBOR(bytes, length, NULL);
+}
+
+static void assert_parses_cbor(const char * const hex, const char * const expected_json)
+{
+    cJSON *item = parse_hex(hex);
+    char *printed = NULL;
+    TEST_ASSERT_NOT_NULL_MESSAGE(item, hex);
+
+    printed = cJSON_PrintUnformatted(item);
+    TEST_ASSERT_NOT_NULL(printed);
+    TEST_ASSERT_EQUAL_STRING_MESSAGE(expected_json, printed, hex);
+
+    cJSON_free(printed);
+    cJSON_Delete(item);
+}
+
+static double parse_hex_number(const char * const hex)
+{
+    cJSON *item = parse_hex(hex);
+    double number = 0;
+    TEST_ASSERT_TRUE_MESSAGE(cJSON_IsNumber(item), hex);
+
+    number = cJSON_GetNumberValue(item);
+    cJSON_Delete(item);
+
+    return number;
+}
+
+/* examples from appendix A of RFC 8949 */
+static void cbor_should_print_values(void)
+{
+    assert_prints_cbor("0", "00");
+    assert_prints_cbor("23", "17");
+    assert_prints_cbor("24", "1818");
+    assert_prints_cbor("100", "1864");
+    assert_prints_cbor("1000", "1903e8");
+    assert_prints_cbor("1000000", "1a000f4240");
+    assert_prints_cbor("1000000000000", "1b000000e8d4a51000");
+    assert_prints_cbor("9007199254740992", "1b0020000000000000");
+    assert_prints_cbor("-1", "20");
+    assert_prints_cbor("-100", "3863");
+    assert_prints_cbor("-1000", "3903e7");
+    assert_prints_cbor("-9007199254740992", "3b001fffffffffffff");
+
+    assert_prints_cbor("1.5", "f93e00");
+    assert_prints_cbor("-0", "f98000");
+    assert_prints_cbor("1.1", "fb3ff199999999999a");
+    assert_prints_cbor("-4.1", "fbc010666666666666");
+    assert_prints_cbor("5.960464477539063e-8", "f90001");
+    assert_prints_cbor("0.00006103515625", "f90400");
+    assert_prints_cbor("3.4028234663852886e+38", "fa7f7fffff");
+    assert_prints_cbor("1.0e+300", "fb7e37e43c8800759c");
+    assert_prints_cbor("1e16", "fb4341c37937e08000");
+    assert_prints_cbor_number(HUGE_VAL, "f97c00");
+    assert_prints_cbor_number(-HUGE_VAL, "f9fc00");
+    assert_prints_cbor_number(NAN, "f97e00");
+
+    assert_prints_cbor("false", "f4");
+    assert_prints_cbor("true", "f5");
+    assert_prints_cbor("null", "f6");
+    assert_prints_cbor("\"\"", "60");
+    assert_prints_cbor("\"IETF\"", "6449455446");
+    assert_prints_cbor("\"\\u00fc\"", "62c3bc");
+    assert_prints_cbor("[]", "80");
+    assert_prints_cbor("[1, [2, 3], [4, 5]]", "8301820203820405");
+    assert_prints_cbor("{}", "a0");
+    assert_prints_cbor("{\"a\": 1, \"b\": [2, 3]}", "a26161016162820203");
+    assert_prints_cbor("{\"a\": 1, \"a\": 2}", "a2616101616102");
+}
+
+static void cbor_should_print_raw_as_embedded_json(void)
+{
+    cJSON *raw = cJSON_CreateRaw("[1,2]");
+    cJSON *parsed = NULL;
+    unsigned char *printed = NULL;
+    size_t length = 0;
+    unsigned char expected[] = { 0xd9, 0x01, 0x06, 0x45, '[', '1', ',', '2', ']' };
+    TEST_ASSERT_NOT_NULL(raw);
+
+    printed = cJSON_PrintCBOR(raw, &length);
+    TEST_ASSERT_NOT_NULL(printed);
+    TEST_ASSERT_EQUAL_UINT((unsigned int)sizeof(expected), (unsigned int)length);
+    TEST_ASSERT_EQUAL_MEMORY(expected, printed, length);
+
+    parsed = cJSON_ParseCBOR(printed, length, NULL);
+    TEST_ASSERT_TRUE(cJSON_IsRaw(parsed));
+    TEST_ASSERT_EQUAL_STRING("[1,2]", item_valuestring(parsed));
+
+    cJSON_free(printed);
+    cJSON_Delete(parsed);
+    cJSON_Delete(raw);
+}
+
+static void cbor_should_parse_values(void)
+{
+    assert_parses_cbor("00", "0");
+    assert_parses_cbor("1903e8", "1000");
+    assert_parses_cbor("3903e7", "-1000");
+    assert_parses_cbor("f4", "false");
+    assert_parses_cbor("f5", "true");
+    assert_parses_cbor("f6", "null");
+    assert_parses_cbor("f7", "null");
+    assert_parses_cbor("6449455446", "\"IETF\"");
+    assert_parses_cbor("62c3bc", "\"\xc3\xbc\"");
+    assert_parses_cbor("8301820203820405", "[1,[2,3],[4,5]]");
+    assert_parses_cbor("a26161016162820203", "{\"a\":1,\"b\":[2,3]}");
+    assert_parses_cbor("d9010643313233", "123");
+
+    /* indefinite lengths */
+    assert_parses_cbor("7f657374726561646d696e67ff", "\"streaming\"");
+    assert_parses_cbor("7fff", "\"\"");
+    assert_parses_cbor("9fff", "[]");
+    assert_parses_cbor("9f018202039f0405ffff", "[1,[2,3],[4,5]]");
+    assert_parses_cbor("bf61610161629f0203ffff", "{\"a\":1,\"b\":[2,3]}");
+    assert_parses_cbor("bf6346756ef563416d7421ff", "{\"Fun\":true,\"Amt\":-2}");
+
+    /* other tags are ignored */
+    assert_parses_cbor("c074323031332d30332d32315432303a30343a30305a", "\"2013-03-21T20:04:00Z\"");
+    assert_parses_cbor("d82076687474703a2f2f7777772e6578616d706c652e636f6d", "\"http://www.example.com\"");
+
+    TEST_ASSERT_TRUE(parse_hex_number("1bffffffffffffffff") == 18446744073709551615.0);
+    TEST_ASSERT_TRUE(parse_hex_number("3bffffffffffffffff") == -18446744073709551616.0);
+    TEST_ASSERT_TRUE(parse_hex_number("f93c00") == 1.0);
+    TEST_ASSERT_TRUE(parse_hex_number("f97bff") == 65504.0);
+    TEST_ASSERT_TRUE(parse_hex_number("f90001") == 5.960464477539063e-8);
+    TEST_ASSERT_TRUE(parse_hex_number("f9c400") == -4.0);
+    TEST_ASSERT_TRUE(parse_hex_number("fa47c35000") == 100000.0);
+    TEST_ASSERT_TRUE(parse_hex_number("fb3ff199999999999a") == 1.1);
+    TEST_ASSERT_TRUE(parse_hex_number("f97c00") == HUGE_VAL);
+    TEST_ASSERT_TRUE(parse_hex_number("fa7f800000") == HUGE_VAL);
+    TEST_ASSERT_TRUE(parse_hex_number("f9fc00") == -HUGE_VAL);
+    TEST_ASSERT_TRUE(parse_hex_number("f97e00") != parse_hex_number("f97e00"));
+    TEST_ASSERT_TRUE(parse_hex_number("fb7ff8000000000000") != parse_hex_number("fb7ff8000000000000"));
+}
+
+static void assert_rejects_cbor(const char * const hex, const size_t error_position)
+{
+    unsigned char bytes[64];
+    size_t length = hex_to_bytes(hex, bytes);
+    size_t consumed = 0;
+
+    TEST_ASSERT_NULL_MESSAGE(cJSON_ParseCBOR(bytes, length, NULL), hex);
+    TEST_ASSERT_TRUE_MESSAGE(cJSON_GetErrorPtr() == (const char*)bytes + error_position, hex);
+    TEST_ASSERT_NULL_MESSAGE(cJSON_ParseCBOR(bytes, length, &consumed), hex);
+    TEST_ASSERT_EQUAL_UINT_MESSAGE((unsigned int)error_position, (unsigned int)consumed, hex);
+}
+
+static void cbor_should_reject_invalid_input(void)
+{
+    TEST_ASSERT_NULL(cJSON_ParseCBOR(NULL, 1, NULL));
+    assert_rejects_cbor("", 0);
+    /* truncated */
+    assert_rejects_cbor("19", 1);
+    assert_rejects_cbor("1903", 1);
+    assert_rejects_cbor("6449", 1);
+    assert_rejects_cbor("830102", 1);
+    assert_rejects_cbor("83", 1);
+    assert_rejects_cbor("9f01", 2);
+    assert_rejects_cbor("7f6161", 3);
+    assert_rejects_cbor("fb3ff1", 1);
+    assert_rejects_cbor("a16161", 3);
+    /* lengths beyond the end are rejected before allocating anything */
+    assert_rejects_cbor("9bffffffffffffffff", 9);
+    assert_rejects_cbor("7bffffffffffffffff", 9);
+    /* not supported */
+    assert_rejects_cbor("4401020304", 0);
+    assert_rejects_cbor("d9010661", 3);
+    assert_rejects_cbor("a10102", 1);
+    assert_rejects_cbor("6100", 1);
+    assert_rejects_cbor("f820", 0);
+    assert_rejects_cbor("f0", 0);
+    /* not well-formed */
+    assert_rejects_cbor("1c", 0);
+    assert_rejects_cbor("ff", 0);
+    assert_rejects_cbor("1f", 0);
+    assert_rejects_cbor("df00", 0);
+    assert_rejects_cbor("7f01ff", 1);
+    assert_rejects_cbor("7f7f60ffff", 1);
+}
+
+static void cbor_should_reject_trailing_bytes_without_consumed(void)
+{
+    unsigned char bytes[] = { 0x00, 0x00 };
+    size_t consumed = 0;
+    cJSON *item = NULL;
+
+    TEST_ASSERT_NULL(cJSON_ParseCBOR(bytes, sizeof(bytes), NULL));
+    TEST_ASSERT_TRUE(cJSON_GetErrorPtr() == (const char*)bytes + 1);
+
+    item = cJSON_ParseCBOR(bytes, sizeof(bytes), &consumed);
+    TEST_ASSERT_NOT_NULL(item);
+    TEST_ASSERT_EQUAL_UINT(1, (unsigned int)consumed);
+    cJSON_Delete(item);
+}
+
+static void cbor_should_limit_nesting(void)
+{
+    unsigned char nested[CJSON_NESTING_LIMIT + 1];
+    cJSON *item = NULL;
+
+    memset(nested, 0x81, sizeof(nested));
+    nested[CJSON_NESTING_LIMIT] = 0x80;
+    item = cJSON_ParseCBOR(nested + 1, CJSON_NESTING_LIMIT, NULL);
+    TEST_ASSERT_NOT_NULL(item);
+    cJSON_Delete(item);
+
+    TEST_ASSERT_NULL(cJSON_ParseCBOR(nested, sizeof(nested), NULL));
+}
+
+static void cbor_should_read_sequences(void)
+{
+    unsigned char bytes[] = { 0x01, 0x62, 'h', 'i', 0x80 };
+    const char *expected[] = { "1", "\"hi\"", "[]" };
+    size_t offset = 0;
+    size_t i = 0;
+
+    for (i = 0; i < 3; i++)
+    {
+        size_t consumed = 0;
+        cJSON *item = cJSON_ParseCBOR(bytes + offset, sizeof(bytes) - offset, &consumed);
+        char *printed = cJSON_PrintUnformatted(item);
+        TEST_ASSERT_NOT_NULL(printed);
+        TEST_ASSERT_EQUAL_STRING(expected[i], printed);
+        offset += consumed;
+
+        cJSON_free(printed);
+        cJSON_Delete(item);
+    }
+    TEST_ASSERT_EQUAL_UINT((unsigned int)sizeof(bytes), (unsigned int)offset);
+}
+
+static void cbor_should_round_trip_test_files(void)
+{
+    const char *files[] = { "inputs/test1", "inputs/test2", "inputs/test3", "inputs/test4", "inputs/test5", "inputs/test7", "inputs/test8", "inputs/test9", "inputs/test10", "inputs/test11" };
+    size_t i = 0;
+
+    for (i = 0; i < (sizeof(files) / sizeof(files[0])); i++)
+    {
+        char *content = read_file(files[i]);
+        cJSON *tree = NULL;
+        cJSON *parsed = NULL;
+        unsigned char *cbor = NULL;
+        char *expected = NULL;
+        char *actual = NULL;
+        size_t length = 0;
+        TEST_ASSERT_NOT_NULL(content);
+
+        tree = cJSON_Parse(content);
+        TEST_ASSERT_NOT_NULL(tree);
+        cbor = cJSON_PrintCBOR(tree, &length);
+        TEST_ASSERT_NOT_NULL(cbor);
+        parsed = cJSON_ParseCBOR(cbor, length, NULL);
+        TEST_ASSERT_NOT_NULL_MESSAGE(parsed, files[i]);
+        TEST_ASSERT_TRUE_MESSAGE(cJSON_Compare(tree, parsed, true), files[i]);
+
+        expected = cJSON_PrintUnformatted(tree);
+        actual = cJSON_PrintUnformatted(parsed);
+        TEST_ASSERT_NOT_NULL(expected);
+        TEST_ASSERT_NOT_NULL(actual);
+        TEST_ASSERT_EQUAL_STRING_MESSAGE(expected, actual, files[i]);
+
+        cJSON_free(expected);
+        cJSON_free(actual);
+        cJSON_free(cbor);
+        cJSON_Delete(parsed);
+        cJSON_Delete(tree);
+        free(content);
+    }
+}
+
+static void cbor_should_round_trip_numbers(void)
+{
+    unsigned long state = 1;
+    int i = 0;
+
+    for (i = 0; i < 100000; i++)
+    {
+        unsigned char bits[sizeof(double)];
+        double number = 0;
+        cJSON *item = NULL;
+        cJSON *parsed = NULL;
+        unsigned char *cbor = NULL;
+        size_t length = 0;
+        size_t j = 0;
+        int exponent = 0;
+
+        for (j = 0; j < sizeof(bits); j++)
+        {
+            state = (state * 1103515245UL + 12345UL) & 0x7FFFFFFFUL;
+            bits[j] = (unsigned char)(state >> 16);
+        }
+        memcpy(&number, bits, sizeof(number));
+        switch (i % 4)
+        {
+            case 0:
+                /* integers of every size */
+                number = floor(ldexp(fabs(number) / (fabs(number) + 1), (int)(state % 64)));
+                break;
+            case 1:
+                /* floats and halves */
+                number = (double)(float)number;
+                if ((i % 8) == 1)
+                {
+                    number = ldexp(floor(ldexp(frexp(number, &exponent), 11)), (int)(state % 50) - 35);
+                }
+                break;
+            default:
+                break;
+        }
+
+        item = cJSON_CreateNumber(number);
+        TEST_ASSERT_NOT_NULL(item);
+        cbor = cJSON_PrintCBOR(item, &length);
+        TEST_ASSERT_NOT_NULL(cbor);
+        parsed = cJSON_ParseCBOR(cbor, length, NULL);
+        TEST_ASSERT_TRUE(cJSON_IsNumber(parsed));
+        if (number == number)
+        {
+            TEST_ASSERT_TRUE(memcmp(&number, &item_number(parsed), sizeof(number)) == 0);
+        }
+        else
+        {
+            TEST_ASSERT_TRUE(item_number(parsed) != item_number(parsed));
+        }
+
+        cJSON_free(cbor);
+        cJSON_Delete(parsed);
+        cJSON_Delete(item);
+    }
+}
+
+int CJSON_CDECL main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(cbor_should_print_values);
+    RUN_TEST(cbor_should_print_raw_as_embedded_json);
+    RUN_TEST(cbor_should_parse_values);
+    RUN_TEST(cbor_should_reject_invalid_input);
+    RUN_TEST(cbor_should_reject_trailing_bytes_without_consumed);
+    RUN_TEST(cbor_should_limit_nesting);
+    RUN_TEST(cbor_should_read_sequences);
+    RUN_TEST(cbor_should_round_trip_test_files);
+    RUN_TEST(cbor_should_round_trip_numbers);
+
+    return UNITY_END();
+}
@@ -205,7 +205,7 @@ static void cjson_add_number_should_add_number(void)
     TEST_ASSERT_NOT_NULL(number = cJSON_GetObjectItemCaseSensitive(root, "number"));
 
     TEST_ASSERT_EQUAL_INT(number->type, cJSON_Number);
-    TEST_ASSERT_EQUAL_DOUBLE(number->valuedouble, 42);
+    TEST_ASSERT_EQUAL_DOUBLE(item_number(number), 42);
     TEST_ASSERT_EQUAL_INT(number->valueint, 42);
 
     cJSON_Delete(root);
@@ -243,7 +243,7 @@ static void cjson_add_string_should_add_string(void)
 
     TEST_ASSERT_NOT_NULL(string = cJSON_GetObjectItemCaseSensitive(root, "string"));
     TEST_ASSERT_EQUAL_INT(string->type, cJSON_String);
-    TEST_ASSERT_EQUAL_STRING(string->valuestring, "Hello World!");
+    TEST_ASSERT_EQUAL_STRING(item_valuestring(string), "Hello World!");
 
     cJSON_Delete(root);
 }
@@ -280,7 +280,7 @@ static void cjson_add_raw_should_add_raw(void)
 
     TEST_ASSERT_NOT_NULL(raw = cJSON_GetObjectItemCaseSensitive(root, "raw"));
     TEST_ASSERT_EQUAL_INT(raw->type, cJSON_Raw);
-    TEST_ASSERT_EQUAL_STRING(raw->valuestring, "{}");
+    TEST_ASSERT_EQUAL_STRING(item_valuestring(raw), "{}");
 
     cJSON_Delete(root);
 }
@@ -31,13 +31,17 @@ void reset(cJSON *item) {
     {
         cJSON_Delete(item->child);
     }
-    if ((item->valuestring != NULL) && !(item->type & cJSON_IsReference))
+    if ((item_valuestring(item) != NULL) && !(item->type & cJSON_IsReference) && !string_is_inline(item))
     {
-        global_hooks.deallocate(item->valuestring);
+        global_hooks.deallocate(item_valuestring(item), global_hooks.user_data);
     }
     if ((item->string != NULL) && !(item->type & cJSON_StringIsConst))
     {
-        global_hooks.deallocate(item->string);
+        global_hooks.deallocate(item->string, global_hooks.user_data);
+    }
+    if (index_of(item) != NULL)
+    {
+        index_free(index_of(item));
     }
 
     memset(item, 0, sizeof(cJSON));
@@ -99,12 +103,45 @@ cleanup:
     return content;
 }
 
+/* count the allocations of cJSON, use_counting_hooks resets the counters and installs them */
+extern size_t allocations;
+extern size_t live_allocations;
+size_t allocations = 0;
+size_t live_allocations = 0;
+
+void * CJSON_CDECL counting_malloc(size_t size);
+void * CJSON_CDECL counting_malloc(size_t size)
+{
+    allocations++;
+    live_allocations++;
+    return malloc(size);
+}
+
+void CJSON_CDECL counting_free(void *pointer);
+void CJSON_CDECL counting_free(void *pointer)
+{
+    if (pointer != NULL)
+    {
+        live_allocations--;
+    }
+    free(pointer);
+}
+
+void use_counting_hooks(void);
+void use_counting_hooks(void)
+{
+    cJSON_Hooks hooks = { counting_malloc, counting_free };
+    allocations = 0;
+    live_allocations = 0;
+    cJSON_InitHooks(&hooks);
+}
+
 /* assertion helper macros */
 #define assert_has_type(item, item_type) TEST_ASSERT_BITS_MESSAGE(0xFF, item_type, item->type, "Item doesn't have expected type.")
 #define assert_has_no_reference(item) TEST_ASSERT_BITS_MESSAGE(cJSON_IsReference, 0, item->type, "Item should not have a string as reference.")
 #define assert_has_no_const_string(item) TEST_ASSERT_BITS_MESSAGE(cJSON_StringIsConst, 0, item->type, "Item should not have a const string.")
-#define assert_has_valuestring(item) TEST_ASSERT_NOT_NULL_MESSAGE(item->valuestring, "Valuestring is NULL.")
-#define assert_has_no_valuestring(item) TEST_ASSERT_NULL_MESSAGE(item->valuestring, "Valuestring is not NULL.")
+#define assert_has_valuestring(item) TEST_ASSERT_NOT_NULL_MESSAGE(item_valuestring(item), "Valuestring is NULL.")
+#define assert_has_no_valuestring(item) TEST_ASSERT_NULL_MESSAGE(item_valuestring(item), "Valuestring is not NULL.")
 #define assert_has_string(item) TEST_ASSERT_NOT_NULL_MESSAGE(item->string, "String is NULL")
 #define assert_has_no_string(item) TEST_ASSERT_NULL_MESSAGE(item->string, "String is not NULL.")
 #define assert_not_in_list(item) \
@@ -0,0 +1,144 @@
+/*
+  Copyright (c) 2009-2017 Dave Gamble and cJSON contributors
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "unity/examples/unity_config.h"
+#include "unity/src/unity.h"
+#include "common.h"
+
+static void accessors_should_return_values(void)
+{
+    cJSON *number = cJSON_CreateNumber(1.5);
+    cJSON *string = cJSON_CreateString("a string that is too long to be inlined");
+    cJSON *null = cJSON_CreateNull();
+    TEST_ASSERT_NOT_NULL(number);
+    TEST_ASSERT_NOT_NULL(string);
+    TEST_ASSERT_NOT_NULL(null);
+
+    TEST_ASSERT_EQUAL_DOUBLE(1.5, cJSON_GetNumberValue(number));
+    TEST_ASSERT_EQUAL_INT(1, number->valueint);
+    TEST_ASSERT_NULL(cJSON_GetStringValue(number));
+
+    TEST_ASSERT_EQUAL_STRING("a string that is too long to be inlined", cJSON_GetStringValue(string));
+    TEST_ASSERT_TRUE(cJSON_GetNumberValue(string) != cJSON_GetNumberValue(string));
+
+    TEST_ASSERT_NULL(cJSON_GetStringValue(null));
+    TEST_ASSERT_NULL(cJSON_GetStringValue(NULL));
+    TEST_ASSERT_TRUE(cJSON_GetNumberValue(NULL) != cJSON_GetNumberValue(NULL));
+
+    cJSON_SetNumberValue(number, -2);
+    TEST_ASSERT_EQUAL_DOUBLE(-2, cJSON_GetNumberValue(number));
+    TEST_ASSERT_EQUAL_INT(-2, number->valueint);
+
+    cJSON_Delete(number);
+    cJSON_Delete(string);
+    cJSON_Delete(null);
+}
+
+static void short_strings_should_be_stored_in_the_item(void)
+{
+    cJSON *tree = cJSON_Parse("{\"short\": \"1234567\", \"long\": \"12345678\", \"empty\": \"\", \"escaped\": \"\\u00e4\\n\"}");
+    cJSON *item = NULL;
+    TEST_ASSERT_NOT_NULL(tree);
+
+    item = cJSON_GetObjectItemCaseSensitive(tree, "short");
+    TEST_ASSERT_EQUAL_STRING("1234567", cJSON_GetStringValue(item));
+#ifdef CJSON_COMPACT_NODES
+    TEST_ASSERT_BITS(cJSON_StringIsInline, cJSON_StringIsInline, item->type);
+    TEST_ASSERT_EQUAL_PTR(item->value.inline_string, cJSON_GetStringValue(item));
+#endif
+
+    item = cJSON_GetObjectItemCaseSensitive(tree, "long");
+    TEST_ASSERT_EQUAL_STRING("12345678", cJSON_GetStringValue(item));
+#ifdef CJSON_COMPACT_NODES
+    TEST_ASSERT_BITS(cJSON_StringIsInline, 0, item->type);
+#endif
+
+    TEST_ASSERT_EQUAL_STRING("", cJSON_GetStringValue(cJSON_GetObjectItemCaseSensitive(tree, "empty")));
+    TEST_ASSERT_EQUAL_STRING("\xc3\xa4\n", cJSON_GetStringValue(cJSON_GetObjectItemCaseSensitive(tree, "escaped")));
+
+    cJSON_Delete(tree);
+}
+
+static void inline_strings_should_survive_tree_operations(void)
+{
+    cJSON *original = cJSON_CreateArray();
+    cJSON *copy = NULL;
+    char *printed = NULL;
+    TEST_ASSERT_NOT_NULL(original);
+
+    cJSON_AddItemToArray(original, cJSON_CreateString("abc"));
+    cJSON_AddItemToArray(original, cJSON_CreateString("a much longer string"));
+    cJSON_AddItemToArray(original, cJSON_CreateNumber(42));
+    cJSON_AddItemToArray(original, cJSON_CreateStringReference("ref"));
+
+    copy = cJSON_Duplicate(original, true);
+    TEST_ASSERT_NOT_NULL(copy);
+    TEST_ASSERT_TRUE(cJSON_Compare(original, copy, true));
+    TEST_ASSERT_EQUAL_STRING("abc", cJSON_GetStringValue(cJSON_GetArrayItem(copy, 0)));
+    TEST_ASSERT_EQUAL_DOUBLE(42, cJSON_GetNumberValue(cJSON_GetArrayItem(copy, 2)));
+    TEST_ASSERT_TRUE(cJSON_GetStringValue(cJSON_GetArrayItem(original, 0)) != cJSON_GetStringValue(cJSON_GetArrayItem(copy, 0)));
+
+    cJSON_Delete(original);
+
+    printed = cJSON_PrintUnformatted(copy);
+    TEST_ASSERT_NOT_NULL(printed);
+    TEST_ASSERT_EQUAL_STRING("[\"abc\",\"a much longer string\",42,\"ref\"]", printed);
+    cJSON_free(printed);
+
+    cJSON_DeleteItemFromArray(copy, 0);
+    TEST_ASSERT_EQUAL_INT(3, cJSON_GetArraySize(copy));
+    cJSON_Delete(copy);
+}
+
+static void invalid_short_strings_should_be_released(void)
+{
+    /* the escape sequence fails after the first characters have been written to the item */
+    TEST_ASSERT_NULL(cJSON_Parse("{\"key\":\"ab\\u\"}"));
+    TEST_ASSERT_NULL(cJSON_Parse("[\"ab\\x\"]"));
+}
+
+static void compact_items_should_be_smaller(void)
+{
+#ifdef CJSON_COMPACT_NODES
+    /* four pointers, the payload and two ints */
+    TEST_ASSERT_TRUE(sizeof(cJSON) <= ((4 * sizeof(void*)) + sizeof(double) + (2 * sizeof(int))));
+#else
+    TEST_IGNORE_MESSAGE("cJSON was built without CJSON_COMPACT_NODES.");
+#endif
+}
+
+int CJSON_CDECL main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(accessors_should_return_values);
+    RUN_TEST(short_strings_should_be_stored_in_the_item);
+    RUN_TEST(inline_strings_should_survive_tree_operations);
+    RUN_TEST(invalid_short_strings_should_be_released);
+    RUN_TEST(compact_items_should_be_smaller);
+
+    return UNITY_END();
+}
@@ -186,6 +186,394 @@ static void cjson_compare_should_compare_objects(void)
                 false))
 }
 
+static void cjson_compare_should_match_members_with_the_same_key_in_order(void)
+{
+    TEST_ASSERT_FALSE(compare_from_string("{\"x\": 1, \"x\": 1}", "{\"x\": 1}", true));
+    TEST_ASSERT_FALSE(compare_from_string("{\"x\": 1}", "{\"x\": 1, \"x\": 1}", true));
+    TEST_ASSERT_TRUE(compare_from_string("{\"x\": 1, \"y\": 0, \"x\": 2}", "{\"x\": 1, \"x\": 2, \"y\": 0}", true));
+    TEST_ASSERT_FALSE(compare_from_string("{\"x\": 1, \"x\": 2}", "{\"x\": 2, \"x\": 1}", true));
+    TEST_ASSERT_TRUE(compare_from_string("{\"X\": 1, \"x\": 2}", "{\"x\": 1, \"X\": 2}", false));
+    TEST_ASSERT_FALSE(compare_from_string("{\"X\": 1, \"x\": 2}", "{\"x\": 1, \"X\": 2}", true));
+    TEST_ASSERT_FALSE(compare_from_string("{\"x\": 1, \"x\": 1, \"y\": 2}", "{\"x\": 1, \"y\": 2, \"y\": 2}", true));
+}
+
+static void cjson_compare_should_compare_wide_objects(void)
+{
+    cJSON *a = cJSON_CreateObject();
+    cJSON *b = cJSON_CreateObject();
+    char key[16];
+    int i = 0;
+
+    for (i = 0; i < 100; i++)
+    {
+        sprintf(key, "key%d", i);
+        cJSON_AddNumberToObject(a, key, i);
+        sprintf(key, "KEY%d", 99 - i);
+        cJSON_AddNumberToObject(b, key, 99 - i);
+    }
+    cJSON_AddNumberToObject(a, "dup", 1);
+    cJSON_AddNumberToObject(a, "dup", 2);
+    cJSON_AddNumberToObject(b, "dup", 1);
+    cJSON_AddNumberToObject(b, "dup", 2);
+
+    TEST_ASSERT_TRUE(cJSON_Compare(a, b, false));
+    TEST_ASSERT_FALSE(cJSON_Compare(a, b, true));
+    /* comparing doesn't leave an index behind */
+    TEST_ASSERT_NULL(index_of(a));
+    TEST_ASSERT_NULL(index_of(b));
+
+    cJSON_SetNumberValue(cJSON_GetObjectItem(b, "key50"), 0);
+    TEST_ASSERT_FALSE(cJSON_Compare(a, b, false));
+    cJSON_SetNumberValue(cJSON_GetObjectItem(b, "key50"), 50);
+    TEST_ASSERT_TRUE(cJSON_Compare(a, b, false));
+
+    cJSON_DeleteItemFromObject(b, "dup");
+    cJSON_AddNumberToObject(b, "dup", 1);
+    TEST_ASSERT_FALSE(cJSON_Compare(a, b, false));
+
+    cJSON_Delete(a);
+    cJSON_Delete(b);
+}
+
+static unsigned long hash_from_string(const char * const json, const cJSON_bool case_sensitive)
+{
+    cJSON *item = cJSON_Parse(json);
+    unsigned long hash = 0;
+
+    TEST_ASSERT_NOT_NULL_MESSAGE(item, "Failed to parse json.");
+    hash = cJSON_Hash(item, case_sensitive);
+    cJSON_Delete(item);
+
+    return hash;
+}
+
+static void cjson_hash_should_hash_equal_items_equally(void)
+{
+    TEST_ASSERT_EQUAL_UINT(0, cJSON_Hash(NULL, true));
+
+    TEST_ASSERT_TRUE(hash_from_string("0", true) == hash_from_string("-0", true));
+    TEST_ASSERT_TRUE(hash_from_string("1", true) != hash_from_string("2", true));
+    TEST_ASSERT_TRUE(hash_from_string("\"a\"", true) != hash_from_string("\"A\"", false));
+    TEST_ASSERT_TRUE(hash_from_string("null", true) != hash_from_string("false", true));
+
+    TEST_ASSERT_TRUE(hash_from_string("{\"a\": 1, \"b\": [2, 3]}", true) == hash_from_string("{\"b\": [2, 3], \"a\": 1}", true));
+    TEST_ASSERT_TRUE(hash_from_string("{\"a\": 1, \"b\": [2, 3]}", true) != hash_from_string("{\"a\": 1, \"b\": [3, 2]}", true));
+    TEST_ASSERT_TRUE(hash_from_string("{\"a\": 1, \"b\": 2}", true) != hash_from_string("{\"a\": 2, \"b\": 1}", true));
+    TEST_ASSERT_TRUE(hash_from_string("{\"a\": 1}", true) != hash_from_string("{\"A\": 1}", true));
+    TEST_ASSERT_TRUE(hash_from_string("{\"a\": 1}", false) == hash_from_string("{\"A\": 1}", false));
+    TEST_ASSERT_TRUE(hash_from_string("[[]]", true) != hash_from_string("[{}]", true));
+    TEST_ASSERT_TRUE(hash_from_string("[1, [2]]", true) != hash_from_string("[[1], 2]", true));
+}
+
+static void cjson_hash_and_compare_should_follow_changes(void)
+{
+    cJSON *root = cJSON_Parse("{\"a\": {\"b\": [1, 2, {\"c\": 3}]}, \"d\": [4]}");
+    cJSON *copy = cJSON_Duplicate(root, true);
+    cJSON *deep = NULL;
+    unsigned long hash = 0;
+    TEST_ASSERT_NOT_NULL(root);
+    TEST_ASSERT_NOT_NULL(copy);
+    deep = cJSON_GetArrayItem(cJSON_GetObjectItem(cJSON_GetObjectItem(root, "a"), "b"), 2);
+
+    hash = cJSON_Hash(root, true);
+    TEST_ASSERT_TRUE(cJSON_Hash(root, true) == hash);
+    TEST_ASSERT_TRUE(cJSON_Hash(copy, true) == hash);
+    TEST_ASSERT_TRUE(cJSON_Compare(root, copy, true));
+
+    cJSON_SetNumberValue(cJSON_GetObjectItem(deep, "c"), 4);
+    TEST_ASSERT_TRUE(cJSON_Hash(root, true) != hash);
+    TEST_ASSERT_FALSE(cJSON_Compare(root, copy, true));
+    cJSON_SetNumberValue(cJSON_GetObjectItem(deep, "c"), 3);
+    TEST_ASSERT_TRUE(cJSON_Hash(root, true) == hash);
+
+    cJSON_AddNullToObject(deep, "e");
+    TEST_ASSERT_TRUE(cJSON_Hash(root, true) != hash);
+    TEST_ASSERT_FALSE(cJSON_Compare(root, copy, true));
+    cJSON_DeleteItemFromObject(deep, "e");
+    TEST_ASSERT_TRUE(cJSON_Hash(root, true) == hash);
+
+    cJSON_InsertItemInArray(cJSON_GetObjectItem(root, "d"), 0, cJSON_CreateNull());
+    TEST_ASSERT_TRUE(cJSON_Hash(root, true) != hash);
+    cJSON_ReplaceItemInArray(cJSON_GetObjectItem(root, "d"), 0, cJSON_CreateNumber(4));
+    cJSON_DeleteItemFromArray(cJSON_GetObjectItem(root, "d"), 1);
+    TEST_ASSERT_TRUE(cJSON_Hash(root, true) == hash);
+    TEST_ASSERT_TRUE(cJSON_Compare(root, copy, true));
+
+    /* nothing is remembered between calls, so writing to the struct directly is fine as well */
+    deep = cJSON_GetArrayItem(cJSON_GetObjectItem(root, "d"), 0);
+    item_number(deep) = 5;
+    TEST_ASSERT_TRUE(cJSON_Hash(root, true) != hash);
+    TEST_ASSERT_FALSE(cJSON_Compare(root, copy, true));
+    item_number(deep) = 4;
+    TEST_ASSERT_TRUE(cJSON_Compare(root, copy, true));
+
+    cJSON_Delete(copy);
+    copy = cJSON_Duplicate(root, false);
+    TEST_ASSERT_NOT_NULL(copy);
+    TEST_ASSERT_TRUE(cJSON_Hash(copy, true) == hash_from_string("{}", true));
+
+    cJSON_Delete(copy);
+    cJSON_Delete(root);
+}
+
+static unsigned long random_state = 1;
+
+static unsigned long next_random(unsigned long limit)
+{
+    random_state = (random_state * 1103515245UL + 12345UL) & 0x7FFFFFFFUL;
+    return (random_state >> 8) % limit;
+}
+
+static cJSON *generate_tree(int depth)
+{
+    static const char * const keys[] = { "a", "A", "b", "c" };
+    cJSON *item = NULL;
+    unsigned long count = 0;
+
+    switch (next_random((depth > 0) ? 7 : 5))
+    {
+        case 0:
+            return cJSON_CreateNumber((double)next_random(3));
+        case 1:
+            return cJSON_CreateString(next_random(2) ? "x" : "X");
+        case 2:
+            return cJSON_CreateBool(next_random(2) != 0);
+        case 3:
+            return cJSON_CreateNull();
+        case 4:
+            return cJSON_CreateNumber(next_random(2) ? -0.0 : 0.0);
+        case 5:
+            item = cJSON_CreateArray();
+            for (count = next_random(4); count > 0; count--)
+            {
+                cJSON_AddItemToArray(item, generate_tree(depth - 1));
+            }
+            return item;
+        default:
+            item = cJSON_CreateObject();
+            /* some objects are big enough to be compared with a hash table */
+            for (count = next_random(2) ? next_random(4) : next_random(12); count > 0; count--)
+            {
+                cJSON_AddItemToObject(item, keys[next_random(4)], generate_tree(depth - 1));
+            }
+            return item;
+    }
+}
+
+/* members with the same key are matched in order */
+static cJSON_bool reference_compare(const cJSON * const a, const cJSON * const b, const cJSON_bool case_sensitive)
+{
+    const cJSON *a_child = NULL;
+    const cJSON *b_child = NULL;
+
+    if ((a->type & 0xFF) != (b->type & 0xFF))
+    {
+        return false;
+    }
+    if (cJSON_IsNumber(a))
+    {
+        return cJSON_GetNumberValue(a) == cJSON_GetNumberValue(b);
+    }
+    if (cJSON_IsString(a))
+    {
+        return strcmp(cJSON_GetStringValue(a), cJSON_GetStringValue(b)) == 0;
+    }
+    if (cJSON_IsArray(a))
+    {
+        for ((void)(a_child = a->child), b_child = b->child; (a_child != NULL) && (b_child != NULL); (void)(a_child = a_child->next), b_child = b_child->next)
+        {
+            if (!reference_compare(a_child, b_child, case_sensitive))
+            {
+                return false;
+            }
+        }
+        return a_child == b_child;
+    }
+    if (cJSON_IsObject(a))
+    {
+        if (cJSON_GetArraySize(a) != cJSON_GetArraySize(b))
+        {
+            return false;
+        }
+        for (a_child = a->child; a_child != NULL; a_child = a_child->next)
+        {
+            const cJSON *earlier = NULL;
+            int occurrence = 0;
+            for (earlier = a->child; earlier != a_child; earlier = earlier->next)
+            {
+                occurrence += (case_sensitive ? strcmp(earlier->string, a_child->string) : case_insensitive_strcmp((const unsigned char*)earlier->string, (const unsigned char*)a_child->string)) == 0;
+            }
+            for (b_child = b->child; b_child != NULL; b_child = b_child->next)
+            {
+                if ((case_sensitive ? strcmp(b_child->string, a_child->string) : case_insensitive_strcmp((const unsigned char*)b_child->string, (const unsigned char*)a_child->string)) == 0)
+                {
+                    if (occurrence == 0)
+                    {
+                        break;
+                    }
+                    occurrence--;
+                }
+            }
+            if ((b_child == NULL) || !reference_compare(a_child, b_child, case_sensitive))
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+/* a random container somewhere in the tree */
+static cJSON *random_container(cJSON * const root)
+{
+    cJSON *container = root;
+    cJSON *child = NULL;
+
+    while (next_random(3) != 0)
+    {
+        int size = cJSON_GetArraySize(container);
+        if (size == 0)
+        {
+            break;
+        }
+        child = cJSON_GetArrayItem(container, (int)next_random((unsigned long)size));
+        if (!cJSON_IsArray(child) && !cJSON_IsObject(child))
+        {
+            break;
+        }
+        container = child;
+    }
+
+    return container;
+}
+
+static void cjson_compare_and_hash_should_agree_on_random_trees(void)
+{
+    int round = 0;
+
+    for (round = 0; round < 3000; round++)
+    {
+        cJSON *a = cJSON_CreateArray();
+        cJSON *b = cJSON_CreateArray();
+        cJSON_bool case_sensitive = (round % 2) == 0;
+        cJSON_bool equal = false;
+
+        cJSON_AddItemToArray(a, generate_tree(3));
+        cJSON_AddItemToArray(b, generate_tree(3));
+
+        equal = reference_compare(a, b, case_sensitive);
+        TEST_ASSERT_EQUAL_INT(equal, cJSON_Compare(a, b, case_sensitive));
+        if (equal)
+        {
+            TEST_ASSERT_TRUE(cJSON_Hash(a, case_sensitive) == cJSON_Hash(b, case_sensitive));
+        }
+
+        /* change a, its hash has to follow */
+        {
+            cJSON *container = random_container(a);
+            cJSON *fresh = NULL;
+            char *printed = NULL;
+            int size = cJSON_GetArraySize(container);
+
+            switch (next_random(4))
+            {
+                case 0:
+                    if (cJSON_IsObject(container))
+                    {
+                        cJSON_AddItemToObject(container, "b", generate_tree(1));
+                    }
+                    else
+                    {
+                        cJSON_InsertItemInArray(container, (int)next_random((unsigned long)size + 1), generate_tree(1));
+                    }
+                    break;
+                case 1:
+                    cJSON_DeleteItemFromArray(container, (int)next_random((unsigned long)size + 1));
+                    break;
+                case 2:
+                    if (size > 0)
+                    {
+                        cJSON *replaced = cJSON_GetArrayItem(container, (int)next_random((unsigned long)size));
+                        cJSON *replacement = generate_tree(1);
+                        if (cJSON_IsObject(container))
+                        {
+                            replacement->string = (char*)cJSON_strdup((const unsigned char*)replaced->string, &global_hooks);
+                        }
+                        cJSON_ReplaceItemViaPointer(container, replaced, replacement);
+                    }
+                    break;
+                default:
+                    if ((size > 0) && cJSON_IsNumber(cJSON_GetArrayItem(container, 0)))
+                    {
+                        cJSON_SetNumberValue(cJSON_GetArrayItem(container, 0), 7);
+                    }
+                    break;
+            }
+
+            printed = cJSON_PrintUnformatted(a);
+            TEST_ASSERT_NOT_NULL(printed);
+            fresh = cJSON_Parse(printed);
+            TEST_ASSERT_NOT_NULL(fresh);
+            TEST_ASSERT_TRUE(cJSON_Hash(a, case_sensitive) == cJSON_Hash(fresh, case_sensitive));
+            TEST_ASSERT_TRUE(cJSON_Compare(a, fresh, case_sensitive));
+            TEST_ASSERT_EQUAL_INT(reference_compare(a, b, case_sensitive), cJSON_Compare(a, b, case_sensitive));
+
+            cJSON_free(printed);
+            cJSON_Delete(fresh);
+        }
+
+        cJSON_Delete(a);
+        cJSON_Delete(b);
+    }
+}
+
+static size_t count_containers(const cJSON * const item)
+{
+    size_t count = 0;
+    const cJSON *child = NULL;
+
+    if (!cJSON_IsArray(item) && !cJSON_IsObject(item))
+    {
+        return 0;
+    }
+    for (child = item->child; child != NULL; child = child->next)
+    {
+        count += count_containers(child);
+    }
+
+    return count + 1;
+}
+
+static void cjson_hash_with_memo_should_hash_every_container_once(void)
+{
+    int round = 0;
+
+    TEST_ASSERT_EQUAL_UINT(0, cJSON_HashWithMemo(NULL, NULL));
+
+    for (round = 0; round < 300; round++)
+    {
+        cJSON_bool case_sensitive = (round % 2) == 0;
+        cJSON *tree = generate_tree(4);
+        cJSON_HashMemo *memo = cJSON_CreateHashMemo(case_sensitive);
+        cJSON *child = NULL;
+        TEST_ASSERT_NOT_NULL(memo);
+
+        /* the children first, so the tree reuses their hashes */
+        cJSON_ArrayForEach(child, tree)
+        {
+            TEST_ASSERT_TRUE(cJSON_HashWithMemo(memo, child) == cJSON_Hash(child, case_sensitive));
+        }
+        TEST_ASSERT_TRUE(cJSON_HashWithMemo(memo, tree) == cJSON_Hash(tree, case_sensitive));
+        TEST_ASSERT_TRUE(cJSON_HashWithMemo(memo, tree) == cJSON_Hash(tree, case_sensitive));
+        TEST_ASSERT_TRUE(cJSON_Hash(tree, case_sensitive) <= 0xFFFFFFFFUL);
+        TEST_ASSERT_EQUAL_UINT(count_containers(tree), memo->count);
+
+        cJSON_DeleteHashMemo(memo);
+        cJSON_Delete(tree);
+    }
+}
+
 int CJSON_CDECL main(void)
 {
     UNITY_BEGIN();
@@ -200,6 +588,12 @@ int CJSON_CDECL main(void)
     RUN_TEST(cjson_compare_should_compare_raw);
     RUN_TEST(cjson_compare_should_compare_arrays);
     RUN_TEST(cjson_compare_should_compare_objects);
+    RUN_TEST(cjson_compare_should_match_members_with_the_same_key_in_order);
+    RUN_TEST(cjson_compare_should_compare_wide_objects);
+    RUN_TEST(cjson_hash_should_hash_equal_items_equally);
+    RUN_TEST(cjson_hash_and_compare_should_follow_changes);
+    RUN_TEST(cjson_compare_and_hash_should_agree_on_random_trees);
+    RUN_TEST(cjson_hash_with_memo_should_hash_every_container_once);
 
     return UNITY_END();
 }
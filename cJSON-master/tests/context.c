@@ -0,0 +1,238 @@
+/*
+  Copyright (c) 2009-2017 Dave Gamble and cJSON contributors
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "unity/examples/unity_config.h"
+#include "unity/src/unity.h"
+#include "common.h"
+
+typedef struct allocation_counter
+{
+    size_t allocations;
+    size_t reallocations;
+    size_t outstanding;
+} allocation_counter;
+
+static void * CJSON_CDECL context_malloc(size_t size, void *user_data)
+{
+    allocation_counter *counter = (allocation_counter*)user_data;
+    void *pointer = malloc(size);
+    if (pointer != NULL)
+    {
+        counter->allocations++;
+        counter->outstanding++;
+    }
+
+    return pointer;
+}
+
+static void CJSON_CDECL context_free(void *pointer, void *user_data)
+{
+    allocation_counter *counter = (allocation_counter*)user_data;
+    if (pointer != NULL)
+    {
+        counter->outstanding--;
+    }
+    free(pointer);
+}
+
+static void * CJSON_CDECL context_realloc(void *pointer, size_t size, void *user_data)
+{
+    allocation_counter *counter = (allocation_counter*)user_data;
+    void *new_pointer = realloc(pointer, size);
+    if (new_pointer != NULL)
+    {
+        counter->reallocations++;
+        if (pointer == NULL)
+        {
+            counter->outstanding++;
+        }
+    }
+
+    return new_pointer;
+}
+
+static void * CJSON_CDECL failing_malloc(size_t size)
+{
+    (void)size;
+    return NULL;
+}
+
+static void CJSON_CDECL failing_free(void *pointer)
+{
+    (void)pointer;
+    TEST_FAIL_MESSAGE("The global hooks have been used.");
+}
+
+static const char json[] = "{\"name\":\"a name that is longer than a few bytes\",\"numbers\":[1,2,3.5],\"nested\":{\"flag\":true,\"nothing\":null}}";
+
+static void context_should_be_used_instead_of_global_hooks(void)
+{
+    allocation_counter counter = { 0, 0, 0 };
+    cJSON_Context context = { context_malloc, context_free, context_realloc, NULL };
+    cJSON_Hooks failing_hooks = { failing_malloc, failing_free };
+    cJSON *tree = NULL;
+    char *printed = NULL;
+
+    context.user_data = &counter;
+    cJSON_InitHooks(&failing_hooks);
+
+    tree = cJSON_ParseWithContext(json, NULL, true, &context);
+    TEST_ASSERT_NOT_NULL(tree);
+    TEST_ASSERT_TRUE(counter.allocations > 0);
+
+    printed = cJSON_PrintWithContext(tree, false, &context);
+    TEST_ASSERT_NOT_NULL(printed);
+    TEST_ASSERT_EQUAL_STRING(json, printed);
+    TEST_ASSERT_TRUE(counter.reallocations > 0);
+
+    context.free_fn(printed, context.user_data);
+    cJSON_DeleteWithContext(tree, &context);
+
+    cJSON_InitHooks(NULL);
+
+    TEST_ASSERT_EQUAL_UINT(0U, (unsigned int)counter.outstanding);
+}
+
+static void context_without_realloc_should_print(void)
+{
+    allocation_counter counter = { 0, 0, 0 };
+    cJSON_Context context = { context_malloc, context_free, NULL, NULL };
+    cJSON *tree = NULL;
+    char *printed = NULL;
+
+    context.user_data = &counter;
+
+    tree = cJSON_ParseWithContext(json, NULL, true, &context);
+    TEST_ASSERT_NOT_NULL(tree);
+    printed = cJSON_PrintWithContext(tree, true, &context);
+    TEST_ASSERT_NOT_NULL(printed);
+    TEST_ASSERT_EQUAL_UINT(0U, (unsigned int)counter.reallocations);
+
+    context.free_fn(printed, context.user_data);
+    cJSON_DeleteWithContext(tree, &context);
+
+    TEST_ASSERT_EQUAL_UINT(0U, (unsigned int)counter.outstanding);
+}
+
+static void context_should_create_and_duplicate(void)
+{
+    allocation_counter counter = { 0, 0, 0 };
+    cJSON_Context context = { context_malloc, context_free, context_realloc, NULL };
+    cJSON *object = NULL;
+    cJSON *array = NULL;
+    cJSON *copy = NULL;
+    char *printed = NULL;
+
+    context.user_data = &counter;
+
+    object = cJSON_CreateObjectWithContext(&context);
+    array = cJSON_CreateArrayWithContext(&context);
+    TEST_ASSERT_NOT_NULL(object);
+    TEST_ASSERT_NOT_NULL(array);
+    cJSON_AddItemToArray(array, cJSON_CreateNumberWithContext(42, &context));
+    cJSON_AddItemToArray(array, cJSON_CreateBoolWithContext(true, &context));
+    cJSON_AddItemToArray(array, cJSON_CreateNullWithContext(&context));
+    TEST_ASSERT_TRUE(cJSON_AddItemToObjectWithContext(object, "array", array, &context));
+    TEST_ASSERT_TRUE(cJSON_AddItemToObjectWithContext(object, "string", cJSON_CreateStringWithContext("a string with some length", &context), &context));
+    TEST_ASSERT_TRUE(cJSON_AddItemToObjectWithContext(object, "raw", cJSON_CreateRawWithContext("[\"raw\"]", &context), &context));
+
+    copy = cJSON_DuplicateWithContext(object, true, &context);
+    TEST_ASSERT_NOT_NULL(copy);
+    TEST_ASSERT_TRUE(cJSON_Compare(object, copy, true));
+
+    printed = cJSON_PrintWithContext(copy, false, &context);
+    TEST_ASSERT_EQUAL_STRING("{\"array\":[42,true,null],\"string\":\"a string with some length\",\"raw\":[\"raw\"]}", printed);
+
+    context.free_fn(printed, context.user_data);
+    cJSON_DeleteWithContext(object, &context);
+    cJSON_DeleteWithContext(copy, &context);
+
+    TEST_ASSERT_EQUAL_UINT(0U, (unsigned int)counter.outstanding);
+}
+
+static void context_should_duplicate_packed_arrays(void)
+{
+    allocation_counter counter = { 0, 0, 0 };
+    cJSON_Context context = { context_malloc, context_free, context_realloc, NULL };
+    cJSON *packed = cJSON_ParsePacked("[1,2.5,-3]", NULL, true);
+    cJSON *copy = NULL;
+
+    context.user_data = &counter;
+    TEST_ASSERT_NOT_NULL(packed);
+    TEST_ASSERT_TRUE(packed->type & cJSON_IsPacked);
+
+    /* the copy can't stay packed, unpacking it would use the global hooks */
+    copy = cJSON_DuplicateWithContext(packed, true, &context);
+    TEST_ASSERT_NOT_NULL(copy);
+    TEST_ASSERT_FALSE(copy->type & (cJSON_IsPacked | cJSON_IsLazy));
+    TEST_ASSERT_EQUAL_UINT(4U, (unsigned int)counter.outstanding);
+    TEST_ASSERT_EQUAL_DOUBLE(-3.0, cJSON_GetNumberValue(cJSON_GetArrayItem(copy, 2)));
+    TEST_ASSERT_TRUE(cJSON_Compare(packed, copy, true));
+
+    cJSON_DeleteWithContext(copy, &context);
+    cJSON_Delete(packed);
+
+    TEST_ASSERT_EQUAL_UINT(0U, (unsigned int)counter.outstanding);
+}
+
+static void context_should_free_everything_on_parse_failure(void)
+{
+    allocation_counter counter = { 0, 0, 0 };
+    cJSON_Context context = { context_malloc, context_free, context_realloc, NULL };
+
+    context.user_data = &counter;
+
+    TEST_ASSERT_NULL(cJSON_ParseWithContext("{\"key\":[\"a long enough string\",{\"inner\":\"value\"", NULL, true, &context));
+    TEST_ASSERT_TRUE(counter.allocations > 0);
+    TEST_ASSERT_EQUAL_UINT(0U, (unsigned int)counter.outstanding);
+}
+
+static void null_context_should_use_global_hooks(void)
+{
+    cJSON *tree = cJSON_ParseWithContext(json, NULL, true, NULL);
+    char *printed = NULL;
+
+    TEST_ASSERT_NOT_NULL(tree);
+    printed = cJSON_PrintWithContext(tree, false, NULL);
+    TEST_ASSERT_EQUAL_STRING(json, printed);
+
+    cJSON_free(printed);
+    cJSON_Delete(tree);
+}
+
+int CJSON_CDECL main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(context_should_be_used_instead_of_global_hooks);
+    RUN_TEST(context_without_realloc_should_print);
+    RUN_TEST(context_should_create_and_duplicate);
+    RUN_TEST(context_should_duplicate_packed_arrays);
+    RUN_TEST(context_should_free_everything_on_parse_failure);
+    RUN_TEST(null_context_should_use_global_hooks);
+
+    return UNITY_END();
+}
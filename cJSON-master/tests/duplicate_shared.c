@@ -0,0 +1,490 @@
+/*
+  Copyright (c) 2009-2017 Dave Gamble and cJSON contributors
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "unity/examples/unity_config.h"
+#include "unity/src/unity.h"
+#include "common.h"
+
+static const char config[] = "{\"service\":{\"name\":\"api\",\"ports\":[80,443],\"limits\":{\"rate\":100,\"burst\":20}},"
+    "\"routes\":[{\"path\":\"/\",\"target\":\"web\"},{\"path\":\"/admin\",\"target\":\"admin\",\"roles\":[\"ops\"]}],\"debug\":false}";
+
+static size_t outstanding = 0;
+
+static void * CJSON_CDECL context_malloc(size_t size, void *user_data)
+{
+    (void)user_data;
+    outstanding++;
+    return malloc(size);
+}
+
+static void CJSON_CDECL context_free(void *pointer, void *user_data)
+{
+    (void)user_data;
+    if (pointer != NULL)
+    {
+        outstanding--;
+    }
+    free(pointer);
+}
+
+static void assert_prints(const cJSON * const item, const char * const expected)
+{
+    char *printed = cJSON_PrintUnformatted(item);
+    TEST_ASSERT_NOT_NULL(printed);
+    TEST_ASSERT_EQUAL_STRING(expected, printed);
+    cJSON_free(printed);
+}
+
+static void duplicate_shared_should_copy_the_children_once(void)
+{
+    cJSON *tree = NULL;
+    cJSON *first = NULL;
+    cJSON *second = NULL;
+    cJSON *third = NULL;
+    size_t deep = 0;
+
+    use_counting_hooks();
+    tree = cJSON_Parse(config);
+    TEST_ASSERT_NOT_NULL(tree);
+
+    allocations = 0;
+    first = cJSON_Duplicate(tree, true);
+    TEST_ASSERT_NOT_NULL(first);
+    deep = allocations;
+    cJSON_Delete(first);
+
+    /* the first copy copies the tree and puts the children of the 8 arrays and objects into blocks */
+    allocations = 0;
+    first = cJSON_DuplicateShared(tree);
+    TEST_ASSERT_NOT_NULL(first);
+    TEST_ASSERT_EQUAL_UINT((unsigned int)deep + 8U, (unsigned int)allocations);
+    TEST_ASSERT_TRUE(first->type & cJSON_IsShared);
+    TEST_ASSERT_FALSE(first->type & cJSON_IsReadOnly);
+    TEST_ASSERT_TRUE(first->child->type & cJSON_IsReadOnly);
+
+    /* the original isn't touched */
+    TEST_ASSERT_FALSE(tree->type & (cJSON_IsShared | cJSON_IsReadOnly));
+    TEST_ASSERT_NOT_NULL(tree->child);
+    TEST_ASSERT_TRUE(tree->child != first->child);
+    TEST_ASSERT_FALSE(tree->child->type & (cJSON_IsShared | cJSON_IsReadOnly));
+
+    /* copies of copies are a single item */
+    allocations = 0;
+    second = cJSON_DuplicateShared(first);
+    TEST_ASSERT_NOT_NULL(second);
+    TEST_ASSERT_EQUAL_UINT(1U, (unsigned int)allocations);
+    TEST_ASSERT_TRUE(second->child == first->child);
+
+    /* so are copies of their children, apart from the key */
+    allocations = 0;
+    third = cJSON_DuplicateShared(cJSON_GetObjectItem(first, "service"));
+    TEST_ASSERT_NOT_NULL(third);
+    TEST_ASSERT_EQUAL_UINT(2U, (unsigned int)allocations);
+    TEST_ASSERT_FALSE(third->type & cJSON_IsReadOnly);
+
+    assert_prints(first, config);
+    assert_prints(second, config);
+    assert_prints(tree, config);
+    assert_prints(third, "{\"name\":\"api\",\"ports\":[80,443],\"limits\":{\"rate\":100,\"burst\":20}}");
+
+    cJSON_Delete(first);
+    cJSON_Delete(tree);
+    cJSON_Delete(third);
+    cJSON_Delete(second);
+    cJSON_InitHooks(NULL);
+}
+
+static void duplicate_shared_should_copy_only_the_changed_path(void)
+{
+    cJSON *tree = NULL;
+    cJSON *copy = NULL;
+    cJSON *other = NULL;
+    cJSON *service = NULL;
+    cJSON *limits = NULL;
+    cJSON *rate = NULL;
+    size_t deep = 0;
+
+    use_counting_hooks();
+    tree = cJSON_Parse(config);
+    TEST_ASSERT_NOT_NULL(tree);
+    allocations = 0;
+    copy = cJSON_Duplicate(tree, true);
+    deep = allocations;
+    cJSON_Delete(copy);
+    copy = cJSON_DuplicateShared(tree);
+    TEST_ASSERT_NOT_NULL(copy);
+    other = cJSON_DuplicateShared(copy);
+    TEST_ASSERT_NOT_NULL(other);
+
+    /* items in a block can't be changed */
+    service = cJSON_GetObjectItem(copy, "service");
+    TEST_ASSERT_TRUE(service->type & cJSON_IsReadOnly);
+    TEST_ASSERT_FALSE(cJSON_Unshare(service));
+    TEST_ASSERT_NULL(cJSON_AddNumberToObject(service, "timeout", 30));
+    TEST_ASSERT_NULL(cJSON_DetachItemFromObject(service, "name"));
+    rate = cJSON_GetObjectItem(cJSON_GetObjectItem(service, "limits"), "rate");
+    cJSON_SetNumberValue(rate, 0);
+    TEST_ASSERT_EQUAL_INT(100, cJSON_SetIntValue(rate, 42));
+    TEST_ASSERT_EQUAL_DOUBLE(100, cJSON_GetNumberValue(rate));
+    TEST_ASSERT_EQUAL_INT(100, rate->valueint);
+    assert_prints(other, config);
+
+    /* until every level above them has been unshared */
+    allocations = 0;
+    TEST_ASSERT_TRUE(cJSON_Unshare(copy));
+    service = cJSON_GetObjectItem(copy, "service");
+    TEST_ASSERT_FALSE(service->type & cJSON_IsReadOnly);
+    TEST_ASSERT_TRUE(cJSON_Unshare(service));
+    limits = cJSON_GetObjectItem(service, "limits");
+    cJSON_ReplaceItemInObject(limits, "rate", cJSON_CreateNumber(50));
+    TEST_ASSERT_TRUE(allocations < deep);
+
+    /* the siblings on the path still share their children */
+    TEST_ASSERT_TRUE(cJSON_GetObjectItem(copy, "routes")->type & cJSON_IsShared);
+    TEST_ASSERT_TRUE(cJSON_GetObjectItem(service, "ports")->type & cJSON_IsShared);
+    TEST_ASSERT_FALSE(service->type & cJSON_IsShared);
+    TEST_ASSERT_FALSE(limits->type & cJSON_IsShared);
+    TEST_ASSERT_TRUE(other->type & cJSON_IsShared);
+
+    assert_prints(tree, config);
+    assert_prints(other, config);
+    TEST_ASSERT_EQUAL_DOUBLE(50, cJSON_GetNumberValue(cJSON_GetObjectItem(cJSON_GetObjectItem(cJSON_GetObjectItem(copy, "service"), "limits"), "rate")));
+
+    cJSON_Delete(tree);
+    cJSON_Delete(copy);
+    cJSON_Delete(other);
+    cJSON_InitHooks(NULL);
+}
+
+static void duplicate_shared_should_unshare_the_path_to_an_item(void)
+{
+    cJSON *tree = cJSON_Parse(config);
+    cJSON *snapshot = NULL;
+    cJSON *other = NULL;
+    cJSON *limits = NULL;
+    cJSON *writable = NULL;
+    cJSON *item = NULL;
+    TEST_ASSERT_NOT_NULL(tree);
+    snapshot = cJSON_DuplicateShared(tree);
+    TEST_ASSERT_NOT_NULL(snapshot);
+    other = cJSON_DuplicateShared(snapshot);
+    TEST_ASSERT_NOT_NULL(other);
+
+    /* changing the children of a read only item fails, the new item still belongs to the caller */
+    limits = cJSON_GetObjectItem(cJSON_GetObjectItem(snapshot, "service"), "limits");
+    TEST_ASSERT_NOT_NULL(limits);
+    item = cJSON_CreateNumber(50);
+    TEST_ASSERT_FALSE(cJSON_ReplaceItemInObject(limits, "rate", item));
+    TEST_ASSERT_FALSE(cJSON_AddItemToObject(limits, "timeout", item));
+    TEST_ASSERT_FALSE(cJSON_AddItemToArray(cJSON_GetObjectItem(snapshot, "routes"), item));
+    TEST_ASSERT_FALSE(cJSON_InsertItemInArray(cJSON_GetObjectItem(snapshot, "routes"), 0, item));
+    TEST_ASSERT_FALSE(cJSON_ReplaceItemInArray(cJSON_GetObjectItem(snapshot, "routes"), 0, item));
+    TEST_ASSERT_FALSE(cJSON_AddItemReferenceToArray(cJSON_GetObjectItem(snapshot, "routes"), item));
+    TEST_ASSERT_NULL(item->next);
+    assert_prints(snapshot, config);
+
+    /* unsharing the path from the root gives the item that can be changed */
+    writable = cJSON_UnshareItem(snapshot, limits);
+    TEST_ASSERT_NOT_NULL(writable);
+    TEST_ASSERT_FALSE(writable->type & (cJSON_IsShared | cJSON_IsReadOnly));
+    TEST_ASSERT_TRUE(writable == cJSON_GetObjectItem(cJSON_GetObjectItem(snapshot, "service"), "limits"));
+    TEST_ASSERT_TRUE(cJSON_ReplaceItemInObject(writable, "rate", item));
+    TEST_ASSERT_EQUAL_DOUBLE(50, cJSON_GetNumberValue(cJSON_GetObjectItem(writable, "rate")));
+    TEST_ASSERT_TRUE(cJSON_GetObjectItem(snapshot, "routes")->type & cJSON_IsShared);
+    assert_prints(other, config);
+    assert_prints(tree, config);
+
+    /* items deeper in arrays */
+    writable = cJSON_UnshareItem(snapshot, cJSON_GetObjectItem(cJSON_GetArrayItem(cJSON_GetObjectItem(snapshot, "routes"), 1), "roles"));
+    TEST_ASSERT_NOT_NULL(writable);
+    TEST_ASSERT_TRUE(cJSON_AddItemToArray(writable, cJSON_CreateString("dev")));
+    assert_prints(cJSON_GetObjectItem(snapshot, "routes"), "[{\"path\":\"/\",\"target\":\"web\"},{\"path\":\"/admin\",\"target\":\"admin\",\"roles\":[\"ops\",\"dev\"]}]");
+    assert_prints(other, config);
+
+    TEST_ASSERT_TRUE(cJSON_UnshareItem(snapshot, snapshot) == snapshot);
+    TEST_ASSERT_NULL(cJSON_UnshareItem(snapshot, cJSON_GetObjectItem(other, "service")));
+    TEST_ASSERT_NULL(cJSON_UnshareItem(cJSON_GetObjectItem(other, "service"), cJSON_GetObjectItem(cJSON_GetObjectItem(other, "service"), "name")));
+    TEST_ASSERT_NULL(cJSON_UnshareItem(NULL, snapshot));
+
+    cJSON_Delete(other);
+    cJSON_Delete(snapshot);
+    cJSON_Delete(tree);
+}
+
+static void duplicate_shared_should_keep_the_original(void)
+{
+    cJSON *tree = cJSON_Parse(config);
+    cJSON *copy = NULL;
+    cJSON *routes = NULL;
+    cJSON *ports = NULL;
+    TEST_ASSERT_NOT_NULL(tree);
+    routes = cJSON_GetObjectItem(tree, "routes");
+    ports = cJSON_GetObjectItem(cJSON_GetObjectItem(tree, "service"), "ports");
+    copy = cJSON_DuplicateShared(tree);
+    TEST_ASSERT_NOT_NULL(copy);
+
+    /* change the original through items found before the copy was made, the copy stays as it was */
+    cJSON_Delete(cJSON_DetachItemFromArray(routes, 0));
+    TEST_ASSERT_NOT_NULL(cJSON_AddStringToObject(cJSON_GetArrayItem(routes, 0), "target", "other"));
+    cJSON_DeleteItemFromObject(tree, "debug");
+    cJSON_AddItemToArray(ports, cJSON_CreateNumber(8080));
+    cJSON_SetNumberValue(cJSON_GetArrayItem(ports, 0), 8000);
+
+    assert_prints(copy, config);
+    assert_prints(tree, "{\"service\":{\"name\":\"api\",\"ports\":[8000,443,8080],\"limits\":{\"rate\":100,\"burst\":20}},"
+        "\"routes\":[{\"path\":\"/admin\",\"target\":\"admin\",\"roles\":[\"ops\"],\"target\":\"other\"}]}");
+    TEST_ASSERT_FALSE(cJSON_Compare(tree, copy, true));
+
+    /* and the other way round, the copy gets children of its own first */
+    cJSON_ReplaceItemInObject(copy, "debug", cJSON_CreateTrue());
+    TEST_ASSERT_FALSE(copy->type & cJSON_IsShared);
+    TEST_ASSERT_TRUE(cJSON_IsTrue(cJSON_GetObjectItem(copy, "debug")));
+    TEST_ASSERT_NULL(cJSON_GetObjectItem(tree, "debug"));
+
+    cJSON_Delete(copy);
+    cJSON_Delete(tree);
+}
+
+static void duplicate_shared_should_allow_deleting_in_any_order(void)
+{
+    cJSON *tree = cJSON_Parse(config);
+    cJSON *first = NULL;
+    cJSON *second = NULL;
+    cJSON *child = NULL;
+    int count = 0;
+    TEST_ASSERT_NOT_NULL(tree);
+
+    first = cJSON_DuplicateShared(tree);
+    TEST_ASSERT_NOT_NULL(first);
+    cJSON_Delete(tree);
+
+    /* copies of copies share the same children */
+    second = cJSON_DuplicateShared(first);
+    TEST_ASSERT_NOT_NULL(second);
+    TEST_ASSERT_TRUE(cJSON_Compare(first, second, true));
+    cJSON_Delete(first);
+
+    cJSON_ArrayForEach(child, second)
+    {
+        count++;
+    }
+    TEST_ASSERT_EQUAL_INT(3, count);
+
+    /* the last one takes the children over */
+    child = second->child;
+    TEST_ASSERT_TRUE(cJSON_Unshare(second));
+    TEST_ASSERT_FALSE(second->type & cJSON_IsShared);
+    TEST_ASSERT_TRUE(second->child == child);
+    TEST_ASSERT_FALSE(child->type & cJSON_IsReadOnly);
+    cJSON_Delete(cJSON_DetachItemFromObject(cJSON_GetObjectItem(second, "service"), "limits"));
+    TEST_ASSERT_NULL(cJSON_GetObjectItem(cJSON_GetObjectItem(second, "service"), "limits"));
+    cJSON_Delete(second);
+
+    /* an item that is shared as part of a bigger tree */
+    tree = cJSON_Parse(config);
+    TEST_ASSERT_NOT_NULL(tree);
+    second = cJSON_DuplicateShared(tree);
+    TEST_ASSERT_NOT_NULL(second);
+    first = cJSON_DuplicateShared(cJSON_GetObjectItem(second, "routes"));
+    TEST_ASSERT_NOT_NULL(first);
+    TEST_ASSERT_EQUAL_STRING("routes", first->string);
+    cJSON_Delete(tree);
+    cJSON_Delete(second);
+    assert_prints(cJSON_GetArrayItem(first, 1), "{\"path\":\"/admin\",\"target\":\"admin\",\"roles\":[\"ops\"]}");
+    cJSON_Delete(first);
+}
+
+static void duplicate_shared_should_read_without_writing(void)
+{
+    cJSON *tree = NULL;
+    cJSON *copy = NULL;
+    cJSON *deep = NULL;
+    cJSON *routes = NULL;
+    int types[3] = { 0, 0, 0 };
+    unsigned long hash = 0;
+    unsigned char *cbor = NULL;
+    size_t length = 0;
+
+    use_counting_hooks();
+    tree = cJSON_Parse(config);
+    TEST_ASSERT_NOT_NULL(tree);
+    hash = cJSON_Hash(tree, true);
+    copy = cJSON_DuplicateShared(tree);
+    TEST_ASSERT_NOT_NULL(copy);
+    routes = cJSON_GetObjectItem(copy, "routes");
+    types[0] = copy->type;
+    types[1] = routes->type;
+    types[2] = routes->child->type;
+
+    /* several threads can read the same copy, nothing is changed or allocated */
+    allocations = 0;
+    TEST_ASSERT_TRUE(cJSON_Compare(tree, copy, true));
+    TEST_ASSERT_EQUAL_INT(3, cJSON_GetArraySize(copy));
+    TEST_ASSERT_EQUAL_INT(2, cJSON_GetArraySize(routes));
+    TEST_ASSERT_NOT_NULL(cJSON_GetArrayItem(routes, 1));
+    TEST_ASSERT_EQUAL_UINT(hash, cJSON_Hash(copy, true));
+    TEST_ASSERT_EQUAL_UINT((unsigned int)strlen(config), (unsigned int)cJSON_PrintedLength(copy, false));
+    TEST_ASSERT_EQUAL_UINT(0U, (unsigned int)allocations);
+    assert_prints(copy, config);
+    cbor = cJSON_PrintCBOR(copy, &length);
+    TEST_ASSERT_NOT_NULL(cbor);
+    cJSON_free(cbor);
+    TEST_ASSERT_EQUAL_INT(types[0], copy->type);
+    TEST_ASSERT_EQUAL_INT(types[1], routes->type);
+    TEST_ASSERT_EQUAL_INT(types[2], routes->child->type);
+    TEST_ASSERT_TRUE(routes == cJSON_GetObjectItem(copy, "routes"));
+
+    /* a plain duplicate gets children of its own */
+    deep = cJSON_Duplicate(copy, true);
+    TEST_ASSERT_NOT_NULL(deep);
+    TEST_ASSERT_FALSE(deep->type & (cJSON_IsShared | cJSON_IsReadOnly));
+    TEST_ASSERT_FALSE(deep->child->type & (cJSON_IsShared | cJSON_IsReadOnly));
+    TEST_ASSERT_TRUE(cJSON_Compare(deep, tree, true));
+    TEST_ASSERT_EQUAL_INT(types[0], copy->type);
+
+    cJSON_Delete(deep);
+    cJSON_Delete(copy);
+    cJSON_Delete(tree);
+    cJSON_InitHooks(NULL);
+}
+
+static void duplicate_shared_should_use_the_global_hooks(void)
+{
+    cJSON_Context context = { context_malloc, context_free, NULL, NULL };
+    cJSON *tree = NULL;
+    cJSON *copy = NULL;
+    cJSON *other = NULL;
+    size_t used = 0;
+
+    outstanding = 0;
+    tree = cJSON_ParseWithContext(config, NULL, true, &context);
+    TEST_ASSERT_NOT_NULL(tree);
+    used = outstanding;
+
+    /* the copy doesn't take anything over from a tree with other hooks */
+    copy = cJSON_DuplicateShared(tree);
+    TEST_ASSERT_NOT_NULL(copy);
+    TEST_ASSERT_EQUAL_UINT((unsigned int)used, (unsigned int)outstanding);
+    cJSON_DeleteWithContext(tree, &context);
+    TEST_ASSERT_EQUAL_UINT(0U, (unsigned int)outstanding);
+    assert_prints(copy, config);
+
+    /* a duplicate with the context reads the blocks and allocates everything with the context */
+    other = cJSON_DuplicateWithContext(copy, true, &context);
+    TEST_ASSERT_NOT_NULL(other);
+    cJSON_Delete(copy);
+    assert_prints(other, config);
+    cJSON_DeleteWithContext(other, &context);
+    TEST_ASSERT_EQUAL_UINT(0U, (unsigned int)outstanding);
+}
+
+static void duplicate_shared_should_work_with_other_trees(void)
+{
+    const char numbers[] = "{\"samples\":[1,2,3.5],\"nested\":{\"more\":[4,5]}}";
+    cJSON *tree = NULL;
+    cJSON *copy = NULL;
+    cJSON *target = NULL;
+
+    /* lazy items are parsed first */
+    tree = cJSON_ParseLazy(config, NULL, true, 1);
+    TEST_ASSERT_NOT_NULL(tree);
+    copy = cJSON_DuplicateShared(tree);
+    TEST_ASSERT_NOT_NULL(copy);
+    assert_prints(copy, config);
+    cJSON_Delete(tree);
+    assert_prints(cJSON_GetObjectItem(copy, "service"), "{\"name\":\"api\",\"ports\":[80,443],\"limits\":{\"rate\":100,\"burst\":20}}");
+    cJSON_Delete(copy);
+
+    /* packed arrays are copied into blocks, the original stays packed */
+    tree = cJSON_ParsePacked(numbers, NULL, true);
+    TEST_ASSERT_NOT_NULL(tree);
+    copy = cJSON_DuplicateShared(tree);
+    TEST_ASSERT_NOT_NULL(copy);
+    TEST_ASSERT_TRUE(cJSON_GetObjectItem(tree, "samples")->type & cJSON_IsPacked);
+    TEST_ASSERT_EQUAL_UINT(cJSON_Hash(tree, true), cJSON_Hash(copy, true));
+    TEST_ASSERT_TRUE(cJSON_Unshare(copy));
+    cJSON_AddItemToArray(cJSON_GetObjectItem(copy, "samples"), cJSON_CreateNumber(6));
+    assert_prints(tree, numbers);
+    assert_prints(copy, "{\"samples\":[1,2,3.5,6],\"nested\":{\"more\":[4,5]}}");
+    cJSON_Delete(copy);
+    cJSON_Delete(tree);
+
+    /* references are copied, the copy doesn't change with their original */
+    target = cJSON_CreateArray();
+    TEST_ASSERT_NOT_NULL(target);
+    cJSON_AddItemToArray(target, cJSON_CreateTrue());
+    tree = cJSON_CreateObject();
+    TEST_ASSERT_NOT_NULL(tree);
+    cJSON_AddItemReferenceToObject(tree, "target", target);
+    copy = cJSON_DuplicateShared(tree);
+    TEST_ASSERT_NOT_NULL(copy);
+    TEST_ASSERT_FALSE(target->type & cJSON_IsShared);
+    cJSON_Delete(tree);
+    cJSON_AddItemToArray(target, cJSON_CreateNull());
+    assert_prints(copy, "{\"target\":[true]}");
+    cJSON_Delete(copy);
+    cJSON_Delete(target);
+
+    /* so are arena items */
+    tree = cJSON_ParseWithArena(config, NULL, true);
+    TEST_ASSERT_NOT_NULL(tree);
+    copy = cJSON_DuplicateShared(tree);
+    TEST_ASSERT_NOT_NULL(copy);
+    TEST_ASSERT_FALSE(copy->type & cJSON_IsArenaItem);
+    cJSON_ArenaDelete(tree);
+    assert_prints(copy, config);
+    cJSON_Delete(copy);
+
+    /* and items without children */
+    tree = cJSON_Parse(config);
+    TEST_ASSERT_NOT_NULL(tree);
+    copy = cJSON_DuplicateShared(cJSON_GetObjectItem(cJSON_GetObjectItem(tree, "service"), "name"));
+    TEST_ASSERT_NOT_NULL(copy);
+    TEST_ASSERT_EQUAL_STRING("api", cJSON_GetStringValue(copy));
+    TEST_ASSERT_FALSE(copy->type & (cJSON_IsShared | cJSON_IsReadOnly));
+    TEST_ASSERT_TRUE(cJSON_Unshare(copy));
+    cJSON_Delete(copy);
+    cJSON_Delete(tree);
+
+    TEST_ASSERT_NULL(cJSON_DuplicateShared(NULL));
+    TEST_ASSERT_FALSE(cJSON_Unshare(NULL));
+}
+
+int CJSON_CDECL main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(duplicate_shared_should_copy_the_children_once);
+    RUN_TEST(duplicate_shared_should_copy_only_the_changed_path);
+    RUN_TEST(duplicate_shared_should_unshare_the_path_to_an_item);
+    RUN_TEST(duplicate_shared_should_keep_the_original);
+    RUN_TEST(duplicate_shared_should_allow_deleting_in_any_order);
+    RUN_TEST(duplicate_shared_should_read_without_writing);
+    RUN_TEST(duplicate_shared_should_use_the_global_hooks);
+    RUN_TEST(duplicate_shared_should_work_with_other_trees);
+
+    return UNITY_END();
+}
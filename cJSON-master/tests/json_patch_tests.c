@@ -62,7 +62,7 @@ static cJSON_bool test_apply_patch(const cJSON * const test)
     comment = cJSON_GetObjectItemCaseSensitive(test, "comment");
     if (cJSON_IsString(comment))
     {
-        printf("Testing \"%s\"\n", comment->valuestring);
+        printf("Testing \"%s\"\n", item_valuestring(comment));
     }
     else
     {
@@ -0,0 +1,220 @@
+/*
+  Copyright (c) 2009-2017 Dave Gamble and cJSON contributors
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "unity/examples/unity_config.h"
+#include "unity/src/unity.h"
+#include "common.h"
+
+static void key_table_should_share_keys_between_documents(void)
+{
+    cJSON_KeyTable *keys = cJSON_CreateKeyTable();
+    cJSON *first = NULL;
+    cJSON *second = NULL;
+    cJSON *child = NULL;
+    TEST_ASSERT_NOT_NULL(keys);
+
+    first = cJSON_ParseWithKeyTable("{\"timestamp\":1,\"host\":\"a\",\"tags\":{\"level\":\"info\"}}", NULL, true, keys);
+    second = cJSON_ParseWithKeyTable("{\"host\":\"b\",\"timestamp\":2,\"tags\":{\"level\":\"warn\",\"extra\":[]}}", NULL, true, keys);
+    TEST_ASSERT_NOT_NULL(first);
+    TEST_ASSERT_NOT_NULL(second);
+    TEST_ASSERT_EQUAL_UINT(5U, (unsigned int)cJSON_GetKeyTableSize(keys));
+
+    TEST_ASSERT_TRUE(cJSON_GetObjectItem(first, "host")->string == cJSON_GetObjectItem(second, "host")->string);
+    TEST_ASSERT_TRUE(cJSON_GetObjectItem(first, "timestamp")->string == cJSON_GetObjectItem(second, "timestamp")->string);
+    TEST_ASSERT_TRUE(cJSON_GetObjectItem(cJSON_GetObjectItem(first, "tags"), "level")->string == cJSON_GetObjectItem(cJSON_GetObjectItem(second, "tags"), "level")->string);
+    TEST_ASSERT_EQUAL_STRING("warn", cJSON_GetStringValue(cJSON_GetObjectItem(cJSON_GetObjectItem(second, "tags"), "level")));
+
+    for (child = second->child; child != NULL; child = child->next)
+    {
+        TEST_ASSERT_TRUE(child->type & cJSON_StringIsConst);
+    }
+
+    /* the keys stay in the table when the documents are gone */
+    cJSON_Delete(first);
+    cJSON_Delete(second);
+    TEST_ASSERT_EQUAL_UINT(5U, (unsigned int)cJSON_GetKeyTableSize(keys));
+
+    cJSON_DeleteKeyTable(keys);
+}
+
+static void key_table_should_unescape_keys(void)
+{
+    cJSON_KeyTable *keys = cJSON_CreateKeyTable();
+    cJSON *tree = NULL;
+    TEST_ASSERT_NOT_NULL(keys);
+
+    tree = cJSON_ParseWithKeyTable("{\"ab\":1,\"a\\u0062\":2,\"line\\n\":3,\"\":4}", NULL, true, keys);
+    TEST_ASSERT_NOT_NULL(tree);
+    TEST_ASSERT_EQUAL_UINT(3U, (unsigned int)cJSON_GetKeyTableSize(keys));
+    TEST_ASSERT_TRUE(tree->child->string == tree->child->next->string);
+    TEST_ASSERT_EQUAL_STRING("line\n", tree->child->next->next->string);
+    TEST_ASSERT_EQUAL_STRING("", tree->child->next->next->next->string);
+    TEST_ASSERT_TRUE(cJSON_InternKey(keys, "line\n") == tree->child->next->next->string);
+
+    cJSON_Delete(tree);
+    cJSON_DeleteKeyTable(keys);
+}
+
+static void key_table_should_not_allocate_known_keys(void)
+{
+    const char json[] = "{\"timestamp\":1,\"host\":\"a\",\"level\":[2,3]}";
+    cJSON_KeyTable *keys = NULL;
+    cJSON *tree = NULL;
+    size_t plain = 0;
+
+    use_counting_hooks();
+    keys = cJSON_CreateKeyTable();
+    TEST_ASSERT_NOT_NULL(keys);
+    tree = cJSON_ParseWithKeyTable(json, NULL, true, keys);
+    TEST_ASSERT_NOT_NULL(tree);
+    cJSON_Delete(tree);
+
+    allocations = 0;
+    tree = cJSON_Parse(json);
+    TEST_ASSERT_NOT_NULL(tree);
+    plain = allocations;
+    cJSON_Delete(tree);
+
+    allocations = 0;
+    tree = cJSON_ParseWithKeyTable(json, NULL, true, keys);
+    TEST_ASSERT_NOT_NULL(tree);
+    /* one allocation less per key */
+    TEST_ASSERT_EQUAL_UINT((unsigned int)plain - 3, (unsigned int)allocations);
+    cJSON_Delete(tree);
+
+    cJSON_DeleteKeyTable(keys);
+    cJSON_InitHooks(NULL);
+}
+
+static void key_table_should_find_interned_keys_by_address(void)
+{
+    cJSON_KeyTable *keys = cJSON_CreateKeyTable();
+    cJSON *tree = NULL;
+    const char *host = NULL;
+    char name[8];
+    int i = 0;
+    TEST_ASSERT_NOT_NULL(keys);
+
+    host = cJSON_InternKey(keys, "host");
+    TEST_ASSERT_NOT_NULL(host);
+    TEST_ASSERT_TRUE(host == cJSON_InternKey(keys, "host"));
+    TEST_ASSERT_NULL(cJSON_InternKey(keys, NULL));
+    TEST_ASSERT_NULL(cJSON_InternKey(NULL, "host"));
+
+    tree = cJSON_ParseWithKeyTable("{\"a\":1,\"host\":\"x\"}", NULL, true, keys);
+    TEST_ASSERT_NOT_NULL(tree);
+    TEST_ASSERT_TRUE(cJSON_GetObjectItemCaseSensitive(tree, host)->string == host);
+    TEST_ASSERT_TRUE(cJSON_GetObjectItem(tree, "HOST")->string == host);
+    TEST_ASSERT_NULL(cJSON_GetObjectItem(tree, "b"));
+
+    /* the table grows */
+    for (i = 0; i < 1000; i++)
+    {
+        sprintf(name, "k%d", i);
+        TEST_ASSERT_EQUAL_STRING(name, cJSON_InternKey(keys, name));
+    }
+    TEST_ASSERT_EQUAL_UINT(1002U, (unsigned int)cJSON_GetKeyTableSize(keys));
+    TEST_ASSERT_TRUE(host == cJSON_InternKey(keys, "host"));
+    TEST_ASSERT_EQUAL_STRING("k512", cJSON_InternKey(keys, "k512"));
+    TEST_ASSERT_EQUAL_UINT(1002U, (unsigned int)cJSON_GetKeyTableSize(keys));
+
+    cJSON_Delete(tree);
+    cJSON_DeleteKeyTable(keys);
+}
+
+static void key_table_trees_should_work_like_others(void)
+{
+    cJSON_KeyTable *keys = cJSON_CreateKeyTable();
+    char *json = read_file("inputs/test7");
+    cJSON *tree = NULL;
+    cJSON *plain = NULL;
+    cJSON *copy = NULL;
+    char *printed = NULL;
+    char *expected = NULL;
+    TEST_ASSERT_NOT_NULL(keys);
+    TEST_ASSERT_NOT_NULL(json);
+
+    tree = cJSON_ParseWithKeyTable(json, NULL, true, keys);
+    plain = cJSON_Parse(json);
+    TEST_ASSERT_NOT_NULL(tree);
+    TEST_ASSERT_NOT_NULL(plain);
+    TEST_ASSERT_TRUE(cJSON_Compare(tree, plain, true));
+
+    printed = cJSON_Print(tree);
+    expected = cJSON_Print(plain);
+    TEST_ASSERT_EQUAL_STRING(expected, printed);
+
+    /* duplicates share the keys as well */
+    copy = cJSON_Duplicate(tree, true);
+    TEST_ASSERT_NOT_NULL(copy);
+    TEST_ASSERT_TRUE(cJSON_Compare(copy, plain, true));
+    TEST_ASSERT_TRUE(copy->child->child->string == tree->child->child->string);
+
+    /* keys can still be replaced */
+    cJSON_ReplaceItemInObject(cJSON_GetArrayItem(tree, 0), "Latitude", cJSON_CreateNumber(0));
+    cJSON_DeleteItemFromObject(cJSON_GetArrayItem(tree, 0), "Longitude");
+
+    cJSON_free(printed);
+    cJSON_free(expected);
+    cJSON_Delete(copy);
+    cJSON_Delete(tree);
+    cJSON_Delete(plain);
+    cJSON_DeleteKeyTable(keys);
+    free(json);
+}
+
+static void key_table_should_fail_like_parse(void)
+{
+    cJSON_KeyTable *keys = cJSON_CreateKeyTable();
+    const char *error_position = NULL;
+    TEST_ASSERT_NOT_NULL(keys);
+
+    TEST_ASSERT_NULL(cJSON_ParseWithKeyTable("{\"a\":1,\"b\":[1,}", &error_position, true, keys));
+    TEST_ASSERT_EQUAL_STRING("}", error_position);
+    TEST_ASSERT_NULL(cJSON_ParseWithKeyTable("{\"a\":1,\"b", NULL, true, keys));
+    TEST_ASSERT_NULL(cJSON_ParseWithKeyTable("{\"a\\x\":1}", NULL, true, keys));
+    TEST_ASSERT_NULL(cJSON_ParseWithKeyTable("{\"a\":1} x", NULL, true, keys));
+    TEST_ASSERT_NULL(cJSON_ParseWithKeyTable("{}", NULL, true, NULL));
+    TEST_ASSERT_NULL(cJSON_ParseWithKeyTable(NULL, NULL, true, keys));
+
+    cJSON_DeleteKeyTable(keys);
+    cJSON_DeleteKeyTable(NULL);
+    TEST_ASSERT_EQUAL_UINT(0U, (unsigned int)cJSON_GetKeyTableSize(NULL));
+}
+
+int CJSON_CDECL main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(key_table_should_share_keys_between_documents);
+    RUN_TEST(key_table_should_unescape_keys);
+    RUN_TEST(key_table_should_not_allocate_known_keys);
+    RUN_TEST(key_table_should_find_interned_keys_by_address);
+    RUN_TEST(key_table_trees_should_work_like_others);
+    RUN_TEST(key_table_should_fail_like_parse);
+
+    return UNITY_END();
+}
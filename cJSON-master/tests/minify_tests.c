@@ -152,6 +152,163 @@ static void cjson_minify_should_minify_json(void) {
     free(buffer);
 }
 
+static void cjson_minify_len_should_not_need_null_termination(void)
+{
+    char buffer[] = "{ \"a\" : [ 1, 2 ] }XXXX";
+
+    TEST_ASSERT_EQUAL_UINT(11, (unsigned int)cJSON_MinifyLen(buffer, sizeof("{ \"a\" : [ 1, 2 ] }") - 1));
+    TEST_ASSERT_EQUAL_STRING("{\"a\":[1,2]}", buffer);
+    TEST_ASSERT_EQUAL_UINT(0, (unsigned int)cJSON_MinifyLen(NULL, 10));
+}
+
+static void cjson_minify_len_should_not_write_past_length(void)
+{
+    char buffer[] = "[1,2]X";
+
+    TEST_ASSERT_EQUAL_UINT(5, (unsigned int)cJSON_MinifyLen(buffer, 5));
+    TEST_ASSERT_EQUAL_STRING("[1,2]X", buffer);
+
+    /* an unterminated string or comment ends at the length */
+    strcpy(buffer, "\" a\"X");
+    TEST_ASSERT_EQUAL_UINT(3, (unsigned int)cJSON_MinifyLen(buffer, 3));
+    TEST_ASSERT_EQUAL_STRING("\" a\"X", buffer);
+    strcpy(buffer, "1/*/X");
+    TEST_ASSERT_EQUAL_UINT(1, (unsigned int)cJSON_MinifyLen(buffer, 4));
+    TEST_ASSERT_EQUAL_STRING("1", buffer);
+}
+
+static void cjson_minify_should_remove_single_slashes(void)
+{
+    char buffer[] = "[1 / 2]/";
+
+    cJSON_Minify(buffer);
+    TEST_ASSERT_EQUAL_STRING("[12]", buffer);
+}
+
+/* the character at a time implementation cJSON_Minify had before */
+static void reference_minify(char *json)
+{
+    char *into = json;
+
+    while (*json)
+    {
+        switch (*json)
+        {
+            case ' ':
+            case '\t':
+            case '\r':
+            case '\n':
+                json++;
+                break;
+
+            case '/':
+                if (json[1] == '/')
+                {
+                    json += 2;
+                    while ((*json != '\0') && (*json != '\n'))
+                    {
+                        json++;
+                    }
+                    if (*json == '\n')
+                    {
+                        json++;
+                    }
+                }
+                else if (json[1] == '*')
+                {
+                    json += 2;
+                    while ((*json != '\0') && !((json[0] == '*') && (json[1] == '/')))
+                    {
+                        json++;
+                    }
+                    if (*json != '\0')
+                    {
+                        json += 2;
+                    }
+                }
+                else
+                {
+                    json++;
+                }
+                break;
+
+            case '\"':
+                *into++ = *json++;
+                while (*json != '\0')
+                {
+                    if (*json == '\"')
+                    {
+                        *into++ = *json++;
+                        break;
+                    }
+                    if ((json[0] == '\\') && (json[1] == '\"'))
+                    {
+                        *into++ = *json++;
+                    }
+                    *into++ = *json++;
+                }
+                break;
+
+            default:
+                *into++ = *json++;
+        }
+    }
+
+    *into = '\0';
+}
+
+static void cjson_minify_should_match_reference_implementation(void)
+{
+    static const char alphabet[] = "    \t\r\n//**\"\"\\\\abc123{}[],:";
+    char input[200];
+    char expected[200];
+    char unterminated[200];
+    size_t minified_length = 0;
+    unsigned long state = 12345;
+    size_t round = 0;
+
+    for (round = 0; round < 20000; round++)
+    {
+        size_t length = 0;
+        size_t i = 0;
+
+        state = state * 1103515245UL + 12345UL;
+        length = (size_t)((state >> 16) % (sizeof(input) - 1));
+        while (i < length)
+        {
+            size_t run = 0;
+            char character = '\0';
+
+            /* runs of up to 64 equal characters reach the vectorized paths */
+            state = state * 1103515245UL + 12345UL;
+            character = alphabet[(state >> 16) % (sizeof(alphabet) - 1)];
+            run = ((state >> 8) & 1) ? 1 : (size_t)((state >> 24) % 64);
+            for (; (run > 0) && (i < length); run--)
+            {
+                input[i++] = character;
+            }
+        }
+        input[length] = '\0';
+        memcpy(expected, input, length + 1);
+
+        reference_minify(expected);
+
+        /* followed by something that must not be touched */
+        memcpy(unterminated, input, length);
+        unterminated[length] = '/';
+        minified_length = cJSON_MinifyLen(unterminated, length);
+        TEST_ASSERT_EQUAL_UINT((unsigned int)strlen(expected), (unsigned int)minified_length);
+        if (minified_length > 0)
+        {
+            TEST_ASSERT_EQUAL_MEMORY(expected, unterminated, minified_length);
+        }
+        TEST_ASSERT_EQUAL_INT('/', unterminated[length]);
+
+        cJSON_Minify(input);
+        TEST_ASSERT_EQUAL_STRING(expected, input);
+    }
+}
+
 int CJSON_CDECL main(void)
 {
     UNITY_BEGIN();
@@ -162,6 +319,10 @@ int CJSON_CDECL main(void)
     RUN_TEST(cjson_minify_should_remove_multiline_comments);
     RUN_TEST(cjson_minify_should_remove_spaces);
     RUN_TEST(cjson_minify_should_not_modify_strings);
+    RUN_TEST(cjson_minify_len_should_not_need_null_termination);
+    RUN_TEST(cjson_minify_len_should_not_write_past_length);
+    RUN_TEST(cjson_minify_should_remove_single_slashes);
+    RUN_TEST(cjson_minify_should_match_reference_implementation);
 
     return UNITY_END();
 }
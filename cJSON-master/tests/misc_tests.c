@@ -80,15 +80,15 @@ static void cjson_get_object_item_should_get_object_items(void)
 
     found = cJSON_GetObjectItem(item, "one");
     TEST_ASSERT_NOT_NULL_MESSAGE(found, "Failed to find first item.");
-    TEST_ASSERT_EQUAL_DOUBLE(found->valuedouble, 1);
+    TEST_ASSERT_EQUAL_DOUBLE(item_number(found), 1);
 
     found = cJSON_GetObjectItem(item, "tWo");
     TEST_ASSERT_NOT_NULL_MESSAGE(found, "Failed to find first item.");
-    TEST_ASSERT_EQUAL_DOUBLE(found->valuedouble, 2);
+    TEST_ASSERT_EQUAL_DOUBLE(item_number(found), 2);
 
     found = cJSON_GetObjectItem(item, "three");
     TEST_ASSERT_NOT_NULL_MESSAGE(found, "Failed to find item.");
-    TEST_ASSERT_EQUAL_DOUBLE(found->valuedouble, 3);
+    TEST_ASSERT_EQUAL_DOUBLE(item_number(found), 3);
 
     found = cJSON_GetObjectItem(item, "four");
     TEST_ASSERT_NULL_MESSAGE(found, "Should not find something that isn't there.");
@@ -111,15 +111,15 @@ static void cjson_get_object_item_case_sensitive_should_get_object_items(void)
 
     found = cJSON_GetObjectItemCaseSensitive(item, "one");
     TEST_ASSERT_NOT_NULL_MESSAGE(found, "Failed to find first item.");
-    TEST_ASSERT_EQUAL_DOUBLE(found->valuedouble, 1);
+    TEST_ASSERT_EQUAL_DOUBLE(item_number(found), 1);
 
     found = cJSON_GetObjectItemCaseSensitive(item, "Two");
     TEST_ASSERT_NOT_NULL_MESSAGE(found, "Failed to find first item.");
-    TEST_ASSERT_EQUAL_DOUBLE(found->valuedouble, 2);
+    TEST_ASSERT_EQUAL_DOUBLE(item_number(found), 2);
 
     found = cJSON_GetObjectItemCaseSensitive(item, "tHree");
     TEST_ASSERT_NOT_NULL_MESSAGE(found, "Failed to find item.");
-    TEST_ASSERT_EQUAL_DOUBLE(found->valuedouble, 3);
+    TEST_ASSERT_EQUAL_DOUBLE(item_number(found), 3);
 
     found = cJSON_GetObjectItemCaseSensitive(item, "One");
     TEST_ASSERT_NULL_MESSAGE(found, "Should not find something that isn't there.");
@@ -221,23 +221,42 @@ static void cjson_should_not_parse_to_deeply_nested_jsons(void)
 
 static void cjson_set_number_value_should_set_numbers(void)
 {
-    cJSON number[1] = {{NULL, NULL, NULL, cJSON_Number, NULL, 0, 0, NULL}};
+    cJSON number[1];
+    memset(number, '\0', sizeof(number));
+    number->type = cJSON_Number;
 
     cJSON_SetNumberValue(number, 1.5);
     TEST_ASSERT_EQUAL(1, number->valueint);
-    TEST_ASSERT_EQUAL_DOUBLE(1.5, number->valuedouble);
+    TEST_ASSERT_EQUAL_DOUBLE(1.5, item_number(number));
 
     cJSON_SetNumberValue(number, -1.5);
     TEST_ASSERT_EQUAL(-1, number->valueint);
-    TEST_ASSERT_EQUAL_DOUBLE(-1.5, number->valuedouble);
+    TEST_ASSERT_EQUAL_DOUBLE(-1.5, item_number(number));
 
     cJSON_SetNumberValue(number, 1 + (double)INT_MAX);
     TEST_ASSERT_EQUAL(INT_MAX, number->valueint);
-    TEST_ASSERT_EQUAL_DOUBLE(1 + (double)INT_MAX, number->valuedouble);
+    TEST_ASSERT_EQUAL_DOUBLE(1 + (double)INT_MAX, item_number(number));
 
     cJSON_SetNumberValue(number, -1 + (double)INT_MIN);
     TEST_ASSERT_EQUAL(INT_MIN, number->valueint);
-    TEST_ASSERT_EQUAL_DOUBLE(-1 + (double)INT_MIN, number->valuedouble);
+    TEST_ASSERT_EQUAL_DOUBLE(-1 + (double)INT_MIN, item_number(number));
+}
+
+static void cjson_set_int_value_should_set_numbers(void)
+{
+    cJSON number[1];
+    memset(number, '\0', sizeof(number));
+    number->type = cJSON_Number;
+
+    TEST_ASSERT_EQUAL(7, cJSON_SetIntValue(number, 7));
+    TEST_ASSERT_EQUAL(7, number->valueint);
+    TEST_ASSERT_EQUAL_DOUBLE(7, item_number(number));
+
+    /* items in a shared block are left as they are */
+    number->type |= cJSON_IsReadOnly;
+    TEST_ASSERT_EQUAL(7, cJSON_SetIntValue(number, 42));
+    TEST_ASSERT_EQUAL(7, number->valueint);
+    TEST_ASSERT_EQUAL_DOUBLE(7, item_number(number));
 }
 
 static void cjson_detach_item_via_pointer_should_detach_items(void)
@@ -246,6 +265,7 @@ static void cjson_detach_item_via_pointer_should_detach_items(void)
     cJSON parent[1];
 
     memset(list, '\0', sizeof(list));
+    memset(parent, '\0', sizeof(parent));
 
     /* link the list */
     list[0].next = &(list[1]);
@@ -306,7 +326,7 @@ static void cjson_replace_item_via_pointer_should_replace_items(void)
 
     /* replace beginning */
     TEST_ASSERT_TRUE(cJSON_ReplaceItemViaPointer(array, beginning, &(replacements[0])));
-    TEST_ASSERT_NULL(replacements[0].prev);
+    TEST_ASSERT_TRUE(replacements[0].prev == end);
     TEST_ASSERT_TRUE(replacements[0].next == middle);
     TEST_ASSERT_TRUE(middle->prev == &(replacements[0]));
     TEST_ASSERT_TRUE(array->child == &(replacements[0]));
@@ -322,16 +342,19 @@ static void cjson_replace_item_via_pointer_should_replace_items(void)
     TEST_ASSERT_TRUE(replacements[2].prev == &(replacements[1]));
     TEST_ASSERT_NULL(replacements[2].next);
     TEST_ASSERT_TRUE(replacements[1].next == &(replacements[2]));
+    TEST_ASSERT_TRUE(array->child->prev == &(replacements[2]));
 
     cJSON_free(array);
 }
 
 static void cjson_replace_item_in_object_should_preserve_name(void)
 {
-    cJSON root[1] = {{ NULL, NULL, NULL, 0, NULL, 0, 0, NULL }};
+    cJSON root[1];
     cJSON *child = NULL;
     cJSON *replacement = NULL;
 
+    memset(root, '\0', sizeof(root));
+
     child = cJSON_CreateNumber(1);
     TEST_ASSERT_NOT_NULL(child);
     replacement = cJSON_CreateNumber(2);
@@ -432,16 +455,17 @@ static void cjson_functions_shouldnt_crash_with_null_pointers(void)
     cJSON_Delete(item);
 }
 
-static void * CJSON_CDECL failing_realloc(void *pointer, size_t size)
+static void * CJSON_CDECL failing_realloc(void *pointer, size_t size, void *user_data)
 {
     (void)size;
     (void)pointer;
+    (void)user_data;
     return NULL;
 }
 
 static void ensure_should_fail_on_failed_realloc(void)
 {
-    printbuffer buffer = {NULL, 10, 0, 0, false, false, {&malloc, &free, &failing_realloc}};
+    printbuffer buffer = {NULL, 10, 0, 0, false, false, {&internal_malloc, &internal_free, &failing_realloc, NULL}, NULL, NULL};
     buffer.buffer = (unsigned char*)malloc(100);
     TEST_ASSERT_NOT_NULL(buffer.buffer);
 
@@ -451,7 +475,7 @@ static void ensure_should_fail_on_failed_realloc(void)
 static void skip_utf8_bom_should_skip_bom(void)
 {
     const unsigned char string[] = "\xEF\xBB\xBF{}";
-    parse_buffer buffer = { 0, 0, 0, 0, { 0, 0, 0 } };
+    parse_buffer buffer = { 0, 0, 0, 0, { 0, 0, 0, NULL }, NULL, NULL, 0, 0, NULL };
     buffer.content = string;
     buffer.length = sizeof(string);
     buffer.hooks = global_hooks;
@@ -463,7 +487,7 @@ static void skip_utf8_bom_should_skip_bom(void)
 static void skip_utf8_bom_should_not_skip_bom_if_not_at_beginning(void)
 {
     const unsigned char string[] = " \xEF\xBB\xBF{}";
-    parse_buffer buffer = { 0, 0, 0, 0, { 0, 0, 0 } };
+    parse_buffer buffer = { 0, 0, 0, 0, { 0, 0, 0, NULL }, NULL, NULL, 0, 0, NULL };
     buffer.content = string;
     buffer.length = sizeof(string);
     buffer.hooks = global_hooks;
@@ -477,7 +501,7 @@ static void cjson_get_string_value_should_get_a_string(void)
     cJSON *string = cJSON_CreateString("test");
     cJSON *number = cJSON_CreateNumber(1);
 
-    TEST_ASSERT_TRUE(cJSON_GetStringValue(string) == string->valuestring);
+    TEST_ASSERT_TRUE(cJSON_GetStringValue(string) == item_valuestring(string));
     TEST_ASSERT_NULL(cJSON_GetStringValue(number));
     TEST_ASSERT_NULL(cJSON_GetStringValue(NULL));
 
@@ -489,7 +513,7 @@ static void cjson_create_string_reference_should_create_a_string_reference(void)
     const char *string = "I am a string!";
 
     cJSON *string_reference = cJSON_CreateStringReference(string);
-    TEST_ASSERT_TRUE(string_reference->valuestring == string);
+    TEST_ASSERT_TRUE(item_valuestring(string_reference) == string);
     TEST_ASSERT_EQUAL_INT(cJSON_IsReference | cJSON_String, string_reference->type);
 
     cJSON_Delete(string_reference);
@@ -549,6 +573,150 @@ static void cjson_add_item_to_object_should_not_use_after_free_when_string_is_al
     cJSON_Delete(object);
 }
 
+/* the prev pointer of the first item points to the last one, all others to their predecessor */
+static void assert_list_is_linked(const cJSON * const parent, int expected_size)
+{
+    cJSON *element = parent->child;
+    cJSON *last = NULL;
+    int size = 0;
+
+    if (element == NULL)
+    {
+        TEST_ASSERT_EQUAL_INT(0, expected_size);
+        return;
+    }
+
+    for (; element != NULL; element = element->next)
+    {
+        if (element != parent->child)
+        {
+            TEST_ASSERT_TRUE_MESSAGE(element->prev == last, "prev doesn't point to the previous item.");
+        }
+        last = element;
+        size++;
+    }
+
+    TEST_ASSERT_EQUAL_INT(expected_size, size);
+    TEST_ASSERT_TRUE_MESSAGE(parent->child->prev == last, "First item doesn't point to the last one.");
+}
+
+static void cjson_add_item_to_array_should_keep_track_of_the_last_item(void)
+{
+    cJSON *array = cJSON_CreateArray();
+    cJSON *object = cJSON_CreateObject();
+    int i = 0;
+
+    TEST_ASSERT_NOT_NULL(array);
+    TEST_ASSERT_NOT_NULL(object);
+
+    for (i = 0; i < 10; i++)
+    {
+        cJSON_AddItemToArray(array, cJSON_CreateNumber(i));
+        assert_list_is_linked(array, i + 1);
+    }
+    TEST_ASSERT_EQUAL_DOUBLE(9, item_number(array->child->prev));
+
+    cJSON_AddNullToObject(object, "first");
+    assert_list_is_linked(object, 1);
+    cJSON_AddItemToObject(object, "array", array);
+    cJSON_AddItemReferenceToObject(object, "reference", array);
+    cJSON_AddItemToObjectCS(object, "last", cJSON_CreateTrue());
+    assert_list_is_linked(object, 4);
+    TEST_ASSERT_EQUAL_STRING("last", object->child->prev->string);
+
+    cJSON_Delete(object);
+}
+
+static void cjson_list_modifications_should_keep_track_of_the_last_item(void)
+{
+    cJSON *array = cJSON_Parse("[0, 1, 2, 3]");
+    cJSON *copy = NULL;
+    TEST_ASSERT_NOT_NULL(array);
+    assert_list_is_linked(array, 4);
+
+    /* insert at the beginning, in the middle and after the end */
+    cJSON_InsertItemInArray(array, 0, cJSON_CreateString("first"));
+    assert_list_is_linked(array, 5);
+    cJSON_InsertItemInArray(array, 2, cJSON_CreateString("middle"));
+    assert_list_is_linked(array, 6);
+    cJSON_InsertItemInArray(array, 6, cJSON_CreateString("last"));
+    assert_list_is_linked(array, 7);
+    TEST_ASSERT_EQUAL_STRING("last", item_valuestring(array->child->prev));
+
+    /* replace the first, a middle and the last item */
+    cJSON_ReplaceItemInArray(array, 0, cJSON_CreateNumber(-1));
+    assert_list_is_linked(array, 7);
+    cJSON_ReplaceItemInArray(array, 3, cJSON_CreateNumber(-2));
+    assert_list_is_linked(array, 7);
+    cJSON_ReplaceItemInArray(array, 6, cJSON_CreateNumber(-3));
+    assert_list_is_linked(array, 7);
+    TEST_ASSERT_EQUAL_DOUBLE(-3, item_number(array->child->prev));
+
+    copy = cJSON_Duplicate(array, true);
+    TEST_ASSERT_NOT_NULL(copy);
+    assert_list_is_linked(copy, 7);
+    cJSON_Delete(copy);
+
+    /* detach the last, a middle and the first item */
+    cJSON_DeleteItemFromArray(array, 6);
+    assert_list_is_linked(array, 6);
+    TEST_ASSERT_EQUAL_DOUBLE(3, item_number(array->child->prev));
+    cJSON_DeleteItemFromArray(array, 2);
+    assert_list_is_linked(array, 5);
+    cJSON_DeleteItemFromArray(array, 0);
+    assert_list_is_linked(array, 4);
+
+    /* appending still works after all of that */
+    cJSON_AddItemToArray(array, cJSON_CreateFalse());
+    assert_list_is_linked(array, 5);
+
+    while (array->child != NULL)
+    {
+        cJSON_DeleteItemFromArray(array, 0);
+        assert_list_is_linked(array, cJSON_GetArraySize(array));
+    }
+
+    /* replace the only item */
+    cJSON_AddItemToArray(array, cJSON_CreateFalse());
+    cJSON_ReplaceItemInArray(array, 0, cJSON_CreateTrue());
+    assert_list_is_linked(array, 1);
+    cJSON_AddItemToArray(array, cJSON_CreateFalse());
+    assert_list_is_linked(array, 2);
+
+    cJSON_Delete(array);
+}
+
+static void cjson_create_arrays_should_keep_track_of_the_last_item(void)
+{
+    const int numbers[] = { 1, 2, 3 };
+    const float floats[] = { 1.0f, 2.0f };
+    const double doubles[] = { 1.0 };
+    const char *strings[] = { "a", "b", "c", "d" };
+    cJSON *item = NULL;
+
+    item = cJSON_CreateIntArray(numbers, 3);
+    assert_list_is_linked(item, 3);
+    cJSON_Delete(item);
+
+    item = cJSON_CreateFloatArray(floats, 2);
+    assert_list_is_linked(item, 2);
+    cJSON_Delete(item);
+
+    item = cJSON_CreateDoubleArray(doubles, 1);
+    assert_list_is_linked(item, 1);
+    cJSON_Delete(item);
+
+    item = cJSON_CreateStringArray(strings, 4);
+    assert_list_is_linked(item, 4);
+    cJSON_Delete(item);
+
+    item = cJSON_Parse("{\"a\": [], \"b\": {\"c\": 1}}");
+    assert_list_is_linked(item, 2);
+    assert_list_is_linked(item->child, 0);
+    assert_list_is_linked(item->child->next, 1);
+    cJSON_Delete(item);
+}
+
 int CJSON_CDECL main(void)
 {
     UNITY_BEGIN();
@@ -562,6 +730,7 @@ int CJSON_CDECL main(void)
     RUN_TEST(typecheck_functions_should_check_type);
     RUN_TEST(cjson_should_not_parse_to_deeply_nested_jsons);
     RUN_TEST(cjson_set_number_value_should_set_numbers);
+    RUN_TEST(cjson_set_int_value_should_set_numbers);
     RUN_TEST(cjson_detach_item_via_pointer_should_detach_items);
     RUN_TEST(cjson_replace_item_via_pointer_should_replace_items);
     RUN_TEST(cjson_replace_item_in_object_should_preserve_name);
@@ -574,6 +743,9 @@ int CJSON_CDECL main(void)
     RUN_TEST(cjson_create_object_reference_should_create_an_object_reference);
     RUN_TEST(cjson_create_array_reference_should_create_an_array_reference);
     RUN_TEST(cjson_add_item_to_object_should_not_use_after_free_when_string_is_aliased);
+    RUN_TEST(cjson_add_item_to_array_should_keep_track_of_the_last_item);
+    RUN_TEST(cjson_list_modifications_should_keep_track_of_the_last_item);
+    RUN_TEST(cjson_create_arrays_should_keep_track_of_the_last_item);
 
     return UNITY_END();
 }
@@ -38,6 +38,11 @@ static void cjson_utils_functions_shouldnt_crash_with_null_pointers(void)
     TEST_ASSERT_NULL(cJSONUtils_GetPointer(NULL, "pointer"));
     TEST_ASSERT_NULL(cJSONUtils_GetPointerCaseSensitive(NULL, "pointer"));
     TEST_ASSERT_NULL(cJSONUtils_GetPointerCaseSensitive(item, NULL));
+    TEST_ASSERT_NULL(cJSONUtils_CompilePointer(NULL));
+    TEST_ASSERT_NULL(cJSONUtils_GetCompiledPointer(item, NULL));
+    TEST_ASSERT_NULL(cJSONUtils_GetCompiledPointerCaseSensitive(item, NULL));
+    TEST_ASSERT_FALSE(cJSONUtils_GetCompiledPointers(item, NULL, 1, NULL));
+    cJSONUtils_DeleteCompiledPointer(NULL);
     TEST_ASSERT_NULL(cJSONUtils_GeneratePatches(item, NULL));
     TEST_ASSERT_NULL(cJSONUtils_GeneratePatches(NULL, item));
     TEST_ASSERT_NULL(cJSONUtils_GeneratePatchesCaseSensitive(item, NULL));
@@ -70,11 +75,472 @@ static void cjson_utils_functions_shouldnt_crash_with_null_pointers(void)
     cJSON_Delete(item);
 }
 
+static void cjson_utils_functions_should_parse_lazy_items(void)
+{
+    const char json[] = "{\"object\":{\"array\":[1,{\"key\":\"value\"}]},\"other\":[2]}";
+    cJSON *lazy = cJSON_ParseLazy(json, NULL, true, 1);
+    cJSON *parsed = cJSON_Parse(json);
+    cJSON *patches = NULL;
+
+    TEST_ASSERT_NOT_NULL(lazy);
+    TEST_ASSERT_NOT_NULL(parsed);
+
+    TEST_ASSERT_EQUAL_STRING("value", cJSON_GetStringValue(cJSONUtils_GetPointer(lazy, "/object/array/1/key")));
+
+    patches = cJSONUtils_GeneratePatches(lazy, parsed);
+    TEST_ASSERT_EQUAL_INT(0, cJSON_GetArraySize(patches));
+    cJSON_Delete(patches);
+
+    cJSON_Delete(lazy);
+    lazy = cJSON_ParseLazy(json, NULL, true, 1);
+    patches = cJSON_Parse("[{\"op\":\"remove\",\"path\":\"/other/0\"}]");
+    TEST_ASSERT_EQUAL_INT(0, cJSONUtils_ApplyPatches(lazy, patches));
+    TEST_ASSERT_EQUAL_INT(0, cJSON_GetArraySize(cJSON_GetObjectItem(lazy, "other")));
+
+    cJSON_Delete(patches);
+    cJSON_Delete(parsed);
+    cJSON_Delete(lazy);
+}
+
+static void cjson_utils_patches_should_replace_the_root_of_an_arena(void)
+{
+    cJSON *tree = cJSON_ParseWithArena("{\"old\": [1, 2]}", NULL, true);
+    cJSON *patches = cJSON_Parse("[{\"op\":\"add\",\"path\":\"/old/-\",\"value\":3},{\"op\":\"replace\",\"path\":\"\",\"value\":{\"new\":\"value\"}},{\"op\":\"add\",\"path\":\"/more\",\"value\":[4]}]");
+    char *printed = NULL;
+
+    TEST_ASSERT_NOT_NULL(tree);
+    TEST_ASSERT_NOT_NULL(patches);
+
+    TEST_ASSERT_EQUAL_INT(0, cJSONUtils_ApplyPatches(tree, patches));
+    TEST_ASSERT_BITS(cJSON_IsArenaRoot, cJSON_IsArenaRoot, tree->type);
+    printed = cJSON_PrintUnformatted(tree);
+    TEST_ASSERT_EQUAL_STRING("{\"new\":\"value\",\"more\":[4]}", printed);
+
+    cJSON_free(printed);
+    cJSON_Delete(patches);
+    cJSON_Delete(tree);
+}
+
+static void cjson_utils_generate_patches_should_skip_equal_subtrees(void)
+{
+    cJSON *from = cJSON_CreateObject();
+    cJSON *to = NULL;
+    cJSON *same = cJSON_AddObjectToObject(from, "same");
+    cJSON *patches = NULL;
+    char key[8];
+    int i = 0;
+
+    for (i = 0; i < 100; i++)
+    {
+        sprintf(key, "k%d", i);
+        cJSON_AddNumberToObject(same, key, i);
+    }
+    cJSON_AddNumberToObject(from, "other", 5);
+    to = cJSON_Duplicate(from, true);
+    cJSON_SetNumberValue(cJSON_GetObjectItem(to, "other"), 6);
+
+    /* diffing the members of same would need a path for each of them */
+    use_counting_hooks();
+    patches = cJSONUtils_GeneratePatchesCaseSensitive(from, to);
+    cJSON_InitHooks(NULL);
+    TEST_ASSERT_TRUE(allocations < 50);
+
+    TEST_ASSERT_EQUAL_INT(1, cJSON_GetArraySize(patches));
+    TEST_ASSERT_EQUAL_STRING("/other", cJSON_GetStringValue(cJSON_GetObjectItem(cJSON_GetArrayItem(patches, 0), "path")));
+
+    cJSON_Delete(patches);
+    cJSON_Delete(from);
+    cJSON_Delete(to);
+}
+
+static void cjson_utils_functions_should_change_shared_copies(void)
+{
+    const char json[] = "{\"object\":{\"array\":[{\"key\":\"value\"},{\"b\":1,\"a\":2}]},\"other\":[1]}";
+    cJSON *tree = cJSON_Parse(json);
+    cJSON *snapshot = NULL;
+    cJSON *copy = NULL;
+    cJSON *patches = NULL;
+    cJSON *shared_patches = NULL;
+    cJSON *object = NULL;
+    char *printed = NULL;
+
+    TEST_ASSERT_NOT_NULL(tree);
+    snapshot = cJSON_DuplicateShared(tree);
+    TEST_ASSERT_NOT_NULL(snapshot);
+    copy = cJSON_DuplicateShared(snapshot);
+    TEST_ASSERT_NOT_NULL(copy);
+
+    patches = cJSON_Parse("[{\"op\":\"test\",\"path\":\"/object/array/1\",\"value\":{\"a\":2,\"b\":1}},"
+            "{\"op\":\"replace\",\"path\":\"/object/array/0/key\",\"value\":\"changed\"},"
+            "{\"op\":\"move\",\"from\":\"/other/0\",\"path\":\"/object/moved\"}]");
+    TEST_ASSERT_NOT_NULL(patches);
+    /* the values of shared patches are read only, the test compares them anyway */
+    shared_patches = cJSON_DuplicateShared(patches);
+    TEST_ASSERT_NOT_NULL(shared_patches);
+    TEST_ASSERT_EQUAL_INT(0, cJSONUtils_ApplyPatchesCaseSensitive(copy, shared_patches));
+    TEST_ASSERT_EQUAL_STRING("changed", cJSON_GetStringValue(cJSONUtils_GetPointer(copy, "/object/array/0/key")));
+    TEST_ASSERT_EQUAL_INT(0, cJSON_GetArraySize(cJSON_GetObjectItem(copy, "other")));
+    cJSON_Delete(shared_patches);
+    cJSON_Delete(patches);
+
+    /* the other copies share nothing that was changed */
+    printed = cJSON_PrintUnformatted(snapshot);
+    TEST_ASSERT_NOT_NULL(printed);
+    TEST_ASSERT_EQUAL_STRING(json, printed);
+    cJSON_free(printed);
+
+    /* read only items are compared through a copy */
+    patches = cJSONUtils_GeneratePatchesCaseSensitive(cJSON_GetObjectItem(snapshot, "object"), cJSON_GetObjectItem(copy, "object"));
+    TEST_ASSERT_NOT_NULL(patches);
+    TEST_ASSERT_EQUAL_INT(2, cJSON_GetArraySize(patches));
+    object = cJSON_Duplicate(cJSON_GetObjectItem(snapshot, "object"), true);
+    TEST_ASSERT_NOT_NULL(object);
+    TEST_ASSERT_EQUAL_INT(0, cJSONUtils_ApplyPatchesCaseSensitive(object, patches));
+    TEST_ASSERT_TRUE(cJSON_Compare(object, cJSON_GetObjectItem(copy, "object"), true));
+    cJSON_Delete(object);
+    cJSON_Delete(patches);
+    patches = cJSONUtils_GeneratePatchesCaseSensitive(cJSON_GetObjectItem(snapshot, "object"), cJSON_GetObjectItem(tree, "object"));
+    TEST_ASSERT_NOT_NULL(patches);
+    TEST_ASSERT_EQUAL_INT(0, cJSON_GetArraySize(patches));
+    cJSON_Delete(patches);
+    patches = cJSONUtils_GenerateMergePatchCaseSensitive(cJSON_GetObjectItem(snapshot, "object"), cJSON_GetObjectItem(copy, "object"));
+    TEST_ASSERT_NOT_NULL(patches);
+    TEST_ASSERT_NOT_NULL(cJSON_GetObjectItem(patches, "moved"));
+    cJSON_Delete(patches);
+
+    /* or unshared along a pointer to change them */
+    object = cJSON_DuplicateShared(snapshot);
+    TEST_ASSERT_NOT_NULL(object);
+    TEST_ASSERT_NULL(cJSONUtils_UnsharePointer(object, "/object/missing"));
+    TEST_ASSERT_TRUE(cJSON_AddItemToObject(cJSONUtils_UnsharePointerCaseSensitive(object, "/object/array/1"), "c", cJSON_CreateNull()));
+    TEST_ASSERT_TRUE(cJSON_IsNull(cJSONUtils_GetPointer(object, "/object/array/1/c")));
+    TEST_ASSERT_NULL(cJSONUtils_GetPointer(snapshot, "/object/array/1/c"));
+    cJSON_Delete(object);
+
+    /* items found in a snapshot are read only, so sorting them doesn't do anything */
+    cJSONUtils_SortObject(cJSON_GetArrayItem(cJSONUtils_GetPointer(snapshot, "/object/array"), 1));
+    printed = cJSON_PrintUnformatted(snapshot);
+    TEST_ASSERT_NOT_NULL(printed);
+    TEST_ASSERT_EQUAL_STRING(json, printed);
+    cJSON_free(printed);
+
+    /* generating patches sorts the objects of both, the snapshot gets children of its own for that */
+    patches = cJSONUtils_GeneratePatchesCaseSensitive(snapshot, copy);
+    TEST_ASSERT_NOT_NULL(patches);
+    TEST_ASSERT_TRUE(cJSON_GetArraySize(patches) > 0);
+    TEST_ASSERT_EQUAL_INT(0, cJSONUtils_ApplyPatchesCaseSensitive(tree, patches));
+    TEST_ASSERT_TRUE(cJSON_Compare(tree, copy, true));
+    cJSON_Delete(patches);
+
+    cJSON_Delete(copy);
+    cJSON_Delete(snapshot);
+    cJSON_Delete(tree);
+}
+
+static void cjson_utils_compiled_pointers_should_match_get_pointer(void)
+{
+    const char *pointers[] = {
+        "", "/", "noslash", "/foo", "/FOO", "/foo/0", "/foo/1/bar", "/foo/01", "/foo/x", "/foo/9",
+        "/a~1b", "/m~0n", "/m~2n", "/m~", "/Case", "/case", "/number/0", "/foo/1/bar/", "/lazy/deep/1",
+        "/dup", "/dup/0", "/FOO/1/BAR", "/foo/1", "/foo/1/", "/foo/0", "/lazy/deep/0"
+    };
+    cJSONUtils_Pointer *compiled[sizeof(pointers) / sizeof(pointers[0]) + 1];
+    cJSON *results[sizeof(pointers) / sizeof(pointers[0]) + 1];
+    cJSON *root = cJSON_ParseLazy("{\"foo\":[1,{\"bar\":true,\"\":[]}],\"\":0,\"a/b\":1,\"m~n\":2,\"Case\":3,\"case\":4,\"number\":5,"
+            "\"lazy\":{\"deep\":[6,7]},\"dup\":8,\"dup\":[9]}", NULL, true, 1);
+    const size_t count = sizeof(pointers) / sizeof(pointers[0]);
+    size_t i = 0;
+
+    TEST_ASSERT_NOT_NULL(root);
+
+    for (i = 0; i < count; i++)
+    {
+        compiled[i] = cJSONUtils_CompilePointer(pointers[i]);
+        TEST_ASSERT_NOT_NULL(compiled[i]);
+        TEST_ASSERT_EQUAL_PTR_MESSAGE(cJSONUtils_GetPointer(root, pointers[i]), cJSONUtils_GetCompiledPointer(root, compiled[i]), pointers[i]);
+        TEST_ASSERT_EQUAL_PTR_MESSAGE(cJSONUtils_GetPointerCaseSensitive(root, pointers[i]), cJSONUtils_GetCompiledPointerCaseSensitive(root, compiled[i]), pointers[i]);
+    }
+    compiled[count] = NULL;
+
+    TEST_ASSERT_TRUE(cJSONUtils_GetCompiledPointers(root, compiled, count + 1, results));
+    for (i = 0; i < count; i++)
+    {
+        TEST_ASSERT_EQUAL_PTR_MESSAGE(cJSONUtils_GetPointer(root, pointers[i]), results[i], pointers[i]);
+    }
+    TEST_ASSERT_NULL(results[count]);
+
+    TEST_ASSERT_TRUE(cJSONUtils_GetCompiledPointersCaseSensitive(root, compiled, count + 1, results));
+    for (i = 0; i < count; i++)
+    {
+        TEST_ASSERT_EQUAL_PTR_MESSAGE(cJSONUtils_GetPointerCaseSensitive(root, pointers[i]), results[i], pointers[i]);
+    }
+
+    TEST_ASSERT_TRUE(cJSONUtils_GetCompiledPointers(NULL, compiled, count, results));
+    TEST_ASSERT_NULL(results[0]);
+
+    for (i = 0; i < count; i++)
+    {
+        cJSONUtils_DeleteCompiledPointer(compiled[i]);
+    }
+    cJSON_Delete(root);
+}
+
+static unsigned long pointer_random_state = 1;
+
+static size_t next_pointer_random(size_t range)
+{
+    pointer_random_state = pointer_random_state * 1103515245UL + 12345UL;
+    return (size_t)((pointer_random_state >> 16) % range);
+}
+
+/* small keys that differ in case and may repeat, so the object members collide a lot */
+static cJSON *generate_pointer_tree(size_t depth)
+{
+    static const char *keys[] = { "a", "A", "b", "B", "ab", "aB", "~", "/" };
+    cJSON *item = NULL;
+    size_t count = next_pointer_random(6);
+    size_t i = 0;
+
+    if ((depth == 0) || (next_pointer_random(4) == 0))
+    {
+        return cJSON_CreateNumber((double)next_pointer_random(100));
+    }
+
+    item = next_pointer_random(2) ? cJSON_CreateArray() : cJSON_CreateObject();
+    for (i = 0; i < count; i++)
+    {
+        if (cJSON_IsArray(item))
+        {
+            cJSON_AddItemToArray(item, generate_pointer_tree(depth - 1));
+        }
+        else
+        {
+            cJSON_AddItemToObject(item, keys[next_pointer_random(sizeof(keys) / sizeof(keys[0]))], generate_pointer_tree(depth - 1));
+        }
+    }
+
+    return item;
+}
+
+static void cjson_utils_compiled_pointers_should_match_get_pointer_on_generated_trees(void)
+{
+    static const char *tokens[] = { "/a", "/A", "/b", "/B", "/ab", "/AB", "/~0", "/~1", "/~2", "/0", "/1", "/2", "/01", "/" };
+    char pointers[64][32];
+    cJSONUtils_Pointer *compiled[64];
+    cJSON *results[64];
+    size_t round = 0;
+    size_t i = 0;
+
+    for (round = 0; round < 200; round++)
+    {
+        cJSON *root = generate_pointer_tree(4);
+        for (i = 0; i < 64; i++)
+        {
+            size_t length = next_pointer_random(4);
+            pointers[i][0] = '\0';
+            for (; length > 0; length--)
+            {
+                strcat(pointers[i], tokens[next_pointer_random(sizeof(tokens) / sizeof(tokens[0]))]);
+            }
+            compiled[i] = cJSONUtils_CompilePointer(pointers[i]);
+            TEST_ASSERT_NOT_NULL(compiled[i]);
+        }
+
+        TEST_ASSERT_TRUE(cJSONUtils_GetCompiledPointers(root, compiled, 64, results));
+        for (i = 0; i < 64; i++)
+        {
+            TEST_ASSERT_EQUAL_PTR_MESSAGE(cJSONUtils_GetPointer(root, pointers[i]), results[i], pointers[i]);
+        }
+        TEST_ASSERT_TRUE(cJSONUtils_GetCompiledPointersCaseSensitive(root, compiled, 64, results));
+        for (i = 0; i < 64; i++)
+        {
+            TEST_ASSERT_EQUAL_PTR_MESSAGE(cJSONUtils_GetPointerCaseSensitive(root, pointers[i]), results[i], pointers[i]);
+            cJSONUtils_DeleteCompiledPointer(compiled[i]);
+        }
+
+        cJSON_Delete(root);
+    }
+}
+
+static void assert_patches_turn_from_into_to(cJSON * const from, cJSON * const to, const size_t array_diff_limit, const int expected_patch_count)
+{
+    cJSON *patches = cJSONUtils_GeneratePatchesWithOpts(from, to, true, array_diff_limit);
+    cJSON *patched = cJSON_Duplicate(from, true);
+
+    TEST_ASSERT_NOT_NULL(patches);
+    TEST_ASSERT_NOT_NULL(patched);
+    if (expected_patch_count >= 0)
+    {
+        TEST_ASSERT_EQUAL_INT(expected_patch_count, cJSON_GetArraySize(patches));
+    }
+    TEST_ASSERT_EQUAL_INT(0, cJSONUtils_ApplyPatchesCaseSensitive(patched, patches));
+    TEST_ASSERT_TRUE(cJSON_Compare(patched, to, true));
+
+    cJSON_Delete(patched);
+    cJSON_Delete(patches);
+}
+
+static void cjson_utils_array_diff_should_create_minimal_patches(void)
+{
+    cJSON *from = cJSON_CreateArray();
+    cJSON *to = NULL;
+    cJSON *patches = NULL;
+    int i = 0;
+
+    for (i = 0; i < 1000; i++)
+    {
+        cJSON_AddItemToArray(from, cJSON_CreateNumber(i));
+    }
+
+    /* inserting at the front */
+    to = cJSON_Duplicate(from, true);
+    cJSON_InsertItemInArray(to, 0, cJSON_CreateString("first"));
+    patches = cJSONUtils_GeneratePatchesWithOpts(from, to, true, 16);
+    TEST_ASSERT_EQUAL_INT(1, cJSON_GetArraySize(patches));
+    TEST_ASSERT_EQUAL_STRING("add", cJSON_GetStringValue(cJSON_GetObjectItem(patches->child, "op")));
+    TEST_ASSERT_EQUAL_STRING("/0", cJSON_GetStringValue(cJSON_GetObjectItem(patches->child, "path")));
+    cJSON_Delete(patches);
+    assert_patches_turn_from_into_to(from, to, 16, 1);
+    /* by position, every element is replaced */
+    patches = cJSONUtils_GeneratePatchesCaseSensitive(from, to);
+    TEST_ASSERT_EQUAL_INT(1001, cJSON_GetArraySize(patches));
+    cJSON_Delete(patches);
+    /* too many changes for the limit */
+    assert_patches_turn_from_into_to(to, from, 0, 1001);
+
+    /* removing from the middle */
+    cJSON_Delete(to);
+    to = cJSON_Duplicate(from, true);
+    cJSON_DeleteItemFromArray(to, 500);
+    assert_patches_turn_from_into_to(from, to, 16, 1);
+
+    /* moving the last element to the front and back */
+    cJSON_Delete(to);
+    to = cJSON_Duplicate(from, true);
+    cJSON_InsertItemInArray(to, 0, cJSON_DetachItemFromArray(to, 999));
+    assert_patches_turn_from_into_to(from, to, 16, 1);
+    assert_patches_turn_from_into_to(to, from, 16, 1);
+
+    /* changing an element */
+    cJSON_Delete(to);
+    to = cJSON_Duplicate(from, true);
+    cJSON_ReplaceItemInArray(to, 10, cJSON_CreateString("changed"));
+    assert_patches_turn_from_into_to(from, to, 16, 1);
+
+    cJSON_Delete(to);
+    cJSON_Delete(from);
+}
+
+static cJSON *generate_array_element(void)
+{
+    static const int numbers[] = { 1, 2 };
+    cJSON *element = NULL;
+
+    switch (next_pointer_random(4))
+    {
+        case 0:
+            element = cJSON_CreateObject();
+            cJSON_AddNumberToObject(element, "id", (double)next_pointer_random(8));
+            cJSON_AddItemToObject(element, "list", cJSON_CreateIntArray(numbers, (int)next_pointer_random(3)));
+            return element;
+
+        case 1:
+            element = cJSON_CreateArray();
+            cJSON_AddItemToArray(element, cJSON_CreateNumber((double)next_pointer_random(4)));
+            cJSON_AddItemToArray(element, cJSON_CreateNumber((double)next_pointer_random(4)));
+            return element;
+
+        default:
+            return cJSON_CreateNumber((double)next_pointer_random(8));
+    }
+}
+
+static void mutate_array(cJSON * const array)
+{
+    size_t edits = next_pointer_random(6);
+    for (; edits > 0; edits--)
+    {
+        int size = cJSON_GetArraySize(array);
+        int position = (size > 0) ? (int)next_pointer_random((size_t)size) : 0;
+        cJSON *element = cJSON_GetArrayItem(array, position);
+
+        switch (next_pointer_random(5))
+        {
+            case 0:
+                cJSON_InsertItemInArray(array, position, generate_array_element());
+                break;
+
+            case 1:
+                if (size > 0)
+                {
+                    cJSON_DeleteItemFromArray(array, position);
+                }
+                break;
+
+            case 2:
+                if (size > 0)
+                {
+                    cJSON_InsertItemInArray(array, (int)next_pointer_random((size_t)size), cJSON_DetachItemFromArray(array, position));
+                }
+                break;
+
+            case 3:
+                if (cJSON_IsArray(element))
+                {
+                    mutate_array(element);
+                }
+                else if (cJSON_IsObject(element))
+                {
+                    mutate_array(cJSON_GetObjectItem(element, "list"));
+                }
+                break;
+
+            default:
+                cJSON_AddItemToArray(array, generate_array_element());
+                break;
+        }
+    }
+}
+
+static void cjson_utils_array_diff_patches_should_apply(void)
+{
+    size_t round = 0;
+
+    for (round = 0; round < 500; round++)
+    {
+        cJSON *from = cJSON_CreateArray();
+        cJSON *to = NULL;
+        size_t length = next_pointer_random(30);
+
+        for (; length > 0; length--)
+        {
+            cJSON_AddItemToArray(from, generate_array_element());
+        }
+        to = cJSON_Duplicate(from, true);
+        mutate_array(to);
+
+        assert_patches_turn_from_into_to(from, to, 1000, -1);
+        assert_patches_turn_from_into_to(to, from, 1000, -1);
+        assert_patches_turn_from_into_to(from, to, 2, -1);
+
+        cJSON_Delete(to);
+        cJSON_Delete(from);
+    }
+}
+
 int main(void)
 {
     UNITY_BEGIN();
 
     RUN_TEST(cjson_utils_functions_shouldnt_crash_with_null_pointers);
+    RUN_TEST(cjson_utils_functions_should_parse_lazy_items);
+    RUN_TEST(cjson_utils_patches_should_replace_the_root_of_an_arena);
+    RUN_TEST(cjson_utils_generate_patches_should_skip_equal_subtrees);
+    RUN_TEST(cjson_utils_functions_should_change_shared_copies);
+    RUN_TEST(cjson_utils_compiled_pointers_should_match_get_pointer);
+    RUN_TEST(cjson_utils_compiled_pointers_should_match_get_pointer_on_generated_trees);
+    RUN_TEST(cjson_utils_array_diff_should_create_minimal_patches);
+    RUN_TEST(cjson_utils_array_diff_patches_should_apply);
 
     return UNITY_END();
 }
@@ -0,0 +1,241 @@
+/*
+  Copyright (c) 2009-2017 Dave Gamble and cJSON contributors
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+/* lookups create the indexes by themselves here, by default they are only created explicitly */
+#define CJSON_OBJECT_INDEX_THRESHOLD 32
+
+#include "unity/examples/unity_config.h"
+#include "unity/src/unity.h"
+#include "common.h"
+
+#define WIDE_OBJECT_SIZE 100
+
+static cJSON *create_wide_object(size_t size)
+{
+    cJSON *object = cJSON_CreateObject();
+    char key[32];
+    size_t i = 0;
+
+    TEST_ASSERT_NOT_NULL(object);
+    for (i = 0; i < size; i++)
+    {
+        sprintf(key, "Key%u", (unsigned int)i);
+        TEST_ASSERT_NOT_NULL(cJSON_AddNumberToObject(object, key, (double)i));
+    }
+
+    return object;
+}
+
+static void assert_all_keys_found(cJSON *object, size_t size)
+{
+    char key[32];
+    size_t i = 0;
+
+    for (i = 0; i < size; i++)
+    {
+        cJSON *item = NULL;
+
+        sprintf(key, "Key%u", (unsigned int)i);
+        item = cJSON_GetObjectItemCaseSensitive(object, key);
+        TEST_ASSERT_NOT_NULL(item);
+        TEST_ASSERT_EQUAL_DOUBLE((double)i, item_number(item));
+
+        sprintf(key, "kEY%u", (unsigned int)i);
+        TEST_ASSERT_EQUAL_PTR(item, cJSON_GetObjectItem(object, key));
+        TEST_ASSERT_NULL(cJSON_GetObjectItemCaseSensitive(object, key));
+    }
+}
+
+static void object_index_should_be_created_for_big_objects(void)
+{
+    cJSON *small = create_wide_object(CJSON_OBJECT_INDEX_THRESHOLD / 2);
+    cJSON *big = create_wide_object(WIDE_OBJECT_SIZE);
+
+    TEST_ASSERT_NULL(cJSON_GetObjectItem(small, "missing"));
+    TEST_ASSERT_NULL(index_of(small));
+
+    TEST_ASSERT_NULL(index_of(big));
+    TEST_ASSERT_NULL(cJSON_GetObjectItem(big, "missing"));
+    TEST_ASSERT_NOT_NULL(index_of(big));
+
+    assert_all_keys_found(big, WIDE_OBJECT_SIZE);
+    assert_all_keys_found(small, CJSON_OBJECT_INDEX_THRESHOLD / 2);
+    TEST_ASSERT_NULL(cJSON_GetObjectItem(big, "missing"));
+
+    cJSON_Delete(small);
+    cJSON_Delete(big);
+}
+
+static void object_index_should_not_be_created_for_arrays_and_references(void)
+{
+    cJSON *array = cJSON_CreateArray();
+    cJSON *object = create_wide_object(WIDE_OBJECT_SIZE);
+    cJSON *reference = cJSON_CreateObjectReference(object->child);
+    size_t i = 0;
+
+    TEST_ASSERT_NOT_NULL(array);
+    TEST_ASSERT_NOT_NULL(reference);
+    for (i = 0; i < WIDE_OBJECT_SIZE; i++)
+    {
+        cJSON_AddItemToArray(array, cJSON_CreateNumber((double)i));
+    }
+
+    TEST_ASSERT_NULL(cJSON_GetObjectItem(array, "missing"));
+    TEST_ASSERT_NULL(index_of(array));
+    TEST_ASSERT_FALSE(cJSON_IndexObject(array));
+
+    TEST_ASSERT_NULL(cJSON_GetObjectItem(reference, "missing"));
+    TEST_ASSERT_NULL(index_of(reference));
+    TEST_ASSERT_FALSE(cJSON_IndexObject(reference));
+    TEST_ASSERT_FALSE(cJSON_IndexObject(NULL));
+
+    cJSON_Delete(reference);
+    cJSON_Delete(object);
+    cJSON_Delete(array);
+}
+
+static void object_index_should_return_first_of_duplicate_keys(void)
+{
+    cJSON *object = create_wide_object(WIDE_OBJECT_SIZE);
+    cJSON *first = cJSON_CreateString("first");
+    cJSON *second = cJSON_CreateString("second");
+    cJSON *third = cJSON_CreateString("third");
+
+    TEST_ASSERT_TRUE(cJSON_IndexObject(object));
+
+    cJSON_AddItemToObject(object, "duplicate", first);
+    cJSON_AddItemToObject(object, "Duplicate", second);
+    cJSON_AddItemToObject(object, "duplicate", third);
+
+    TEST_ASSERT_NOT_NULL(index_of(object));
+    TEST_ASSERT_EQUAL_PTR(first, cJSON_GetObjectItemCaseSensitive(object, "duplicate"));
+    TEST_ASSERT_EQUAL_PTR(second, cJSON_GetObjectItemCaseSensitive(object, "Duplicate"));
+    TEST_ASSERT_EQUAL_PTR(first, cJSON_GetObjectItem(object, "DUPLICATE"));
+
+    cJSON_Delete(cJSON_DetachItemFromObjectCaseSensitive(object, "duplicate"));
+    TEST_ASSERT_EQUAL_PTR(second, cJSON_GetObjectItem(object, "duplicate"));
+    TEST_ASSERT_EQUAL_PTR(third, cJSON_GetObjectItemCaseSensitive(object, "duplicate"));
+
+    cJSON_Delete(object);
+}
+
+static void object_index_should_follow_modifications(void)
+{
+    cJSON *object = create_wide_object(WIDE_OBJECT_SIZE);
+    cJSON *replacement = NULL;
+    char key[32];
+    size_t i = 0;
+
+    TEST_ASSERT_TRUE(cJSON_IndexObject(object));
+
+    /* remove every other item, forcing plenty of deleted entries */
+    for (i = 0; i < WIDE_OBJECT_SIZE; i += 2)
+    {
+        sprintf(key, "Key%u", (unsigned int)i);
+        cJSON_DeleteItemFromObjectCaseSensitive(object, key);
+        TEST_ASSERT_NULL(cJSON_GetObjectItemCaseSensitive(object, key));
+    }
+    TEST_ASSERT_NOT_NULL(index_of(object));
+
+    /* add them again */
+    for (i = 0; i < WIDE_OBJECT_SIZE; i += 2)
+    {
+        sprintf(key, "Key%u", (unsigned int)i);
+        cJSON_AddNumberToObject(object, key, (double)i);
+    }
+    TEST_ASSERT_NOT_NULL(index_of(object));
+    assert_all_keys_found(object, WIDE_OBJECT_SIZE);
+
+    replacement = cJSON_CreateNumber(1000);
+    cJSON_ReplaceItemInObjectCaseSensitive(object, "Key7", replacement);
+    TEST_ASSERT_EQUAL_PTR(replacement, cJSON_GetObjectItemCaseSensitive(object, "Key7"));
+    TEST_ASSERT_NOT_NULL(index_of(object));
+
+    cJSON_AddItemToArray(object, cJSON_CreateNull());
+    TEST_ASSERT_NULL(index_of(object));
+
+    cJSON_Delete(object);
+}
+
+static void object_index_should_be_dropped_by_insertions(void)
+{
+    cJSON *object = create_wide_object(WIDE_OBJECT_SIZE);
+    cJSON *inserted = cJSON_CreateTrue();
+
+    TEST_ASSERT_TRUE(cJSON_IndexObject(object));
+
+    inserted->string = (char*)cJSON_malloc(sizeof("Key50"));
+    strcpy(inserted->string, "Key50");
+    cJSON_InsertItemInArray(object, 0, inserted);
+    TEST_ASSERT_NULL(index_of(object));
+
+    /* the inserted item comes first now */
+    TEST_ASSERT_EQUAL_PTR(inserted, cJSON_GetObjectItemCaseSensitive(object, "Key50"));
+    TEST_ASSERT_NULL(cJSON_GetObjectItem(object, "missing"));
+    TEST_ASSERT_NOT_NULL(index_of(object));
+    TEST_ASSERT_EQUAL_PTR(inserted, cJSON_GetObjectItemCaseSensitive(object, "Key50"));
+
+    cJSON_Delete(object);
+}
+
+static void object_index_should_work_on_parsed_objects(void)
+{
+    cJSON *object = create_wide_object(WIDE_OBJECT_SIZE);
+    char *printed = cJSON_PrintUnformatted(object);
+    cJSON *parsed = NULL;
+    cJSON *arena_parsed = NULL;
+
+    TEST_ASSERT_NOT_NULL(printed);
+    parsed = cJSON_Parse(printed);
+    arena_parsed = cJSON_ParseWithArena(printed, NULL, true);
+    TEST_ASSERT_NOT_NULL(parsed);
+    TEST_ASSERT_NOT_NULL(arena_parsed);
+
+    assert_all_keys_found(parsed, WIDE_OBJECT_SIZE);
+    assert_all_keys_found(arena_parsed, WIDE_OBJECT_SIZE);
+    TEST_ASSERT_NOT_NULL(index_of(arena_parsed));
+
+    TEST_ASSERT_TRUE(cJSON_Compare(object, parsed, true));
+    TEST_ASSERT_TRUE(cJSON_Compare(parsed, arena_parsed, false));
+
+    cJSON_Delete(cJSON_DetachItemFromObject(parsed, "Key99"));
+    TEST_ASSERT_FALSE(cJSON_Compare(object, parsed, true));
+
+    cJSON_free(printed);
+    cJSON_Delete(object);
+    cJSON_Delete(parsed);
+    cJSON_ArenaDelete(arena_parsed);
+}
+
+int CJSON_CDECL main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(object_index_should_be_created_for_big_objects);
+    RUN_TEST(object_index_should_not_be_created_for_arrays_and_references);
+    RUN_TEST(object_index_should_return_first_of_duplicate_keys);
+    RUN_TEST(object_index_should_follow_modifications);
+    RUN_TEST(object_index_should_be_dropped_by_insertions);
+    RUN_TEST(object_index_should_work_on_parsed_objects);
+
+    return UNITY_END();
+}
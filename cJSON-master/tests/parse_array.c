@@ -44,7 +44,7 @@ static void assert_is_array(cJSON *array_item)
 
 static void assert_not_array(const char *json)
 {
-    parse_buffer buffer = { 0, 0, 0, 0, { 0, 0, 0 } };
+    parse_buffer buffer = { 0, 0, 0, 0, { 0, 0, 0, NULL }, NULL, NULL, 0, 0, NULL };
     buffer.content = (const unsigned char*)json;
     buffer.length = strlen(json) + sizeof("");
     buffer.hooks = global_hooks;
@@ -55,7 +55,7 @@ static void assert_not_array(const char *json)
 
 static void assert_parse_array(const char *json)
 {
-    parse_buffer buffer = { 0, 0, 0, 0, { 0, 0, 0 } };
+    parse_buffer buffer = { 0, 0, 0, 0, { 0, 0, 0, NULL }, NULL, NULL, 0, 0, NULL };
     buffer.content = (const unsigned char*)json;
     buffer.length = strlen(json) + sizeof("");
     buffer.hooks = global_hooks;
@@ -85,12 +85,15 @@ static void parse_array_should_parse_arrays_with_one_element(void)
     assert_parse_array("[\"hello!\"]");
     assert_has_child(item);
     assert_has_type(item->child, cJSON_String);
-    TEST_ASSERT_EQUAL_STRING("hello!", item->child->valuestring);
+    TEST_ASSERT_EQUAL_STRING("hello!", item_valuestring(item->child));
     reset(item);
 
     assert_parse_array("[[]]");
     assert_has_child(item);
-    assert_is_array(item->child);
+    /* the only element is its own last element */
+    TEST_ASSERT_TRUE(item->child->prev == item->child);
+    TEST_ASSERT_NULL(item->child->next);
+    assert_has_type(item->child, cJSON_Array);
     assert_has_no_child(item->child);
     reset(item);
 
@@ -0,0 +1,218 @@
+/*
+  Copyright (c) 2009-2017 Dave Gamble and cJSON contributors
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "unity/examples/unity_config.h"
+#include "unity/src/unity.h"
+#include "common.h"
+
+typedef struct
+{
+    size_t count;
+    size_t invalid;
+    size_t stop_after;
+    cJSON_bool use_arena;
+    const char *buffer;
+    size_t length;
+} batch_state;
+
+/* every valid record has its index as "id", invalid ones consist of "x" */
+static cJSON_bool CJSON_CDECL check_record(cJSON *item, size_t index, const char *record, size_t record_length, void *context)
+{
+    batch_state *state = (batch_state*)context;
+
+    TEST_ASSERT_EQUAL_UINT((unsigned int)state->count, (unsigned int)index);
+    TEST_ASSERT_TRUE((record >= state->buffer) && ((record + record_length) <= (state->buffer + state->length)));
+    TEST_ASSERT_TRUE(((record + record_length) == (state->buffer + state->length)) || (record[record_length] == '\n'));
+    state->count++;
+
+    if (item == NULL)
+    {
+        TEST_ASSERT_TRUE(record[0] == 'x');
+        state->invalid++;
+    }
+    else
+    {
+        TEST_ASSERT_EQUAL_DOUBLE((double)index, cJSON_GetNumberValue(cJSON_GetObjectItemCaseSensitive(item, "id")));
+        if (state->use_arena)
+        {
+            /* the arena is reused after the call, copies survive it */
+            cJSON *copy = cJSON_Duplicate(item, true);
+            TEST_ASSERT_BITS(cJSON_IsArenaItem, cJSON_IsArenaItem, item->type);
+            TEST_ASSERT_TRUE(cJSON_Compare(item, copy, true));
+            cJSON_Delete(copy);
+        }
+        else
+        {
+            cJSON_Delete(item);
+        }
+    }
+
+    return state->count != state->stop_after;
+}
+
+/* records of different lengths, every seventh one is invalid, every fifth is followed by a blank line */
+static char *create_records(size_t count, size_t *length)
+{
+    char *buffer = (char*)malloc(count * 128);
+    size_t offset = 0;
+    size_t i = 0;
+    TEST_ASSERT_NOT_NULL(buffer);
+
+    for (i = 0; i < count; i++)
+    {
+        if ((i % 7) == 3)
+        {
+            offset += (size_t)sprintf(buffer + offset, "x{\"id\": %u}\n", (unsigned int)i);
+        }
+        else
+        {
+            offset += (size_t)sprintf(buffer + offset, "{\"id\": %u, \"name\": \"record\", \"values\": [%u, true, null]}%s\n", (unsigned int)i, (unsigned int)(i * i), ((i % 3) == 0) ? "\r" : "");
+        }
+        if ((i % 5) == 0)
+        {
+            offset += (size_t)sprintf(buffer + offset, " \t\n");
+        }
+    }
+
+    *length = offset;
+    return buffer;
+}
+
+static void parse_batch_should_deliver_records_in_order(void)
+{
+    const int thread_counts[] = { 0, 1, 2, 3, 8 };
+    size_t length = 0;
+    char *buffer = create_records(20000, &length);
+    size_t i = 0;
+    int use_arena = 0;
+
+    /* the input has to span multiple chunks */
+    TEST_ASSERT_TRUE(length > (4 * 64 * 1024));
+
+    for (use_arena = 0; use_arena <= 1; use_arena++)
+    {
+        for (i = 0; i < (sizeof(thread_counts) / sizeof(thread_counts[0])); i++)
+        {
+            batch_state state;
+            memset(&state, '\0', sizeof(state));
+            state.use_arena = use_arena;
+            state.buffer = buffer;
+            state.length = length;
+
+            TEST_ASSERT_TRUE(cJSON_ParseBatch(buffer, length, thread_counts[i], use_arena, check_record, &state));
+            TEST_ASSERT_EQUAL_UINT(20000, (unsigned int)state.count);
+            TEST_ASSERT_EQUAL_UINT(2857, (unsigned int)state.invalid);
+        }
+    }
+
+    free(buffer);
+}
+
+static void parse_batch_should_handle_long_records_and_missing_newlines(void)
+{
+    const size_t long_length = 200 * 1024;
+    char *buffer = (char*)malloc(long_length + 64);
+    size_t offset = 0;
+    int threads = 0;
+    TEST_ASSERT_NOT_NULL(buffer);
+
+    /* a record that spans several chunks, surrounded by short ones, the last one without a newline */
+    offset += (size_t)sprintf(buffer, "{\"id\": 0}\n{\"id\": 1, \"long\": \"");
+    memset(buffer + offset, 'a', long_length);
+    offset += long_length;
+    offset += (size_t)sprintf(buffer + offset, "\"}\n\n{\"id\": 2}");
+
+    for (threads = 0; threads <= 4; threads += 2)
+    {
+        batch_state state;
+        memset(&state, '\0', sizeof(state));
+        state.buffer = buffer;
+        state.length = offset;
+
+        TEST_ASSERT_TRUE(cJSON_ParseBatch(buffer, offset, threads, false, check_record, &state));
+        TEST_ASSERT_EQUAL_UINT(3, (unsigned int)state.count);
+        TEST_ASSERT_EQUAL_UINT(0, (unsigned int)state.invalid);
+    }
+
+    free(buffer);
+}
+
+static void parse_batch_should_stop_when_the_callback_fails(void)
+{
+    size_t length = 0;
+    char *buffer = create_records(20000, &length);
+    int use_arena = 0;
+
+    for (use_arena = 0; use_arena <= 1; use_arena++)
+    {
+        batch_state state;
+        memset(&state, '\0', sizeof(state));
+        state.use_arena = use_arena;
+        state.buffer = buffer;
+        state.length = length;
+        state.stop_after = 1234;
+
+        /* the records that have already been parsed by other threads are released */
+        TEST_ASSERT_FALSE(cJSON_ParseBatch(buffer, length, 4, use_arena, check_record, &state));
+        TEST_ASSERT_EQUAL_UINT(1234, (unsigned int)state.count);
+
+        memset(&state, '\0', sizeof(state));
+        state.use_arena = use_arena;
+        state.buffer = buffer;
+        state.length = length;
+        state.stop_after = 1234;
+        TEST_ASSERT_FALSE(cJSON_ParseBatch(buffer, length, 0, use_arena, check_record, &state));
+        TEST_ASSERT_EQUAL_UINT(1234, (unsigned int)state.count);
+    }
+
+    free(buffer);
+}
+
+static void parse_batch_should_handle_null_and_empty_input(void)
+{
+    batch_state state;
+    memset(&state, '\0', sizeof(state));
+    state.buffer = "";
+
+    TEST_ASSERT_FALSE(cJSON_ParseBatch(NULL, 1, 2, false, check_record, &state));
+    TEST_ASSERT_FALSE(cJSON_ParseBatch("{}", 2, 2, false, NULL, &state));
+
+    TEST_ASSERT_TRUE(cJSON_ParseBatch(NULL, 0, 2, false, check_record, &state));
+    TEST_ASSERT_TRUE(cJSON_ParseBatch("\n\n  \n", 5, 2, false, check_record, &state));
+    TEST_ASSERT_EQUAL_UINT(0, (unsigned int)state.count);
+}
+
+int CJSON_CDECL main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(parse_batch_should_deliver_records_in_order);
+    RUN_TEST(parse_batch_should_handle_long_records_and_missing_newlines);
+    RUN_TEST(parse_batch_should_stop_when_the_callback_fails);
+    RUN_TEST(parse_batch_should_handle_null_and_empty_input);
+
+    return UNITY_END();
+}
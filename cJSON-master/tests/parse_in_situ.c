@@ -0,0 +1,154 @@
+/*
+  Copyright (c) 2009-2017 Dave Gamble and cJSON contributors
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "unity/examples/unity_config.h"
+#include "unity/src/unity.h"
+#include "common.h"
+
+static void parse_in_situ_should_parse_like_parse(void)
+{
+    const char *files[] = { "inputs/test1", "inputs/test2", "inputs/test3", "inputs/test4", "inputs/test5", "inputs/test7", "inputs/test8", "inputs/test9", "inputs/test10", "inputs/test11" };
+    size_t i = 0;
+
+    for (i = 0; i < (sizeof(files) / sizeof(files[0])); i++)
+    {
+        char *content = read_file(files[i]);
+        cJSON *expected = NULL;
+        cJSON *actual = NULL;
+        TEST_ASSERT_NOT_NULL(content);
+
+        expected = cJSON_Parse(content);
+        actual = cJSON_ParseInSitu(content);
+        TEST_ASSERT_NOT_NULL(expected);
+        TEST_ASSERT_NOT_NULL(actual);
+        TEST_ASSERT_TRUE_MESSAGE(cJSON_Compare(expected, actual, true), files[i]);
+
+        cJSON_Delete(expected);
+        cJSON_Delete(actual);
+        free(content);
+    }
+}
+
+static void parse_in_situ_should_point_into_the_buffer(void)
+{
+    char json[] = "{\"key\": \"value\", \"escaped\\tkey\": \"a\\\"b\\u00e4\\ud83d\\ude00c\", \"array\": [\"\", 1]}";
+    cJSON *tree = cJSON_ParseInSitu(json);
+    cJSON *value = NULL;
+    TEST_ASSERT_NOT_NULL(tree);
+    assert_has_type(tree, cJSON_Object);
+
+    value = cJSON_GetObjectItemCaseSensitive(tree, "key");
+    TEST_ASSERT_NOT_NULL(value);
+    TEST_ASSERT_EQUAL_STRING("value", item_valuestring(value));
+    TEST_ASSERT_BITS(cJSON_IsReference | cJSON_StringIsConst, cJSON_IsReference | cJSON_StringIsConst, value->type);
+    TEST_ASSERT_TRUE((value->string >= json) && (value->string < (json + sizeof(json))));
+    TEST_ASSERT_TRUE((item_valuestring(value) >= json) && (item_valuestring(value) < (json + sizeof(json))));
+
+    value = cJSON_GetObjectItemCaseSensitive(tree, "escaped\tkey");
+    TEST_ASSERT_NOT_NULL(value);
+    TEST_ASSERT_EQUAL_STRING("a\"b\xc3\xa4\xf0\x9f\x98\x80" "c", item_valuestring(value));
+
+    value = cJSON_GetObjectItemCaseSensitive(tree, "array");
+    TEST_ASSERT_NOT_NULL(value);
+    TEST_ASSERT_BITS(cJSON_IsReference, 0, value->type);
+    TEST_ASSERT_EQUAL_STRING("", item_valuestring(cJSON_GetArrayItem(value, 0)));
+    TEST_ASSERT_EQUAL_DOUBLE(1, item_number(cJSON_GetArrayItem(value, 1)));
+
+    cJSON_Delete(tree);
+}
+
+static void parse_in_situ_should_not_allocate_strings(void)
+{
+    char json[] = "{\"one\": \"1\", \"two\": [\"2\", \"3\"], \"three\": {\"four\": \"4\"}}";
+    cJSON *tree = NULL;
+
+    use_counting_hooks();
+    tree = cJSON_ParseInSitu(json);
+    TEST_ASSERT_NOT_NULL(tree);
+    /* one allocation per item, none for keys and strings */
+    TEST_ASSERT_EQUAL_UINT(7, allocations);
+
+    cJSON_Delete(tree);
+    cJSON_InitHooks(NULL);
+}
+
+static void parse_in_situ_should_allow_modifications(void)
+{
+    char json[] = "{\"a\": \"string\", \"b\": [\"x\", \"y\"]}";
+    cJSON *tree = cJSON_ParseInSitu(json);
+    cJSON *copy = NULL;
+    char *printed = NULL;
+    TEST_ASSERT_NOT_NULL(tree);
+
+    cJSON_ReplaceItemInObjectCaseSensitive(tree, "a", cJSON_CreateString("replaced"));
+    cJSON_DeleteItemFromArray(cJSON_GetObjectItemCaseSensitive(tree, "b"), 0);
+    cJSON_AddItemToArray(cJSON_GetObjectItemCaseSensitive(tree, "b"), cJSON_CreateString("z"));
+
+    copy = cJSON_Duplicate(tree, true);
+    TEST_ASSERT_NOT_NULL(copy);
+    TEST_ASSERT_BITS(cJSON_IsReference, 0, cJSON_GetArrayItem(cJSON_GetObjectItemCaseSensitive(copy, "b"), 0)->type);
+
+    printed = cJSON_PrintUnformatted(tree);
+    TEST_ASSERT_EQUAL_STRING("{\"a\":\"replaced\",\"b\":[\"y\",\"z\"]}", printed);
+    cJSON_free(printed);
+
+    cJSON_Delete(tree);
+    cJSON_Delete(copy);
+}
+
+static void parse_in_situ_should_handle_errors(void)
+{
+    char json[] = "{\"key\": [1, 2, \"unterminated]}";
+    const char *expected_error = NULL;
+
+    TEST_ASSERT_NULL(cJSON_ParseInSitu(NULL));
+
+    TEST_ASSERT_NULL(cJSON_Parse(json));
+    expected_error = cJSON_GetErrorPtr();
+    TEST_ASSERT_NULL(cJSON_ParseInSitu(json));
+    TEST_ASSERT_EQUAL_PTR(expected_error, cJSON_GetErrorPtr());
+
+    {
+        /* the failing item already has a key that points into the buffer */
+        char missing_colon[] = "{\"a\": \"b\", \"key\" 1}";
+        char missing_value[] = "[\"a\", {\"key\": }]";
+        TEST_ASSERT_NULL(cJSON_ParseInSitu(missing_colon));
+        TEST_ASSERT_NULL(cJSON_ParseInSitu(missing_value));
+    }
+}
+
+int CJSON_CDECL main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(parse_in_situ_should_parse_like_parse);
+    RUN_TEST(parse_in_situ_should_point_into_the_buffer);
+    RUN_TEST(parse_in_situ_should_not_allocate_strings);
+    RUN_TEST(parse_in_situ_should_allow_modifications);
+    RUN_TEST(parse_in_situ_should_handle_errors);
+
+    return UNITY_END();
+}
@@ -0,0 +1,210 @@
+/*
+  Copyright (c) 2009-2017 Dave Gamble and cJSON contributors
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "unity/examples/unity_config.h"
+#include "unity/src/unity.h"
+#include "common.h"
+
+static const char document[] = "{\"a\":{\"b\":[1,2,{\"c\":3}],\"s\":\"]}\\\"[{\"},\"d\":[true,null],\"e\":\"text\"}";
+
+static void parse_lazy_should_skip_nested_arrays_and_objects(void)
+{
+    cJSON *tree = cJSON_ParseLazy(document, NULL, true, 1);
+    cJSON *a = NULL;
+    cJSON *b = NULL;
+    cJSON *c = NULL;
+
+    TEST_ASSERT_NOT_NULL(tree);
+    TEST_ASSERT_FALSE(tree->type & cJSON_IsLazy);
+
+    a = tree->child;
+    TEST_ASSERT_TRUE(cJSON_IsObject(a));
+    TEST_ASSERT_TRUE(a->type & cJSON_IsLazy);
+    TEST_ASSERT_NULL(a->child);
+    TEST_ASSERT_TRUE(a->next->type & cJSON_IsLazy);
+    TEST_ASSERT_EQUAL_STRING("text", cJSON_GetStringValue(a->next->next));
+
+    /* one level at a time */
+    b = cJSON_GetObjectItemCaseSensitive(a, "b");
+    TEST_ASSERT_FALSE(a->type & cJSON_IsLazy);
+    TEST_ASSERT_TRUE(cJSON_IsArray(b));
+    TEST_ASSERT_TRUE(b->type & cJSON_IsLazy);
+    TEST_ASSERT_EQUAL_STRING("]}\"[{", cJSON_GetStringValue(cJSON_GetObjectItemCaseSensitive(a, "s")));
+
+    TEST_ASSERT_EQUAL_INT(3, cJSON_GetArraySize(b));
+    c = cJSON_GetArrayItem(b, 2);
+    TEST_ASSERT_TRUE(c->type & cJSON_IsLazy);
+    TEST_ASSERT_EQUAL_DOUBLE(3.0, cJSON_GetNumberValue(cJSON_GetObjectItemCaseSensitive(c, "c")));
+
+    cJSON_Delete(tree);
+}
+
+static void parse_lazy_should_respect_depth(void)
+{
+    cJSON *tree = cJSON_ParseLazy(document, NULL, true, 2);
+    cJSON *a = NULL;
+
+    TEST_ASSERT_NOT_NULL(tree);
+    a = tree->child;
+    TEST_ASSERT_FALSE(a->type & cJSON_IsLazy);
+    TEST_ASSERT_TRUE(a->child->type & cJSON_IsLazy);
+    TEST_ASSERT_FALSE(a->child->next->type & cJSON_IsLazy);
+
+    cJSON_Delete(tree);
+}
+
+static void lazy_trees_should_print_compare_and_duplicate_like_parsed_ones(void)
+{
+    cJSON *tree = cJSON_ParseLazy(document, NULL, true, 1);
+    cJSON *other_tree = cJSON_ParseLazy(document, NULL, true, 1);
+    cJSON *parsed = cJSON_Parse(document);
+    cJSON *copy = NULL;
+    cJSON *element = NULL;
+    char *printed = NULL;
+    char *expected = NULL;
+    int count = 0;
+
+    TEST_ASSERT_NOT_NULL(tree);
+    TEST_ASSERT_NOT_NULL(other_tree);
+    TEST_ASSERT_NOT_NULL(parsed);
+
+    cJSON_ArrayForEach(element, cJSON_GetObjectItemCaseSensitive(tree, "d"))
+    {
+        count++;
+    }
+    TEST_ASSERT_EQUAL_INT(2, count);
+
+    copy = cJSON_Duplicate(tree, true);
+    TEST_ASSERT_NOT_NULL(copy);
+    TEST_ASSERT_TRUE(cJSON_Compare(parsed, copy, true));
+    TEST_ASSERT_TRUE(cJSON_Compare(other_tree, parsed, true));
+
+    printed = cJSON_Print(copy);
+    expected = cJSON_Print(parsed);
+    TEST_ASSERT_EQUAL_STRING(expected, printed);
+
+    cJSON_free(printed);
+    cJSON_free(expected);
+    cJSON_Delete(copy);
+    cJSON_Delete(other_tree);
+    cJSON_Delete(parsed);
+    cJSON_Delete(tree);
+}
+
+static void lazy_trees_should_print_without_being_accessed(void)
+{
+    cJSON *tree = cJSON_ParseLazy(document, NULL, true, 1);
+    char *printed = NULL;
+
+    TEST_ASSERT_NOT_NULL(tree);
+    printed = cJSON_PrintUnformatted(tree);
+    TEST_ASSERT_EQUAL_STRING("{\"a\":{\"b\":[1,2,{\"c\":3}],\"s\":\"]}\\\"[{\"},\"d\":[true,null],\"e\":\"text\"}", printed);
+
+    cJSON_free(printed);
+    cJSON_Delete(tree);
+}
+
+static void lazy_items_should_be_checked_when_they_are_accessed(void)
+{
+    cJSON *tree = cJSON_ParseLazy("{\"valid\":[1],\"invalid\":[1,,2],\"mismatched\":[1}}", NULL, true, 1);
+    cJSON *invalid = NULL;
+
+    TEST_ASSERT_NOT_NULL(tree);
+    TEST_ASSERT_NOT_NULL(cJSON_GetArrayItem(cJSON_GetObjectItemCaseSensitive(tree, "valid"), 0));
+
+    invalid = cJSON_GetObjectItemCaseSensitive(tree, "invalid");
+    TEST_ASSERT_NULL(cJSON_GetArrayItem(invalid, 0));
+    TEST_ASSERT_FALSE(cJSON_Materialize(invalid));
+    TEST_ASSERT_TRUE(invalid->type & cJSON_IsLazy);
+    TEST_ASSERT_NULL(cJSON_PrintUnformatted(tree));
+
+    TEST_ASSERT_FALSE(cJSON_Materialize(cJSON_GetObjectItemCaseSensitive(tree, "mismatched")));
+
+    cJSON_Delete(tree);
+}
+
+static void parse_lazy_should_fail_on_unbalanced_brackets(void)
+{
+    const char *parse_end = NULL;
+    TEST_ASSERT_NULL(cJSON_ParseLazy("{\"a\":[1,2}", &parse_end, true, 1));
+    TEST_ASSERT_NULL(cJSON_ParseLazy("{\"a\":[1,\"]\"", &parse_end, true, 1));
+    TEST_ASSERT_NULL(cJSON_ParseLazy("{\"a\":{\"b\":\"\\\"}", &parse_end, true, 1));
+}
+
+static void parse_lazy_should_limit_nesting(void)
+{
+    char deep[(CJSON_NESTING_LIMIT + 1) * 2 + 1];
+    cJSON *tree = NULL;
+    cJSON *item = NULL;
+    size_t i = 0;
+
+    for (i = 0; i < (CJSON_NESTING_LIMIT + 1); i++)
+    {
+        deep[i] = '[';
+        deep[(CJSON_NESTING_LIMIT + 1) * 2 - 1 - i] = ']';
+    }
+    deep[sizeof(deep) - 1] = '\0';
+
+    TEST_ASSERT_NULL(cJSON_ParseLazy(deep, NULL, true, 1));
+    TEST_ASSERT_NULL(cJSON_ParseLazy(deep, NULL, true, 100));
+
+    /* the nesting is counted from the top even though every level is parsed on its own */
+    deep[(CJSON_NESTING_LIMIT + 1) * 2 - 1] = '\0';
+    tree = cJSON_ParseLazy(deep + 1, NULL, true, 1);
+    TEST_ASSERT_NOT_NULL(tree);
+    for (item = tree, i = 1; cJSON_GetArrayItem(item, 0) != NULL; item = cJSON_GetArrayItem(item, 0))
+    {
+        i++;
+    }
+    TEST_ASSERT_EQUAL_UINT(CJSON_NESTING_LIMIT, (unsigned int)i);
+    cJSON_Delete(tree);
+}
+
+static void materialize_should_accept_other_items(void)
+{
+    cJSON *number = cJSON_CreateNumber(1);
+
+    TEST_ASSERT_FALSE(cJSON_Materialize(NULL));
+    TEST_ASSERT_TRUE(cJSON_Materialize(number));
+
+    cJSON_Delete(number);
+}
+
+int CJSON_CDECL main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(parse_lazy_should_skip_nested_arrays_and_objects);
+    RUN_TEST(parse_lazy_should_respect_depth);
+    RUN_TEST(lazy_trees_should_print_compare_and_duplicate_like_parsed_ones);
+    RUN_TEST(lazy_trees_should_print_without_being_accessed);
+    RUN_TEST(lazy_items_should_be_checked_when_they_are_accessed);
+    RUN_TEST(parse_lazy_should_fail_on_unbalanced_brackets);
+    RUN_TEST(parse_lazy_should_limit_nesting);
+    RUN_TEST(materialize_should_accept_other_items);
+
+    return UNITY_END();
+}
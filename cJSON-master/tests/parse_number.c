@@ -45,14 +45,14 @@ static void assert_is_number(cJSON *number_item)
 
 static void assert_parse_number(const char *string, int integer, double real)
 {
-    parse_buffer buffer = { 0, 0, 0, 0, { 0, 0, 0 } };
+    parse_buffer buffer = { 0, 0, 0, 0, { 0, 0, 0, NULL }, NULL, NULL, 0, 0, NULL };
     buffer.content = (const unsigned char*)string;
     buffer.length = strlen(string) + sizeof("");
 
     TEST_ASSERT_TRUE(parse_number(item, &buffer));
     assert_is_number(item);
     TEST_ASSERT_EQUAL_INT(integer, item->valueint);
-    TEST_ASSERT_EQUAL_DOUBLE(real, item->valuedouble);
+    TEST_ASSERT_EQUAL_DOUBLE(real, item_number(item));
 }
 
 static void parse_number_should_parse_zero(void)
@@ -96,6 +96,74 @@ static void parse_number_should_parse_negative_reals(void)
     assert_parse_number("-123e-128", 0, -123e-128);
 }
 
+static void parse_number_should_fall_back_to_strtod(void)
+{
+    /* too many digits or a too big exponent for the fast path */
+    assert_parse_number("1234567890123456789", INT_MAX, 1234567890123456789.0);
+    assert_parse_number("0.1000000000000000055511151231257827", 0, 0.1);
+    assert_parse_number("1e-300", 0, 1e-300);
+    assert_parse_number("2.2250738585072014e-308", 0, 2.2250738585072014e-308);
+    assert_parse_number("1e23", INT_MAX, 1e23);
+    assert_parse_number("123456e20", INT_MAX, 123456e20);
+
+    /* not strictly JSON, but always accepted */
+    assert_parse_number("01", 1, 1);
+    assert_parse_number("1.", 1, 1);
+    assert_parse_number("1e", 1, 1);
+}
+
+static unsigned long random_state = 1;
+
+/* linear congruential generator, so the test is the same on every platform */
+static unsigned long random_number(unsigned long limit)
+{
+    random_state = ((random_state * 1103515245UL) + 12345UL) & 0xFFFFFFFFUL;
+    return (random_state >> 8) % limit;
+}
+
+static void parse_number_should_parse_like_strtod(void)
+{
+    char number[64];
+    size_t i = 0;
+
+    for (i = 0; i < 100000; i++)
+    {
+        parse_buffer buffer = { 0, 0, 0, 0, { 0, 0, 0, NULL }, NULL, NULL, 0, 0, NULL };
+        double expected = 0;
+        size_t digits = 1 + random_number(18);
+        size_t decimal_point = random_number(digits + 1);
+        size_t length = 0;
+        size_t digit = 0;
+
+        if (random_number(2) == 0)
+        {
+            number[length++] = '-';
+        }
+        for (digit = 0; digit < digits; digit++)
+        {
+            if ((digit == decimal_point) && (digit != 0))
+            {
+                number[length++] = '.';
+            }
+            /* no leading zeros */
+            number[length++] = (char)(((digit == 0) ? '1' : '0') + random_number((digit == 0) ? 9 : 10));
+        }
+        if (random_number(2) == 0)
+        {
+            length += (size_t)sprintf(number + length, "e%d", (int)random_number(80) - 40);
+        }
+        number[length] = '\0';
+
+        buffer.content = (const unsigned char*)number;
+        buffer.length = length + sizeof("");
+        TEST_ASSERT_TRUE(parse_number(item, &buffer));
+        TEST_ASSERT_EQUAL_UINT(length, buffer.offset);
+
+        expected = strtod(number, NULL);
+        TEST_ASSERT_EQUAL_MEMORY_MESSAGE(&expected, &item_number(item), sizeof(expected), number);
+    }
+}
+
 int CJSON_CDECL main(void)
 {
     /* initialize cJSON item */
@@ -106,5 +174,7 @@ int CJSON_CDECL main(void)
     RUN_TEST(parse_number_should_parse_positive_integers);
     RUN_TEST(parse_number_should_parse_positive_reals);
     RUN_TEST(parse_number_should_parse_negative_reals);
+    RUN_TEST(parse_number_should_fall_back_to_strtod);
+    RUN_TEST(parse_number_should_parse_like_strtod);
     return UNITY_END();
 }
@@ -0,0 +1,335 @@
+/*
+  Copyright (c) 2009-2017 Dave Gamble and cJSON contributors
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "unity/examples/unity_config.h"
+#include "unity/src/unity.h"
+#include "common.h"
+
+static void assert_is_packed(const cJSON *item, int count)
+{
+    TEST_ASSERT_NOT_NULL(item);
+    TEST_ASSERT_TRUE(cJSON_IsArray(item));
+    TEST_ASSERT_TRUE(item->type & cJSON_IsPacked);
+    TEST_ASSERT_TRUE(item->type & cJSON_IsLazy);
+    TEST_ASSERT_NULL(item->child);
+    TEST_ASSERT_EQUAL_INT(count, cJSON_GetArraySize(item));
+}
+
+static void assert_prints_like_parse(const char *json)
+{
+    cJSON *packed = cJSON_ParsePacked(json, NULL, true);
+    cJSON *tree = cJSON_Parse(json);
+    char *packed_printed = NULL;
+    char *printed = NULL;
+
+    TEST_ASSERT_NOT_NULL_MESSAGE(packed, json);
+    TEST_ASSERT_NOT_NULL(tree);
+
+    packed_printed = cJSON_PrintUnformatted(packed);
+    printed = cJSON_PrintUnformatted(tree);
+    TEST_ASSERT_EQUAL_STRING(printed, packed_printed);
+    cJSON_free(packed_printed);
+    cJSON_free(printed);
+
+    packed_printed = cJSON_Print(packed);
+    printed = cJSON_Print(tree);
+    TEST_ASSERT_EQUAL_STRING(printed, packed_printed);
+    cJSON_free(packed_printed);
+    cJSON_free(printed);
+
+    TEST_ASSERT_TRUE(cJSON_Compare(packed, tree, true));
+    TEST_ASSERT_TRUE(cJSON_Compare(tree, packed, true));
+
+    cJSON_Delete(packed);
+    cJSON_Delete(tree);
+}
+
+static void parse_packed_should_pack_arrays_of_numbers(void)
+{
+    cJSON *tree = cJSON_ParsePacked("{\"a\":[1, -2.5e3 ,0.1],\"b\":[],\"c\":[1,\"x\"],\"d\":[[1],[2,3]]}", NULL, true);
+    cJSON *d = NULL;
+    TEST_ASSERT_NOT_NULL(tree);
+
+    assert_is_packed(cJSON_GetObjectItem(tree, "a"), 3);
+    TEST_ASSERT_FALSE(cJSON_GetObjectItem(tree, "b")->type & cJSON_IsPacked);
+    TEST_ASSERT_FALSE(cJSON_GetObjectItem(tree, "c")->type & cJSON_IsPacked);
+    d = cJSON_GetObjectItem(tree, "d");
+    TEST_ASSERT_FALSE(d->type & cJSON_IsPacked);
+    assert_is_packed(d->child, 1);
+    assert_is_packed(d->child->next, 2);
+
+    cJSON_Delete(tree);
+
+    tree = cJSON_ParsePacked("[1,2,3]", NULL, true);
+    assert_is_packed(tree, 3);
+    cJSON_Delete(tree);
+}
+
+static void parse_packed_should_print_like_parse(void)
+{
+    const char *files[] = { "inputs/test1", "inputs/test2", "inputs/test3", "inputs/test4", "inputs/test5", "inputs/test7", "inputs/test8", "inputs/test9", "inputs/test10", "inputs/test11" };
+    size_t i = 0;
+
+    assert_prints_like_parse("[1,2.5,-3e-7,1e300,0,-0.0,123456789012]");
+    assert_prints_like_parse("{\"a\":[1,2],\"b\":{\"c\":[[3],[4,5]]},\"d\":[6,\"e\"]}");
+    for (i = 0; i < (sizeof(files) / sizeof(files[0])); i++)
+    {
+        char *content = read_file(files[i]);
+        TEST_ASSERT_NOT_NULL(content);
+        assert_prints_like_parse(content);
+        free(content);
+    }
+}
+
+static void parse_packed_should_fail_like_parse(void)
+{
+    const char *documents[] = { "[1,2,", "[1,2", "[1, x]", "[1,,2]", "[1 2]", "[-]", "[1,2]x", "[1,2,\"a\"", "[1,\"a\",2", "[1,2,\"a\",]" };
+    size_t i = 0;
+
+    for (i = 0; i < (sizeof(documents) / sizeof(documents[0])); i++)
+    {
+        const char *parse_end = NULL;
+        const char *packed_end = NULL;
+
+        TEST_ASSERT_NULL(cJSON_ParseWithOpts(documents[i], &parse_end, true));
+        TEST_ASSERT_NULL_MESSAGE(cJSON_ParsePacked(documents[i], &packed_end, true), documents[i]);
+        TEST_ASSERT_TRUE_MESSAGE(parse_end == packed_end, documents[i]);
+    }
+}
+
+static void get_double_array_should_not_unpack(void)
+{
+    double numbers[4] = { 0, 0, 0, 0 };
+    cJSON *packed = cJSON_ParsePacked("[1,2.5,-3]", NULL, true);
+
+    TEST_ASSERT_TRUE(cJSON_GetDoubleArray(packed, numbers, 3));
+    TEST_ASSERT_TRUE(numbers[0] == 1.0);
+    TEST_ASSERT_TRUE(numbers[1] == 2.5);
+    TEST_ASSERT_TRUE(numbers[2] == -3.0);
+    TEST_ASSERT_TRUE(cJSON_GetDoubleArray(packed, numbers, 0));
+    TEST_ASSERT_FALSE(cJSON_GetDoubleArray(packed, numbers, 4));
+    assert_is_packed(packed, 3);
+    cJSON_Delete(packed);
+}
+
+static void get_double_array_should_read_normal_arrays(void)
+{
+    double numbers[3] = { 0, 0, 0 };
+    cJSON *array = cJSON_Parse("[4,5,\"six\"]");
+    cJSON *object = cJSON_Parse("{\"a\":1}");
+
+    TEST_ASSERT_TRUE(cJSON_GetDoubleArray(array, numbers, 2));
+    TEST_ASSERT_TRUE(numbers[0] == 4.0);
+    TEST_ASSERT_TRUE(numbers[1] == 5.0);
+    TEST_ASSERT_FALSE(cJSON_GetDoubleArray(array, numbers, 3));
+    TEST_ASSERT_FALSE(cJSON_GetDoubleArray(object, numbers, 1));
+    TEST_ASSERT_FALSE(cJSON_GetDoubleArray(NULL, numbers, 1));
+    TEST_ASSERT_FALSE(cJSON_GetDoubleArray(array, NULL, 1));
+
+    cJSON_Delete(array);
+    cJSON_Delete(object);
+}
+
+static void packed_arrays_should_unpack_when_items_are_needed(void)
+{
+    cJSON *packed = cJSON_ParsePacked("[1,2,3e10]", NULL, true);
+    cJSON *element = NULL;
+    int count = 0;
+
+    element = cJSON_GetArrayItem(packed, 2);
+    TEST_ASSERT_NOT_NULL(element);
+    TEST_ASSERT_FALSE(packed->type & (cJSON_IsPacked | cJSON_IsLazy));
+    TEST_ASSERT_TRUE(cJSON_GetNumberValue(element) == 3e10);
+    TEST_ASSERT_EQUAL_INT(INT_MAX, element->valueint);
+    TEST_ASSERT_EQUAL_INT(3, cJSON_GetArraySize(packed));
+    TEST_ASSERT_TRUE(packed->child->prev == element);
+    cJSON_Delete(packed);
+
+    packed = cJSON_ParsePacked("[1,2,3]", NULL, true);
+    cJSON_ArrayForEach(element, packed)
+    {
+        count++;
+        TEST_ASSERT_EQUAL_INT(count, element->valueint);
+    }
+    TEST_ASSERT_EQUAL_INT(3, count);
+    cJSON_Delete(packed);
+
+    packed = cJSON_ParsePacked("[1,2,3]", NULL, true);
+    cJSON_AddItemToArray(packed, cJSON_CreateString("four"));
+    TEST_ASSERT_EQUAL_INT(4, cJSON_GetArraySize(packed));
+    cJSON_DeleteItemFromArray(packed, 0);
+    TEST_ASSERT_EQUAL_INT(2, cJSON_GetArrayItem(packed, 0)->valueint);
+    cJSON_Delete(packed);
+}
+
+static void packed_arrays_should_be_duplicated_and_compared(void)
+{
+    double numbers[] = { 1, 2, 3.5 };
+    cJSON *packed = cJSON_CreatePackedDoubleArray(numbers, 3);
+    cJSON *normal = cJSON_CreateDoubleArray(numbers, 3);
+    cJSON *copy = NULL;
+
+    assert_is_packed(packed, 3);
+    copy = cJSON_Duplicate(packed, true);
+    assert_is_packed(copy, 3);
+    TEST_ASSERT_TRUE(cJSON_Compare(packed, copy, true));
+    TEST_ASSERT_TRUE(cJSON_Compare(normal, copy, true));
+    assert_is_packed(packed, 3);
+    cJSON_Delete(copy);
+
+    copy = cJSON_Duplicate(packed, false);
+    TEST_ASSERT_TRUE(cJSON_IsArray(copy));
+    TEST_ASSERT_FALSE(copy->type & (cJSON_IsPacked | cJSON_IsLazy));
+    TEST_ASSERT_EQUAL_INT(0, cJSON_GetArraySize(copy));
+    cJSON_Delete(copy);
+
+    numbers[2] = 4;
+    copy = cJSON_CreatePackedDoubleArray(numbers, 3);
+    TEST_ASSERT_FALSE(cJSON_Compare(packed, copy, true));
+    cJSON_Delete(copy);
+    copy = cJSON_CreatePackedDoubleArray(numbers, 2);
+    TEST_ASSERT_FALSE(cJSON_Compare(packed, copy, true));
+    cJSON_Delete(copy);
+
+    copy = cJSON_CreatePackedDoubleArray(numbers, 0);
+    TEST_ASSERT_TRUE(cJSON_IsArray(copy));
+    TEST_ASSERT_FALSE(copy->type & cJSON_IsPacked);
+    cJSON_Delete(copy);
+    TEST_ASSERT_NULL(cJSON_CreatePackedDoubleArray(NULL, 1));
+    TEST_ASSERT_NULL(cJSON_CreatePackedDoubleArray(numbers, -1));
+
+    cJSON_Delete(packed);
+    cJSON_Delete(normal);
+}
+
+static void references_to_packed_arrays_should_share_the_items(void)
+{
+    double numbers[] = { 1, 2 };
+    cJSON *packed = cJSON_CreatePackedDoubleArray(numbers, 2);
+    cJSON *holder = cJSON_CreateArray();
+    char *printed = NULL;
+
+    cJSON_AddItemReferenceToArray(holder, packed);
+    TEST_ASSERT_FALSE(packed->type & cJSON_IsPacked);
+    printed = cJSON_PrintUnformatted(holder);
+    TEST_ASSERT_EQUAL_STRING("[[1,2]]", printed);
+
+    cJSON_free(printed);
+    cJSON_Delete(holder);
+    cJSON_Delete(packed);
+}
+
+static void packed_arrays_should_print_as_cbor(void)
+{
+    cJSON *packed = cJSON_ParsePacked("[1,1.5,-2]", NULL, true);
+    cJSON *tree = cJSON_Parse("[1,1.5,-2]");
+    unsigned char *packed_cbor = NULL;
+    unsigned char *cbor = NULL;
+    size_t packed_length = 0;
+    size_t length = 0;
+
+    packed_cbor = cJSON_PrintCBOR(packed, &packed_length);
+    cbor = cJSON_PrintCBOR(tree, &length);
+    TEST_ASSERT_NOT_NULL(packed_cbor);
+    TEST_ASSERT_NOT_NULL(cbor);
+    TEST_ASSERT_EQUAL_UINT((unsigned int)length, (unsigned int)packed_length);
+    TEST_ASSERT_EQUAL_MEMORY(cbor, packed_cbor, length);
+    assert_is_packed(packed, 3);
+
+    cJSON_free(packed_cbor);
+    cJSON_free(cbor);
+    cJSON_Delete(packed);
+    cJSON_Delete(tree);
+}
+
+static void parse_packed_should_keep_the_numbers_in_front_of_other_elements(void)
+{
+    cJSON *array = cJSON_ParsePacked("[1, 2.5 ,\"x\",3,[4]]", NULL, true);
+    cJSON *child = NULL;
+
+    TEST_ASSERT_NOT_NULL(array);
+    TEST_ASSERT_FALSE(array->type & (cJSON_IsPacked | cJSON_IsLazy));
+    TEST_ASSERT_EQUAL_INT(5, cJSON_GetArraySize(array));
+
+    child = array->child;
+    TEST_ASSERT_TRUE(cJSON_IsNumber(child));
+    TEST_ASSERT_EQUAL_DOUBLE(1.0, cJSON_GetNumberValue(child));
+    TEST_ASSERT_EQUAL_DOUBLE(2.5, cJSON_GetNumberValue(child->next));
+    TEST_ASSERT_TRUE(child->next->prev == child);
+    TEST_ASSERT_EQUAL_STRING("x", cJSON_GetStringValue(child->next->next));
+    TEST_ASSERT_TRUE(child->next->next->prev == child->next);
+    TEST_ASSERT_EQUAL_DOUBLE(3.0, cJSON_GetNumberValue(child->next->next->next));
+    assert_is_packed(child->prev, 1);
+    TEST_ASSERT_TRUE(child->prev == child->next->next->next->next);
+
+    cJSON_Delete(array);
+
+    assert_prints_like_parse("[0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17,18,19,null,true]");
+}
+
+static void parse_packed_should_allocate_once_per_array(void)
+{
+    char json[4096];
+    size_t length = 0;
+    cJSON *packed = NULL;
+    int i = 0;
+
+    json[length++] = '[';
+    for (i = 0; i < 500; i++)
+    {
+        length += (size_t)sprintf(json + length, "%d,", i);
+    }
+    json[length - 1] = ']';
+    json[length] = '\0';
+
+    use_counting_hooks();
+    packed = cJSON_ParsePacked(json, NULL, true);
+    cJSON_InitHooks(NULL);
+
+    assert_is_packed(packed, 500);
+    /* the item and the numbers, without realloc they grow by doubling from 16 to 512 */
+    TEST_ASSERT_EQUAL_UINT(7U, (unsigned int)allocations);
+    cJSON_Delete(packed);
+}
+
+int CJSON_CDECL main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(parse_packed_should_pack_arrays_of_numbers);
+    RUN_TEST(parse_packed_should_print_like_parse);
+    RUN_TEST(parse_packed_should_fail_like_parse);
+    RUN_TEST(get_double_array_should_not_unpack);
+    RUN_TEST(get_double_array_should_read_normal_arrays);
+    RUN_TEST(packed_arrays_should_unpack_when_items_are_needed);
+    RUN_TEST(packed_arrays_should_be_duplicated_and_compared);
+    RUN_TEST(references_to_packed_arrays_should_share_the_items);
+    RUN_TEST(packed_arrays_should_print_as_cbor);
+    RUN_TEST(parse_packed_should_keep_the_numbers_in_front_of_other_elements);
+    RUN_TEST(parse_packed_should_allocate_once_per_array);
+
+    return UNITY_END();
+}
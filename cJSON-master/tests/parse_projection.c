@@ -0,0 +1,282 @@
+/*
+  Copyright (c) 2009-2017 Dave Gamble and cJSON contributors
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "unity/examples/unity_config.h"
+#include "unity/src/unity.h"
+#include "common.h"
+
+static void assert_projection(const char *json, const char * const *pointers, size_t count, cJSON_bool case_sensitive, const char *expected)
+{
+    cJSON *results[8];
+    cJSON *projection = NULL;
+    char *printed = NULL;
+
+    TEST_ASSERT_TRUE(count <= (sizeof(results) / sizeof(results[0])));
+    projection = cJSON_ParseProjection(json, pointers, count, case_sensitive, results);
+    TEST_ASSERT_NOT_NULL_MESSAGE(projection, json);
+    printed = cJSON_PrintUnformatted(projection);
+    TEST_ASSERT_NOT_NULL(printed);
+    TEST_ASSERT_EQUAL_STRING(expected, printed);
+
+    cJSON_free(printed);
+    cJSON_Delete(projection);
+}
+
+/* the results have to be equal to what cJSONUtils_GetPointer finds in the whole document */
+static void assert_same_results(const char *json, const char * const *pointers, size_t count, cJSON_bool case_sensitive, const char * const *expected)
+{
+    cJSON *results[8];
+    cJSON *projection = NULL;
+    size_t i = 0;
+
+    TEST_ASSERT_TRUE(count <= (sizeof(results) / sizeof(results[0])));
+    projection = cJSON_ParseProjection(json, pointers, count, case_sensitive, results);
+    TEST_ASSERT_NOT_NULL_MESSAGE(projection, json);
+    for (i = 0; i < count; i++)
+    {
+        if (expected[i] == NULL)
+        {
+            TEST_ASSERT_NULL_MESSAGE(results[i], pointers[i]);
+        }
+        else
+        {
+            char *printed = cJSON_PrintUnformatted(results[i]);
+            TEST_ASSERT_NOT_NULL_MESSAGE(printed, pointers[i]);
+            TEST_ASSERT_EQUAL_STRING_MESSAGE(expected[i], printed, pointers[i]);
+            cJSON_free(printed);
+        }
+    }
+
+    cJSON_Delete(projection);
+}
+
+static void parse_projection_should_keep_only_selected_values(void)
+{
+    const char json[] = "{\"a\":{\"b\":1,\"c\":[1,2]},\"d\":[true,{\"e\":\"x\",\"f\":null},false],\"g\":\"skipped\"}";
+    const char *ab[] = { "/a/b" };
+    const char *d1e[] = { "/d/1/e" };
+    const char *several[] = { "/g", "/a/c/1", "/d/2" };
+    const char *none[] = { "/missing", "/a/b/c", "/d/3", "/d/01", "/d/-" };
+    const char *whole[] = { "" };
+
+    assert_projection(json, ab, 1, true, "{\"a\":{\"b\":1}}");
+    assert_projection(json, d1e, 1, true, "{\"d\":[{\"e\":\"x\"}]}");
+    assert_projection(json, several, 3, true, "{\"a\":{\"c\":[2]},\"d\":[false],\"g\":\"skipped\"}");
+    assert_projection(json, none, 5, true, "{}");
+    assert_projection(json, none, 0, true, "{}");
+    assert_projection(json, whole, 1, true, json);
+    assert_projection("[1,[2,3]]", several, 0, true, "[]");
+}
+
+static void parse_projection_should_find_the_same_items_as_get_pointer(void)
+{
+    const char json[] = "{\"a\":{\"b\":1},\"A\":2,\"a/b\":3,\"m~n\":4,\"\\u0078\":5,\"\":6,\"dup\":{\"x\":1},\"dup\":{\"y\":2},\"arr\":[[0,1],[2,3]]}";
+    const char *pointers[] = { "/a", "/a/b", "/a~1b", "/m~0n", "/x", "/", "/dup/y", "/arr/1/0" };
+    const char *expected[] = { "{\"b\":1}", "1", "3", "4", "5", "6", NULL, "2" };
+    const char *insensitive[] = { "/A", "/M~0N", "/X", "/DUP/X" };
+    const char *insensitive_expected[] = { "{\"b\":1}", "4", "5", "1" };
+    const char *sensitive_expected[] = { "2", NULL, NULL, NULL };
+    const char *invalid[] = { "/m~2n", "/arr/x", "/arr/", NULL };
+    const char *invalid_expected[] = { NULL, NULL, NULL, NULL };
+
+    assert_same_results(json, pointers, 8, true, expected);
+    assert_same_results(json, insensitive, 4, false, insensitive_expected);
+    assert_same_results(json, insensitive, 4, true, sensitive_expected);
+    assert_same_results(json, invalid, 4, true, invalid_expected);
+}
+
+static void parse_projection_should_handle_overlapping_pointers(void)
+{
+    const char json[] = "{\"a\":{\"b\":[1,{\"c\":2}]},\"d\":3}";
+    const char *pointers[] = { "/a/b/1/c", "/a", "/a/b/0", "/d", "/d/e" };
+    const char *expected[] = { "2", "{\"b\":[1,{\"c\":2}]}", "1", "3", NULL };
+
+    assert_same_results(json, pointers, 5, true, expected);
+    assert_projection(json, pointers, 5, true, json);
+}
+
+static void parse_projection_should_parse_scalar_documents(void)
+{
+    const char *pointers[] = { "", "/a" };
+    const char *expected[] = { "\"text\"", NULL };
+
+    assert_same_results(" \"text\" ", pointers, 2, true, expected);
+    assert_projection("12", pointers + 1, 1, true, "12");
+}
+
+static void parse_projection_should_fail_like_the_parser(void)
+{
+    const char *documents[] = { "{\"a\":1,\"b\":[1,2}", "{\"a\":tru}", "[1,2,", "{\"a\" 1}", "{\"x\":\"\\q\"}", "", "{\"a\":{\"b\":[nul]}}" };
+    const char *pointers[] = { "/a/b/0", "/c" };
+    cJSON *results[2];
+    size_t i = 0;
+
+    for (i = 0; i < (sizeof(documents) / sizeof(documents[0])); i++)
+    {
+        const char *parser_error = NULL;
+        TEST_ASSERT_NULL(cJSON_Parse(documents[i]));
+        parser_error = cJSON_GetErrorPtr();
+
+        results[0] = results[1] = (cJSON*)documents;
+        TEST_ASSERT_NULL_MESSAGE(cJSON_ParseProjection(documents[i], pointers, 2, true, results), documents[i]);
+        TEST_ASSERT_TRUE_MESSAGE(cJSON_GetErrorPtr() == parser_error, documents[i]);
+        TEST_ASSERT_NULL(results[0]);
+        TEST_ASSERT_NULL(results[1]);
+    }
+
+    TEST_ASSERT_NULL(cJSON_ParseProjection(NULL, pointers, 2, true, NULL));
+    TEST_ASSERT_NULL(cJSON_ParseProjection("{}", NULL, 2, true, NULL));
+}
+
+static void parse_projection_should_limit_nesting(void)
+{
+    char deep[(CJSON_NESTING_LIMIT + 1) * 2 + 1];
+    const char *pointers[] = { "/0" };
+    cJSON *projection = NULL;
+    size_t i = 0;
+
+    for (i = 0; i < (CJSON_NESTING_LIMIT + 1); i++)
+    {
+        deep[i] = '[';
+        deep[(CJSON_NESTING_LIMIT + 1) * 2 - 1 - i] = ']';
+    }
+    deep[sizeof(deep) - 1] = '\0';
+
+    TEST_ASSERT_NULL(cJSON_ParseProjection(deep, pointers, 1, true, NULL));
+    projection = cJSON_ParseProjection(deep + 1, pointers, 1, true, NULL);
+    TEST_ASSERT_NOT_NULL(projection);
+    cJSON_Delete(projection);
+}
+
+static void parse_projection_should_not_allocate_skipped_values(void)
+{
+    static const char json[] = "{\"skipped\":[\"a string that is long enough\",1,{\"inner\":\"\\u00e9\"}],\"kept\":{\"a\":1,\"b\":\"long strings are skipped as well\"}}";
+    const char *pointers[] = { "/kept/a" };
+    cJSON *projection = NULL;
+
+    use_counting_hooks();
+    projection = cJSON_ParseProjection(json, pointers, 1, true, NULL);
+    cJSON_InitHooks(NULL);
+    TEST_ASSERT_NOT_NULL(projection);
+
+    /* the scratch space, the root, kept with its name and a with its name */
+    TEST_ASSERT_EQUAL_UINT(8U, (unsigned int)allocations);
+    cJSON_Delete(projection);
+}
+
+/* select every single item of the test files and compare it with the item in the whole tree */
+static void assert_every_item_found(const char *json, const cJSON *item, char *pointer, size_t length)
+{
+    const char *pointers[1];
+    cJSON *result = NULL;
+    cJSON *projection = NULL;
+    const cJSON *child = NULL;
+    size_t index = 0;
+
+    pointers[0] = pointer;
+    projection = cJSON_ParseProjection(json, pointers, 1, true, &result);
+    TEST_ASSERT_NOT_NULL(projection);
+    TEST_ASSERT_NOT_NULL_MESSAGE(result, pointer);
+    TEST_ASSERT_TRUE_MESSAGE(cJSON_Compare(item, result, true), pointer);
+    /* only the path to the item is kept */
+    TEST_ASSERT_TRUE_MESSAGE((length == 0) || (cJSON_GetArraySize(projection) == 1), pointer);
+    cJSON_Delete(projection);
+
+    for (child = item->child; child != NULL; child = child->next, index++)
+    {
+        size_t child_length = length;
+        if (child_length > 200)
+        {
+            continue;
+        }
+        pointer[child_length++] = '/';
+        if (cJSON_IsArray(item))
+        {
+            child_length += (size_t)sprintf(pointer + child_length, "%lu", (unsigned long)index);
+        }
+        else
+        {
+            const char *name = NULL;
+            for (name = child->string; (*name != '\0') && (child_length < 250); name++)
+            {
+                if ((*name == '~') || (*name == '/'))
+                {
+                    pointer[child_length++] = '~';
+                    pointer[child_length++] = (*name == '~') ? '0' : '1';
+                }
+                else
+                {
+                    pointer[child_length++] = *name;
+                }
+            }
+        }
+        pointer[child_length] = '\0';
+
+        /* only the first of duplicate names can be found */
+        if (!cJSON_IsObject(item) || (cJSON_GetObjectItemCaseSensitive(item, child->string) == child))
+        {
+            assert_every_item_found(json, child, pointer, child_length);
+        }
+        pointer[length] = '\0';
+    }
+}
+
+static void parse_projection_should_find_every_item_of_test_files(void)
+{
+    const char *files[] = { "inputs/test1", "inputs/test2", "inputs/test3", "inputs/test4", "inputs/test5", "inputs/test7", "inputs/test8", "inputs/test9", "inputs/test10", "inputs/test11" };
+    size_t i = 0;
+
+    for (i = 0; i < (sizeof(files) / sizeof(files[0])); i++)
+    {
+        char pointer[256] = "";
+        char *content = read_file(files[i]);
+        cJSON *tree = NULL;
+        TEST_ASSERT_NOT_NULL(content);
+
+        tree = cJSON_Parse(content);
+        TEST_ASSERT_NOT_NULL(tree);
+        assert_every_item_found(content, tree, pointer, 0);
+
+        cJSON_Delete(tree);
+        free(content);
+    }
+}
+
+int CJSON_CDECL main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(parse_projection_should_keep_only_selected_values);
+    RUN_TEST(parse_projection_should_find_the_same_items_as_get_pointer);
+    RUN_TEST(parse_projection_should_handle_overlapping_pointers);
+    RUN_TEST(parse_projection_should_parse_scalar_documents);
+    RUN_TEST(parse_projection_should_fail_like_the_parser);
+    RUN_TEST(parse_projection_should_limit_nesting);
+    RUN_TEST(parse_projection_should_not_allocate_skipped_values);
+    RUN_TEST(parse_projection_should_find_every_item_of_test_files);
+
+    return UNITY_END();
+}
@@ -45,21 +45,20 @@ static void assert_is_string(cJSON *string_item)
 
 static void assert_parse_string(const char *string, const char *expected)
 {
-    parse_buffer buffer = { 0, 0, 0, 0, { 0, 0, 0 } };
+    parse_buffer buffer = { 0, 0, 0, 0, { 0, 0, 0, NULL }, NULL, NULL, 0, 0, NULL };
     buffer.content = (const unsigned char*)string;
     buffer.length = strlen(string) + sizeof("");
     buffer.hooks = global_hooks;
 
     TEST_ASSERT_TRUE_MESSAGE(parse_string(item, &buffer), "Couldn't parse string.");
     assert_is_string(item);
-    TEST_ASSERT_EQUAL_STRING_MESSAGE(expected, item->valuestring, "The parsed result isn't as expected.");
-    global_hooks.deallocate(item->valuestring);
-    item->valuestring = NULL;
+    TEST_ASSERT_EQUAL_STRING_MESSAGE(expected, item_valuestring(item), "The parsed result isn't as expected.");
+    reset(item);
 }
 
 static void assert_not_parse_string(const char * const string)
 {
-    parse_buffer buffer = { 0, 0, 0, 0, { 0, 0, 0 } };
+    parse_buffer buffer = { 0, 0, 0, 0, { 0, 0, 0, NULL }, NULL, NULL, 0, 0, NULL };
     buffer.content = (const unsigned char*)string;
     buffer.length = strlen(string) + sizeof("");
     buffer.hooks = global_hooks;
@@ -119,6 +118,47 @@ static void parse_string_should_parse_bug_94(void)
     reset(item);
 }
 
+static void parse_string_should_find_escapes_anywhere_in_long_strings(void)
+{
+    /* long enough for several vectors, so that every offset in and after a vector is covered */
+    char string[100];
+    char expected[100];
+    size_t position = 0;
+
+    for (position = 1; position < (sizeof(string) - 3); position++)
+    {
+        memset(string, 'a', sizeof(string) - 2);
+        string[0] = '\"';
+        string[position] = '\\';
+        string[position + 1] = 'n';
+        string[sizeof(string) - 2] = '\"';
+        string[sizeof(string) - 1] = '\0';
+
+        memset(expected, 'a', sizeof(expected) - 4);
+        expected[position - 1] = '\n';
+        expected[sizeof(expected) - 4] = '\0';
+
+        assert_parse_string(string, expected);
+        reset(item);
+    }
+}
+
+static void parse_string_should_not_parse_unterminated_long_strings(void)
+{
+    char string[100];
+
+    memset(string, 'a', sizeof(string) - 1);
+    string[0] = '\"';
+    string[sizeof(string) - 1] = '\0';
+
+    assert_not_parse_string(string);
+    reset(item);
+
+    string[sizeof(string) - 2] = '\\';
+    assert_not_parse_string(string);
+    reset(item);
+}
+
 int CJSON_CDECL main(void)
 {
     /* initialize cJSON item and error pointer */
@@ -131,5 +171,7 @@ int CJSON_CDECL main(void)
     RUN_TEST(parse_string_should_not_parse_invalid_backslash);
     RUN_TEST(parse_string_should_parse_bug_94);
     RUN_TEST(parse_string_should_not_overflow_with_closing_backslash);
+    RUN_TEST(parse_string_should_find_escapes_anywhere_in_long_strings);
+    RUN_TEST(parse_string_should_not_parse_unterminated_long_strings);
     return UNITY_END();
 }
@@ -0,0 +1,270 @@
+/*
+  Copyright (c) 2009-2017 Dave Gamble and cJSON contributors
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#include "unity/examples/unity_config.h"
+#include "unity/src/unity.h"
+#include "common.h"
+
+static void parse_with_arena_should_parse_like_parse_with_opts(void)
+{
+    const char *files[] = { "inputs/test1", "inputs/test2", "inputs/test3", "inputs/test4", "inputs/test5", "inputs/test7", "inputs/test8", "inputs/test9", "inputs/test10", "inputs/test11" };
+    size_t i = 0;
+
+    for (i = 0; i < (sizeof(files) / sizeof(files[0])); i++)
+    {
+        char *content = read_file(files[i]);
+        cJSON *expected = NULL;
+        cJSON *actual = NULL;
+        TEST_ASSERT_NOT_NULL(content);
+
+        expected = cJSON_ParseWithOpts(content, NULL, false);
+        actual = cJSON_ParseWithArena(content, NULL, false);
+        TEST_ASSERT_NOT_NULL(expected);
+        TEST_ASSERT_NOT_NULL(actual);
+        TEST_ASSERT_TRUE_MESSAGE(cJSON_Compare(expected, actual, true), files[i]);
+
+        cJSON_Delete(expected);
+        cJSON_ArenaDelete(actual);
+        free(content);
+    }
+}
+
+static void parse_with_arena_should_mark_items_and_strings(void)
+{
+    cJSON *tree = cJSON_ParseWithArena("{\"key\": \"a longer value\", \"array\": [1, {}]}", NULL, true);
+    cJSON *value = NULL;
+    TEST_ASSERT_NOT_NULL(tree);
+
+    TEST_ASSERT_BITS(cJSON_IsArenaItem, cJSON_IsArenaItem, tree->type);
+    assert_has_type(tree, cJSON_Object);
+
+    value = cJSON_GetObjectItemCaseSensitive(tree, "key");
+    TEST_ASSERT_NOT_NULL(value);
+    assert_has_type(value, cJSON_String);
+    TEST_ASSERT_BITS(cJSON_IsArenaItem | cJSON_IsReference | cJSON_StringIsConst, cJSON_IsArenaItem | cJSON_IsReference | cJSON_StringIsConst, value->type);
+    TEST_ASSERT_EQUAL_STRING("a longer value", item_valuestring(value));
+
+    value = cJSON_GetArrayItem(cJSON_GetObjectItemCaseSensitive(tree, "array"), 1);
+    TEST_ASSERT_NOT_NULL(value);
+    assert_has_type(value, cJSON_Object);
+    TEST_ASSERT_BITS(cJSON_IsArenaItem | cJSON_IsReference, cJSON_IsArenaItem, value->type);
+
+    cJSON_ArenaDelete(tree);
+}
+
+static void parse_with_arena_should_use_few_allocations(void)
+{
+    char *content = read_file("inputs/test7");
+    cJSON *tree = NULL;
+    TEST_ASSERT_NOT_NULL(content);
+
+    use_counting_hooks();
+    tree = cJSON_ParseWithArena(content, NULL, false);
+    TEST_ASSERT_NOT_NULL(tree);
+    TEST_ASSERT_TRUE(allocations <= 3);
+
+    cJSON_ArenaDelete(tree);
+    TEST_ASSERT_EQUAL_UINT(0, live_allocations);
+    cJSON_InitHooks(NULL);
+
+    free(content);
+}
+
+static void parse_with_arena_should_grow_into_new_chunks(void)
+{
+    cJSON *array = cJSON_CreateArray();
+    cJSON *tree = NULL;
+    char *printed = NULL;
+    int i = 0;
+
+    for (i = 0; i < 5000; i++)
+    {
+        cJSON_AddItemToArray(array, cJSON_CreateString("a string that is long enough to fill the arena quickly"));
+    }
+    printed = cJSON_PrintUnformatted(array);
+    TEST_ASSERT_NOT_NULL(printed);
+
+    use_counting_hooks();
+    tree = cJSON_ParseWithArena(printed, NULL, true);
+    TEST_ASSERT_NOT_NULL(tree);
+    TEST_ASSERT_TRUE(allocations > 1);
+    TEST_ASSERT_TRUE(allocations < 10);
+    cJSON_ArenaDelete(tree);
+    TEST_ASSERT_EQUAL_UINT(0, live_allocations);
+    cJSON_InitHooks(NULL);
+
+    cJSON_free(printed);
+    cJSON_Delete(array);
+}
+
+static void parse_with_arena_should_allow_modifications(void)
+{
+    cJSON *tree = NULL;
+    cJSON *copy = NULL;
+
+    use_counting_hooks();
+    tree = cJSON_ParseWithArena("{\"a\": [1, 2, 3], \"b\": \"string\", \"c\": {\"d\": null}}", NULL, true);
+    TEST_ASSERT_NOT_NULL(tree);
+
+    /* mixing heap items into the arena tree */
+    cJSON_AddItemToArray(cJSON_GetObjectItemCaseSensitive(tree, "a"), cJSON_CreateString("heap"));
+    cJSON_AddNumberToObject(cJSON_GetObjectItemCaseSensitive(tree, "c"), "e", 42);
+    cJSON_ReplaceItemInObjectCaseSensitive(tree, "b", cJSON_CreateString("replaced"));
+    cJSON_DeleteItemFromArray(cJSON_GetObjectItemCaseSensitive(tree, "a"), 0);
+    cJSON_AddItemToObject(tree, "f", cJSON_CreateObject());
+    cJSON_AddItemToObject(cJSON_GetObjectItemCaseSensitive(tree, "f"), "moved", cJSON_DetachItemFromObjectCaseSensitive(tree, "c"));
+
+    /* duplicates don't depend on the arena */
+    copy = cJSON_Duplicate(tree, true);
+    TEST_ASSERT_NOT_NULL(copy);
+    TEST_ASSERT_BITS(cJSON_IsArenaItem, 0, copy->type);
+    TEST_ASSERT_BITS(cJSON_IsArenaItem | cJSON_StringIsConst, 0, copy->child->type);
+
+    cJSON_ArenaDelete(tree);
+
+    {
+        char *printed = cJSON_PrintUnformatted(copy);
+        TEST_ASSERT_EQUAL_STRING("{\"a\":[2,3,\"heap\"],\"b\":\"replaced\",\"f\":{\"moved\":{\"d\":null,\"e\":42}}}", printed);
+        cJSON_free(printed);
+    }
+    cJSON_Delete(copy);
+
+    TEST_ASSERT_EQUAL_UINT(0, live_allocations);
+    cJSON_InitHooks(NULL);
+}
+
+static void parse_with_arena_should_be_released_by_cJSON_Delete(void)
+{
+    cJSON *tree = NULL;
+    cJSON *array = NULL;
+    size_t owners = 0;
+    arena_owner *owner = NULL;
+    int i = 0;
+
+    use_counting_hooks();
+    tree = cJSON_ParseWithArena("{\"a\": [1, 2, 3], \"b\": \"string\", \"c\": {\"d\": null}}", NULL, true);
+    TEST_ASSERT_NOT_NULL(tree);
+    TEST_ASSERT_BITS(cJSON_IsArenaRoot, cJSON_IsArenaRoot, tree->type);
+    TEST_ASSERT_BITS(cJSON_IsArenaRoot, 0, tree->child->type);
+
+    /* the arena remembers the array once, not every item */
+    array = cJSON_GetObjectItemCaseSensitive(tree, "a");
+    for (i = 0; i < 100; i++)
+    {
+        TEST_ASSERT_TRUE(cJSON_AddItemToArray(array, cJSON_CreateNumber(i)));
+    }
+    for (owner = arena_of(tree)->owners; owner != NULL; owner = owner->next)
+    {
+        owners++;
+    }
+    TEST_ASSERT_EQUAL_UINT(1, owners);
+
+    /* keys, indexes and values that arena items get later */
+    TEST_ASSERT_TRUE(cJSON_AddItemToObject(tree, "moved", cJSON_DetachItemFromObjectCaseSensitive(tree, "c")));
+    TEST_ASSERT_TRUE(cJSON_IndexObject(tree));
+    TEST_ASSERT_TRUE(cJSON_IndexArray(array));
+    TEST_ASSERT_TRUE(cJSON_ReplaceItemValue(cJSON_GetObjectItemCaseSensitive(tree, "b"), cJSON_CreateString("replaced")));
+    TEST_ASSERT_TRUE(cJSON_InsertItemInArray(array, 1, cJSON_CreateObject()));
+    TEST_ASSERT_TRUE(cJSON_ReplaceItemInArray(array, 0, cJSON_CreateTrue()));
+    cJSON_DeleteItemFromArray(array, 2);
+    TEST_ASSERT_EQUAL_STRING("replaced", cJSON_GetStringValue(cJSON_GetObjectItemCaseSensitive(tree, "b")));
+
+    cJSON_Delete(tree);
+    TEST_ASSERT_EQUAL_UINT(0, live_allocations);
+    cJSON_InitHooks(NULL);
+}
+
+static void parse_with_arena_should_replace_the_root(void)
+{
+    cJSON *tree = NULL;
+    char *printed = NULL;
+
+    use_counting_hooks();
+    tree = cJSON_ParseWithArena("[\"old\", {}]", NULL, true);
+    TEST_ASSERT_NOT_NULL(tree);
+
+    TEST_ASSERT_TRUE(cJSON_ReplaceItemValue(tree, cJSON_Parse("{\"new\": [true]}")));
+    TEST_ASSERT_BITS(cJSON_IsArenaItem | cJSON_IsArenaRoot, cJSON_IsArenaItem | cJSON_IsArenaRoot, tree->type);
+    printed = cJSON_PrintUnformatted(tree);
+    TEST_ASSERT_EQUAL_STRING("{\"new\":[true]}", printed);
+    cJSON_free(printed);
+
+    /* the root can't be moved out of its arena */
+    TEST_ASSERT_FALSE(cJSON_ReplaceItemValue(cJSON_GetObjectItem(tree, "new"), tree));
+
+    cJSON_Delete(tree);
+    TEST_ASSERT_EQUAL_UINT(0, live_allocations);
+    cJSON_InitHooks(NULL);
+}
+
+static void parse_with_arena_delete_should_ignore_other_items(void)
+{
+    cJSON *heap = cJSON_Parse("{\"a\": [1]}");
+    cJSON *tree = cJSON_ParseWithArena("{\"a\": [1]}", NULL, true);
+    TEST_ASSERT_NOT_NULL(heap);
+    TEST_ASSERT_NOT_NULL(tree);
+
+    cJSON_ArenaDelete(heap);
+    cJSON_ArenaDelete(tree->child);
+    TEST_ASSERT_TRUE(cJSON_Compare(heap, tree, true));
+
+    cJSON_Delete(heap);
+    cJSON_ArenaDelete(tree);
+}
+
+static void parse_with_arena_should_handle_errors(void)
+{
+    const char json[] = "{\"key\": [1, 2, \"unterminated]}";
+    const char *parse_end = NULL;
+    const char *expected_end = NULL;
+
+    TEST_ASSERT_NULL(cJSON_ParseWithArena(NULL, NULL, false));
+    TEST_ASSERT_NULL(cJSON_ParseWithOpts(json, &expected_end, false));
+
+    use_counting_hooks();
+    TEST_ASSERT_NULL(cJSON_ParseWithArena(json, &parse_end, false));
+    TEST_ASSERT_EQUAL_UINT(0, live_allocations);
+    cJSON_InitHooks(NULL);
+
+    TEST_ASSERT_EQUAL_PTR(expected_end, parse_end);
+    TEST_ASSERT_EQUAL_PTR(expected_end, cJSON_GetErrorPtr());
+
+    TEST_ASSERT_NULL(cJSON_ParseWithArena("[]x", NULL, true));
+    cJSON_ArenaDelete(NULL);
+}
+
+int CJSON_CDECL main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(parse_with_arena_should_parse_like_parse_with_opts);
+    RUN_TEST(parse_with_arena_should_mark_items_and_strings);
+    RUN_TEST(parse_with_arena_should_use_few_allocations);
+    RUN_TEST(parse_with_arena_should_grow_into_new_chunks);
+    RUN_TEST(parse_with_arena_should_allow_modifications);
+    RUN_TEST(parse_with_arena_should_be_released_by_cJSON_Delete);
+    RUN_TEST(parse_with_arena_should_replace_the_root);
+    RUN_TEST(parse_with_arena_delete_should_ignore_other_items);
+    RUN_TEST(parse_with_arena_should_handle_errors);
+
+    return UNITY_END();
+}
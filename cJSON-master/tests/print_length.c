@@ -0,0 +1,224 @@
+/*
+  Copyright (c) 2009-2017 Dave Gamble and cJSON contributors
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "unity/examples/unity_config.h"
+#include "unity/src/unity.h"
+#include "common.h"
+
+/* the length has to match the printed text, and a buffer of exactly that length plus the zero has to be enough */
+static void assert_printed_length(cJSON *item, cJSON_bool format)
+{
+    char *printed = format ? cJSON_Print(item) : cJSON_PrintUnformatted(item);
+    size_t length = cJSON_PrintedLength(item, format);
+    char *buffer = NULL;
+
+    TEST_ASSERT_NOT_NULL(printed);
+    TEST_ASSERT_EQUAL_UINT((unsigned int)strlen(printed), (unsigned int)length);
+
+    /* exactly sized allocations, so overruns are caught by sanitizers */
+    buffer = (char*)malloc(length + 1);
+    TEST_ASSERT_NOT_NULL(buffer);
+    TEST_ASSERT_TRUE(cJSON_PrintPreallocated(item, buffer, (int)length + 1, format));
+    TEST_ASSERT_EQUAL_STRING(printed, buffer);
+    free(buffer);
+
+    if (length > 0)
+    {
+        buffer = (char*)malloc(length);
+        TEST_ASSERT_NOT_NULL(buffer);
+        TEST_ASSERT_FALSE(cJSON_PrintPreallocated(item, buffer, (int)length, format));
+        free(buffer);
+    }
+
+    cJSON_free(printed);
+}
+
+static void assert_printed_length_for_json(const char *json)
+{
+    cJSON *tree = cJSON_Parse(json);
+    TEST_ASSERT_NOT_NULL_MESSAGE(tree, json);
+
+    assert_printed_length(tree, true);
+    assert_printed_length(tree, false);
+
+    cJSON_Delete(tree);
+}
+
+/* a raw item can't be printed without its text */
+static cJSON *create_raw_without_text(void)
+{
+    cJSON *raw = cJSON_CreateRaw("1");
+    TEST_ASSERT_NOT_NULL(raw);
+    if (!string_is_inline(raw))
+    {
+        cJSON_free(item_valuestring(raw));
+    }
+    set_valuestring(raw, NULL);
+
+    return raw;
+}
+
+static void printed_length_should_match_print_for_examples(void)
+{
+    const char *files[] = { "inputs/test1", "inputs/test2", "inputs/test3", "inputs/test4", "inputs/test5",
+                            "inputs/test7", "inputs/test8", "inputs/test9", "inputs/test10", "inputs/test11" };
+    size_t i = 0;
+
+    for (i = 0; i < (sizeof(files) / sizeof(files[0])); i++)
+    {
+        char *json = read_file(files[i]);
+        TEST_ASSERT_NOT_NULL_MESSAGE(json, files[i]);
+        assert_printed_length_for_json(json);
+        free(json);
+    }
+}
+
+static void printed_length_should_count_escapes_and_numbers(void)
+{
+    assert_printed_length_for_json("\"\\\"\\\\\\/\\b\\f\\n\\r\\t\\u0001\\u001f\\u00e4\"");
+    assert_printed_length_for_json("{\"\\n\\u0002\":\"\\t\",\"\":\"\"}");
+    assert_printed_length_for_json("[0,-0,1,-1,0.1,1e300,-1.5e-300,123456789012345678,5e-324,3.141592653589793]");
+    assert_printed_length_for_json("[[],{},[[{}]],{\"a\":{\"b\":[{\"c\":[]}]}}]");
+    assert_printed_length_for_json("[null,true,false]");
+}
+
+static void printed_length_should_handle_special_items(void)
+{
+    cJSON *object = cJSON_CreateObject();
+    cJSON *lazy = NULL;
+    cJSON *packed = NULL;
+    cJSON *raw = NULL;
+
+    TEST_ASSERT_NOT_NULL(cJSON_AddRawToObject(object, "raw", "[1, 2 ,3]"));
+    TEST_ASSERT_NOT_NULL(cJSON_AddNumberToObject(object, "nan", NAN));
+    cJSON_AddItemToObject(object, "string", cJSON_CreateStringReference("x"));
+    set_valuestring(cJSON_GetObjectItem(object, "string"), NULL);
+    assert_printed_length(object, true);
+    assert_printed_length(object, false);
+    cJSON_Delete(object);
+
+    lazy = cJSON_ParseLazy("{\"a\":[1,{\"b\":[2,\"c\"]}],\"d\":{}}", NULL, true, 1);
+    TEST_ASSERT_NOT_NULL(lazy);
+    assert_printed_length(lazy, true);
+    assert_printed_length(lazy, false);
+    cJSON_Delete(lazy);
+
+    packed = cJSON_ParsePacked("{\"a\":[1,-2.5e3,0.1],\"b\":[],\"c\":[[7]]}", NULL, true);
+    TEST_ASSERT_NOT_NULL(packed);
+    assert_printed_length(packed, true);
+    assert_printed_length(packed, false);
+    /* still packed */
+    TEST_ASSERT_TRUE(cJSON_GetObjectItem(packed, "a")->type & cJSON_IsPacked);
+    cJSON_Delete(packed);
+
+    raw = create_raw_without_text();
+    TEST_ASSERT_EQUAL_UINT(0U, (unsigned int)cJSON_PrintedLength(raw, false));
+    cJSON_Delete(raw);
+
+    TEST_ASSERT_EQUAL_UINT(0U, (unsigned int)cJSON_PrintedLength(NULL, false));
+}
+
+static void print_buffer_should_be_reused(void)
+{
+    cJSON_PrintBuffer *print_buffer = NULL;
+    cJSON *small = cJSON_Parse("{\"a\":[1,2,3]}");
+    cJSON *big = cJSON_Parse("{\"a\":[1,2,3],\"b\":\"a somewhat longer string to make it grow\"}");
+    const char *printed = NULL;
+    size_t length = 0;
+    int i = 0;
+
+    TEST_ASSERT_NOT_NULL(small);
+    TEST_ASSERT_NOT_NULL(big);
+
+    use_counting_hooks();
+    print_buffer = cJSON_CreatePrintBuffer(0);
+    TEST_ASSERT_NOT_NULL(print_buffer);
+
+    /* the first print allocates exactly the size it needs */
+    printed = cJSON_PrintToBuffer(print_buffer, small, false, &length);
+    TEST_ASSERT_EQUAL_STRING("{\"a\":[1,2,3]}", printed);
+    TEST_ASSERT_EQUAL_UINT((unsigned int)strlen(printed), (unsigned int)length);
+    TEST_ASSERT_EQUAL_UINT(2U, (unsigned int)allocations);
+
+    /* bigger documents grow it */
+    printed = cJSON_PrintToBuffer(print_buffer, big, true, &length);
+    TEST_ASSERT_EQUAL_UINT((unsigned int)cJSON_PrintedLength(big, true), (unsigned int)length);
+    TEST_ASSERT_EQUAL_UINT((unsigned int)strlen(printed), (unsigned int)length);
+
+    /* and after that, printing doesn't allocate anymore */
+    allocations = 0;
+    for (i = 0; i < 10; i++)
+    {
+        printed = cJSON_PrintToBuffer(print_buffer, (i % 2) ? small : big, true, NULL);
+        TEST_ASSERT_NOT_NULL(printed);
+    }
+    printed = cJSON_PrintToBuffer(print_buffer, small, true, &length);
+    TEST_ASSERT_EQUAL_UINT((unsigned int)strlen(printed), (unsigned int)length);
+    TEST_ASSERT_EQUAL_UINT(0U, (unsigned int)allocations);
+
+    cJSON_DeletePrintBuffer(print_buffer);
+    cJSON_InitHooks(NULL);
+
+    cJSON_Delete(small);
+    cJSON_Delete(big);
+}
+
+static void print_buffer_should_fail_gracefully(void)
+{
+    cJSON_PrintBuffer *print_buffer = cJSON_CreatePrintBuffer(1);
+    cJSON *raw = create_raw_without_text();
+    cJSON *array = cJSON_CreateArray();
+
+    TEST_ASSERT_NOT_NULL(print_buffer);
+    TEST_ASSERT_NOT_NULL(array);
+
+    TEST_ASSERT_NULL(cJSON_PrintToBuffer(NULL, raw, false, NULL));
+    TEST_ASSERT_NULL(cJSON_PrintToBuffer(print_buffer, NULL, false, NULL));
+
+    /* a failed print leaves the buffer usable */
+    cJSON_AddItemToArray(array, raw);
+    TEST_ASSERT_NULL(cJSON_PrintToBuffer(print_buffer, array, false, NULL));
+
+    cJSON_DeleteItemFromArray(array, 0);
+    TEST_ASSERT_EQUAL_STRING("[]", cJSON_PrintToBuffer(print_buffer, array, true, NULL));
+
+    cJSON_DeletePrintBuffer(print_buffer);
+    cJSON_DeletePrintBuffer(NULL);
+    cJSON_Delete(array);
+}
+
+int CJSON_CDECL main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(printed_length_should_match_print_for_examples);
+    RUN_TEST(printed_length_should_count_escapes_and_numbers);
+    RUN_TEST(printed_length_should_handle_special_items);
+    RUN_TEST(print_buffer_should_be_reused);
+    RUN_TEST(print_buffer_should_fail_gracefully);
+
+    return UNITY_END();
+}
@@ -28,7 +28,7 @@ static void assert_print_number(const char *expected, double input)
 {
     unsigned char printed[1024];
     cJSON item[1];
-    printbuffer buffer = { 0, 0, 0, 0, 0, 0, { 0, 0, 0 } };
+    printbuffer buffer = { 0, 0, 0, 0, 0, 0, { 0, 0, 0, NULL }, NULL, NULL };
     buffer.buffer = printed;
     buffer.length = sizeof(printed);
     buffer.offset = 0;
@@ -36,6 +36,7 @@ static void assert_print_number(const char *expected, double input)
     buffer.hooks = global_hooks;
 
     memset(item, 0, sizeof(item));
+    item->type = cJSON_Number;
     cJSON_SetNumberValue(item, input);
 
     TEST_ASSERT_TRUE_MESSAGE(print_number(item, &buffer), "Failed to print number.");
@@ -68,7 +69,10 @@ static void print_number_should_print_positive_reals(void)
     assert_print_number("1000000000000", 10e11);
     assert_print_number("1.23e+129", 123e+127);
     assert_print_number("1.23e-126", 123e-128);
-    assert_print_number("3.1415926535897931", 3.1415926535897931);
+    assert_print_number("3.141592653589793", 3.1415926535897931);
+    assert_print_number("0.30000000000000004", 0.1 + 0.2);
+    assert_print_number("5e-324", 5e-324);
+    assert_print_number("1.7976931348623157e+308", 1.7976931348623157e+308);
 }
 
 static void print_number_should_print_negative_reals(void)
@@ -80,6 +84,85 @@ static void print_number_should_print_negative_reals(void)
     assert_print_number("-1.23e-126", -123e-128);
 }
 
+static void print_number_should_print_integers_like_sprintf(void)
+{
+    assert_print_number("999999999999999", 999999999999999.0);
+    assert_print_number("-999999999999999", -999999999999999.0);
+    assert_print_number("1000000000", 1000000000.0);
+    assert_print_number("1000000001", 1000000001.0);
+    assert_print_number("123000000456", 123000000456.0);
+    assert_print_number("1e+15", 1e15);
+    assert_print_number("1234567890123456", 1234567890123456.0);
+    assert_print_number("-0", -0.0);
+}
+
+static unsigned long random_state = 1;
+
+/* linear congruential generator, so the test is the same on every platform */
+static unsigned char random_byte(void)
+{
+    random_state = ((random_state * 1103515245UL) + 12345UL) & 0xFFFFFFFFUL;
+    return (unsigned char)(random_state >> 16);
+}
+
+static void print_number_should_print_the_shortest_round_trip(void)
+{
+    unsigned char printed[64];
+    char shorter[512];
+    double number = 0;
+    double parsed = 0;
+    cJSON item[1];
+    printbuffer buffer = { 0, 0, 0, 0, 0, 0, { 0, 0, 0, NULL }, NULL, NULL };
+    size_t i = 0;
+    size_t byte = 0;
+
+    for (i = 0; i < 100000; i++)
+    {
+        unsigned char bytes[sizeof(double)];
+        size_t digits = 0;
+
+        /* random bit patterns, this covers all exponents */
+        for (byte = 0; byte < sizeof(bytes); byte++)
+        {
+            bytes[byte] = random_byte();
+        }
+        memcpy(&number, bytes, sizeof(number));
+        if ((number * 0) != 0)
+        {
+            /* NaN or Infinity */
+            continue;
+        }
+
+        memset(item, 0, sizeof(item));
+        item->type = cJSON_Number;
+        cJSON_SetNumberValue(item, number);
+        buffer.buffer = printed;
+        buffer.length = sizeof(printed);
+        buffer.offset = 0;
+        buffer.noalloc = true;
+        buffer.hooks = global_hooks;
+        TEST_ASSERT_TRUE(print_number(item, &buffer));
+
+        /* the printed number has to be parsed back to the same double */
+        parsed = strtod((const char*)printed, NULL);
+        TEST_ASSERT_EQUAL_MEMORY(&number, &parsed, sizeof(number));
+
+        /* and there is no shorter representation */
+        for (byte = 0; (printed[byte] != '\0') && (printed[byte] != 'e'); byte++)
+        {
+            if ((printed[byte] >= '0') && (printed[byte] <= '9') && ((digits > 0) || (printed[byte] != '0')))
+            {
+                digits++;
+            }
+        }
+        if (digits > 15)
+        {
+            sprintf(shorter, "%1.*g", (int)digits - 1, number);
+            TEST_ASSERT_TRUE(strtod(shorter, NULL) != number);
+        }
+    }
+}
+
 static void print_number_should_print_non_number(void)
 {
     TEST_IGNORE();
@@ -98,6 +181,8 @@ int CJSON_CDECL main(void)
     RUN_TEST(print_number_should_print_negative_integers);
     RUN_TEST(print_number_should_print_positive_integers);
     RUN_TEST(print_number_should_print_positive_reals);
+    RUN_TEST(print_number_should_print_integers_like_sprintf);
+    RUN_TEST(print_number_should_print_the_shortest_round_trip);
     RUN_TEST(print_number_should_print_negative_reals);
     RUN_TEST(print_number_should_print_non_number);
 
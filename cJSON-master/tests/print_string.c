@@ -27,7 +27,7 @@
 static void assert_print_string(const char *expected, const char *input)
 {
     unsigned char printed[1024];
-    printbuffer buffer = { 0, 0, 0, 0, 0, 0, { 0, 0, 0 } };
+    printbuffer buffer = { 0, 0, 0, 0, 0, 0, { 0, 0, 0, NULL }, NULL, NULL };
     buffer.buffer = printed;
     buffer.length = sizeof(printed);
     buffer.offset = 0;
@@ -65,6 +65,36 @@ static void print_string_should_print_utf8(void)
     assert_print_string("\"ü猫慕\"", "ü猫慕");
 }
 
+static void print_string_should_escape_characters_anywhere_in_long_strings(void)
+{
+    /* long enough for several vectors, so that every offset in and after a vector is covered */
+    const char special_characters[] = { '\"', '\\', '\n', '\x01', '\x1f' };
+    const char *escaped[] = { "\\\"", "\\\\", "\\n", "\\u0001", "\\u001f" };
+    char input[100];
+    char expected[120];
+    size_t position = 0;
+    size_t i = 0;
+
+    for (i = 0; i < sizeof(special_characters); i++)
+    {
+        for (position = 0; position < (sizeof(input) - 1); position++)
+        {
+            memset(input, 'a', sizeof(input) - 1);
+            input[sizeof(input) - 1] = '\0';
+            input[position] = special_characters[i];
+
+            expected[0] = '\"';
+            memset(expected + 1, 'a', position);
+            strcpy(expected + 1 + position, escaped[i]);
+            memset(expected + strlen(expected), 'a', sizeof(input) - 2 - position);
+            expected[1 + strlen(escaped[i]) + sizeof(input) - 2] = '\"';
+            expected[1 + strlen(escaped[i]) + sizeof(input) - 1] = '\0';
+
+            assert_print_string(expected, input);
+        }
+    }
+}
+
 int CJSON_CDECL main(void)
 {
     /* initialize cJSON item */
@@ -73,6 +103,7 @@ int CJSON_CDECL main(void)
     RUN_TEST(print_string_should_print_empty_strings);
     RUN_TEST(print_string_should_print_ascii);
     RUN_TEST(print_string_should_print_utf8);
+    RUN_TEST(print_string_should_escape_characters_anywhere_in_long_strings);
 
     return UNITY_END();
 }
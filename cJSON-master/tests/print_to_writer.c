@@ -0,0 +1,243 @@
+/*
+  Copyright (c) 2009-2017 Dave Gamble and cJSON contributors
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "unity/examples/unity_config.h"
+#include "unity/src/unity.h"
+#include "common.h"
+
+/* collects everything that is written to it */
+typedef struct
+{
+    char *data;
+    size_t length;
+    size_t calls;
+    size_t fail_after; /* 0 means never fail */
+} sink;
+
+static cJSON_bool CJSON_CDECL write_to_sink(const char *data, size_t length, void *context)
+{
+    sink *output = (sink*)context;
+
+    output->calls++;
+    if ((output->fail_after != 0) && (output->calls > output->fail_after))
+    {
+        return false;
+    }
+
+    output->data = (char*)realloc(output->data, output->length + length + 1);
+    TEST_ASSERT_NOT_NULL(output->data);
+    memcpy(output->data + output->length, data, length);
+    output->length += length;
+    output->data[output->length] = '\0';
+
+    return true;
+}
+
+/* print through a printbuffer of the given size to exercise flushing */
+static void assert_writer_output(const cJSON *item, cJSON_bool format, size_t buffer_size)
+{
+    printbuffer buffer = { 0, 0, 0, 0, 0, 0, { 0, 0, 0, NULL }, NULL, NULL };
+    sink output = { NULL, 0, 0, 0 };
+    char *expected = format ? cJSON_Print(item) : cJSON_PrintUnformatted(item);
+    TEST_ASSERT_NOT_NULL(expected);
+
+    buffer.buffer = (unsigned char*)global_hooks.allocate(buffer_size, global_hooks.user_data);
+    TEST_ASSERT_NOT_NULL(buffer.buffer);
+    buffer.length = buffer_size;
+    buffer.format = format;
+    buffer.hooks = global_hooks;
+    buffer.write = write_to_sink;
+    buffer.write_context = &output;
+
+    TEST_ASSERT_TRUE(print_value(item, &buffer));
+    update_offset(&buffer);
+    TEST_ASSERT_TRUE(flush_printbuffer(&buffer));
+
+    TEST_ASSERT_EQUAL_UINT((unsigned int)strlen(expected), (unsigned int)output.length);
+    TEST_ASSERT_EQUAL_STRING(expected, output.data);
+
+    global_hooks.deallocate(buffer.buffer, global_hooks.user_data);
+    free(output.data);
+    cJSON_free(expected);
+}
+
+static void assert_writer_output_for_file(const char *filename)
+{
+    cJSON *tree = NULL;
+    char *json = read_file(filename);
+    size_t buffer_size = 0;
+    TEST_ASSERT_NOT_NULL_MESSAGE(json, "Failed to read test input.");
+
+    tree = cJSON_Parse(json);
+    TEST_ASSERT_NOT_NULL_MESSAGE(tree, "Failed to parse test input.");
+
+    for (buffer_size = 1; buffer_size <= 64; buffer_size++)
+    {
+        assert_writer_output(tree, true, buffer_size);
+        assert_writer_output(tree, false, buffer_size);
+    }
+
+    cJSON_Delete(tree);
+    free(json);
+}
+
+static void print_to_writer_should_match_print_for_examples(void)
+{
+    assert_writer_output_for_file("inputs/test1");
+    assert_writer_output_for_file("inputs/test2");
+    assert_writer_output_for_file("inputs/test3");
+    assert_writer_output_for_file("inputs/test4");
+    assert_writer_output_for_file("inputs/test5");
+    assert_writer_output_for_file("inputs/test7");
+}
+
+static void print_to_writer_should_flush_big_documents(void)
+{
+    sink output = { NULL, 0, 0, 0 };
+    cJSON *array = cJSON_CreateArray();
+    char *expected = NULL;
+    int i = 0;
+
+    for (i = 0; i < 10000; i++)
+    {
+        cJSON *entry = cJSON_CreateObject();
+        TEST_ASSERT_NOT_NULL(cJSON_AddNumberToObject(entry, "number", i * 0.5));
+        TEST_ASSERT_NOT_NULL(cJSON_AddStringToObject(entry, "string", "some \"escaped\"\ttext"));
+        cJSON_AddItemToArray(array, entry);
+    }
+    expected = cJSON_Print(array);
+    TEST_ASSERT_NOT_NULL(expected);
+
+    TEST_ASSERT_TRUE(cJSON_PrintToWriter(array, true, write_to_sink, &output));
+    TEST_ASSERT_TRUE(output.calls > 1);
+    TEST_ASSERT_EQUAL_UINT((unsigned int)strlen(expected), (unsigned int)output.length);
+    TEST_ASSERT_EQUAL_STRING(expected, output.data);
+
+    free(output.data);
+    cJSON_free(expected);
+    cJSON_Delete(array);
+}
+
+static void print_to_writer_should_handle_strings_bigger_than_the_buffer(void)
+{
+    sink output = { NULL, 0, 0, 0 };
+    char *long_string = (char*)malloc(10001);
+    cJSON *object = NULL;
+    char *expected = NULL;
+    TEST_ASSERT_NOT_NULL(long_string);
+
+    memset(long_string, 'a', 10000);
+    long_string[10000] = '\0';
+    object = cJSON_CreateObject();
+    TEST_ASSERT_NOT_NULL(cJSON_AddStringToObject(object, "long", long_string));
+    expected = cJSON_PrintUnformatted(object);
+
+    TEST_ASSERT_TRUE(cJSON_PrintToWriter(object, false, write_to_sink, &output));
+    TEST_ASSERT_EQUAL_STRING(expected, output.data);
+
+    free(output.data);
+    free(long_string);
+    cJSON_free(expected);
+    cJSON_Delete(object);
+}
+
+static void print_to_writer_should_fail_if_the_callback_fails(void)
+{
+    sink output = { NULL, 0, 0, 1 };
+    cJSON *array = cJSON_CreateArray();
+    int i = 0;
+
+    for (i = 0; i < 2000; i++)
+    {
+        cJSON_AddItemToArray(array, cJSON_CreateString("element"));
+    }
+
+    TEST_ASSERT_FALSE(cJSON_PrintToWriter(array, false, write_to_sink, &output));
+    TEST_ASSERT_EQUAL_UINT(2, (unsigned int)output.calls);
+
+    free(output.data);
+    cJSON_Delete(array);
+}
+
+static void print_to_writer_should_fail_on_null(void)
+{
+    sink output = { NULL, 0, 0, 0 };
+    cJSON *item = cJSON_CreateNull();
+
+    TEST_ASSERT_FALSE(cJSON_PrintToWriter(NULL, false, write_to_sink, &output));
+    TEST_ASSERT_FALSE(cJSON_PrintToWriter(item, false, NULL, &output));
+    TEST_ASSERT_FALSE(cJSON_PrintToFd(item, false, -1));
+
+    cJSON_Delete(item);
+}
+
+static void print_to_fd_should_write_to_a_pipe(void)
+{
+#if defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__))
+    int fds[2];
+    cJSON *tree = NULL;
+    char *json = read_file("inputs/test1");
+    char *expected = NULL;
+    char written[4096];
+    ssize_t length = 0;
+    TEST_ASSERT_NOT_NULL(json);
+    TEST_ASSERT_EQUAL_INT(0, pipe(fds));
+
+    tree = cJSON_Parse(json);
+    TEST_ASSERT_NOT_NULL(tree);
+    expected = cJSON_Print(tree);
+    TEST_ASSERT_TRUE(strlen(expected) < sizeof(written));
+
+    /* the output is small enough to fit into the pipe */
+    TEST_ASSERT_TRUE(cJSON_PrintToFd(tree, true, fds[1]));
+    close(fds[1]);
+    length = read(fds[0], written, sizeof(written) - 1);
+    TEST_ASSERT_TRUE(length >= 0);
+    written[length] = '\0';
+    TEST_ASSERT_EQUAL_STRING(expected, written);
+
+    close(fds[0]);
+    cJSON_free(expected);
+    cJSON_Delete(tree);
+    free(json);
+#else
+    TEST_IGNORE_MESSAGE("No file descriptors on this platform.");
+#endif
+}
+
+int CJSON_CDECL main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(print_to_writer_should_match_print_for_examples);
+    RUN_TEST(print_to_writer_should_flush_big_documents);
+    RUN_TEST(print_to_writer_should_handle_strings_bigger_than_the_buffer);
+    RUN_TEST(print_to_writer_should_fail_if_the_callback_fails);
+    RUN_TEST(print_to_writer_should_fail_on_null);
+    RUN_TEST(print_to_fd_should_write_to_a_pipe);
+
+    return UNITY_END();
+}
@@ -185,9 +185,9 @@ static int supports_full_hd(const char * const monitor)
     }
 
     name = cJSON_GetObjectItemCaseSensitive(monitor_json, "name");
-    if (cJSON_IsString(name) && (name->valuestring != NULL))
+    if (cJSON_IsString(name) && (cJSON_GetStringValue(name) != NULL))
     {
-        printf("Checking monitor \"%s\"\n", name->valuestring);
+        printf("Checking monitor \"%s\"\n", cJSON_GetStringValue(name));
     }
 
     resolutions = cJSON_GetObjectItemCaseSensitive(monitor_json, "resolutions");
@@ -202,7 +202,7 @@ static int supports_full_hd(const char * const monitor)
             goto end;
         }
 
-        if ((width->valuedouble == 1920) && (height->valuedouble == 1080))
+        if ((cJSON_GetNumberValue(width) == 1920) && (cJSON_GetNumberValue(height) == 1080))
         {
             status = 1;
             goto end;
@@ -0,0 +1,350 @@
+/*
+  Copyright (c) 2009-2017 Dave Gamble and cJSON contributors
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#include "unity/examples/unity_config.h"
+#include "unity/src/unity.h"
+#include "common.h"
+
+/* the events are logged in a compact text form */
+static char event_log[4096];
+static size_t events_until_stop = 0;
+
+static cJSON_bool CJSON_CDECL log_event(int event, const cJSON *item, void *user_data)
+{
+    char *log = (char*)user_data;
+    char entry[256];
+
+    entry[0] = '\0';
+    if ((event != cJSON_EventKey) && (item->string != NULL))
+    {
+        sprintf(entry, "%s=", item->string);
+    }
+
+    switch (event)
+    {
+        case cJSON_EventObjectStart:
+            TEST_ASSERT_TRUE(cJSON_IsObject(item));
+            strcat(entry, "{");
+            break;
+        case cJSON_EventObjectEnd:
+            TEST_ASSERT_TRUE(cJSON_IsObject(item));
+            strcat(entry, "}");
+            break;
+        case cJSON_EventArrayStart:
+            TEST_ASSERT_TRUE(cJSON_IsArray(item));
+            strcat(entry, "[");
+            break;
+        case cJSON_EventArrayEnd:
+            TEST_ASSERT_TRUE(cJSON_IsArray(item));
+            strcat(entry, "]");
+            break;
+        case cJSON_EventKey:
+            sprintf(entry, "key:%s", item_valuestring(item));
+            break;
+        case cJSON_EventValue:
+            if (cJSON_IsString(item))
+            {
+                sprintf(entry + strlen(entry), "'%s'", item_valuestring(item));
+            }
+            else if (cJSON_IsNumber(item))
+            {
+                sprintf(entry + strlen(entry), "%g", item_number(item));
+            }
+            else if (cJSON_IsBool(item))
+            {
+                strcat(entry, cJSON_IsTrue(item) ? "true" : "false");
+            }
+            else
+            {
+                TEST_ASSERT_TRUE(cJSON_IsNull(item));
+                strcat(entry, "null");
+            }
+            break;
+        default:
+            TEST_FAIL_MESSAGE("Unknown event.");
+    }
+
+    if (log[0] != '\0')
+    {
+        strcat(log, " ");
+    }
+    strcat(log, entry);
+
+    if (events_until_stop > 0)
+    {
+        events_until_stop--;
+        return events_until_stop > 0;
+    }
+
+    return true;
+}
+
+/* feed the json in chunks of the given size */
+static cJSON_bool stream_parse_in_chunks(const char *json, size_t chunk_size, size_t *offset)
+{
+    cJSON_StreamParser *parser = cJSON_CreateStreamParser(log_event, event_log);
+    size_t length = strlen(json);
+    size_t position = 0;
+    cJSON_bool success = true;
+
+    TEST_ASSERT_NOT_NULL(parser);
+    event_log[0] = '\0';
+
+    for (position = 0; success && (position < length); position += chunk_size)
+    {
+        success = cJSON_StreamParserFeed(parser, json + position, (chunk_size < (length - position)) ? chunk_size : (length - position));
+    }
+    if (success)
+    {
+        success = cJSON_StreamParserFinish(parser);
+    }
+    if (offset != NULL)
+    {
+        *offset = cJSON_StreamParserGetOffset(parser);
+    }
+
+    cJSON_DeleteStreamParser(parser);
+
+    return success;
+}
+
+static void assert_events(const char *json, const char *expected)
+{
+    char first_log[sizeof(event_log)];
+    size_t chunk_size = 0;
+
+    TEST_ASSERT_TRUE(stream_parse_in_chunks(json, strlen(json) + 1, NULL));
+    TEST_ASSERT_EQUAL_STRING(expected, event_log);
+    strcpy(first_log, event_log);
+
+    /* the result must not depend on where the chunks are split */
+    for (chunk_size = 1; chunk_size < 8; chunk_size++)
+    {
+        TEST_ASSERT_TRUE(stream_parse_in_chunks(json, chunk_size, NULL));
+        TEST_ASSERT_EQUAL_STRING(first_log, event_log);
+    }
+}
+
+static void assert_not_stream_parsed(const char *json, size_t error_offset)
+{
+    size_t chunk_size = 0;
+    size_t offset = 0;
+
+    for (chunk_size = 1; chunk_size <= (strlen(json) + 1); chunk_size++)
+    {
+        TEST_ASSERT_FALSE(stream_parse_in_chunks(json, chunk_size, &offset));
+        TEST_ASSERT_EQUAL_UINT(error_offset, offset);
+    }
+}
+
+static void stream_parser_should_report_values(void)
+{
+    assert_events("null", "null");
+    assert_events(" true ", "true");
+    assert_events("false", "false");
+    assert_events("-12.5e3", "-12500");
+    assert_events("\"string\"", "'string'");
+    assert_events("\"escaped \\\"\\u00fc\\\\\"", "'escaped \"\xc3\xbc\\'");
+}
+
+static void stream_parser_should_report_objects_and_arrays(void)
+{
+    assert_events("[]", "[ ]");
+    assert_events("{}", "{ }");
+    assert_events("[1, [2, []], {}]", "[ 1 [ 2 [ ] ] { } ]");
+    assert_events(
+        "{\"number\": 1, \"array\": [true, {\"key\": \"value\"}], \"object\": {\"empty\": {}}, \"null\": null}",
+        "{ key:number number=1 key:array array=[ true { key:key key='value' } ] "
+        "key:object object={ key:empty empty={ } } key:null null=null }");
+}
+
+static void stream_parser_should_parse_several_documents(void)
+{
+    assert_events("{\"a\":1}\n{\"a\":2}\n[3]\n4 5", "{ key:a a=1 } { key:a a=2 } [ 3 ] 4 5");
+    assert_events("\xEF\xBB\xBF[1]", "[ 1 ]");
+}
+
+static void stream_parser_should_reject_invalid_json(void)
+{
+    assert_not_stream_parsed("", 0);
+    assert_not_stream_parsed("   ", 3);
+    assert_not_stream_parsed("[1,2", 4);
+    assert_not_stream_parsed("[1 2]", 3);
+    assert_not_stream_parsed("{\"a\" 1}", 5);
+    assert_not_stream_parsed("{1:1}", 1);
+    assert_not_stream_parsed("[1}", 2);
+    assert_not_stream_parsed("{\"a\":1]", 6);
+    assert_not_stream_parsed("[1,]", 3);
+    assert_not_stream_parsed("[tru]", 1);
+    assert_not_stream_parsed("\"unterminated", 1);
+    assert_not_stream_parsed("[1] x", 4);
+    /* numbers and literals at the top level need whitespace after them */
+    assert_not_stream_parsed("truefalse", 4);
+    assert_not_stream_parsed("1null", 1);
+    assert_not_stream_parsed("2 null[3]", 6);
+}
+
+static void stream_parser_should_separate_values_without_whitespace(void)
+{
+    assert_events("\"a\"\"b\"", "'a' 'b'");
+    assert_events("[1]2 {}", "[ 1 ] 2 { }");
+    assert_events("\"a\"true", "'a' true");
+}
+
+static size_t long_string_length = 0;
+
+static cJSON_bool CJSON_CDECL measure_string(int event, const cJSON *item, void *user_data)
+{
+    (void)user_data;
+    TEST_ASSERT_EQUAL_INT(cJSON_EventValue, event);
+    TEST_ASSERT_TRUE(cJSON_IsString(item));
+    long_string_length = strlen(item_valuestring(item));
+    TEST_ASSERT_EQUAL_STRING_LEN("a\na\n", item_valuestring(item), 4);
+
+    return true;
+}
+
+static void stream_parser_should_continue_long_tokens(void)
+{
+    char json[30001];
+    size_t chunk_size = 0;
+    size_t i = 0;
+
+    /* a long string with escapes at every possible chunk boundary */
+    json[0] = '\"';
+    for (i = 1; i < (sizeof(json) - 3); i += 3)
+    {
+        memcpy(json + i, "a\\n", 3);
+    }
+    json[i] = '\"';
+    json[i + 1] = '\0';
+
+    for (chunk_size = 1; chunk_size < 5; chunk_size++)
+    {
+        cJSON_StreamParser *parser = cJSON_CreateStreamParser(measure_string, NULL);
+        size_t position = 0;
+        TEST_ASSERT_NOT_NULL(parser);
+
+        long_string_length = 0;
+        for (position = 0; position < (i + 1); position += chunk_size)
+        {
+            TEST_ASSERT_TRUE(cJSON_StreamParserFeed(parser, json + position, (chunk_size < (i + 1 - position)) ? chunk_size : (i + 1 - position)));
+        }
+        TEST_ASSERT_TRUE(cJSON_StreamParserFinish(parser));
+        TEST_ASSERT_EQUAL_UINT((unsigned int)(((i - 1) / 3) * 2), (unsigned int)long_string_length);
+        cJSON_DeleteStreamParser(parser);
+    }
+
+    /* and a number spread over many feeds (cJSON reads at most 63 digits) */
+    memset(json, '7', 40);
+    strcpy(json + 40, " ");
+    TEST_ASSERT_TRUE(stream_parse_in_chunks(json, 1, NULL));
+    TEST_ASSERT_EQUAL_STRING("7.77778e+39", event_log);
+}
+
+static void stream_parser_should_enforce_the_nesting_limit(void)
+{
+    char deep[CJSON_NESTING_LIMIT + 2];
+    cJSON_StreamParser *parser = NULL;
+
+    memset(deep, '[', sizeof(deep));
+    deep[sizeof(deep) - 1] = '\0';
+
+    parser = cJSON_CreateStreamParser(log_event, event_log);
+    TEST_ASSERT_NOT_NULL(parser);
+    event_log[0] = '\0';
+    TEST_ASSERT_TRUE(cJSON_StreamParserFeed(parser, deep, CJSON_NESTING_LIMIT));
+    TEST_ASSERT_FALSE(cJSON_StreamParserFeed(parser, deep, 1));
+    TEST_ASSERT_EQUAL_UINT(CJSON_NESTING_LIMIT, cJSON_StreamParserGetOffset(parser));
+    /* a failed parser stays failed */
+    TEST_ASSERT_FALSE(cJSON_StreamParserFeed(parser, "]", 1));
+    TEST_ASSERT_FALSE(cJSON_StreamParserFinish(parser));
+    cJSON_DeleteStreamParser(parser);
+}
+
+static void stream_parser_should_stop_when_the_callback_says_so(void)
+{
+    size_t offset = 0;
+
+    events_until_stop = 3;
+    TEST_ASSERT_FALSE(stream_parse_in_chunks("[1, 2, 3, 4]", 100, &offset));
+    TEST_ASSERT_EQUAL_STRING("[ 1 2", event_log);
+    TEST_ASSERT_EQUAL_UINT(5, offset);
+    events_until_stop = 0;
+}
+
+static cJSON_bool CJSON_CDECL count_values(int event, const cJSON *item, void *user_data)
+{
+    (void)item;
+    if (event == cJSON_EventValue)
+    {
+        (*(size_t*)user_data)++;
+    }
+
+    return true;
+}
+
+static void stream_parser_should_not_allocate_items(void)
+{
+    const char element[] = "{\"id\": 12345, \"name\": \"a somewhat longer string value\", \"tags\": [\"x\", \"y\"]},\n";
+    cJSON_StreamParser *parser = NULL;
+    size_t values = 0;
+    size_t i = 0;
+
+    use_counting_hooks();
+
+    parser = cJSON_CreateStreamParser(count_values, &values);
+    TEST_ASSERT_NOT_NULL(parser);
+    TEST_ASSERT_TRUE(cJSON_StreamParserFeed(parser, "[", 1));
+    for (i = 0; i < 1000; i++)
+    {
+        /* split in an odd place, so there is always something pending */
+        TEST_ASSERT_TRUE(cJSON_StreamParserFeed(parser, element, 13));
+        TEST_ASSERT_TRUE(cJSON_StreamParserFeed(parser, element + 13, sizeof(element) - 1 - 13));
+    }
+    TEST_ASSERT_TRUE(cJSON_StreamParserFeed(parser, "null]", 5));
+    TEST_ASSERT_TRUE(cJSON_StreamParserFinish(parser));
+    cJSON_DeleteStreamParser(parser);
+
+    cJSON_InitHooks(NULL);
+
+    TEST_ASSERT_EQUAL_UINT(4001, values);
+    /* the parser, its memory for strings and the buffer for pending input */
+    TEST_ASSERT_TRUE(allocations <= 5);
+}
+
+int CJSON_CDECL main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(stream_parser_should_report_values);
+    RUN_TEST(stream_parser_should_report_objects_and_arrays);
+    RUN_TEST(stream_parser_should_parse_several_documents);
+    RUN_TEST(stream_parser_should_reject_invalid_json);
+    RUN_TEST(stream_parser_should_separate_values_without_whitespace);
+    RUN_TEST(stream_parser_should_continue_long_tokens);
+    RUN_TEST(stream_parser_should_enforce_the_nesting_limit);
+    RUN_TEST(stream_parser_should_stop_when_the_callback_says_so);
+    RUN_TEST(stream_parser_should_not_allocate_items);
+
+    return UNITY_END();
+}
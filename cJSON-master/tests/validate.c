@@ -0,0 +1,201 @@
+/*
+  Copyright (c) 2009-2017 Dave Gamble and cJSON contributors
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "unity/examples/unity_config.h"
+#include "unity/src/unity.h"
+#include "common.h"
+
+/* cJSON_Validate has to agree with the parser about validity and the position of the error */
+static void assert_same_as_parser(const char *json)
+{
+    const char *parse_end = NULL;
+    const char *error_position = NULL;
+    cJSON *tree = cJSON_ParseWithOpts(json, &parse_end, true);
+    cJSON_bool valid = cJSON_Validate(json, strlen(json), &error_position);
+
+    if (tree != NULL)
+    {
+        TEST_ASSERT_TRUE_MESSAGE(valid, json);
+        TEST_ASSERT_NULL(error_position);
+    }
+    else
+    {
+        TEST_ASSERT_FALSE_MESSAGE(valid, json);
+        TEST_ASSERT_EQUAL_PTR_MESSAGE(parse_end, error_position, json);
+    }
+
+    cJSON_Delete(tree);
+}
+
+static void validate_should_accept_what_the_parser_accepts(void)
+{
+    static const char *documents[] = {
+        "null", " true ", "false\n", "\xEF\xBB\xBF{}", "0", "-1.5e10", "01", "1.", "[]", "[ ]", "{ }",
+        "\"\"", "\"\\b\\f\\n\\r\\t\\\"\\\\\\/\"", "\"\\u00e9\\uD83D\\uDE00\"", "\"\\uZZZZ\"",
+        "[1, \"two\", {\"three\": [3, null]}, false]",
+        "{\"a\":{\"b\":{\"c\":[[[[]]]]}},\"d\":\"\xe2\x82\xac\"}"
+    };
+    size_t i = 0;
+
+    for (i = 0; i < (sizeof(documents) / sizeof(documents[0])); i++)
+    {
+        assert_same_as_parser(documents[i]);
+        TEST_ASSERT_TRUE_MESSAGE(cJSON_Validate(documents[i], strlen(documents[i]), NULL), documents[i]);
+    }
+}
+
+static void validate_should_reject_what_the_parser_rejects(void)
+{
+    static const char *documents[] = {
+        "", " ", "nul", "truex", "-", "+1", ".5", "[", "[1", "[1,", "[1,]", "[,1]", "]", "{", "{\"a\"", "{\"a\":",
+        "{\"a\":1,}", "{a:1}", "{\"a\" 1}", "\"", "\"abc", "\"\\x\"", "\"\\u12\"", "\"\\uD83D\"", "\"\\uDE00\"",
+        "\"\\uD83D\\u0041\"", "\"abc\\", "[1] [2]", "{\"a\":[1,2}", "[\"\\\"]"
+    };
+    size_t i = 0;
+
+    for (i = 0; i < (sizeof(documents) / sizeof(documents[0])); i++)
+    {
+        assert_same_as_parser(documents[i]);
+    }
+}
+
+static void validate_should_agree_with_the_parser_on_damaged_documents(void)
+{
+    static const char original[] = "{\"name\":\"caf\\u00e9 \\\"x\\\"\",\"values\":[1,-2.5e3,true,false,null,{\"nested\":[\"\\uD83D\\uDE00\"]}],\"empty\":{}}";
+    static const char replacements[] = "{}[]\",:\\ 0-etu";
+    char damaged[sizeof(original) + 1];
+    size_t position = 0;
+    size_t replacement = 0;
+
+    for (position = 0; position < (sizeof(original) - 1); position++)
+    {
+        /* remove one character */
+        memcpy(damaged, original, position);
+        memcpy(damaged + position, original + position + 1, sizeof(original) - position - 1);
+        assert_same_as_parser(damaged);
+
+        /* or replace it */
+        for (replacement = 0; replacement < (sizeof(replacements) - 1); replacement++)
+        {
+            memcpy(damaged, original, sizeof(original));
+            damaged[position] = replacements[replacement];
+            assert_same_as_parser(damaged);
+        }
+    }
+}
+
+static void validate_should_read_numbers_like_the_parser(void)
+{
+    static const char *numbers[] = {
+        "0", "-0", "01", "-01", "1.", "-.5", ".5", "1.e5", "1e", "1e+", "1E-2", "1e5x", "1.5.5", "--1", "-+1", "1e999",
+        "123456789012345678901234567890", "0.00000000000000000000000000000000000000000000000000000000000000000000001",
+        "0.00000000000000000000000000000000000000000000000000000000000000000000000",
+        "1e00000000000000000000000000000000000000000000000000000000000000000000005",
+        "1234567890123456789012345678901234567890123456789012345678901234567890e5"
+    };
+    char document[128];
+    size_t i = 0;
+
+    for (i = 0; i < (sizeof(numbers) / sizeof(numbers[0])); i++)
+    {
+        assert_same_as_parser(numbers[i]);
+        sprintf(document, "[%s]", numbers[i]);
+        assert_same_as_parser(document);
+    }
+}
+
+static void validate_should_respect_the_length(void)
+{
+    const char *error_position = NULL;
+
+    TEST_ASSERT_TRUE(cJSON_Validate("[1,2]garbage", 5, NULL));
+    TEST_ASSERT_FALSE(cJSON_Validate("[1,2]", 4, &error_position));
+    TEST_ASSERT_NOT_NULL(error_position);
+    TEST_ASSERT_FALSE(cJSON_Validate("\"abc\"", 4, NULL));
+    TEST_ASSERT_TRUE(cJSON_Validate("nullx", 4, NULL));
+    TEST_ASSERT_FALSE(cJSON_Validate("[]", 0, &error_position));
+    TEST_ASSERT_FALSE(cJSON_Validate(NULL, 1, &error_position));
+    TEST_ASSERT_NULL(error_position);
+}
+
+static void validate_should_stop_at_null_characters(void)
+{
+    const char *error_position = NULL;
+    static const char array[] = "[1,\0 2]";
+    static const char string[] = "\"a\0b\"";
+    static const char trailing[] = "[1]\0garbage";
+
+    TEST_ASSERT_FALSE(cJSON_Validate(array, sizeof(array) - 1, &error_position));
+    TEST_ASSERT_EQUAL_PTR(array + 3, error_position);
+    TEST_ASSERT_FALSE(cJSON_Validate(string, sizeof(string) - 1, &error_position));
+    TEST_ASSERT_NOT_NULL(error_position);
+    TEST_ASSERT_TRUE(cJSON_Validate(trailing, sizeof(trailing) - 1, NULL));
+}
+
+static void validate_should_limit_nesting(void)
+{
+    char deep[(CJSON_NESTING_LIMIT + 1) * 2 + 1];
+    size_t i = 0;
+
+    for (i = 0; i < (CJSON_NESTING_LIMIT + 1); i++)
+    {
+        deep[i] = '[';
+        deep[(2 * (CJSON_NESTING_LIMIT + 1)) - 1 - i] = ']';
+    }
+    deep[sizeof(deep) - 1] = '\0';
+
+    assert_same_as_parser(deep);
+    TEST_ASSERT_FALSE(cJSON_Validate(deep, strlen(deep), NULL));
+    TEST_ASSERT_TRUE(cJSON_Validate(deep + 1, strlen(deep) - 2, NULL));
+}
+
+static void validate_should_not_allocate(void)
+{
+    static const char json[] = "{\"key\":[\"a string that is long enough\",1,{\"inner\":\"\\u00e9\"}]}";
+
+    use_counting_hooks();
+    TEST_ASSERT_TRUE(cJSON_Validate(json, sizeof(json) - 1, NULL));
+    TEST_ASSERT_FALSE(cJSON_Validate(json, sizeof(json) - 2, NULL));
+    cJSON_InitHooks(NULL);
+
+    TEST_ASSERT_EQUAL_UINT(0U, (unsigned int)allocations);
+}
+
+int CJSON_CDECL main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(validate_should_accept_what_the_parser_accepts);
+    RUN_TEST(validate_should_reject_what_the_parser_rejects);
+    RUN_TEST(validate_should_agree_with_the_parser_on_damaged_documents);
+    RUN_TEST(validate_should_read_numbers_like_the_parser);
+    RUN_TEST(validate_should_respect_the_length);
+    RUN_TEST(validate_should_stop_at_null_characters);
+    RUN_TEST(validate_should_limit_nesting);
+    RUN_TEST(validate_should_not_allocate);
+
+    return UNITY_END();
+}